@@ -0,0 +1,286 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Vicente J. Botet Escriba 2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/fixed_point for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file
+ * @brief Defines an accumulator holding the exact sum of a long chain of fixed point numbers, as the products of a
+ * multiply-accumulate.
+ *
+ */
+
+#ifndef BOOST_FIXED_POINT_ACCUMULATOR_HPP
+#define BOOST_FIXED_POINT_ACCUMULATOR_HPP
+
+#include <boost/fixed_point/number.hpp>
+#include <boost/fixed_point/int128.hpp>
+#include <boost/static_assert.hpp>
+#include <climits>
+
+namespace boost
+{
+  namespace fixed_point
+  {
+    namespace detail
+    {
+      //! The type of the sum of up to 2^N numbers of type @c T, @c T with N more bits of range.
+      template <typename T, int N>
+      struct accumulator_value;
+      template <int R, int P, typename RP, typename OP, typename F, int N>
+      struct accumulator_value<real_t<R,P,RP,OP,F>, N>
+      {
+        typedef real_t<R+N, P, RP, OP, F> type;
+      };
+      template <int R, int P, typename RP, typename OP, typename F, int N>
+      struct accumulator_value<ureal_t<R,P,RP,OP,F>, N>
+      {
+        typedef ureal_t<R+N, P, RP, OP, F> type;
+      };
+
+      /**
+       * The number @c To nearest to the value of index @c v and resolution <c>2^From::resolution_exp</c>, with the
+       * rounding and overflow policies of @c To.
+       *
+       * The value is rounded on 128 bits by the round_quotient of the rounding policy, the divisor being a power of
+       * two. An out of range value is given to the overflow policy as the boost::intmax_t or boost::uintmax_t nearest
+       * to it, or, when the policy wraps, reduced modulo the range of @c To.
+       */
+      template <typename From, typename To, typename I>
+      To limbs_cast(I v)
+      {
+        typedef typename To::underlying_type underlying_type;
+        typedef typename max_type<To::is_signed>::type max_t;
+        typedef typename To::overflow_type overflow_type;
+        BOOST_STATIC_CONSTEXPR int d = To::resolution_exp - From::resolution_exp;
+        BOOST_STATIC_ASSERT_MSG((d > -128 && d < 127), "The resolutions are too far apart");
+        // the negative bounds are only compared with a signed sum
+        const bool is_signed = std::numeric_limits<I>::is_signed;
+        const I max_index(To::max_index);
+        const I min_index(To::min_index);
+        I q = v;
+        if (d > 0)
+        {
+          // the quotient truncated toward zero and the remainder with the sign of the dividend
+          const int s = d > 0 ? d : 0;
+          const I den = I(1) << s;
+          q = ((is_signed && v < I(0)) ? v + (den - 1) : v) >> s;
+          q = To::rounding_type::template round_quotient<I>(q, v - (q << s), den);
+        }
+        else if (d < 0)
+        {
+          // the bounds are symmetric or 0, so that the shifted bounds are exact
+          const int s = d < 0 ? -d : 0;
+          if (v > (max_index >> s)) q = max_index + 1;
+          else if (is_signed && v < -(-min_index >> s)) q = min_index - 1;
+          else q <<= s;
+        }
+        const bool positive = q > max_index;
+        if (!positive && !(is_signed && q < min_index))
+          return To(index(underlying_type(q.template convert_to<max_t>())));
+        if (overflow_type::is_modulo)
+        {
+          const I range = max_index - min_index + 1;
+          if (d < 0)
+          {
+            // the shifted value has been lost, so v is shifted again one bit at a time modulo the range
+            q = v % range;
+            for (int i = 0; i < -d; ++i)
+            {
+              q <<= 1;
+              if (q >= range) q -= range;
+              else if (is_signed && q <= -range) q += range;
+            }
+          }
+          else
+            q %= range;
+          if (is_signed && q < min_index) q += range;
+          else if (q > max_index) q -= range;
+        }
+        else
+        {
+          const I hi(integer_max<max_t>::value);
+          const I lo(std::numeric_limits<max_t>::min());
+          if (q > hi) q = hi;
+          else if (is_signed && q < lo) q = lo;
+        }
+        const max_t x = q.template convert_to<max_t>();
+        return To(index(positive ? overflow_type::template on_positive_overflow<To, max_t>(x)
+            : overflow_type::template on_negative_overflow<To, max_t>(x)));
+      }
+
+      /**
+       * The underlying integer of the sum: the one of the value type when it fits in a builtin integer, or int128
+       * and uint128.
+       */
+      template <typename T, int N, bool Limbs = (T::digits + N > sizeof(boost::intmax_t) * CHAR_BIT)
+#if defined(BOOST_FIXED_POINT_HAS_INT128)
+          && (T::digits + N > 128)
+#endif
+          >
+      struct accumulator_storage
+      {
+        typedef typename accumulator_value<T, N>::type value_type;
+        typedef typename value_type::underlying_type type;
+
+        template <typename Res>
+        static Res get(type v)
+        {
+          return fixed_point::number_cast<Res>(value_type(index(v)));
+        }
+      };
+      template <typename T, int N>
+      struct accumulator_storage<T, N, true>
+      {
+        BOOST_STATIC_ASSERT_MSG(T::digits + N <= 128, "The sum needs more than 128 bits");
+        typedef integer128<T::is_signed> type;
+
+        template <typename Res>
+        static Res get(type v)
+        {
+          return limbs_cast<T, Res>(v);
+        }
+      };
+    }
+
+    /**
+     * @brief Exact sum of up to 2^N numbers of type @c T.
+     *
+     * Each operator+ grows the range by one bit, so that a chain of additions either outgrows the range of the
+     * template parameters or needs a number_cast, and an overflow check, at each step. The accumulator has from the
+     * start the range of the sum of 2^N numbers, the one add_result gives after N additions, so that the terms are
+     * added to its underlying integer without any check nor rounding. The sum is normalized once at the end to the
+     * target type with its rounding and overflow policies.
+     *
+     * The sums of up to 128 bits are stored on the builtin 128 bits integer when the compiler provides one, and on
+     * the two limbs of int128 or uint128 otherwise, where value() is not available, so that the exact sums of 96 or
+     * 128 bits, as the ones of financial amounts, are portable.
+     *
+     * @TParams
+     * @Param{T,the type of the terms, usually a multiply_result type}
+     * @Param{N,the base 2 logarithm of the maximum number of terms}
+     *
+     * @Example
+     * @code
+     * accumulator<multiply_result<real_t<15,-16> >::type> acc;
+     * for (std::size_t i = 0; i < n; ++i)
+     *   acc += x[i] * h[i];
+     * real_t<15,-16> y = acc.get<real_t<15,-16> >();
+     * @endcode
+     */
+    template <typename T, int N = 32>
+    class accumulator
+    {
+    public:
+      //! The type of the terms.
+      typedef T term_type;
+      //! The type of the sum, @c T with @c N more bits of range.
+      typedef typename detail::accumulator_value<T, N>::type value_type;
+      //! The underlying integer of the sum.
+      typedef typename detail::accumulator_storage<T, N>::type underlying_type;
+
+      /**
+       * @Effects constructs an accumulator holding 0.
+       */
+      accumulator() :
+        value_(0)
+      {
+      }
+
+      /**
+       * @Effects constructs an accumulator holding @c x.
+       */
+      explicit accumulator(T const& x) :
+        value_(underlying_type(x.count()))
+      {
+      }
+
+      /**
+       * @Effects adds @c x to the sum, without overflow check.
+       * @Requires the sum holds at most 2^N terms.
+       */
+      accumulator& operator+=(T const& x)
+      {
+        value_ += underlying_type(x.count());
+        return *this;
+      }
+
+      /**
+       * @Effects adds @c x, of any fixed point type whose range and resolution are included in the ones of @c T, to
+       * the sum, without overflow check.
+       * @Requires the sum holds at most 2^N terms.
+       */
+      template <typename U>
+      accumulator& operator+=(U const& x)
+      {
+        BOOST_STATIC_ASSERT_MSG((U::resolution_exp >= T::resolution_exp && U::range_exp <= T::range_exp),
+            "The term is not exactly representable by the term type of the accumulator");
+        value_ += underlying_type(x.count()) * (underlying_type(1) << (U::resolution_exp - T::resolution_exp));
+        return *this;
+      }
+
+      /**
+       * @Effects subtracts @c x from the sum, without overflow check.
+       * @Requires the sum holds at most 2^N terms, and stays positive when @c T is unsigned.
+       */
+      accumulator& operator-=(T const& x)
+      {
+        value_ -= underlying_type(x.count());
+        return *this;
+      }
+
+      /**
+       * @Effects adds the sum of @c other, so that accumulators of partial sums can be merged.
+       * @Requires the sum holds at most 2^N terms in all.
+       */
+      accumulator& operator+=(accumulator const& other)
+      {
+        value_ += other.value_;
+        return *this;
+      }
+
+      /**
+       * @Effects resets the sum to 0.
+       */
+      void clear()
+      {
+        value_ = 0;
+      }
+
+      /**
+       * @Returns the index of the sum.
+       */
+      underlying_type count() const
+      {
+        return value_;
+      }
+
+      /**
+       * @Returns the exact sum.
+       */
+      value_type value() const
+      {
+        return value_type(index(value_));
+      }
+
+      /**
+       * @Returns the sum converted to @c Res with its rounding and overflow policies, <c>number_cast<Res>(value())</c>.
+       */
+      template <typename Res>
+      Res get() const
+      {
+        return detail::accumulator_storage<T, N>::template get<Res>(value_);
+      }
+
+    private:
+      underlying_type value_;
+    };
+  }
+}
+
+#endif // header
@@ -0,0 +1,1081 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Vicente J. Botet Escriba 2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/fixed_point for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file
+ * @brief Defines the batch operations on contiguous arrays of fixed point numbers.
+ *
+ * The batch operations give the same results as the scalar operators applied element by element. When the
+ * processor supports it, the common cases, including the conversions from arrays of doubles, are computed with
+ * SSE4, AVX2 or AVX-512 instructions, selected at run time; the other cases use the scalar operators.
+ *
+ * Define BOOST_FIXED_POINT_NO_SIMD to use only the scalar operators.
+ */
+
+#ifndef BOOST_FIXED_POINT_BATCH_HPP
+#define BOOST_FIXED_POINT_BATCH_HPP
+
+#include <boost/fixed_point/number.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/integral_constant.hpp>
+#include <boost/type_traits/is_floating_point.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <cstddef>
+
+#if !defined(BOOST_FIXED_POINT_NO_SIMD) && (defined(__GNUC__) || defined(__clang__)) \
+    && (defined(__x86_64__) || defined(__i386__)) \
+    && (defined(__clang__) || (__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define BOOST_FIXED_POINT_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace boost
+{
+  namespace fixed_point
+  {
+    namespace simd
+    {
+      /**
+       * Instruction sets the batch operations can use, from the least to the most capable.
+       *
+       * @c sse4 needs SSE4.2, as the 64 bits comparisons used to detect the overflows appeared with it.
+       * @c avx512 needs AVX-512F.
+       */
+      enum level
+      {
+        none, sse4, avx2, avx512
+      };
+
+      namespace detail
+      {
+        inline level detect()
+        {
+#if defined(BOOST_FIXED_POINT_SIMD_X86)
+          __builtin_cpu_init();
+          if (__builtin_cpu_supports("avx512f")) return avx512;
+          if (__builtin_cpu_supports("avx2")) return avx2;
+          if (__builtin_cpu_supports("sse4.2")) return sse4;
+#endif
+          return none;
+        }
+        inline level& current()
+        {
+          static level l = detect();
+          return l;
+        }
+      }
+
+      //! @Returns the most capable instruction set supported by the processor.
+      inline level supported()
+      {
+        static const level l = detail::detect();
+        return l;
+      }
+
+      //! @Returns the instruction set used by the batch operations.
+      inline level active()
+      {
+        return detail::current();
+      }
+
+      /**
+       * @Effects Restricts the instruction set used by the batch operations to @c l, or to the supported one if it is
+       * less capable.
+       * @Returns the previous instruction set.
+       *
+       * This is not thread safe; it is intended to compare the kernels between them.
+       */
+      inline level restrict_to(level l)
+      {
+        level prev = detail::current();
+        detail::current() = (l < supported()) ? l : supported();
+        return prev;
+      }
+
+#if defined(BOOST_FIXED_POINT_SIMD_X86)
+      namespace detail
+      {
+        inline bool detect_vbmi()
+        {
+          __builtin_cpu_init();
+          return __builtin_cpu_supports("avx512bw") != 0 && __builtin_cpu_supports("avx512vbmi") != 0;
+        }
+
+        //! Whether the processor supports the AVX-512 VBMI instructions, used at the avx512 level.
+        inline bool vbmi_supported()
+        {
+          static const bool res = detect_vbmi();
+          return res;
+        }
+
+        /**
+         * Kernels on the underlying integers. Each one processes the longest prefix made of whole vectors and returns
+         * its length; the caller processes the rest with the scalar operators.
+         */
+
+        enum round_kind
+        {
+          round_negative, round_truncated, round_positive, round_half_up, round_half_down, round_even, round_odd
+        };
+
+        /**
+         * Parameters of the reduction of the resolution of int64 indices by @c d bits to int32 indices.
+         * Values greater than @c max_shifted or less than @c min_shifted overflow.
+         */
+        struct requantize_params
+        {
+          int d;
+          boost::int64_t max_shifted;
+          boost::int64_t min_shifted;
+          boost::int64_t max_index;
+          boost::int64_t min_index;
+          bool saturate;
+          //! the overflow::sticky_flags of the saturated values, set by the kernel.
+          unsigned overflow;
+        };
+
+        /**
+         * Parameters of the conversion of doubles to int32 indices: the doubles are multiplied by @c scale, rounded,
+         * and overflow if they are greater than @c max_index or less than @c min_index.
+         */
+        struct convert_params
+        {
+          double scale;
+          double max_index;
+          double min_index;
+          bool saturate;
+          //! the overflow::sticky_flags of the saturated values, set by the kernel.
+          unsigned overflow;
+        };
+
+        ///////////////////////////////////////////////////////////////////////
+        // SSE4
+
+        template <bool Sub>
+        __attribute__((target("sse4.2")))
+        std::size_t add_widen_sse4(const boost::int32_t* a, const boost::int32_t* b, boost::int64_t* r, std::size_t n)
+        {
+          std::size_t i = 0;
+          for (; i + 2 <= n; i += 2)
+          {
+            __m128i x = _mm_cvtepi32_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(a + i)));
+            __m128i y = _mm_cvtepi32_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(b + i)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(r + i), Sub ? _mm_sub_epi64(x, y) : _mm_add_epi64(x, y));
+          }
+          return i;
+        }
+        template <bool Sub>
+        __attribute__((target("sse4.2")))
+        std::size_t add_sse4(const boost::int32_t* a, const boost::int32_t* b, boost::int32_t* r, std::size_t n)
+        {
+          std::size_t i = 0;
+          for (; i + 4 <= n; i += 4)
+          {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(r + i), Sub ? _mm_sub_epi32(x, y) : _mm_add_epi32(x, y));
+          }
+          return i;
+        }
+        __attribute__((target("sse4.2")))
+        inline std::size_t mul_widen_sse4(const boost::int32_t* a, const boost::int32_t* b, boost::int64_t* r,
+            std::size_t n)
+        {
+          std::size_t i = 0;
+          for (; i + 2 <= n; i += 2)
+          {
+            __m128i x = _mm_cvtepi32_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(a + i)));
+            __m128i y = _mm_cvtepi32_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(b + i)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(r + i), _mm_mul_epi32(x, y));
+          }
+          return i;
+        }
+
+        /**
+         * Adds to @c acc the sum of <c>a[i] * b[i]</c> over the processed prefix. @c b must not contain -32768, so
+         * that the sums of two products computed by pmaddwd don't overflow.
+         */
+        __attribute__((target("sse4.2")))
+        inline std::size_t mac_int16_sse4(const boost::int16_t* a, const boost::int16_t* b, std::size_t n,
+            boost::int64_t& acc)
+        {
+          __m128i sum = _mm_setzero_si128();
+          std::size_t i = 0;
+          for (; i + 8 <= n; i += 8)
+          {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+            __m128i m = _mm_madd_epi16(x, y);
+            sum = _mm_add_epi64(sum, _mm_add_epi64(_mm_cvtepi32_epi64(m), _mm_cvtepi32_epi64(_mm_srli_si128(m, 8))));
+          }
+          boost::int64_t lanes[2];
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), sum);
+          acc += lanes[0] + lanes[1];
+          return i;
+        }
+
+        template <int Kind>
+        __attribute__((target("sse4.2")))
+        std::size_t requantize_sse4(const boost::int64_t* v, boost::int32_t* r, std::size_t n,
+            requantize_params& p)
+        {
+          const __m128i count = _mm_cvtsi32_si128(p.d);
+          const __m128i zero = _mm_setzero_si128();
+          const __m128i one = _mm_set1_epi64x(1);
+          const __m128i low = _mm_set1_epi64x((boost::int64_t(1) << p.d) - 1);
+          const __m128i half = _mm_set1_epi64x(boost::int64_t(1) << (p.d - 1));
+          const __m128i top = _mm_set1_epi64x(boost::int64_t(1) << (63 - p.d));
+          const __m128i max_shifted = _mm_set1_epi64x(p.max_shifted);
+          const __m128i min_shifted = _mm_set1_epi64x(p.min_shifted);
+          const __m128i max_index = _mm_set1_epi64x(p.max_index);
+          const __m128i min_index = _mm_set1_epi64x(p.min_index);
+          std::size_t i = 0;
+          __m128i positive = _mm_setzero_si128();
+          __m128i negative = _mm_setzero_si128();
+          for (; i + 2 <= n; i += 2)
+          {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(v + i));
+            __m128i gt = _mm_cmpgt_epi64(x, max_shifted);
+            __m128i lt = _mm_cmpgt_epi64(min_shifted, x);
+            if (!p.saturate && !_mm_testz_si128(_mm_or_si128(gt, lt), _mm_or_si128(gt, lt))) break;
+            __m128i sign = _mm_cmpgt_epi64(zero, x);
+            __m128i bias;
+            switch (Kind)
+            {
+            case round_negative: bias = zero; break;
+            case round_truncated: bias = _mm_and_si128(sign, low); break;
+            case round_positive: bias = low; break;
+            case round_half_up: bias = _mm_add_epi64(half, sign); break;
+            case round_half_down: bias = _mm_sub_epi64(_mm_sub_epi64(half, one), sign); break;
+            case round_even: bias = _mm_add_epi64(_mm_sub_epi64(half, one), _mm_and_si128(_mm_srl_epi64(x, count), one)); break;
+            default: bias = _mm_sub_epi64(half, _mm_and_si128(_mm_srl_epi64(x, count), one)); break;
+            }
+            // arithmetic shift right of 64 bits integers, which SSE doesn't provide
+            __m128i y = _mm_sub_epi64(_mm_xor_si128(_mm_srl_epi64(_mm_add_epi64(x, bias), count), top), top);
+            y = _mm_blendv_epi8(y, max_index, gt);
+            y = _mm_blendv_epi8(y, min_index, lt);
+            positive = _mm_or_si128(positive, gt);
+            negative = _mm_or_si128(negative, lt);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(r + i), _mm_shuffle_epi32(y, _MM_SHUFFLE(2, 0, 2, 0)));
+          }
+          p.overflow = (!_mm_testz_si128(positive, positive) ? unsigned(overflow::positive_overflow_flag) : 0u)
+              | (!_mm_testz_si128(negative, negative) ? unsigned(overflow::negative_overflow_flag) : 0u);
+          return i;
+        }
+
+        template <int Kind>
+        __attribute__((target("sse4.2")))
+        std::size_t convert_sse4(const double* v, boost::int32_t* r, std::size_t n, convert_params & p)
+        {
+          const __m128d scale = _mm_set1_pd(p.scale);
+          const __m128d zero = _mm_setzero_pd();
+          const __m128d half = _mm_set1_pd(0.5);
+          const __m128d one = _mm_set1_pd(1.0);
+          const __m128d max_index = _mm_set1_pd(p.max_index);
+          const __m128d min_index = _mm_set1_pd(p.min_index);
+          std::size_t i = 0;
+          __m128d positive = _mm_setzero_pd();
+          __m128d negative = _mm_setzero_pd();
+          for (; i + 2 <= n; i += 2)
+          {
+            __m128d y = _mm_mul_pd(_mm_loadu_pd(v + i), scale);
+            __m128d f;
+            if (Kind == round_negative) f = _mm_floor_pd(y);
+            else if (Kind == round_truncated) f = _mm_round_pd(y, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+            else if (Kind == round_positive) f = _mm_ceil_pd(y);
+            else if (Kind == round_even) f = _mm_round_pd(y, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+            else
+            {
+              __m128d fl = _mm_floor_pd(y);
+              __m128d rest = _mm_sub_pd(y, fl);
+              __m128d tie;
+              if (Kind == round_half_up) tie = _mm_cmpge_pd(fl, zero);
+              else if (Kind == round_half_down) tie = _mm_cmplt_pd(fl, zero);
+              else tie = _mm_cmpeq_pd(_mm_mul_pd(fl, half), _mm_floor_pd(_mm_mul_pd(fl, half)));
+              __m128d up = _mm_or_pd(_mm_cmpgt_pd(rest, half), _mm_and_pd(_mm_cmpeq_pd(rest, half), tie));
+              f = _mm_add_pd(fl, _mm_and_pd(up, one));
+            }
+            __m128d gt = _mm_cmpgt_pd(f, max_index);
+            __m128d lt = _mm_cmplt_pd(f, min_index);
+            if (!p.saturate && _mm_movemask_pd(_mm_or_pd(gt, lt)) != 0) break;
+            f = _mm_blendv_pd(f, max_index, gt);
+            f = _mm_blendv_pd(f, min_index, lt);
+            positive = _mm_or_pd(positive, gt);
+            negative = _mm_or_pd(negative, lt);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(r + i), _mm_cvtpd_epi32(f));
+          }
+          p.overflow = (_mm_movemask_pd(positive) != 0 ? unsigned(overflow::positive_overflow_flag) : 0u)
+              | (_mm_movemask_pd(negative) != 0 ? unsigned(overflow::negative_overflow_flag) : 0u);
+          return i;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // AVX2
+
+        template <bool Sub>
+        __attribute__((target("avx2")))
+        std::size_t add_widen_avx2(const boost::int32_t* a, const boost::int32_t* b, boost::int64_t* r, std::size_t n)
+        {
+          std::size_t i = 0;
+          for (; i + 4 <= n; i += 4)
+          {
+            __m256i x = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+            __m256i y = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(r + i), Sub ? _mm256_sub_epi64(x, y) : _mm256_add_epi64(x, y));
+          }
+          return i;
+        }
+        template <bool Sub>
+        __attribute__((target("avx2")))
+        std::size_t add_avx2(const boost::int32_t* a, const boost::int32_t* b, boost::int32_t* r, std::size_t n)
+        {
+          std::size_t i = 0;
+          for (; i + 8 <= n; i += 8)
+          {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(r + i), Sub ? _mm256_sub_epi32(x, y) : _mm256_add_epi32(x, y));
+          }
+          return i;
+        }
+        __attribute__((target("avx2")))
+        inline std::size_t mul_widen_avx2(const boost::int32_t* a, const boost::int32_t* b, boost::int64_t* r,
+            std::size_t n)
+        {
+          std::size_t i = 0;
+          for (; i + 4 <= n; i += 4)
+          {
+            __m256i x = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+            __m256i y = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(r + i), _mm256_mul_epi32(x, y));
+          }
+          return i;
+        }
+
+        /**
+         * Adds to @c acc the sum of <c>a[i] * b[i]</c> over the processed prefix. @c b must not contain -32768.
+         */
+        __attribute__((target("avx2")))
+        inline std::size_t mac_int16_avx2(const boost::int16_t* a, const boost::int16_t* b, std::size_t n,
+            boost::int64_t& acc)
+        {
+          __m256i sum = _mm256_setzero_si256();
+          std::size_t i = 0;
+          for (; i + 16 <= n; i += 16)
+          {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            __m256i m = _mm256_madd_epi16(x, y);
+            sum = _mm256_add_epi64(sum, _mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(m)),
+                _mm256_cvtepi32_epi64(_mm256_extracti128_si256(m, 1))));
+          }
+          __m128i half = _mm_add_epi64(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+          boost::int64_t lanes[2];
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), half);
+          acc += lanes[0] + lanes[1];
+          return i;
+        }
+
+        template <int Kind>
+        __attribute__((target("avx2")))
+        std::size_t requantize_avx2(const boost::int64_t* v, boost::int32_t* r, std::size_t n,
+            requantize_params& p)
+        {
+          const __m128i count = _mm_cvtsi32_si128(p.d);
+          const __m256i zero = _mm256_setzero_si256();
+          const __m256i one = _mm256_set1_epi64x(1);
+          const __m256i low = _mm256_set1_epi64x((boost::int64_t(1) << p.d) - 1);
+          const __m256i half = _mm256_set1_epi64x(boost::int64_t(1) << (p.d - 1));
+          const __m256i top = _mm256_set1_epi64x(boost::int64_t(1) << (63 - p.d));
+          const __m256i max_shifted = _mm256_set1_epi64x(p.max_shifted);
+          const __m256i min_shifted = _mm256_set1_epi64x(p.min_shifted);
+          const __m256i max_index = _mm256_set1_epi64x(p.max_index);
+          const __m256i min_index = _mm256_set1_epi64x(p.min_index);
+          const __m256i even_dwords = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+          std::size_t i = 0;
+          __m256i positive = _mm256_setzero_si256();
+          __m256i negative = _mm256_setzero_si256();
+          for (; i + 4 <= n; i += 4)
+          {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v + i));
+            __m256i gt = _mm256_cmpgt_epi64(x, max_shifted);
+            __m256i lt = _mm256_cmpgt_epi64(min_shifted, x);
+            if (!p.saturate && !_mm256_testz_si256(_mm256_or_si256(gt, lt), _mm256_or_si256(gt, lt))) break;
+            __m256i sign = _mm256_cmpgt_epi64(zero, x);
+            __m256i bias;
+            switch (Kind)
+            {
+            case round_negative: bias = zero; break;
+            case round_truncated: bias = _mm256_and_si256(sign, low); break;
+            case round_positive: bias = low; break;
+            case round_half_up: bias = _mm256_add_epi64(half, sign); break;
+            case round_half_down: bias = _mm256_sub_epi64(_mm256_sub_epi64(half, one), sign); break;
+            case round_even: bias = _mm256_add_epi64(_mm256_sub_epi64(half, one), _mm256_and_si256(_mm256_srl_epi64(x, count), one)); break;
+            default: bias = _mm256_sub_epi64(half, _mm256_and_si256(_mm256_srl_epi64(x, count), one)); break;
+            }
+            // arithmetic shift right of 64 bits integers, which AVX2 doesn't provide
+            __m256i y = _mm256_sub_epi64(_mm256_xor_si256(_mm256_srl_epi64(_mm256_add_epi64(x, bias), count), top), top);
+            y = _mm256_blendv_epi8(y, max_index, gt);
+            y = _mm256_blendv_epi8(y, min_index, lt);
+            positive = _mm256_or_si256(positive, gt);
+            negative = _mm256_or_si256(negative, lt);
+            y = _mm256_permutevar8x32_epi32(y, even_dwords);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(r + i), _mm256_castsi256_si128(y));
+          }
+          p.overflow = (!_mm256_testz_si256(positive, positive) ? unsigned(overflow::positive_overflow_flag) : 0u)
+              | (!_mm256_testz_si256(negative, negative) ? unsigned(overflow::negative_overflow_flag) : 0u);
+          return i;
+        }
+
+        template <int Kind>
+        __attribute__((target("avx2")))
+        std::size_t convert_avx2(const double* v, boost::int32_t* r, std::size_t n, convert_params & p)
+        {
+          const __m256d scale = _mm256_set1_pd(p.scale);
+          const __m256d zero = _mm256_setzero_pd();
+          const __m256d half = _mm256_set1_pd(0.5);
+          const __m256d one = _mm256_set1_pd(1.0);
+          const __m256d max_index = _mm256_set1_pd(p.max_index);
+          const __m256d min_index = _mm256_set1_pd(p.min_index);
+          std::size_t i = 0;
+          __m256d positive = _mm256_setzero_pd();
+          __m256d negative = _mm256_setzero_pd();
+          for (; i + 4 <= n; i += 4)
+          {
+            __m256d y = _mm256_mul_pd(_mm256_loadu_pd(v + i), scale);
+            __m256d f;
+            if (Kind == round_negative) f = _mm256_floor_pd(y);
+            else if (Kind == round_truncated) f = _mm256_round_pd(y, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+            else if (Kind == round_positive) f = _mm256_ceil_pd(y);
+            else if (Kind == round_even) f = _mm256_round_pd(y, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+            else
+            {
+              __m256d fl = _mm256_floor_pd(y);
+              __m256d rest = _mm256_sub_pd(y, fl);
+              __m256d tie;
+              if (Kind == round_half_up) tie = _mm256_cmp_pd(fl, zero, _CMP_GE_OQ);
+              else if (Kind == round_half_down) tie = _mm256_cmp_pd(fl, zero, _CMP_LT_OQ);
+              else tie = _mm256_cmp_pd(_mm256_mul_pd(fl, half), _mm256_floor_pd(_mm256_mul_pd(fl, half)), _CMP_EQ_OQ);
+              __m256d up = _mm256_or_pd(_mm256_cmp_pd(rest, half, _CMP_GT_OQ),
+                  _mm256_and_pd(_mm256_cmp_pd(rest, half, _CMP_EQ_OQ), tie));
+              f = _mm256_add_pd(fl, _mm256_and_pd(up, one));
+            }
+            __m256d gt = _mm256_cmp_pd(f, max_index, _CMP_GT_OQ);
+            __m256d lt = _mm256_cmp_pd(f, min_index, _CMP_LT_OQ);
+            if (!p.saturate && _mm256_movemask_pd(_mm256_or_pd(gt, lt)) != 0) break;
+            f = _mm256_blendv_pd(f, max_index, gt);
+            f = _mm256_blendv_pd(f, min_index, lt);
+            positive = _mm256_or_pd(positive, gt);
+            negative = _mm256_or_pd(negative, lt);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(r + i), _mm256_cvtpd_epi32(f));
+          }
+          p.overflow = (_mm256_movemask_pd(positive) != 0 ? unsigned(overflow::positive_overflow_flag) : 0u)
+              | (_mm256_movemask_pd(negative) != 0 ? unsigned(overflow::negative_overflow_flag) : 0u);
+          return i;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // AVX-512
+
+        template <bool Sub>
+        __attribute__((target("avx512f")))
+        std::size_t add_widen_avx512(const boost::int32_t* a, const boost::int32_t* b, boost::int64_t* r,
+            std::size_t n)
+        {
+          std::size_t i = 0;
+          for (; i + 8 <= n; i += 8)
+          {
+            __m512i x = _mm512_cvtepi32_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)));
+            __m512i y = _mm512_cvtepi32_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+            _mm512_storeu_si512(r + i, Sub ? _mm512_sub_epi64(x, y) : _mm512_add_epi64(x, y));
+          }
+          return i;
+        }
+        template <bool Sub>
+        __attribute__((target("avx512f")))
+        std::size_t add_avx512(const boost::int32_t* a, const boost::int32_t* b, boost::int32_t* r, std::size_t n)
+        {
+          std::size_t i = 0;
+          for (; i + 16 <= n; i += 16)
+          {
+            __m512i x = _mm512_loadu_si512(a + i);
+            __m512i y = _mm512_loadu_si512(b + i);
+            _mm512_storeu_si512(r + i, Sub ? _mm512_sub_epi32(x, y) : _mm512_add_epi32(x, y));
+          }
+          return i;
+        }
+        __attribute__((target("avx512f")))
+        inline std::size_t mul_widen_avx512(const boost::int32_t* a, const boost::int32_t* b, boost::int64_t* r,
+            std::size_t n)
+        {
+          std::size_t i = 0;
+          for (; i + 8 <= n; i += 8)
+          {
+            __m512i x = _mm512_cvtepi32_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)));
+            __m512i y = _mm512_cvtepi32_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+            _mm512_storeu_si512(r + i, _mm512_mul_epi32(x, y));
+          }
+          return i;
+        }
+
+        template <int Kind>
+        __attribute__((target("avx512f")))
+        std::size_t requantize_avx512(const boost::int64_t* v, boost::int32_t* r, std::size_t n,
+            requantize_params& p)
+        {
+          const __m128i count = _mm_cvtsi32_si128(p.d);
+          const __m512i zero = _mm512_setzero_si512();
+          const __m512i one = _mm512_set1_epi64(1);
+          const __m512i low = _mm512_set1_epi64((boost::int64_t(1) << p.d) - 1);
+          const __m512i half = _mm512_set1_epi64(boost::int64_t(1) << (p.d - 1));
+          const __m512i max_shifted = _mm512_set1_epi64(p.max_shifted);
+          const __m512i min_shifted = _mm512_set1_epi64(p.min_shifted);
+          const __m512i max_index = _mm512_set1_epi64(p.max_index);
+          const __m512i min_index = _mm512_set1_epi64(p.min_index);
+          std::size_t i = 0;
+          __mmask8 positive = 0;
+          __mmask8 negative = 0;
+          for (; i + 8 <= n; i += 8)
+          {
+            __m512i x = _mm512_loadu_si512(v + i);
+            __mmask8 gt = _mm512_cmpgt_epi64_mask(x, max_shifted);
+            __mmask8 lt = _mm512_cmpgt_epi64_mask(min_shifted, x);
+            if (!p.saturate && (gt | lt) != 0) break;
+            __m512i sign = _mm512_srai_epi64(x, 63);
+            __m512i bias;
+            switch (Kind)
+            {
+            case round_negative: bias = zero; break;
+            case round_truncated: bias = _mm512_and_si512(sign, low); break;
+            case round_positive: bias = low; break;
+            case round_half_up: bias = _mm512_add_epi64(half, sign); break;
+            case round_half_down: bias = _mm512_sub_epi64(_mm512_sub_epi64(half, one), sign); break;
+            case round_even: bias = _mm512_add_epi64(_mm512_sub_epi64(half, one), _mm512_and_si512(_mm512_srl_epi64(x, count), one)); break;
+            default: bias = _mm512_sub_epi64(half, _mm512_and_si512(_mm512_srl_epi64(x, count), one)); break;
+            }
+            __m512i y = _mm512_sra_epi64(_mm512_add_epi64(x, bias), count);
+            y = _mm512_mask_mov_epi64(y, gt, max_index);
+            y = _mm512_mask_mov_epi64(y, lt, min_index);
+            positive = positive | gt;
+            negative = negative | lt;
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(r + i), _mm512_cvtepi64_epi32(y));
+          }
+          p.overflow = (positive != 0 ? unsigned(overflow::positive_overflow_flag) : 0u)
+              | (negative != 0 ? unsigned(overflow::negative_overflow_flag) : 0u);
+          return i;
+        }
+
+        template <int Kind>
+        __attribute__((target("avx512f")))
+        std::size_t convert_avx512(const double* v, boost::int32_t* r, std::size_t n, convert_params & p)
+        {
+          const __m512d scale = _mm512_set1_pd(p.scale);
+          const __m512d zero = _mm512_setzero_pd();
+          const __m512d half = _mm512_set1_pd(0.5);
+          const __m512d one = _mm512_set1_pd(1.0);
+          const __m512d max_index = _mm512_set1_pd(p.max_index);
+          const __m512d min_index = _mm512_set1_pd(p.min_index);
+          std::size_t i = 0;
+          __mmask8 positive = 0;
+          __mmask8 negative = 0;
+          for (; i + 8 <= n; i += 8)
+          {
+            __m512d y = _mm512_mul_pd(_mm512_loadu_pd(v + i), scale);
+            __m512d f;
+            if (Kind == round_negative) f = _mm512_roundscale_pd(y, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+            else if (Kind == round_truncated) f = _mm512_roundscale_pd(y, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+            else if (Kind == round_positive) f = _mm512_roundscale_pd(y, _MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC);
+            else if (Kind == round_even) f = _mm512_roundscale_pd(y, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+            else
+            {
+              __m512d fl = _mm512_roundscale_pd(y, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+              __m512d rest = _mm512_sub_pd(y, fl);
+              __mmask8 tie;
+              if (Kind == round_half_up) tie = _mm512_cmp_pd_mask(fl, zero, _CMP_GE_OQ);
+              else if (Kind == round_half_down) tie = _mm512_cmp_pd_mask(fl, zero, _CMP_LT_OQ);
+              else tie = _mm512_cmp_pd_mask(_mm512_mul_pd(fl, half),
+                  _mm512_roundscale_pd(_mm512_mul_pd(fl, half), _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC), _CMP_EQ_OQ);
+              __mmask8 up = _mm512_cmp_pd_mask(rest, half, _CMP_GT_OQ) | (_mm512_cmp_pd_mask(rest, half, _CMP_EQ_OQ) & tie);
+              f = _mm512_mask_add_pd(fl, up, fl, one);
+            }
+            __mmask8 gt = _mm512_cmp_pd_mask(f, max_index, _CMP_GT_OQ);
+            __mmask8 lt = _mm512_cmp_pd_mask(f, min_index, _CMP_LT_OQ);
+            if (!p.saturate && (gt | lt) != 0) break;
+            f = _mm512_mask_mov_pd(f, gt, max_index);
+            f = _mm512_mask_mov_pd(f, lt, min_index);
+            positive = positive | gt;
+            negative = negative | lt;
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(r + i), _mm512_cvtpd_epi32(f));
+          }
+          p.overflow = (positive != 0 ? unsigned(overflow::positive_overflow_flag) : 0u)
+              | (negative != 0 ? unsigned(overflow::negative_overflow_flag) : 0u);
+          return i;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // dispatch
+
+        template <bool Sub>
+        std::size_t add_widen(const boost::int32_t* a, const boost::int32_t* b, boost::int64_t* r, std::size_t n)
+        {
+          switch (active())
+          {
+          case avx512: return add_widen_avx512<Sub>(a, b, r, n);
+          case avx2: return add_widen_avx2<Sub>(a, b, r, n);
+          case sse4: return add_widen_sse4<Sub>(a, b, r, n);
+          default: return 0;
+          }
+        }
+        template <bool Sub>
+        std::size_t add(const boost::int32_t* a, const boost::int32_t* b, boost::int32_t* r, std::size_t n)
+        {
+          switch (active())
+          {
+          case avx512: return add_avx512<Sub>(a, b, r, n);
+          case avx2: return add_avx2<Sub>(a, b, r, n);
+          case sse4: return add_sse4<Sub>(a, b, r, n);
+          default: return 0;
+          }
+        }
+        inline std::size_t mul_widen(const boost::int32_t* a, const boost::int32_t* b, boost::int64_t* r, std::size_t n)
+        {
+          switch (active())
+          {
+          case avx512: return mul_widen_avx512(a, b, r, n);
+          case avx2: return mul_widen_avx2(a, b, r, n);
+          case sse4: return mul_widen_sse4(a, b, r, n);
+          default: return 0;
+          }
+        }
+        /**
+         * The 512 bits pmaddwd (_mm512_madd_epi16) needs AVX-512BW, which the avx512 level doesn't require, so the
+         * AVX2 kernel is used at this level.
+         */
+        inline std::size_t mac_int16(const boost::int16_t* a, const boost::int16_t* b, std::size_t n,
+            boost::int64_t& acc)
+        {
+          switch (active())
+          {
+          case avx512:
+          case avx2: return mac_int16_avx2(a, b, n, acc);
+          case sse4: return mac_int16_sse4(a, b, n, acc);
+          default: return 0;
+          }
+        }
+        template <int Kind>
+        std::size_t requantize(const boost::int64_t* v, boost::int32_t* r, std::size_t n, requantize_params& p)
+        {
+          switch (active())
+          {
+          case avx512: return requantize_avx512<Kind>(v, r, n, p);
+          case avx2: return requantize_avx2<Kind>(v, r, n, p);
+          case sse4: return requantize_sse4<Kind>(v, r, n, p);
+          default: return 0;
+          }
+        }
+        template <int Kind>
+        std::size_t convert(const double* v, boost::int32_t* r, std::size_t n, convert_params& p)
+        {
+          switch (active())
+          {
+          case avx512: return convert_avx512<Kind>(v, r, n, p);
+          case avx2: return convert_avx2<Kind>(v, r, n, p);
+          case sse4: return convert_sse4<Kind>(v, r, n, p);
+          default: return 0;
+          }
+        }
+      }
+#endif
+    }
+
+    namespace batch
+    {
+      namespace detail
+      {
+        //! Whether @c T is a @c real_t stored on an int32.
+        template <typename T>
+        struct is_int32
+        {
+          BOOST_STATIC_CONSTEXPR bool value = T::is_signed && sizeof(T) == 4
+              && sizeof(typename T::underlying_type) == 4;
+        };
+        //! Whether @c T is a @c real_t stored on an int64.
+        template <typename T>
+        struct is_int64
+        {
+          BOOST_STATIC_CONSTEXPR bool value = T::is_signed && sizeof(T) == 8
+              && sizeof(typename T::underlying_type) == 8;
+        };
+
+        //! The rounding kind of the kernels, or -1 when there is no kernel for @c RP.
+        template <typename RP>
+        struct round_kind
+        {
+          BOOST_STATIC_CONSTEXPR int value = -1;
+        };
+#if defined(BOOST_FIXED_POINT_SIMD_X86)
+        template <>
+        struct round_kind<round::negative>
+        {
+          BOOST_STATIC_CONSTEXPR int value = simd::detail::round_negative;
+        };
+        template <>
+        struct round_kind<round::truncated>
+        {
+          BOOST_STATIC_CONSTEXPR int value = simd::detail::round_truncated;
+        };
+        template <>
+        struct round_kind<round::positive>
+        {
+          BOOST_STATIC_CONSTEXPR int value = simd::detail::round_positive;
+        };
+        template <>
+        struct round_kind<round::nearest_half_up>
+        {
+          BOOST_STATIC_CONSTEXPR int value = simd::detail::round_half_up;
+        };
+        template <>
+        struct round_kind<round::nearest_half_down>
+        {
+          BOOST_STATIC_CONSTEXPR int value = simd::detail::round_half_down;
+        };
+        template <>
+        struct round_kind<round::nearest_even>
+        {
+          BOOST_STATIC_CONSTEXPR int value = simd::detail::round_even;
+        };
+        template <>
+        struct round_kind<round::nearest_odd>
+        {
+          BOOST_STATIC_CONSTEXPR int value = simd::detail::round_odd;
+        };
+#endif
+
+        //! Whether the overflow policy @c OP saturates, so that the kernels can saturate instead of stopping.
+        template <typename OP>
+        struct saturates
+        {
+          BOOST_STATIC_CONSTEXPR bool value = false;
+        };
+        template <>
+        struct saturates<overflow::saturate>
+        {
+          BOOST_STATIC_CONSTEXPR bool value = true;
+        };
+        template <>
+        struct saturates<overflow::sticky<overflow::saturate> >
+        {
+          BOOST_STATIC_CONSTEXPR bool value = true;
+        };
+
+        //! Records the overflows saturated by a kernel when @c OP is a sticky policy.
+        template <typename OP>
+        struct record_overflow
+        {
+          static void apply(unsigned)
+          {
+          }
+        };
+        template <typename Handling>
+        struct record_overflow<overflow::sticky<Handling> >
+        {
+          static void apply(unsigned flags)
+          {
+            overflow::detail::sticky_word() |= flags;
+          }
+        };
+
+        /**
+         * add_kernel<Sub, T, RT>::apply computes with SIMD instructions the longest prefix it can of
+         * <c>lhs[i] + rhs[i]</c> (<c>lhs[i] - rhs[i]</c> if @c Sub), and returns its length.
+         */
+        template <bool Sub, typename T, typename RT,
+            int Kind = (T::resolution_exp != RT::resolution_exp || !is_int32<T>::value) ? 0
+              : is_int32<RT>::value ? 1 : is_int64<RT>::value ? 2 : 0>
+        struct add_kernel
+        {
+          static std::size_t apply(T const*, T const*, RT*, std::size_t)
+          {
+            return 0;
+          }
+        };
+#if defined(BOOST_FIXED_POINT_SIMD_X86)
+        template <bool Sub, typename T, typename RT>
+        struct add_kernel<Sub, T, RT, 1>
+        {
+          static std::size_t apply(T const* lhs, T const* rhs, RT* res, std::size_t n)
+          {
+            return simd::detail::add<Sub>(reinterpret_cast<const boost::int32_t*>(lhs),
+                reinterpret_cast<const boost::int32_t*>(rhs), reinterpret_cast<boost::int32_t*>(res), n);
+          }
+        };
+        template <bool Sub, typename T, typename RT>
+        struct add_kernel<Sub, T, RT, 2>
+        {
+          static std::size_t apply(T const* lhs, T const* rhs, RT* res, std::size_t n)
+          {
+            return simd::detail::add_widen<Sub>(reinterpret_cast<const boost::int32_t*>(lhs),
+                reinterpret_cast<const boost::int32_t*>(rhs), reinterpret_cast<boost::int64_t*>(res), n);
+          }
+        };
+#endif
+
+        /**
+         * multiply_kernel<T, RT>::apply computes with SIMD instructions the longest prefix it can of
+         * <c>lhs[i] * rhs[i]</c>, and returns its length.
+         */
+        template <typename T, typename RT, bool Enabled = is_int32<T>::value && is_int64<RT>::value>
+        struct multiply_kernel
+        {
+          static std::size_t apply(T const*, T const*, RT*, std::size_t)
+          {
+            return 0;
+          }
+        };
+#if defined(BOOST_FIXED_POINT_SIMD_X86)
+        template <typename T, typename RT>
+        struct multiply_kernel<T, RT, true>
+        {
+          static std::size_t apply(T const* lhs, T const* rhs, RT* res, std::size_t n)
+          {
+            return simd::detail::mul_widen(reinterpret_cast<const boost::int32_t*>(lhs),
+                reinterpret_cast<const boost::int32_t*>(rhs), reinterpret_cast<boost::int64_t*>(res), n);
+          }
+        };
+#endif
+
+        /**
+         * number_cast_kernel<From, To, Saturate>::apply computes with SIMD instructions the longest prefix it can
+         * of <c>number_cast<To>(from[i])</c>, and returns its length. Unless @c Saturate or the overflow policy of
+         * @c To saturates, it stops before the first vector containing an overflow, so that the overflow policy of @c To
+         * is applied by the scalar code.
+         */
+        template <typename From, typename To, bool Saturate,
+            bool Enabled = is_int64<From>::value && is_int32<To>::value
+              && (To::resolution_exp > From::resolution_exp) && (To::resolution_exp - From::resolution_exp < 32)
+              && (round_kind<typename To::rounding_type>::value >= 0)>
+        struct number_cast_kernel
+        {
+          BOOST_STATIC_CONSTEXPR bool enabled = false;
+          static std::size_t apply(From const*, To*, std::size_t)
+          {
+            return 0;
+          }
+        };
+#if defined(BOOST_FIXED_POINT_SIMD_X86)
+        template <typename From, typename To, bool Saturate>
+        struct number_cast_kernel<From, To, Saturate, true>
+        {
+          BOOST_STATIC_CONSTEXPR bool enabled = true;
+          static std::size_t apply(From const* from, To* to, std::size_t n)
+          {
+            simd::detail::requantize_params p;
+            p.d = To::resolution_exp - From::resolution_exp;
+            p.max_shifted = boost::int64_t(To::max_index) << p.d;
+            p.min_shifted = boost::int64_t(To::min_index) * (boost::int64_t(1) << p.d);
+            p.max_index = To::max_index;
+            p.min_index = To::min_index;
+            p.saturate = Saturate || saturates<typename To::overflow_type>::value;
+            p.overflow = overflow::no_overflow;
+            std::size_t res = simd::detail::requantize<round_kind<typename To::rounding_type>::value>(
+                reinterpret_cast<const boost::int64_t*>(from), reinterpret_cast<boost::int32_t*>(to), n, p);
+            if (!Saturate) record_overflow<typename To::overflow_type>::apply(p.overflow);
+            return res;
+          }
+        };
+#endif
+
+        /**
+         * convert_kernel<From, To, Saturate>::apply computes with SIMD instructions the longest prefix it can of
+         * <c>To(from[i])</c>, where @c From is a floating point type, and returns its length. Unless @c Saturate or
+         * the overflow policy of @c To saturates, it stops before the first vector containing an overflow.
+         */
+        template <typename From, typename To, bool Saturate,
+            bool Enabled = is_same<From, double>::value && is_int32<To>::value
+              && (round_kind<typename To::rounding_type>::value >= 0)>
+        struct convert_kernel
+        {
+          BOOST_STATIC_CONSTEXPR bool enabled = false;
+          static std::size_t apply(From const*, To*, std::size_t)
+          {
+            return 0;
+          }
+        };
+#if defined(BOOST_FIXED_POINT_SIMD_X86)
+        template <typename From, typename To, bool Saturate>
+        struct convert_kernel<From, To, Saturate, true>
+        {
+          BOOST_STATIC_CONSTEXPR bool enabled = true;
+          static std::size_t apply(From const* from, To* to, std::size_t n)
+          {
+            simd::detail::convert_params p;
+            p.scale = To::template inverse_factor<double>();
+            p.max_index = To::max_index;
+            p.min_index = To::min_index;
+            p.saturate = Saturate || saturates<typename To::overflow_type>::value;
+            p.overflow = overflow::no_overflow;
+            std::size_t res = simd::detail::convert<round_kind<typename To::rounding_type>::value>(from,
+                reinterpret_cast<boost::int32_t*>(to), n, p);
+            if (!Saturate) record_overflow<typename To::overflow_type>::apply(p.overflow);
+            return res;
+          }
+        };
+#endif
+
+        //! The kernel converting arrays of @c From, which is either a fixed point or a floating point type.
+        template <typename From, typename To, bool Saturate, bool IsFloat = is_floating_point<From>::value>
+        struct cast_kernel : number_cast_kernel<From, To, Saturate>
+        {
+        };
+        template <typename From, typename To, bool Saturate>
+        struct cast_kernel<From, To, Saturate, true> : convert_kernel<From, To, Saturate>
+        {
+        };
+
+        //! The type of <c>T() - T()</c>, which is signed even if @c T is unsigned.
+        template <typename T>
+        struct subtract_result
+        {
+          typedef typename add_result<T>::type type;
+        };
+        template <int R, int P, typename RP, typename OP, typename F>
+        struct subtract_result<ureal_t<R, P, RP, OP, F> >
+        {
+          typedef typename add_result<real_t<R, P, RP, OP, F> >::type type;
+        };
+
+        //! The same fixed point type with the overflow::saturate policy.
+        template <typename T>
+        struct saturating;
+        template <int R, int P, typename RP, typename OP, typename F>
+        struct saturating<real_t<R, P, RP, OP, F> >
+        {
+          typedef real_t<R, P, RP, overflow::saturate, F> type;
+        };
+        template <int R, int P, typename RP, typename OP, typename F>
+        struct saturating<ureal_t<R, P, RP, OP, F> >
+        {
+          typedef ureal_t<R, P, RP, overflow::saturate, F> type;
+        };
+
+        template <typename To, typename From>
+        To cast(From const& from, false_type)
+        {
+          return fixed_point::number_cast<To>(from);
+        }
+        template <typename To, typename From>
+        To cast(From const& from, true_type)
+        {
+          return To(from);
+        }
+
+        template <typename To, bool Saturate>
+        struct scalar_cast
+        {
+          template <typename From>
+          static To apply(From const& from)
+          {
+            return cast<To>(from, is_floating_point<From>());
+          }
+        };
+        template <typename To>
+        struct scalar_cast<To, true>
+        {
+          template <typename From>
+          static To apply(From const& from)
+          {
+            return To(index(cast<typename saturating<To>::type>(from, is_floating_point<From>()).count()));
+          }
+        };
+
+        template <typename To, typename From, bool Saturate>
+        void number_cast(From const* from, To* to, std::size_t n)
+        {
+          typedef cast_kernel<From, To, Saturate> kernel;
+          // after a kernel stops, this number of elements, which is at least the length of the longest vector, is
+          // processed by the scalar code.
+          const std::size_t scalar_run = 16;
+          std::size_t i = 0;
+          while (i < n)
+          {
+            if (kernel::enabled) i += kernel::apply(from + i, to + i, n - i);
+            std::size_t end = kernel::enabled ? ((n - i < scalar_run) ? n : i + scalar_run) : n;
+            for (; i < end; ++i)
+              to[i] = scalar_cast<To, Saturate>::apply(from[i]);
+          }
+        }
+      }
+
+      /**
+       * @Requires @c res, @c lhs and @c rhs point to @c n elements.
+       * @Effects <c>res[i] = lhs[i] + rhs[i]</c> for every @c i in <c>[0, n)</c>.
+       */
+      template <typename T>
+      void add(T const* lhs, T const* rhs, typename add_result<T>::type* res, std::size_t n)
+      {
+        typedef typename add_result<T>::type RT;
+        std::size_t i = detail::add_kernel<false, T, RT>::apply(lhs, rhs, res, n);
+        for (; i < n; ++i)
+          res[i] = lhs[i] + rhs[i];
+      }
+
+      /**
+       * @Requires @c res, @c lhs and @c rhs point to @c n elements.
+       * @Effects <c>res[i] = lhs[i] - rhs[i]</c> for every @c i in <c>[0, n)</c>.
+       */
+      template <typename T>
+      void subtract(T const* lhs, T const* rhs, typename detail::subtract_result<T>::type* res, std::size_t n)
+      {
+        typedef typename detail::subtract_result<T>::type RT;
+        std::size_t i = detail::add_kernel<true, T, RT>::apply(lhs, rhs, res, n);
+        for (; i < n; ++i)
+          res[i] = lhs[i] - rhs[i];
+      }
+
+      /**
+       * @Requires @c res, @c lhs and @c rhs point to @c n elements.
+       * @Effects <c>res[i] = lhs[i] * rhs[i]</c> for every @c i in <c>[0, n)</c>.
+       */
+      template <typename T>
+      void multiply(T const* lhs, T const* rhs, typename multiply_result<T>::type* res, std::size_t n)
+      {
+        typedef typename multiply_result<T>::type RT;
+        std::size_t i = detail::multiply_kernel<T, RT>::apply(lhs, rhs, res, n);
+        for (; i < n; ++i)
+          res[i] = lhs[i] * rhs[i];
+      }
+
+      /**
+       * @Requires @c from and @c to point to @c n elements.
+       * @Effects <c>to[i] = number_cast<To>(from[i])</c> for every @c i in <c>[0, n)</c>, applying the rounding and
+       * the overflow policies of @c To. When @c From is a floating point type, <c>to[i] = To(from[i])</c>.
+       */
+      template <typename To, typename From>
+      void number_cast(From const* from, To* to, std::size_t n)
+      {
+        detail::number_cast<To, From, false>(from, to, n);
+      }
+
+      /**
+       * @Requires @c from and @c to point to @c n elements.
+       * @Effects <c>to[i] = number_cast<To>(from[i])</c> for every @c i in <c>[0, n)</c>, applying the rounding
+       * policy of @c To, but saturating the values out of the range of @c To whatever the overflow policy of @c To.
+       */
+      template <typename To, typename From>
+      void saturate(From const* from, To* to, std::size_t n)
+      {
+        detail::number_cast<To, From, true>(from, to, n);
+      }
+    }
+  }
+}
+
+#endif // header
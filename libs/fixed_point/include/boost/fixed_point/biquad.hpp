@@ -0,0 +1,315 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Vicente J. Botet Escriba 2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/fixed_point for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file
+ * @brief Defines cascades of second order infinite impulse response sections, biquads, in direct form I, with an
+ * optional noise shaping error feedback, and in transposed direct form II.
+ *
+ * The sums of products are exact, computed on an accumulator, and are quantized to the state type with its rounding
+ * and overflow policies, by default to nearest even and saturating, as a wrapping overflow makes a recursive filter
+ * oscillate.
+ */
+
+#ifndef BOOST_FIXED_POINT_BIQUAD_HPP
+#define BOOST_FIXED_POINT_BIQUAD_HPP
+
+#include <boost/fixed_point/number.hpp>
+#include <boost/fixed_point/accumulator.hpp>
+#include <boost/assert.hpp>
+#include <boost/static_assert.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace boost
+{
+  namespace fixed_point
+  {
+    namespace iir
+    {
+      /**
+       * Direct form I: the last two inputs and outputs of each section are kept, and the output is the only
+       * quantization. @c Order, 0, 1 or 2, is the order of the error feedback: the quantization error of the @c Order
+       * last outputs is added back to the next sum, so that the quantization noise is shaped by <c>(1 - z^-1)^Order</c>
+       * and moved away from the low frequencies, where the poles of a low-pass filter amplify it.
+       */
+      template <int Order = 0>
+      struct direct_form_1
+      {
+        BOOST_STATIC_ASSERT_MSG(Order >= 0 && Order <= 2, "The order of the error feedback must be 0, 1 or 2");
+      };
+
+      /**
+       * Transposed direct form II: each section keeps two states, which are quantized as the output.
+       */
+      struct transposed_direct_form_2
+      {
+      };
+
+      /**
+       * The default state of a filter of samples @c Sample: the same range and resolution, rounded to nearest even and
+       * saturating.
+       */
+      template <typename Sample>
+      struct default_state
+      {
+      };
+#if ! defined(BOOST_FIXED_POINT_DOXYGEN_INVOKED)
+      template <int R, int P, typename RP, typename OP, typename F>
+      struct default_state<real_t<R,P,RP,OP,F> >
+      {
+        typedef real_t<R, P, round::nearest_even, overflow::saturate, F> type;
+      };
+#endif
+    }
+
+    /**
+     * The coefficients of a biquad, <c>y[n] = b0 * x[n] + b1 * x[n-1] + b2 * x[n-2] - a1 * y[n-1] - a2 * y[n-2]</c>,
+     * normalized so that a0 is 1.
+     */
+    template <typename Coefficient>
+    struct biquad_coefficients
+    {
+      Coefficient b0, b1, b2, a1, a2;
+    };
+
+    namespace detail
+    {
+      //! The types of the sums of products of a section.
+      template <typename Coefficient, typename State>
+      struct biquad_types
+      {
+        //! The coefficients with the policies of the states, as the operands of a product share its policies.
+        typedef real_t<Coefficient::range_exp, Coefficient::resolution_exp, typename State::rounding_type,
+            typename State::overflow_type, typename State::family_type> coefficient_type;
+        typedef biquad_coefficients<coefficient_type> coefficients_type;
+        typedef typename multiply_result<coefficient_type, State>::type product_type;
+        //! The sum of at most 8 products.
+        typedef accumulator<product_type, 3> accumulator_type;
+        typedef typename accumulator_type::value_type value_type;
+        typedef typename accumulator_type::underlying_type underlying_type;
+        BOOST_STATIC_CONSTEXPR int shift = State::resolution_exp - product_type::resolution_exp;
+      };
+
+      template <typename Form, typename Coefficient, typename State>
+      class biquad_section;
+
+      /**
+       * Direct form I section, with an error feedback of order @c Order.
+       */
+      template <int Order, typename Coefficient, typename State>
+      class biquad_section<iir::direct_form_1<Order>, Coefficient, State>
+      {
+        typedef biquad_types<Coefficient, State> types;
+        typedef typename types::accumulator_type accumulator_type;
+        typedef typename types::value_type value_type;
+        typedef typename types::underlying_type underlying_type;
+      public:
+        explicit biquad_section(biquad_coefficients<Coefficient> const& c)
+        {
+          c_.b0 = c.b0;
+          c_.b1 = c.b1;
+          c_.b2 = c.b2;
+          c_.a1 = c.a1;
+          c_.a2 = c.a2;
+          reset();
+        }
+
+        void reset()
+        {
+          x1_ = x2_ = y1_ = y2_ = State(index(0));
+          e1_ = e2_ = 0;
+        }
+
+        //! Filters the block @c v of @c n values in place.
+        void process(State* v, std::size_t n)
+        {
+          const underlying_type unit = underlying_type(1) << types::shift;
+          for (std::size_t i = 0; i < n; ++i)
+          {
+            State x = v[i];
+            accumulator_type acc(c_.b0 * x);
+            acc += c_.b1 * x1_;
+            acc += c_.b2 * x2_;
+            acc -= c_.a1 * y1_;
+            acc -= c_.a2 * y2_;
+            underlying_type s = acc.count();
+            if (Order == 1)
+              s += e1_;
+            else if (Order == 2)
+              s += 2 * e1_ - e2_;
+            State y = fixed_point::number_cast<State>(value_type(index(s)));
+            if (Order > 0)
+            {
+              // the error of a saturated output is not fed back
+              underlying_type e = s - underlying_type(y.count()) * unit;
+              e2_ = e1_;
+              e1_ = (e < unit && e > -unit) ? e : underlying_type(0);
+            }
+            x2_ = x1_;
+            x1_ = x;
+            y2_ = y1_;
+            y1_ = y;
+            v[i] = y;
+          }
+        }
+
+      private:
+        typename types::coefficients_type c_;
+        State x1_, x2_, y1_, y2_;
+        //! The last quantization errors, at the resolution of the products.
+        underlying_type e1_, e2_;
+      };
+
+      /**
+       * Transposed direct form II section.
+       */
+      template <typename Coefficient, typename State>
+      class biquad_section<iir::transposed_direct_form_2, Coefficient, State>
+      {
+        typedef biquad_types<Coefficient, State> types;
+        typedef typename types::accumulator_type accumulator_type;
+      public:
+        explicit biquad_section(biquad_coefficients<Coefficient> const& c)
+        {
+          c_.b0 = c.b0;
+          c_.b1 = c.b1;
+          c_.b2 = c.b2;
+          c_.a1 = c.a1;
+          c_.a2 = c.a2;
+          reset();
+        }
+
+        void reset()
+        {
+          s1_ = s2_ = State(index(0));
+        }
+
+        //! Filters the block @c v of @c n values in place.
+        void process(State* v, std::size_t n)
+        {
+          for (std::size_t i = 0; i < n; ++i)
+          {
+            State x = v[i];
+            accumulator_type acc(c_.b0 * x);
+            acc += s1_;
+            State y = acc.template get<State>();
+            accumulator_type acc1(c_.b1 * x);
+            acc1 -= c_.a1 * y;
+            acc1 += s2_;
+            s1_ = acc1.template get<State>();
+            accumulator_type acc2(c_.b2 * x);
+            acc2 -= c_.a2 * y;
+            s2_ = acc2.template get<State>();
+            v[i] = y;
+          }
+        }
+
+      private:
+        typename types::coefficients_type c_;
+        State s1_, s2_;
+      };
+    }
+
+    /**
+     * @brief Cascade of biquads.
+     *
+     * The samples are converted exactly to @c State, filtered by each section in turn, and the outputs are converted
+     * to @c Sample with its rounding and overflow policies. Each section quantizes its outputs, and its states in
+     * transposed direct form II, to @c State with its rounding and overflow policies.
+     *
+     * @TParams
+     * @Param{Sample,the type of the input and output samples}
+     * @Param{Coefficient,the type of the coefficients, with one integral bit at least as a1 can be up to 2}
+     * @Param{State,the type of the states, including the range and the resolution of @c Sample}
+     * @Param{Form,@c iir::direct_form_1<Order> or @c iir::transposed_direct_form_2}
+     *
+     * @Example
+     * @code
+     * biquad_coefficients<real_t<1,-30> > c[2] = ...;
+     * biquad_cascade<real_t<0,-15>, real_t<1,-30>, real_t<3,-28> > f(c, 2);
+     * f.process(in, out, n);
+     * @endcode
+     */
+    template <typename Sample, typename Coefficient, typename State = typename iir::default_state<Sample>::type,
+        typename Form = iir::direct_form_1<> >
+    class biquad_cascade
+    {
+      BOOST_STATIC_ASSERT_MSG((State::range_exp >= Sample::range_exp
+          && State::resolution_exp <= Sample::resolution_exp),
+          "The state type must include the range and the resolution of the samples");
+      BOOST_STATIC_ASSERT_MSG((Coefficient::range_exp >= 1), "The coefficients need one integral bit at least");
+      typedef detail::biquad_section<Form, Coefficient, State> section_type;
+    public:
+      typedef Sample sample_type;
+      typedef Coefficient coefficient_type;
+      typedef State state_type;
+
+      /**
+       * @Requires @c c points to @c sections coefficients.
+       * @Effects constructs a cascade of @c sections biquads, with null states.
+       */
+      biquad_cascade(biquad_coefficients<Coefficient> const* c, std::size_t sections)
+      {
+        sections_.reserve(sections);
+        for (std::size_t i = 0; i < sections; ++i)
+          sections_.push_back(section_type(c[i]));
+      }
+
+      //! @Returns the number of sections.
+      std::size_t sections() const
+      {
+        return sections_.size();
+      }
+
+      //! @Effects resets the states of all the sections to 0.
+      void reset()
+      {
+        for (std::size_t i = 0; i < sections_.size(); ++i)
+          sections_[i].reset();
+      }
+
+      /**
+       * @Effects filters the sample @c x.
+       * @Returns the output of @c x.
+       */
+      Sample operator()(Sample const& x)
+      {
+        State v = x;
+        for (std::size_t i = 0; i < sections_.size(); ++i)
+          sections_[i].process(&v, 1);
+        return number_cast<Sample>(v);
+      }
+
+      /**
+       * @Requires @c in and @c out point to @c n samples.
+       * @Effects filters the block of samples @c in, storing the outputs in @c out. Each section processes the whole
+       * block before the next one.
+       */
+      void process(Sample const* in, Sample* out, std::size_t n)
+      {
+        work_.resize(n, State(index(0)));
+        for (std::size_t i = 0; i < n; ++i)
+          work_[i] = in[i];
+        if (n > 0)
+          for (std::size_t i = 0; i < sections_.size(); ++i)
+            sections_[i].process(&work_[0], n);
+        for (std::size_t i = 0; i < n; ++i)
+          out[i] = number_cast<Sample>(work_[i]);
+      }
+
+    private:
+      std::vector<section_type> sections_;
+      std::vector<State> work_;
+    };
+  }
+}
+
+#endif // header
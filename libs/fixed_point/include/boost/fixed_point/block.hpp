@@ -0,0 +1,447 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Vicente J. Botet Escriba 2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/fixed_point for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file
+ * @brief Defines block floating point arrays: fixed point mantissas sharing a single exponent.
+ *
+ * A @c block_real_t<N,Digits> stores @c N mantissas of @c Digits digits, on an int16 for up to 15 digits, and one
+ * exponent, so that the numbers have the footprint of their mantissas and the dynamic range of the exponent. The
+ * element @c i is <c>mantissa(i) * 2^(exponent() - Digits)</c>, and its absolute value is less than
+ * <c>2^exponent()</c>.
+ *
+ * The sums and products are computed exactly on a wider integer and rounded once to the normalized result, whose
+ * greatest mantissa has @c Digits digits.
+ */
+
+#ifndef BOOST_FIXED_POINT_BLOCK_HPP
+#define BOOST_FIXED_POINT_BLOCK_HPP
+
+#include <boost/fixed_point/number.hpp>
+#include <boost/fixed_point/dynamic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/integer_traits.hpp>
+#include <boost/mpl/if.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/make_unsigned.hpp>
+#include <cmath>
+#include <cstddef>
+
+namespace boost
+{
+  namespace fixed_point
+  {
+    /**
+     * @brief Block floating point array of @c N numbers sharing one exponent.
+     *
+     * @TParams
+     * @Param{N,the number of elements}
+     * @Param{Digits,the digits of the mantissas, from 2 to 30}
+     * @Param{Rounding,the rounding policy of the mantissas}
+     *
+     * The arithmetic is closed: the sums and products of two blocks are blocks of the same type. The default
+     * constructor leaves the mantissas and the exponent uninitialized, as for @c real_t.
+     *
+     * @Example
+     * @code
+     * block_real_t<64> a, b;
+     * batch::number_cast(&samples[0], a);          // from 64 real_t
+     * block_real_t<64> c = a * b;
+     * batch::number_cast(c, &out[0]);              // to 64 real_t
+     * @endcode
+     */
+    template <std::size_t N, int Digits = 15, typename Rounding = round::nearest_even>
+    class block_real_t
+    {
+      BOOST_STATIC_ASSERT_MSG(Digits >= 2 && Digits <= 30, "The mantissas have between 2 and 30 digits.");
+    public:
+      //! The type of the mantissas, whose absolute value is less than 1.
+      typedef real_t<0, -Digits, Rounding, overflow::saturate> mantissa_type;
+      typedef typename mantissa_type::underlying_type underlying_type;
+      typedef Rounding rounding_type;
+      typedef arithmetic::closed arithmetic_type;
+      //! The type of the elements.
+      typedef dynamic_real_t<Rounding, overflow::saturate> value_type;
+
+      BOOST_STATIC_CONSTEXPR std::size_t static_size = N;
+      BOOST_STATIC_CONSTEXPR int digits = Digits;
+      BOOST_STATIC_CONSTEXPR underlying_type max_index = mantissa_type::max_index;
+
+      block_real_t()
+      {
+      }
+
+      //! @Effects constructs @c N zeros of exponent @c e.
+      explicit block_real_t(int e) :
+        exponent_(e)
+      {
+        for (std::size_t i = 0; i < N; ++i)
+          mantissas_[i] = 0;
+      }
+
+      //! @Returns @c N.
+      static std::size_t size()
+      {
+        return N;
+      }
+
+      //! @Returns the shared exponent.
+      int exponent() const
+      {
+        return exponent_;
+      }
+
+      //! @Returns the mantissa of the element @c i.
+      mantissa_type mantissa(std::size_t i) const
+      {
+        return mantissa_type(index(mantissas_[i]));
+      }
+
+      //! @Returns the element @c i, in the format of range @c exponent() and of @c Digits digits.
+      value_type operator[](std::size_t i) const
+      {
+        return value_type(index(mantissas_[i]), format(exponent_, exponent_ - Digits));
+      }
+
+      //! @Returns the element @c i as a double.
+      double as_double(std::size_t i) const
+      {
+        return std::ldexp(double(mantissas_[i]), exponent_ - Digits);
+      }
+
+      //! @Returns the underlying integers of the mantissas.
+      underlying_type const* data() const
+      {
+        return mantissas_;
+      }
+
+      //! @Returns the underlying integers of the mantissas, to be set together with the exponent.
+      underlying_type* data()
+      {
+        return mantissas_;
+      }
+
+      //! @Effects sets the shared exponent, without changing the mantissas.
+      void set_exponent(int e)
+      {
+        exponent_ = e;
+      }
+
+      /**
+       * @Effects shifts the mantissas left and decreases the exponent, so that the greatest mantissa has @c Digits
+       * digits. The values are not changed. A block of zeros keeps its exponent.
+       */
+      void normalize();
+
+    private:
+      underlying_type mantissas_[N];
+      int exponent_;
+    };
+
+#if ! defined(BOOST_FIXED_POINT_DOXYGEN_INVOKED)
+    namespace detail
+    {
+      //! The number of significant bits of the non negative @c m.
+      template <typename W>
+      int block_bits(W m)
+      {
+        int res = 0;
+        for (; m != 0; m >>= 1)
+          ++res;
+        return res;
+      }
+
+      /**
+       * Rounds the @c n exact values <c>values(i)</c> of resolution <c>2^resolution</c> to the mantissas @c m of the
+       * normalized block, and returns its exponent. @c m can be the array the values are computed from.
+       *
+       * The first pass finds the least and greatest values, and the second one shifts all of them by the same number
+       * of bits. As the rounding is monotonic, the shift is increased by one bit beforehand when the rounding of
+       * the least or greatest value reaches <c>2^Digits</c>.
+       */
+      template <typename RP, int Digits, typename W, typename Values, typename M>
+      int block_normalize(Values const& values, std::size_t n, int resolution, M* m)
+      {
+        typedef typename make_unsigned<W>::type unsigned_type;
+        const W max_index = (W(1) << Digits) - 1;
+        W least = 0, greatest = 0;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+          W v = values(i);
+          least = v < least ? v : least;
+          greatest = v > greatest ? v : greatest;
+        }
+        if (least == 0 && greatest == 0)
+        {
+          for (std::size_t i = 0; i < n; ++i)
+            m[i] = 0;
+          return resolution + Digits;
+        }
+        int s = block_bits(greatest > -least ? greatest : -least) - Digits;
+        if (s <= 0)
+        {
+          for (std::size_t i = 0; i < n; ++i)
+            m[i] = M(W(unsigned_type(values(i)) << -s));
+          return resolution + s + Digits;
+        }
+        if (dynamic_round<RP>::apply(greatest, s) > max_index || dynamic_round<RP>::apply(least, s) < -max_index)
+          ++s;
+        for (std::size_t i = 0; i < n; ++i)
+          m[i] = M(dynamic_round<RP>::apply(values(i), s));
+        return resolution + s + Digits;
+      }
+
+      //! The mantissas of a block.
+      template <typename W, typename M>
+      struct block_values
+      {
+        M const* m;
+        W operator()(std::size_t i) const
+        {
+          return W(m[i]);
+        }
+      };
+
+      //! The indexes of an array of numbers.
+      template <typename From>
+      struct block_counts
+      {
+        From const* f;
+        boost::intmax_t operator()(std::size_t i) const
+        {
+          return boost::intmax_t(f[i].count());
+        }
+      };
+
+      /**
+       * The sums or differences of two blocks, the mantissas of @c a shifted left by @c s bits: <c>a - b</c>, or
+       * <c>b - a</c> when @c Reversed.
+       */
+      template <typename W, typename M, bool Subtract, bool Reversed = false>
+      struct block_sums
+      {
+        typedef typename make_unsigned<W>::type unsigned_type;
+        M const* a;
+        M const* b;
+        int s;
+        W operator()(std::size_t i) const
+        {
+          W x = W(unsigned_type(W(a[i])) << s);
+          return Subtract ? (Reversed ? W(b[i]) - x : x - W(b[i])) : x + W(b[i]);
+        }
+      };
+
+      /**
+       * The sums of two blocks whose exponents differ by more than the bits of the integers: the mantissas of @c b
+       * are shifted right by @c far bits beyond @c s, with the sticky bit of dynamic_sticky_shift.
+       */
+      template <typename M, bool Subtract, bool Reversed = false>
+      struct block_far_sums
+      {
+        M const* a;
+        M const* b;
+        int s;
+        int far;
+        boost::intmax_t operator()(std::size_t i) const
+        {
+          int k = far + integer_traits<boost::intmax_t>::digits - 1;
+          boost::intmax_t y = dynamic_sticky_shift(boost::intmax_t(b[i]), k);
+          boost::intmax_t x = boost::intmax_t(boost::uintmax_t(a[i]) << s);
+          return Subtract ? (Reversed ? y - x : x - y) : x + y;
+        }
+      };
+
+      //! The products of two blocks.
+      template <typename W, typename M>
+      struct block_products
+      {
+        M const* a;
+        M const* b;
+        W operator()(std::size_t i) const
+        {
+          return W(a[i]) * W(b[i]);
+        }
+      };
+
+      //! The integer of the exact sums: an int32 when they have at most 31 bits.
+      template <int Bits>
+      struct block_wide
+      {
+        typedef typename mpl::if_c<(Bits <= 31), boost::int32_t, boost::intmax_t>::type type;
+      };
+
+      /**
+       * The sums <c>hi + lo</c>, or the differences <c>hi - lo</c> (<c>lo - hi</c> when @c Reversed), of two blocks,
+       * @c hi having the greater exponent. The differences are computed exactly in both orders and rounded once, as
+       * negating the rounded <c>hi - lo</c> would round the other way with the directed rounding policies.
+       */
+      template <bool Subtract, bool Reversed, std::size_t N, int D, typename RP>
+      void block_add_ordered(block_real_t<N, D, RP> const& hi, block_real_t<N, D, RP> const& lo,
+          block_real_t<N, D, RP>& r)
+      {
+        typedef typename block_real_t<N, D, RP>::underlying_type M;
+        // the mantissas of the block of greater exponent are shifted left by d bits
+        const int d = hi.exponent() - lo.exponent();
+        const int int32_shift = integer_traits<boost::int32_t>::digits - 1 - D;
+        const int intmax_shift = integer_traits<boost::intmax_t>::digits - 1 - D;
+        int e;
+        if (d <= int32_shift)
+        {
+          block_sums<boost::int32_t, M, Subtract, Reversed> v = { hi.data(), lo.data(), d };
+          e = block_normalize<RP, D, boost::int32_t>(v, N, lo.exponent() - D, r.data());
+        }
+        else if (d <= intmax_shift)
+        {
+          block_sums<boost::intmax_t, M, Subtract, Reversed> v = { hi.data(), lo.data(), d };
+          e = block_normalize<RP, D, boost::intmax_t>(v, N, lo.exponent() - D, r.data());
+        }
+        else
+        {
+          bool zero = true;
+          for (std::size_t i = 0; i < N; ++i)
+            zero &= hi.data()[i] == 0;
+          if (zero)
+          {
+            // lo is exact on D digits, so its opposite too
+            block_values<boost::intmax_t, M> v = { lo.data() };
+            e = block_normalize<RP, D, boost::intmax_t>(v, N, lo.exponent() - D, r.data());
+            if (Subtract && !Reversed)
+              for (std::size_t i = 0; i < N; ++i)
+                r.data()[i] = M(-r.data()[i]);
+          }
+          else
+          {
+            block_far_sums<M, Subtract, Reversed> v = { hi.data(), lo.data(), intmax_shift, d - intmax_shift };
+            e = block_normalize<RP, D, boost::intmax_t>(v, N, hi.exponent() - D - intmax_shift, r.data());
+          }
+        }
+        r.set_exponent(e);
+      }
+
+      template <bool Subtract, std::size_t N, int D, typename RP>
+      void block_add(block_real_t<N, D, RP> const& a, block_real_t<N, D, RP> const& b, block_real_t<N, D, RP>& r)
+      {
+        if (b.exponent() <= a.exponent())
+          block_add_ordered<Subtract, false>(a, b, r);
+        else if (Subtract)
+          block_add_ordered<true, true>(b, a, r);
+        else
+          block_add_ordered<false, false>(b, a, r);
+      }
+
+      template <std::size_t N, int D, typename RP>
+      void block_multiply(block_real_t<N, D, RP> const& a, block_real_t<N, D, RP> const& b,
+          block_real_t<N, D, RP>& r)
+      {
+        typedef typename block_real_t<N, D, RP>::underlying_type M;
+        typedef typename block_wide<2 * D + 1>::type wide_type;
+        block_products<wide_type, M> v = { a.data(), b.data() };
+        r.set_exponent(block_normalize<RP, D, wide_type>(v, N, a.exponent() + b.exponent() - 2 * D, r.data()));
+      }
+    }
+#endif
+
+    template <std::size_t N, int D, typename RP>
+    void block_real_t<N, D, RP>::normalize()
+    {
+      typedef typename detail::block_wide<D + 1>::type wide_type;
+      detail::block_values<wide_type, underlying_type> v = { mantissas_ };
+      exponent_ = detail::block_normalize<RP, D, wide_type>(v, N, exponent_ - D, mantissas_);
+    }
+
+    /**
+     * @Returns the normalized sums of the elements, rounded once from the exact sums.
+     */
+    template <std::size_t N, int D, typename RP>
+    block_real_t<N, D, RP> operator+(block_real_t<N, D, RP> const& lhs, block_real_t<N, D, RP> const& rhs)
+    {
+      block_real_t<N, D, RP> res;
+      detail::block_add<false>(lhs, rhs, res);
+      return res;
+    }
+
+    /**
+     * @Returns the normalized differences of the elements, rounded once from the exact differences.
+     */
+    template <std::size_t N, int D, typename RP>
+    block_real_t<N, D, RP> operator-(block_real_t<N, D, RP> const& lhs, block_real_t<N, D, RP> const& rhs)
+    {
+      block_real_t<N, D, RP> res;
+      detail::block_add<true>(lhs, rhs, res);
+      return res;
+    }
+
+    /**
+     * @Returns the normalized products of the elements, rounded once from the exact products.
+     */
+    template <std::size_t N, int D, typename RP>
+    block_real_t<N, D, RP> operator*(block_real_t<N, D, RP> const& lhs, block_real_t<N, D, RP> const& rhs)
+    {
+      block_real_t<N, D, RP> res;
+      detail::block_multiply(lhs, rhs, res);
+      return res;
+    }
+
+    namespace batch
+    {
+      /**
+       * @Effects <c>res[i] = lhs[i] + rhs[i]</c> for every block @c i in <c>[0, n)</c>.
+       */
+      template <std::size_t N, int D, typename RP>
+      void add(block_real_t<N, D, RP> const* lhs, block_real_t<N, D, RP> const* rhs, block_real_t<N, D, RP>* res,
+          std::size_t n)
+      {
+        for (std::size_t i = 0; i < n; ++i)
+          fixed_point::detail::block_add<false>(lhs[i], rhs[i], res[i]);
+      }
+
+      /**
+       * @Effects <c>res[i] = lhs[i] * rhs[i]</c> for every block @c i in <c>[0, n)</c>.
+       */
+      template <std::size_t N, int D, typename RP>
+      void multiply(block_real_t<N, D, RP> const* lhs, block_real_t<N, D, RP> const* rhs,
+          block_real_t<N, D, RP>* res, std::size_t n)
+      {
+        for (std::size_t i = 0; i < n; ++i)
+          fixed_point::detail::block_multiply(lhs[i], rhs[i], res[i]);
+      }
+
+      /**
+       * @TParams
+       * @Param{From,a @c real_t or @c ureal_t of at most 63 digits}
+       *
+       * @Effects converts the @c N numbers <c>from[i]</c> to the normalized block @c to, rounded with the rounding
+       * policy of the block.
+       */
+      template <typename From, std::size_t N, int D, typename RP>
+      void number_cast(From const* from, block_real_t<N, D, RP>& to)
+      {
+        fixed_point::detail::block_counts<From> v = { from };
+        to.set_exponent(fixed_point::detail::block_normalize<RP, D, boost::intmax_t>(v, N, From::resolution_exp,
+            to.data()));
+      }
+
+      /**
+       * @TParams
+       * @Param{To,a @c real_t or @c ureal_t}
+       *
+       * @Effects <c>to[i] = number_cast<To>(from[i])</c> for the @c N elements, with the rounding and overflow
+       * policies of @c To, as batch::from_dynamic does.
+       */
+      template <typename To, std::size_t N, int D, typename RP>
+      void number_cast(block_real_t<N, D, RP> const& from, To* to)
+      {
+        from_dynamic(from.data(), format(from.exponent(), from.exponent() - D), to, N);
+      }
+    }
+  }
+}
+
+#endif // header
@@ -0,0 +1,360 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Vicente J. Botet Escriba 2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/fixed_point for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file
+ * @brief Defines complex numbers of fixed point parts, with exact arithmetic, and batch kernels on arrays of complex
+ * numbers whose real and imaginary parts are stored in two arrays.
+ *
+ * The result types are given by specializations of @c add_result and @c multiply_result: the product of two complex
+ * numbers is <c>complex<add_result<multiply_result<T1,T2>::type>::type></c>, computed directly on the underlying
+ * integers of the result, without any intermediate number.
+ */
+
+#ifndef BOOST_FIXED_POINT_COMPLEX_HPP
+#define BOOST_FIXED_POINT_COMPLEX_HPP
+
+#include <boost/fixed_point/number.hpp>
+#include <boost/static_assert.hpp>
+#include <cstddef>
+
+namespace boost
+{
+  namespace fixed_point
+  {
+    /**
+     * @brief Complex number whose real and imaginary parts are fixed point numbers of type @c T.
+     *
+     * The default constructor leaves the parts uninitialized, as for @c real_t.
+     *
+     * @Requires @c T is signed, as the products and the conjugates subtract the parts.
+     */
+    template <typename T>
+    class complex
+    {
+      BOOST_STATIC_ASSERT_MSG(T::is_signed, "The parts of a complex number must be signed");
+    public:
+      typedef T value_type;
+      typedef typename T::arithmetic_type arithmetic_type;
+
+      complex()
+      {
+      }
+
+      //! @Effects constructs <c>re + 0 * i</c>.
+      complex(T const& re) :
+        re_(re), im_(index(0))
+      {
+      }
+
+      //! @Effects constructs <c>re + im * i</c>.
+      complex(T const& re, T const& im) :
+        re_(re), im_(im)
+      {
+      }
+
+      //! @Returns the real part.
+      T real() const
+      {
+        return re_;
+      }
+      //! @Effects sets the real part.
+      void real(T const& re)
+      {
+        re_ = re;
+      }
+      //! @Returns the imaginary part.
+      T imag() const
+      {
+        return im_;
+      }
+      //! @Effects sets the imaginary part.
+      void imag(T const& im)
+      {
+        im_ = im;
+      }
+
+      /**
+       * @Effects As if <c>number_cast<complex>(*this+rhs)</c>
+       * @Returns this instance.
+       */
+      complex& operator+=(complex const& rhs)
+      {
+        re_ += rhs.re_;
+        im_ += rhs.im_;
+        return *this;
+      }
+
+      /**
+       * @Effects As if <c>number_cast<complex>(*this-rhs)</c>
+       * @Returns this instance.
+       */
+      complex& operator-=(complex const& rhs)
+      {
+        re_ -= rhs.re_;
+        im_ -= rhs.im_;
+        return *this;
+      }
+
+      /**
+       * @Effects As if <c>number_cast<complex>(*this*rhs)</c>
+       * @Returns this instance.
+       * @Throws Any exception the Overflow policy can throw.
+       */
+      complex& operator*=(complex const& rhs);
+
+    private:
+      T re_, im_;
+    };
+
+#if ! defined(BOOST_FIXED_POINT_DOXYGEN_INVOKED)
+    template <typename T1, typename T2, bool B1, bool B2>
+    struct add_result<complex<T1>, complex<T2>, B1, B2>
+    {
+      typedef complex<typename add_result<T1, T2>::type> type;
+    };
+
+    template <typename T1, typename T2, bool B1, bool B2>
+    struct multiply_result<complex<T1>, complex<T2>, B1, B2>
+    {
+      typedef complex<typename add_result<typename multiply_result<T1, T2>::type>::type> type;
+    };
+#endif
+
+    /**
+     * Magnitude squared type metafunction: @c add_result of the square of the parts.
+     */
+    template <typename T>
+    struct norm_result
+    {
+      typedef typename add_result<typename multiply_result<T>::type>::type type;
+    };
+
+    namespace detail
+    {
+      /**
+       * number_cast of a complex number: each part is converted with the rounding and overflow policies of @c To.
+       */
+      template <typename From, typename To>
+      struct number_cast<complex<From>, complex<To>, false>
+      {
+        complex<To> operator()(complex<From> const& z) const
+        {
+          return complex<To>(number_cast<From, To>()(z.real()), number_cast<From, To>()(z.imag()));
+        }
+      };
+
+      //! The exact product of two parts, on the underlying integer @c W of the result.
+      template <typename W, typename T1, typename T2>
+      W complex_product(T1 const& a, T2 const& b)
+      {
+        return W(a.count()) * W(b.count());
+      }
+    }
+
+    /**
+     * @Returns the exact sum.
+     */
+    template <typename T1, typename T2>
+    typename add_result<complex<T1>, complex<T2> >::type
+    operator+(complex<T1> const& lhs, complex<T2> const& rhs)
+    {
+      return typename add_result<complex<T1>, complex<T2> >::type(lhs.real() + rhs.real(), lhs.imag() + rhs.imag());
+    }
+
+    /**
+     * @Returns the exact difference.
+     */
+    template <typename T1, typename T2>
+    typename add_result<complex<T1>, complex<T2> >::type
+    operator-(complex<T1> const& lhs, complex<T2> const& rhs)
+    {
+      return typename add_result<complex<T1>, complex<T2> >::type(lhs.real() - rhs.real(), lhs.imag() - rhs.imag());
+    }
+
+    /**
+     * @Returns the opposite, exact as the range of a signed @c real_t is symmetric.
+     */
+    template <typename T>
+    complex<T> operator-(complex<T> const& z)
+    {
+      return complex<T>(T(index(-z.real().count())), T(index(-z.imag().count())));
+    }
+
+    /**
+     * @Returns the exact product, computed with 4 multiplications.
+     */
+    template <typename T1, typename T2>
+    typename multiply_result<complex<T1>, complex<T2> >::type
+    operator*(complex<T1> const& lhs, complex<T2> const& rhs)
+    {
+      typedef typename multiply_result<complex<T1>, complex<T2> >::type result_type;
+      typedef typename result_type::value_type part_type;
+      typedef typename part_type::underlying_type W;
+      W re = detail::complex_product<W>(lhs.real(), rhs.real()) - detail::complex_product<W>(lhs.imag(), rhs.imag());
+      W im = detail::complex_product<W>(lhs.real(), rhs.imag()) + detail::complex_product<W>(lhs.imag(), rhs.real());
+      return result_type(part_type(index(re)), part_type(index(im)));
+    }
+
+    /**
+     * The product with 3 multiplications, the Gauss algorithm: with <c>lhs = a + b * i</c> and <c>rhs = c + d * i</c>,
+     * <c>k1 = c * (a + b)</c>, <c>k2 = a * (d - c)</c> and <c>k3 = b * (c + d)</c>, the product is
+     * <c>(k1 - k3) + (k1 + k2) * i</c>. The factors <c>a + b</c>, <c>d - c</c> and <c>c + d</c> have one more bit,
+     * so the products are computed on an integer one bit wider than the result. This pays off when the
+     * multiplications are more expensive than the additions, for wide parts.
+     *
+     * @Returns the exact product, as <c>lhs * rhs</c>.
+     */
+    template <typename T1, typename T2>
+    typename multiply_result<complex<T1>, complex<T2> >::type
+    multiply_gauss(complex<T1> const& lhs, complex<T2> const& rhs)
+    {
+      typedef typename multiply_result<complex<T1>, complex<T2> >::type result_type;
+      typedef typename result_type::value_type part_type;
+      typedef typename real_t<part_type::range_exp + 1, part_type::resolution_exp>::underlying_type W;
+      W a = lhs.real().count(), b = lhs.imag().count(), c = rhs.real().count(), d = rhs.imag().count();
+      W k1 = c * (a + b);
+      W k2 = a * (d - c);
+      W k3 = b * (c + d);
+      typedef typename part_type::underlying_type U;
+      return result_type(part_type(index(U(k1 - k3))), part_type(index(U(k1 + k2))));
+    }
+
+    /**
+     * @Returns the conjugate, exact as the range of a signed @c real_t is symmetric.
+     */
+    template <typename T>
+    complex<T> conj(complex<T> const& z)
+    {
+      return complex<T>(z.real(), T(index(-z.imag().count())));
+    }
+
+    /**
+     * @Returns the exact magnitude squared, <c>re^2 + im^2</c>.
+     */
+    template <typename T>
+    typename norm_result<T>::type
+    norm(complex<T> const& z)
+    {
+      typedef typename norm_result<T>::type result_type;
+      typedef typename result_type::underlying_type W;
+      return result_type(index(detail::complex_product<W>(z.real(), z.real())
+          + detail::complex_product<W>(z.imag(), z.imag())));
+    }
+
+    /**
+     * @Returns <c>lhs.real() == rhs.real() && lhs.imag() == rhs.imag()</c>.
+     */
+    template <typename T1, typename T2>
+    bool operator==(complex<T1> const& lhs, complex<T2> const& rhs)
+    {
+      return lhs.real() == rhs.real() && lhs.imag() == rhs.imag();
+    }
+
+    /**
+     * @Returns <c>!(lhs == rhs)</c>.
+     */
+    template <typename T1, typename T2>
+    bool operator!=(complex<T1> const& lhs, complex<T2> const& rhs)
+    {
+      return !(lhs == rhs);
+    }
+
+    template <typename T>
+    complex<T>& complex<T>::operator*=(complex const& rhs)
+    {
+      *this = number_cast<complex>((*this) * rhs);
+      return *this;
+    }
+
+    namespace batch
+    {
+      /**
+       * @Requires the real parts @c ar, @c br, @c cr and the imaginary parts @c ai, @c bi, @c ci point to @c n
+       * elements.
+       * @Effects <c>c[i] = a[i] * b[i]</c> for every @c i in <c>[0, n)</c>, exactly.
+       */
+      template <typename T>
+      void complex_multiply(T const* ar, T const* ai, T const* br, T const* bi,
+          typename multiply_result<complex<T> >::type::value_type* cr,
+          typename multiply_result<complex<T> >::type::value_type* ci, std::size_t n)
+      {
+        typedef typename multiply_result<complex<T> >::type::value_type part_type;
+        typedef typename part_type::underlying_type W;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+          W a = ar[i].count(), b = ai[i].count(), c = br[i].count(), d = bi[i].count();
+          cr[i] = part_type(index(W(a * c - b * d)));
+          ci[i] = part_type(index(W(a * d + b * c)));
+        }
+      }
+
+      /**
+       * @Requires as @c complex_multiply.
+       * @Effects <c>c[i] = multiply_gauss(a[i], b[i])</c> for every @c i in <c>[0, n)</c>.
+       */
+      template <typename T>
+      void complex_multiply_gauss(T const* ar, T const* ai, T const* br, T const* bi,
+          typename multiply_result<complex<T> >::type::value_type* cr,
+          typename multiply_result<complex<T> >::type::value_type* ci, std::size_t n)
+      {
+        typedef typename multiply_result<complex<T> >::type::value_type part_type;
+        typedef typename part_type::underlying_type U;
+        typedef typename real_t<part_type::range_exp + 1, part_type::resolution_exp>::underlying_type W;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+          W a = ar[i].count(), b = ai[i].count(), c = br[i].count(), d = bi[i].count();
+          W k1 = c * (a + b);
+          W k2 = a * (d - c);
+          W k3 = b * (c + d);
+          cr[i] = part_type(index(U(k1 - k3)));
+          ci[i] = part_type(index(U(k1 + k2)));
+        }
+      }
+
+      /**
+       * @Requires as @c complex_multiply.
+       * @Effects <c>c[i] = a[i] * conj(b[i])</c> for every @c i in <c>[0, n)</c>, exactly.
+       */
+      template <typename T>
+      void complex_multiply_conj(T const* ar, T const* ai, T const* br, T const* bi,
+          typename multiply_result<complex<T> >::type::value_type* cr,
+          typename multiply_result<complex<T> >::type::value_type* ci, std::size_t n)
+      {
+        typedef typename multiply_result<complex<T> >::type::value_type part_type;
+        typedef typename part_type::underlying_type W;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+          W a = ar[i].count(), b = ai[i].count(), c = br[i].count(), d = bi[i].count();
+          cr[i] = part_type(index(W(a * c + b * d)));
+          ci[i] = part_type(index(W(b * c - a * d)));
+        }
+      }
+
+      /**
+       * @Requires @c re, @c im and @c res point to @c n elements.
+       * @Effects <c>res[i] = norm(z[i])</c> for every @c i in <c>[0, n)</c>, exactly.
+       */
+      template <typename T>
+      void norm(T const* re, T const* im, typename norm_result<T>::type* res, std::size_t n)
+      {
+        typedef typename norm_result<T>::type result_type;
+        typedef typename result_type::underlying_type W;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+          W a = re[i].count(), b = im[i].count();
+          res[i] = result_type(index(W(a * a + b * b)));
+        }
+      }
+    }
+  }
+}
+
+#endif // header
@@ -0,0 +1,216 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Vicente J. Botet Escriba 2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/fixed_point for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file
+ * @brief Defines a divisor that replaces the integer divisions by a same fixed point number by multiplications.
+ *
+ */
+
+#ifndef BOOST_FIXED_POINT_DIVISOR_HPP
+#define BOOST_FIXED_POINT_DIVISOR_HPP
+
+#include <boost/fixed_point/number.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/assert.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/common_type.hpp>
+#include <boost/type_traits/is_signed.hpp>
+#include <climits>
+
+namespace boost
+{
+  namespace fixed_point
+  {
+    namespace detail
+    {
+      /**
+       * High half of the product of two boost::uintmax_t.
+       */
+      inline boost::uintmax_t mul_hi(boost::uintmax_t a, boost::uintmax_t b)
+      {
+#if defined(BOOST_FIXED_POINT_HAS_INT128)
+        BOOST_STATIC_ASSERT(sizeof(boost::uintmax_t) * 2 <= sizeof(boost::uint128_type));
+        return boost::uintmax_t((boost::uint128_type(a) * b) >> (sizeof(boost::uintmax_t) * CHAR_BIT));
+#else
+        const unsigned half = sizeof(boost::uintmax_t) * CHAR_BIT / 2;
+        const boost::uintmax_t mask = (boost::uintmax_t(1) << half) - 1;
+        boost::uintmax_t a_lo = a & mask, a_hi = a >> half;
+        boost::uintmax_t b_lo = b & mask, b_hi = b >> half;
+        boost::uintmax_t lo_lo = a_lo * b_lo;
+        boost::uintmax_t hi_lo = a_hi * b_lo;
+        boost::uintmax_t lo_hi = a_lo * b_hi;
+        boost::uintmax_t cross = (lo_lo >> half) + (hi_lo & mask) + lo_hi;
+        return a_hi * b_hi + (hi_lo >> half) + (cross >> half);
+#endif
+      }
+
+      /**
+       * Unsigned division by an invariant integer using multiplication (Granlund and Montgomery, "Division by
+       * invariant integers using multiplication", figure 4.1).
+       *
+       * The quotient of any boost::uintmax_t by @c d is computed with a multiplication, a subtraction and two shifts.
+       */
+      class unsigned_divisor
+      {
+      public:
+        BOOST_STATIC_CONSTEXPR unsigned width = sizeof(boost::uintmax_t) * CHAR_BIT;
+
+        explicit unsigned_divisor(boost::uintmax_t d) :
+          d_(d)
+        {
+          BOOST_ASSERT_MSG(d != 0, "Division by 0");
+          // l = ceil(log2(d))
+          unsigned l = 0;
+          for (boost::uintmax_t x = d - 1; x != 0; x >>= 1)
+            ++l;
+          // m = floor(2^width * (2^l - d) / d) + 1, computed by long division as 2^width * (2^l - d) doesn't fit.
+          boost::uintmax_t rem = (l == width) ? boost::uintmax_t(0) - d : (boost::uintmax_t(1) << l) - d;
+          boost::uintmax_t m = 0;
+          for (unsigned i = 0; i < width; ++i)
+          {
+            bool carry = (rem >> (width - 1)) != 0;
+            rem <<= 1;
+            m <<= 1;
+            if (carry || rem >= d)
+            {
+              rem -= d;
+              m |= 1;
+            }
+          }
+          m_ = m + 1;
+          sh1_ = l < 1 ? l : 1;
+          sh2_ = l < 1 ? 0 : l - 1;
+        }
+
+        //! the divisor.
+        boost::uintmax_t value() const
+        {
+          return d_;
+        }
+
+        //! @Returns <c>n / value()</c>.
+        boost::uintmax_t quotient(boost::uintmax_t n) const
+        {
+          boost::uintmax_t t = mul_hi(m_, n);
+          return (t + ((n - t) >> sh1_)) >> sh2_;
+        }
+
+      private:
+        boost::uintmax_t d_;
+        boost::uintmax_t m_;
+        unsigned sh1_;
+        unsigned sh2_;
+      };
+
+      template <typename T, bool IsSigned = is_signed<T>::value>
+      struct magnitude
+      {
+        static boost::uintmax_t apply(T v)
+        {
+          return v < 0 ? boost::uintmax_t(0) - boost::uintmax_t(v) : boost::uintmax_t(v);
+        }
+      };
+      template <typename T>
+      struct magnitude<T, false>
+      {
+        static boost::uintmax_t apply(T v)
+        {
+          return boost::uintmax_t(v);
+        }
+      };
+    }
+
+    /**
+     * A fixed point divisor that is reused for several divisions.
+     *
+     * The construction precomputes a multiplier and a shift, so that divide<Res>(lhs, divisor) replaces the integer
+     * division done by divide<Res>(lhs, rhs) by a multiplication. The result is the same, including the rounding
+     * applied by the rounding policy of @c Res.
+     *
+     * @Requires @c T is a @c real_t or a @c ureal_t.
+     */
+    template <typename T>
+    class divisor
+    {
+    public:
+      //! the fixed point type of the divisor.
+      typedef T value_type;
+
+      /**
+       * @Requires <c>d != 0</c>.
+       * @Effects Precomputes the multiplier and the shift of @c d.
+       */
+      explicit divisor(value_type const& d) :
+        value_(d), magnitude_(detail::magnitude<typename value_type::underlying_type>::apply(d.count()))
+      {
+      }
+
+      //! the divisor.
+      value_type value() const
+      {
+        return value_;
+      }
+
+      /**
+       * @Returns the truncated quotient and the remainder of <c>n / value().count()</c>.
+       */
+      template <typename I>
+      void divide(I n, I& q, I& r) const
+      {
+        I d = I(value_.count());
+        I aq = I(magnitude_.quotient(detail::magnitude<I>::apply(n)));
+        I s = detail::sign_mask<I>::apply(n ^ d);
+        q = (aq ^ s) - s;
+        r = n - q * d;
+      }
+
+    private:
+      value_type value_;
+      detail::unsigned_divisor magnitude_;
+    };
+
+    /**
+     * Fixed point division by a precomputed divisor giving the expected result type.
+     *
+     * @Requires The resolution of @c lhs is not finer than the one of the divisor and the numerator shifted to the
+     * resolution of @c Res fits in boost::intmax_t.
+     * @Returns <c>divide<Res>(lhs, rhs.value())</c>.
+     */
+    template <typename Res, typename From, typename T>
+    inline
+    Res
+    divide(From const& lhs, divisor<T> const& rhs)
+    {
+      typedef Res result_type;
+      typedef typename common_type<From, T>::type DT;
+      BOOST_STATIC_ASSERT_MSG((int(DT::resolution_exp) == int(T::resolution_exp)),
+          "The dividend must not have a finer resolution than the divisor");
+      BOOST_STATIC_ASSERT((Res::is_signed==DT::is_signed));
+
+      typedef typename detail::shift_impl<DT, Res>::result_type I;
+      BOOST_STATIC_ASSERT_MSG((sizeof(I) <= sizeof(boost::uintmax_t)),
+          "The numerator is too wide for a precomputed divisor");
+      I n = detail::shift<DT, Res>(DT(lhs).count());
+      I q;
+      I r;
+      rhs.divide(n, q, r);
+
+      typedef typename result_type::rounding_type rounding_type;
+      I ci = rounding_type::template round_quotient<I>(q, r, I(rhs.value().count()));
+      BOOST_ASSERT(ci <= Res::max_index);
+      BOOST_ASSERT(ci >= Res::min_index);
+      return result_type(index(ci));
+    }
+
+  }
+}
+
+#endif // header
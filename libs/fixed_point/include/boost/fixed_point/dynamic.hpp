@@ -0,0 +1,853 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Vicente J. Botet Escriba 2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/fixed_point for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file
+ * @brief Defines fixed point numbers whose range and resolution are chosen at run time, and their conversions from
+ * and to the numbers of compile time formats.
+ *
+ * A @c dynamic_real_t stores its index on a @c boost::intmax_t together with its @c format, so that the format read
+ * from a configuration file or a stream header needs no dispatch over the instantiations of @c real_t. The
+ * conversions to a @c real_t are done by @c number_cast, with the rounding and overflow policies of the target, and
+ * reduce to a copy of the index when the format fits the target. The batch conversions work on arrays of indexes
+ * sharing a single format.
+ */
+
+#ifndef BOOST_FIXED_POINT_DYNAMIC_HPP
+#define BOOST_FIXED_POINT_DYNAMIC_HPP
+
+#include <boost/fixed_point/number.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/assert.hpp>
+#include <boost/integer_traits.hpp>
+#include <boost/mpl/if.hpp>
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/type_traits/is_signed.hpp>
+#include <boost/type_traits/make_unsigned.hpp>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+namespace boost
+{
+  namespace fixed_point
+  {
+    /**
+     * @brief The range and resolution exponents of a signed fixed point number, chosen at run time.
+     *
+     * The numbers of the format are the multiples of <c>2^resolution_exp</c> whose absolute value is less than
+     * <c>2^range_exp</c>. Their indexes are stored on a @c boost::intmax_t, so the format has at most 63 digits.
+     */
+    struct format
+    {
+      BOOST_STATIC_CONSTEXPR int max_digits = integer_traits<boost::intmax_t>::digits;
+
+      int range_exp;
+      int resolution_exp;
+
+      /**
+       * @Requires <c>resolution <= range && range - resolution <= max_digits</c>.
+       */
+      format(int range, int resolution) :
+        range_exp(range), resolution_exp(resolution)
+      {
+        BOOST_ASSERT(resolution <= range && range - resolution <= max_digits);
+      }
+
+      //! @Returns the number of digits of the indexes, without the sign.
+      int digits() const
+      {
+        return range_exp - resolution_exp;
+      }
+
+      //! @Returns the greatest index, <c>2^digits() - 1</c>.
+      boost::intmax_t max_index() const
+      {
+        return digits() == 0 ? 0 : boost::intmax_t(~boost::uintmax_t(0) >> (8 * sizeof(boost::uintmax_t) - digits()));
+      }
+
+      //! @Returns the least index, <c>-max_index()</c>.
+      boost::intmax_t min_index() const
+      {
+        return -max_index();
+      }
+    };
+
+    inline bool operator==(format const& lhs, format const& rhs)
+    {
+      return lhs.range_exp == rhs.range_exp && lhs.resolution_exp == rhs.resolution_exp;
+    }
+
+    inline bool operator!=(format const& lhs, format const& rhs)
+    {
+      return !(lhs == rhs);
+    }
+
+    /**
+     * @TParams
+     * @Param{T,a @c real_t or @c ureal_t}
+     * @Returns the format of @c T.
+     */
+    template <typename T>
+    format format_of()
+    {
+      return format(T::range_exp, T::resolution_exp);
+    }
+
+#if ! defined(BOOST_FIXED_POINT_DOXYGEN_INVOKED)
+    namespace detail
+    {
+      /**
+       * @Returns the index @c v shifted right by <c>s > 62</c> to a shift of 62, keeping a sticky bit below the 62
+       * bits, which is on the same side of every integer and half integer multiple of <c>2^62</c> as the exact value,
+       * so that neither the rounding nor the overflow are changed. @c s is updated.
+       */
+      inline boost::intmax_t dynamic_sticky_shift(boost::intmax_t v, int& s)
+      {
+        const int max_shift = integer_traits<boost::intmax_t>::digits - 1;
+        int k = s - max_shift > max_shift + 1 ? max_shift + 1 : s - max_shift;
+        boost::uintmax_t low = boost::uintmax_t(v) & ((boost::uintmax_t(1) << k) - 1);
+        s = max_shift;
+        return (v >> k) | boost::intmax_t(low != 0);
+      }
+
+      /**
+       * dynamic_round<RP>::apply(v, s) is the quotient of the signed integer @c v by <c>2^s</c>, rounded as @c RP
+       * rounds the quotients, for <c>0 < s < digits(v)</c>.
+       */
+      template <typename RP>
+      struct dynamic_round
+      {
+        template <typename T>
+        static T apply(T v, int s)
+        {
+          typedef typename make_unsigned<T>::type unsigned_type;
+          const T d = T(1) << s;
+          // the quotient and remainder of the C division, without dividing
+          T q = (v + ((v >> integer_traits<T>::digits) & (d - 1))) >> s;
+          return RP::template round_quotient<T>(q, v - T(unsigned_type(q) << s), d);
+        }
+      };
+      template <>
+      struct dynamic_round<round::fastest>
+      {
+        template <typename T>
+        static T apply(T v, int s)
+        {
+          return v >> s;
+        }
+      };
+
+      /**
+       * dynamic_overflow<OP> handles the overflows of @c OP with bounds known at run time: saturates, wraps, throws
+       * or records them as @c OP does for a @c real_t. The other policies return the value.
+       */
+      template <typename OP>
+      struct dynamic_overflow
+      {
+        static boost::intmax_t on_positive(boost::intmax_t v, boost::intmax_t, boost::intmax_t)
+        {
+          return v;
+        }
+        static boost::intmax_t on_negative(boost::intmax_t v, boost::intmax_t, boost::intmax_t)
+        {
+          return v;
+        }
+      };
+      template <>
+      struct dynamic_overflow<overflow::impossible>
+      {
+        static boost::intmax_t on_positive(boost::intmax_t v, boost::intmax_t, boost::intmax_t)
+        {
+          BOOST_ASSERT_MSG(false, "Positive overflow while trying to convert fixed point numbers");
+          return v;
+        }
+        static boost::intmax_t on_negative(boost::intmax_t v, boost::intmax_t, boost::intmax_t)
+        {
+          BOOST_ASSERT_MSG(false, "Negative overflow while trying to convert fixed point numbers");
+          return v;
+        }
+      };
+      template <>
+      struct dynamic_overflow<overflow::saturate>
+      {
+        static boost::intmax_t on_positive(boost::intmax_t, boost::intmax_t, boost::intmax_t max)
+        {
+          return max;
+        }
+        static boost::intmax_t on_negative(boost::intmax_t, boost::intmax_t min, boost::intmax_t)
+        {
+          return min;
+        }
+      };
+      template <>
+      struct dynamic_overflow<overflow::exception>
+      {
+        static boost::intmax_t on_positive(boost::intmax_t, boost::intmax_t, boost::intmax_t)
+        {
+          throw positive_overflow();
+        }
+        static boost::intmax_t on_negative(boost::intmax_t, boost::intmax_t, boost::intmax_t)
+        {
+          throw negative_overflow();
+        }
+      };
+      template <>
+      struct dynamic_overflow<overflow::modulus>
+      {
+        static boost::intmax_t on_positive(boost::intmax_t v, boost::intmax_t min, boost::intmax_t max)
+        {
+          // the range of a format is at most 2^64 - 1, so it is computed on unsigned integers
+          boost::uintmax_t range = boost::uintmax_t(max) - boost::uintmax_t(min) + 1;
+          return boost::intmax_t((boost::uintmax_t(v) - boost::uintmax_t(min)) % range + boost::uintmax_t(min));
+        }
+        static boost::intmax_t on_negative(boost::intmax_t v, boost::intmax_t min, boost::intmax_t max)
+        {
+          boost::uintmax_t range = boost::uintmax_t(max) - boost::uintmax_t(min) + 1;
+          return boost::intmax_t(boost::uintmax_t(max) - (boost::uintmax_t(max) - boost::uintmax_t(v)) % range);
+        }
+      };
+      template <typename Handling>
+      struct dynamic_overflow<overflow::sticky<Handling> >
+      {
+        static boost::intmax_t on_positive(boost::intmax_t v, boost::intmax_t min, boost::intmax_t max)
+        {
+          overflow::detail::sticky_word() |= overflow::positive_overflow_flag;
+          return dynamic_overflow<Handling>::on_positive(v, min, max);
+        }
+        static boost::intmax_t on_negative(boost::intmax_t v, boost::intmax_t min, boost::intmax_t max)
+        {
+          overflow::detail::sticky_word() |= overflow::negative_overflow_flag;
+          return dynamic_overflow<Handling>::on_negative(v, min, max);
+        }
+      };
+
+      //! The bounds and overflow handling of a compile time format @c To.
+      template <typename To>
+      struct static_bounds
+      {
+        typedef typename To::rounding_type rounding_type;
+        typedef typename To::overflow_type overflow_type;
+
+        boost::intmax_t min() const
+        {
+          return To::min_index;
+        }
+        boost::intmax_t max() const
+        {
+          return To::max_index;
+        }
+        boost::intmax_t on_positive(boost::intmax_t v) const
+        {
+          return overflow_type::template on_positive_overflow<To, boost::intmax_t>(v);
+        }
+        boost::intmax_t on_negative(boost::intmax_t v) const
+        {
+          return overflow_type::template on_negative_overflow<To, boost::intmax_t>(v);
+        }
+      };
+
+      //! The bounds of a run time format, whose overflows are handled by @c OP.
+      template <typename RP, typename OP>
+      struct dynamic_bounds
+      {
+        typedef RP rounding_type;
+
+        boost::intmax_t min_, max_;
+
+        explicit dynamic_bounds(format const& f) :
+          min_(f.min_index()), max_(f.max_index())
+        {
+        }
+        boost::intmax_t min() const
+        {
+          return min_;
+        }
+        boost::intmax_t max() const
+        {
+          return max_;
+        }
+        boost::intmax_t on_positive(boost::intmax_t v) const
+        {
+          return dynamic_overflow<OP>::on_positive(v, min_, max_);
+        }
+        boost::intmax_t on_negative(boost::intmax_t v) const
+        {
+          return dynamic_overflow<OP>::on_negative(v, min_, max_);
+        }
+      };
+
+      //! @Returns the index @c v within the bounds @c b, overflowed as @c b does.
+      template <typename Bounds>
+      boost::intmax_t dynamic_bound(boost::intmax_t v, Bounds const& b)
+      {
+        if (v > b.max())
+          return b.on_positive(v);
+        if (v < b.min())
+          return b.on_negative(v);
+        return v;
+      }
+
+      /**
+       * @Returns the index @c v shifted right by <c>s > 0</c>, rounded as @c b does. As for the conversions between
+       * @c real_t, the overflows are detected on the exact value, and the index shifted towards negative infinity is
+       * given to the overflow policy.
+       */
+      template <typename Bounds>
+      boost::intmax_t dynamic_shift_right(boost::intmax_t v, int s, Bounds const& b)
+      {
+        if (s > integer_traits<boost::intmax_t>::digits - 1)
+          v = dynamic_sticky_shift(v, s);
+        boost::intmax_t f = v >> s;
+        bool inexact = (v & ((boost::intmax_t(1) << s) - 1)) != 0;
+        if (f > b.max() || (f == b.max() && inexact))
+          return b.on_positive(f);
+        if (f < b.min())
+          return b.on_negative(f);
+        return dynamic_round<typename Bounds::rounding_type>::apply(v, s);
+      }
+
+      /**
+       * @Returns the index @c v shifted left by <c>s > 0</c> and bounded as @c b does. The indexes shifted beyond 64
+       * bits are given to the overflow policy on their low 64 bits.
+       */
+      template <typename Bounds>
+      boost::intmax_t dynamic_shift_left(boost::intmax_t v, int s, Bounds const& b)
+      {
+        const int max_shift = integer_traits<boost::intmax_t>::digits;
+        const boost::intmax_t limit = s >= max_shift ? 0 : integer_traits<boost::intmax_t>::const_max >> s;
+        boost::intmax_t w = s > max_shift ? 0 : boost::intmax_t(boost::uintmax_t(v) << s);
+        if (v > limit)
+          return b.on_positive(w);
+        if (v < -limit)
+          return b.on_negative(w);
+        return dynamic_bound(w, b);
+      }
+
+      /**
+       * @Returns the index @c v of resolution <c>2^from</c> converted to the resolution <c>2^to</c> and to the
+       * bounds @c b, rounded and overflowed as @c b does.
+       */
+      template <typename Bounds>
+      boost::intmax_t dynamic_rescale(boost::intmax_t v, int from, int to, Bounds const& b)
+      {
+        if (to > from)
+          return dynamic_shift_right(v, to - from, b);
+        if (to < from)
+          return dynamic_shift_left(v, from - to, b);
+        return dynamic_bound(v, b);
+      }
+    }
+#endif
+
+    /**
+     * @brief Signed fixed point number whose format is chosen at run time.
+     *
+     * @TParams
+     * @Param{Rounding,the rounding policy of the conversions to a format given at run time}
+     * @Param{Overflow,the overflow policy of the conversions to a format given at run time}
+     *
+     * The conversions to a @c real_t use the policies of the @c real_t, as @c number_cast does. The default
+     * constructor leaves the index and the format uninitialized, as for @c real_t.
+     *
+     * @Example
+     * @code
+     * format f(header.range_exp, header.resolution_exp);
+     * dynamic_real_t<> x(index(header.sample), f);
+     * real_t<0, -15, round::nearest_even, overflow::saturate> y = number_cast<real_t<0, -15,
+     *     round::nearest_even, overflow::saturate> >(x);
+     * @endcode
+     */
+    template <typename Rounding = round::negative, typename Overflow = overflow::exception>
+    class dynamic_real_t
+    {
+    public:
+      typedef boost::intmax_t underlying_type;
+      typedef Rounding rounding_type;
+      typedef Overflow overflow_type;
+      BOOST_STATIC_CONSTEXPR bool is_signed = true;
+
+      dynamic_real_t()
+      {
+      }
+
+      /**
+       * @Requires <c>f.min_index() <= i.get() && i.get() <= f.max_index()</c>.
+       * @Effects constructs the number of index @c i in the format @c f.
+       */
+      template <typename I>
+      dynamic_real_t(index_tag<I> i, format const& f) :
+        value_(i.get()), format_(f)
+      {
+        BOOST_ASSERT(f.min_index() <= value_ && value_ <= f.max_index());
+      }
+
+      //! @Effects constructs the same number as @c x, in the format of @c x.
+      template <int R, int P, typename RP, typename OP, typename F>
+      dynamic_real_t(real_t<R, P, RP, OP, F> const& x) :
+        value_(x.count()), format_(R, P)
+      {
+      }
+
+      //! @Effects constructs the same number as @c x, in the format of @c x.
+      template <int R, int P, typename RP, typename OP, typename F>
+      dynamic_real_t(ureal_t<R, P, RP, OP, F> const& x) :
+        value_(x.count()), format_(R, P)
+      {
+      }
+
+      /**
+       * @Effects constructs @c x converted to the format @c f with the @c Rounding and @c Overflow policies.
+       */
+      template <int R, int P, typename RP, typename OP, typename F>
+      dynamic_real_t(real_t<R, P, RP, OP, F> const& x, format const& f) :
+        value_(detail::dynamic_rescale(x.count(), P, f.resolution_exp, bounds_type(f))), format_(f)
+      {
+      }
+
+      /**
+       * @Effects constructs @c x converted to the format @c f with the @c Rounding and @c Overflow policies.
+       */
+      template <int R, int P, typename RP, typename OP, typename F>
+      dynamic_real_t(ureal_t<R, P, RP, OP, F> const& x, format const& f) :
+        value_(detail::dynamic_rescale(x.count(), P, f.resolution_exp, bounds_type(f))), format_(f)
+      {
+      }
+
+      /**
+       * @Requires @c x is finite.
+       * @Effects constructs @c x converted to the format @c f with the @c Rounding and @c Overflow policies.
+       */
+      dynamic_real_t(double x, format const& f) :
+        format_(f)
+      {
+        BOOST_ASSERT(x - x == 0);
+        int e = 0;
+        // x is m * 2^e exactly, with m on 53 bits
+        const int mantissa_digits = std::numeric_limits<double>::digits;
+        double m = std::ldexp(std::frexp(x, &e), mantissa_digits);
+        value_ = detail::dynamic_rescale(boost::intmax_t(m), e - mantissa_digits, f.resolution_exp, bounds_type(f));
+      }
+
+      //! @Returns the index.
+      underlying_type count() const
+      {
+        return value_;
+      }
+
+      //! @Returns the format.
+      format get_format() const
+      {
+        return format_;
+      }
+
+      //! @Returns the range exponent of the format.
+      int range_exp() const
+      {
+        return format_.range_exp;
+      }
+
+      //! @Returns the resolution exponent of the format.
+      int resolution_exp() const
+      {
+        return format_.resolution_exp;
+      }
+
+      //! @Returns whether the format is the one of @c T, so that the conversion to @c T is a copy of the index.
+      template <typename T>
+      bool has_format() const
+      {
+        return format_ == format_of<T>();
+      }
+
+      //! @Returns the nearest double.
+      double as_double() const
+      {
+        return std::ldexp(double(value_), format_.resolution_exp);
+      }
+
+      /**
+       * @Returns the number converted to the format @c f with the @c Rounding and @c Overflow policies.
+       */
+      dynamic_real_t rescale(format const& f) const
+      {
+        return dynamic_real_t(index(detail::dynamic_rescale(value_, format_.resolution_exp, f.resolution_exp,
+            bounds_type(f))), f);
+      }
+
+    private:
+      typedef detail::dynamic_bounds<Rounding, Overflow> bounds_type;
+
+      underlying_type value_;
+      format format_;
+    };
+
+#if ! defined(BOOST_FIXED_POINT_DOXYGEN_INVOKED)
+    namespace detail
+    {
+      /**
+       * number_cast of a dynamic_real_t to a real_t or ureal_t, with the policies of @c To. The index is copied when
+       * the resolutions are the same and the range of @c x fits the one of @c To.
+       */
+      template <typename RP, typename OP, typename To>
+      struct number_cast<dynamic_real_t<RP, OP>, To, false>
+      {
+        To operator()(dynamic_real_t<RP, OP> const& x) const
+        {
+          typedef typename To::underlying_type underlying_type;
+          if (x.resolution_exp() == To::resolution_exp && x.range_exp() <= To::range_exp
+              && (To::is_signed || x.count() >= 0))
+            return To(index(underlying_type(x.count())));
+          return To(index(underlying_type(dynamic_rescale(x.count(), x.resolution_exp(), To::resolution_exp,
+              static_bounds<To>()))));
+        }
+      };
+
+      //! number_cast of a real_t or ureal_t to a dynamic_real_t keeps its format.
+      template <typename From, typename RP, typename OP>
+      struct number_cast<From, dynamic_real_t<RP, OP>, false>
+      {
+        dynamic_real_t<RP, OP> operator()(From const& x) const
+        {
+          return dynamic_real_t<RP, OP>(x);
+        }
+      };
+
+      //! number_cast between dynamic_real_t keeps the format.
+      template <typename RP1, typename OP1, typename RP2, typename OP2>
+      struct number_cast<dynamic_real_t<RP1, OP1>, dynamic_real_t<RP2, OP2>, false>
+      {
+        dynamic_real_t<RP2, OP2> operator()(dynamic_real_t<RP1, OP1> const& x) const
+        {
+          return dynamic_real_t<RP2, OP2>(index(x.count()), x.get_format());
+        }
+      };
+
+      //! The index of @c x at the resolution <c>2^resolution</c>, which is not coarser than the one of @c x.
+      template <typename RP, typename OP>
+      boost::intmax_t dynamic_align(dynamic_real_t<RP, OP> const& x, int resolution)
+      {
+        int s = x.resolution_exp() - resolution;
+        return s == 0 ? x.count() : boost::intmax_t(boost::uintmax_t(x.count()) << s);
+      }
+
+      //! The format of the sums, which must have at most format::max_digits.
+      template <typename RP, typename OP>
+      format dynamic_add_format(dynamic_real_t<RP, OP> const& lhs, dynamic_real_t<RP, OP> const& rhs)
+      {
+        return format((lhs.range_exp() > rhs.range_exp() ? lhs.range_exp() : rhs.range_exp()) + 1,
+            lhs.resolution_exp() < rhs.resolution_exp() ? lhs.resolution_exp() : rhs.resolution_exp());
+      }
+
+      //! -1, 0 or 1 as @c lhs is less than, equal to or greater than @c rhs.
+      template <typename RP, typename OP>
+      int dynamic_compare(dynamic_real_t<RP, OP> const& lhs, dynamic_real_t<RP, OP> const& rhs)
+      {
+        boost::intmax_t l = lhs.count(), r = rhs.count();
+        int s = lhs.resolution_exp() - rhs.resolution_exp();
+        // the coarser index is shifted left, unless it overflows and then exceeds the other index
+        boost::intmax_t& coarse = s > 0 ? l : r;
+        int a = s > 0 ? s : -s;
+        const int max_shift = integer_traits<boost::intmax_t>::digits;
+        const boost::intmax_t limit = a >= max_shift ? 0 : integer_traits<boost::intmax_t>::const_max >> a;
+        if (coarse > limit || coarse < -limit)
+          return (coarse > 0) == (s > 0) ? 1 : -1;
+        coarse = boost::intmax_t(boost::uintmax_t(coarse) << a);
+        return l < r ? -1 : l > r ? 1 : 0;
+      }
+    }
+#endif
+
+    /**
+     * @Requires the sum format, whose range is the greatest of the ranges plus one and whose resolution is the finest
+     * of the resolutions, has at most format::max_digits.
+     * @Returns the exact sum, in the sum format.
+     */
+    template <typename RP, typename OP>
+    dynamic_real_t<RP, OP> operator+(dynamic_real_t<RP, OP> const& lhs, dynamic_real_t<RP, OP> const& rhs)
+    {
+      format f = detail::dynamic_add_format(lhs, rhs);
+      return dynamic_real_t<RP, OP>(index(detail::dynamic_align(lhs, f.resolution_exp)
+          + detail::dynamic_align(rhs, f.resolution_exp)), f);
+    }
+
+    /**
+     * @Requires the sum format has at most format::max_digits.
+     * @Returns the exact difference, in the sum format.
+     */
+    template <typename RP, typename OP>
+    dynamic_real_t<RP, OP> operator-(dynamic_real_t<RP, OP> const& lhs, dynamic_real_t<RP, OP> const& rhs)
+    {
+      format f = detail::dynamic_add_format(lhs, rhs);
+      return dynamic_real_t<RP, OP>(index(detail::dynamic_align(lhs, f.resolution_exp)
+          - detail::dynamic_align(rhs, f.resolution_exp)), f);
+    }
+
+    /**
+     * @Requires the sum of the digits of the formats is at most format::max_digits.
+     * @Returns the exact product, whose range and resolution exponents are the sums of the ones of the operands.
+     */
+    template <typename RP, typename OP>
+    dynamic_real_t<RP, OP> operator*(dynamic_real_t<RP, OP> const& lhs, dynamic_real_t<RP, OP> const& rhs)
+    {
+      return dynamic_real_t<RP, OP>(index(lhs.count() * rhs.count()),
+          format(lhs.range_exp() + rhs.range_exp(), lhs.resolution_exp() + rhs.resolution_exp()));
+    }
+
+    //! @Returns the opposite, in the same format.
+    template <typename RP, typename OP>
+    dynamic_real_t<RP, OP> operator-(dynamic_real_t<RP, OP> const& x)
+    {
+      return dynamic_real_t<RP, OP>(index(-x.count()), x.get_format());
+    }
+
+    //! @Returns whether the numbers are equal, whatever their formats.
+    template <typename RP, typename OP>
+    bool operator==(dynamic_real_t<RP, OP> const& lhs, dynamic_real_t<RP, OP> const& rhs)
+    {
+      return detail::dynamic_compare(lhs, rhs) == 0;
+    }
+
+    template <typename RP, typename OP>
+    bool operator!=(dynamic_real_t<RP, OP> const& lhs, dynamic_real_t<RP, OP> const& rhs)
+    {
+      return detail::dynamic_compare(lhs, rhs) != 0;
+    }
+
+    template <typename RP, typename OP>
+    bool operator<(dynamic_real_t<RP, OP> const& lhs, dynamic_real_t<RP, OP> const& rhs)
+    {
+      return detail::dynamic_compare(lhs, rhs) < 0;
+    }
+
+    template <typename RP, typename OP>
+    bool operator>(dynamic_real_t<RP, OP> const& lhs, dynamic_real_t<RP, OP> const& rhs)
+    {
+      return detail::dynamic_compare(lhs, rhs) > 0;
+    }
+
+    template <typename RP, typename OP>
+    bool operator<=(dynamic_real_t<RP, OP> const& lhs, dynamic_real_t<RP, OP> const& rhs)
+    {
+      return detail::dynamic_compare(lhs, rhs) <= 0;
+    }
+
+    template <typename RP, typename OP>
+    bool operator>=(dynamic_real_t<RP, OP> const& lhs, dynamic_real_t<RP, OP> const& rhs)
+    {
+      return detail::dynamic_compare(lhs, rhs) >= 0;
+    }
+
+    namespace batch
+    {
+#if ! defined(BOOST_FIXED_POINT_DOXYGEN_INVOKED)
+      namespace detail
+      {
+        //! Stores an index to a number or to an integer.
+        template <typename O, bool IsIntegral = is_integral<O>::value>
+        struct dynamic_store
+        {
+          template <typename W>
+          static void apply(O& o, W v)
+          {
+            o = O(index(typename O::underlying_type(v)));
+          }
+        };
+        template <typename O>
+        struct dynamic_store<O, true>
+        {
+          template <typename W>
+          static void apply(O& o, W v)
+          {
+            o = O(v);
+          }
+        };
+
+        //! Loads the index of a number or an integer.
+        template <typename I, bool IsIntegral = is_integral<I>::value>
+        struct dynamic_load
+        {
+          static typename I::underlying_type apply(I const& i)
+          {
+            return i.count();
+          }
+        };
+        template <typename I>
+        struct dynamic_load<I, true>
+        {
+          static I apply(I i)
+          {
+            return i;
+          }
+        };
+
+        //! The index type of @c T, an integer or a number.
+        template <typename T, bool IsIntegral = is_integral<T>::value>
+        struct dynamic_index
+        {
+          typedef typename T::underlying_type type;
+        };
+        template <typename T>
+        struct dynamic_index<T, true>
+        {
+          typedef T type;
+        };
+
+        //! Whether the indexes of @c T are representable by an int32.
+        template <typename T>
+        struct dynamic_fits_int32
+        {
+          typedef typename dynamic_index<T>::type index_type;
+          BOOST_STATIC_CONSTEXPR bool value = sizeof(index_type) < 4
+              || (sizeof(index_type) == 4 && is_signed<index_type>::value);
+        };
+
+        /**
+         * The type on which the indexes of @c I are converted to the ones of @c O: an int32 when both are
+         * representable by an int32, so that the loops are vectorized on more lanes.
+         */
+        template <typename I, typename O>
+        struct dynamic_work
+        {
+          typedef typename mpl::if_c<
+              dynamic_fits_int32<I>::value && dynamic_fits_int32<O>::value,
+              boost::int32_t, boost::intmax_t
+          >::type type;
+        };
+
+        // The format of the targets includes the format of the sources: the indexes are shifted left by s >= 0.
+        template <typename W, typename I, typename O>
+        void dynamic_exact(I const* from, int s, O* to, std::size_t n)
+        {
+          typedef typename make_unsigned<W>::type unsigned_type;
+          if (s == 0)
+            for (std::size_t i = 0; i < n; ++i)
+              dynamic_store<O>::apply(to[i], dynamic_load<I>::apply(from[i]));
+          else
+            for (std::size_t i = 0; i < n; ++i)
+              dynamic_store<O>::apply(to[i], W(unsigned_type(W(dynamic_load<I>::apply(from[i]))) << s));
+        }
+
+        /**
+         * Saturating conversions, without branches: as the rounding is monotonic, saturating the rounded index gives
+         * the bound exactly when the exact value is out of the bounds. Requires <c>0 <= s < digits(W)</c>.
+         */
+        template <typename W, typename RP, typename I, typename O>
+        void dynamic_saturate(I const* from, int f, int t, W min, W max, O* to, std::size_t n)
+        {
+          typedef typename make_unsigned<W>::type unsigned_type;
+          if (t > f)
+          {
+            const int s = t - f;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+              W y = fixed_point::detail::dynamic_round<RP>::apply(W(dynamic_load<I>::apply(from[i])), s);
+              y = y > max ? max : y;
+              dynamic_store<O>::apply(to[i], y < min ? min : y);
+            }
+          }
+          else
+          {
+            const int s = f - t;
+            const W high = max >> s, low = -((-min) >> s);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+              W v = W(dynamic_load<I>::apply(from[i]));
+              W y = W(unsigned_type(v) << s);
+              y = v > high ? max : y;
+              dynamic_store<O>::apply(to[i], v < low ? min : y);
+            }
+          }
+        }
+
+        // The conversions by any policies, with the direction of the shift hoisted out of the loops.
+        template <typename I, typename Bounds, typename O>
+        void dynamic_rescale(I const* from, int f, int t, Bounds const& b, O* to, std::size_t n)
+        {
+          using fixed_point::detail::dynamic_shift_right;
+          using fixed_point::detail::dynamic_shift_left;
+          using fixed_point::detail::dynamic_bound;
+          if (t > f)
+            for (std::size_t i = 0; i < n; ++i)
+              dynamic_store<O>::apply(to[i], dynamic_shift_right(boost::intmax_t(dynamic_load<I>::apply(from[i])),
+                  t - f, b));
+          else if (t < f)
+            for (std::size_t i = 0; i < n; ++i)
+              dynamic_store<O>::apply(to[i], dynamic_shift_left(boost::intmax_t(dynamic_load<I>::apply(from[i])),
+                  f - t, b));
+          else
+            for (std::size_t i = 0; i < n; ++i)
+              dynamic_store<O>::apply(to[i], dynamic_bound(boost::intmax_t(dynamic_load<I>::apply(from[i])), b));
+        }
+
+        /**
+         * Converts the indexes of resolution <c>2^f</c> and range <c>2^fr</c> to the resolution <c>2^t</c> and the
+         * range <c>2^tr</c>, on the fastest of the loops above.
+         */
+        template <typename RP, typename OP, typename I, typename Bounds, typename O>
+        void dynamic_convert(I const* from, int fr, int f, int tr, int t, bool signed_target, Bounds const& b,
+            O* to, std::size_t n)
+        {
+          typedef typename dynamic_work<I, O>::type work_type;
+          const int s = t > f ? t - f : f - t;
+          if (signed_target && t <= f && tr >= fr)
+            dynamic_exact<work_type>(from, f - t, to, n);
+          else if (is_same<OP, overflow::saturate>::value && s < integer_traits<work_type>::digits)
+            dynamic_saturate<work_type, RP>(from, f, t, work_type(b.min()), work_type(b.max()), to, n);
+          else
+            dynamic_rescale(from, f, t, b, to, n);
+        }
+      }
+#endif
+
+      /**
+       * @TParams
+       * @Param{To,a @c real_t or @c ureal_t}
+       * @Param{I,an integral type}
+       *
+       * @Requires the indexes <c>from[i]</c> are within the bounds of the format @c f.
+       * @Effects <c>to[i] = number_cast<To>(dynamic_real_t<>(index(from[i]), f))</c> for every @c i in
+       * <c>[0, n)</c>. When the format of @c To includes @c f, the indexes are only shifted; otherwise the
+       * saturating conversions are done without branches.
+       */
+      template <typename To, typename I>
+      void from_dynamic(I const* from, format const& f, To* to, std::size_t n)
+      {
+        detail::dynamic_convert<typename To::rounding_type, typename To::overflow_type>(from, f.range_exp,
+            f.resolution_exp, To::range_exp, To::resolution_exp, To::is_signed,
+            fixed_point::detail::static_bounds<To>(), to, n);
+      }
+
+      /**
+       * @TParams
+       * @Param{To,a @c dynamic_real_t, whose policies convert the numbers}
+       * @Param{From,a @c real_t or @c ureal_t}
+       * @Param{I,an integral type}
+       *
+       * @Requires the indexes of the format @c f are representable by @c I.
+       * @Effects <c>to[i] = To(from[i], f).count()</c> for every @c i in <c>[0, n)</c>. When @c f includes the
+       * format of @c From, the indexes are only shifted.
+       */
+      template <typename To, typename From, typename I>
+      void to_dynamic(From const* from, format const& f, I* to, std::size_t n)
+      {
+        BOOST_ASSERT(f.max_index() <= boost::intmax_t(integer_traits<I>::const_max));
+        typedef typename To::rounding_type rounding_type;
+        typedef typename To::overflow_type overflow_type;
+        detail::dynamic_convert<rounding_type, overflow_type>(from, From::range_exp, From::resolution_exp,
+            f.range_exp, f.resolution_exp, true,
+            fixed_point::detail::dynamic_bounds<rounding_type, overflow_type>(f), to, n);
+      }
+    }
+  }
+}
+
+#endif // header
@@ -0,0 +1,390 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Vicente J. Botet Escriba 2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/fixed_point for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file
+ * @brief Defines expression templates deferring the normalization of compound fixed point expressions.
+ *
+ * Each operator of number.hpp builds its exact result type, converting its operands to it, so that a compound
+ * expression builds as many intermediate numbers as operators, each one with its own underlying integer. Once one of
+ * the operands is wrapped with lazy(), the operators +, - and * build instead an expression tree, which knows at
+ * compile time the range and the resolution of the exact result. number_cast evaluates the whole tree on a single
+ * integer, the smallest one holding the exact result, and rounds it once to the target type.
+ */
+
+#ifndef BOOST_FIXED_POINT_EXPRESSION_HPP
+#define BOOST_FIXED_POINT_EXPRESSION_HPP
+
+#include <boost/fixed_point/number.hpp>
+#include <boost/mpl/if.hpp>
+#include <boost/mpl/bool.hpp>
+#include <boost/utility/enable_if.hpp>
+
+namespace boost
+{
+  namespace fixed_point
+  {
+    namespace detail
+    {
+      //! The operators of the expression trees.
+      struct terminal_op {};
+      struct plus_op {};
+      struct minus_op {};
+      struct multiplies_op {};
+      struct negate_op {};
+    }
+
+    /**
+     * Node of an expression tree. @c Op is one of the operator tags, and @c L and @c R the operands, a fixed point
+     * number for the terminals and other nodes otherwise.
+     *
+     * Every node defines:
+     * - @c range_exp, @c resolution_exp and @c is_signed, the ones of the exact result of the operators of
+     *   number.hpp,
+     * - @c leaf_type, the type of its leftmost terminal, whose policies are the ones of @c value_type,
+     * - @c value_type, the exact type of the expression,
+     * - <c>evaluate<W>()</c>, the index of the exact value at the resolution @c resolution_exp, computed on the
+     *   integer @c W.
+     *
+     * The nodes hold their operands by value, so that an expression can be stored.
+     */
+    template <typename Op, typename L, typename R = void>
+    struct expression;
+
+    namespace detail
+    {
+      //! The exact type of an expression with the range, resolution and signedness of @c E and the policies of @c T.
+      template <typename E, typename T>
+      struct expression_value
+      {
+        typedef typename mpl::if_c<E::is_signed,
+            real_t<E::range_exp, E::resolution_exp, typename T::rounding_type, typename T::overflow_type,
+                typename T::family_type>,
+            ureal_t<E::range_exp, E::resolution_exp, typename T::rounding_type, typename T::overflow_type,
+                typename T::family_type> >::type type;
+      };
+
+      //! The smallest integer holding the indices of the expression @c E and of all its subexpressions.
+      template <typename E>
+      struct expression_integer
+      {
+        typedef typename mpl::if_c<E::is_signed,
+            typename int_t<E::range_exp - E::resolution_exp + 1>::least,
+            typename uint_t<E::range_exp - E::resolution_exp>::least>::type type;
+      };
+
+      //! Common definitions of the binary nodes.
+      template <typename L, typename R>
+      struct binary_expression
+      {
+        typedef typename L::leaf_type leaf_type;
+        BOOST_STATIC_CONSTEXPR int resolution_exp = (L::resolution_exp < R::resolution_exp) ? L::resolution_exp
+            : R::resolution_exp;
+        BOOST_STATIC_CONSTEXPR int range_exp = ((L::range_exp > R::range_exp) ? L::range_exp : R::range_exp) + 1;
+
+        L lhs;
+        R rhs;
+        binary_expression(L const& l, R const& r) :
+          lhs(l), rhs(r)
+        {
+        }
+
+        //! The index of @c lhs at the resolution of the node.
+        template <typename W>
+        W evaluate_lhs() const
+        {
+          return lhs.template evaluate<W>() * (W(1) << (L::resolution_exp - resolution_exp));
+        }
+        //! The index of @c rhs at the resolution of the node.
+        template <typename W>
+        W evaluate_rhs() const
+        {
+          return rhs.template evaluate<W>() * (W(1) << (R::resolution_exp - resolution_exp));
+        }
+      };
+    }
+
+    /**
+     * A fixed point number, the leaf of the expression trees.
+     */
+    template <typename T>
+    struct expression<detail::terminal_op, T, void>
+    {
+      typedef T leaf_type;
+      typedef T value_type;
+      BOOST_STATIC_CONSTEXPR int range_exp = T::range_exp;
+      BOOST_STATIC_CONSTEXPR int resolution_exp = T::resolution_exp;
+      BOOST_STATIC_CONSTEXPR bool is_signed = T::is_signed;
+
+      T value;
+      explicit expression(T const& x) :
+        value(x)
+      {
+      }
+
+      template <typename W>
+      W evaluate() const
+      {
+        return W(value.count());
+      }
+    };
+
+    /**
+     * <c>L + R</c>.
+     */
+    template <typename L, typename R>
+    struct expression<detail::plus_op, L, R> : detail::binary_expression<L, R>
+    {
+      typedef detail::binary_expression<L, R> base_type;
+      BOOST_STATIC_CONSTEXPR bool is_signed = L::is_signed || R::is_signed;
+      typedef typename detail::expression_value<expression, typename L::leaf_type>::type value_type;
+
+      expression(L const& l, R const& r) :
+        base_type(l, r)
+      {
+      }
+
+      template <typename W>
+      W evaluate() const
+      {
+        return this->template evaluate_lhs<W>() + this->template evaluate_rhs<W>();
+      }
+    };
+
+    /**
+     * <c>L - R</c>, signed as the difference of two unsigned numbers can be negative.
+     */
+    template <typename L, typename R>
+    struct expression<detail::minus_op, L, R> : detail::binary_expression<L, R>
+    {
+      typedef detail::binary_expression<L, R> base_type;
+      BOOST_STATIC_CONSTEXPR bool is_signed = true;
+      typedef typename detail::expression_value<expression, typename L::leaf_type>::type value_type;
+
+      expression(L const& l, R const& r) :
+        base_type(l, r)
+      {
+      }
+
+      template <typename W>
+      W evaluate() const
+      {
+        return this->template evaluate_lhs<W>() - this->template evaluate_rhs<W>();
+      }
+    };
+
+    /**
+     * <c>L * R</c>.
+     */
+    template <typename L, typename R>
+    struct expression<detail::multiplies_op, L, R>
+    {
+      typedef typename L::leaf_type leaf_type;
+      BOOST_STATIC_CONSTEXPR int range_exp = L::range_exp + R::range_exp;
+      BOOST_STATIC_CONSTEXPR int resolution_exp = L::resolution_exp + R::resolution_exp;
+      BOOST_STATIC_CONSTEXPR bool is_signed = L::is_signed || R::is_signed;
+      typedef typename detail::expression_value<expression, leaf_type>::type value_type;
+
+      L lhs;
+      R rhs;
+      expression(L const& l, R const& r) :
+        lhs(l), rhs(r)
+      {
+      }
+
+      template <typename W>
+      W evaluate() const
+      {
+        return W(lhs.template evaluate<W>() * rhs.template evaluate<W>());
+      }
+    };
+
+    /**
+     * <c>-E</c>.
+     */
+    template <typename E>
+    struct expression<detail::negate_op, E, void>
+    {
+      typedef typename E::leaf_type leaf_type;
+      BOOST_STATIC_CONSTEXPR int range_exp = E::range_exp;
+      BOOST_STATIC_CONSTEXPR int resolution_exp = E::resolution_exp;
+      BOOST_STATIC_CONSTEXPR bool is_signed = true;
+      typedef typename detail::expression_value<expression, leaf_type>::type value_type;
+
+      E operand;
+      explicit expression(E const& e) :
+        operand(e)
+      {
+      }
+
+      template <typename W>
+      W evaluate() const
+      {
+        return -operand.template evaluate<W>();
+      }
+    };
+
+    /**
+     * is_expression<T>::value is true when @c T is an expression tree.
+     */
+    template <typename T>
+    struct is_expression : mpl::false_
+    {
+    };
+    template <typename Op, typename L, typename R>
+    struct is_expression<expression<Op, L, R> > : mpl::true_
+    {
+    };
+
+    /**
+     * as_expression<T>::type is the node of the operand @c T: the terminal of a fixed point number, or the
+     * expression itself.
+     */
+    template <typename T>
+    struct as_expression
+    {
+    };
+#if ! defined(BOOST_FIXED_POINT_DOXYGEN_INVOKED)
+    template <int R, int P, typename RP, typename OP, typename F>
+    struct as_expression<real_t<R,P,RP,OP,F> >
+    {
+      typedef expression<detail::terminal_op, real_t<R,P,RP,OP,F> > type;
+      static type apply(real_t<R,P,RP,OP,F> const& x)
+      {
+        return type(x);
+      }
+    };
+    template <int R, int P, typename RP, typename OP, typename F>
+    struct as_expression<ureal_t<R,P,RP,OP,F> >
+    {
+      typedef expression<detail::terminal_op, ureal_t<R,P,RP,OP,F> > type;
+      static type apply(ureal_t<R,P,RP,OP,F> const& x)
+      {
+        return type(x);
+      }
+    };
+    template <typename Op, typename L, typename R>
+    struct as_expression<expression<Op, L, R> >
+    {
+      typedef expression<Op, L, R> type;
+      static type const& apply(type const& e)
+      {
+        return e;
+      }
+    };
+#endif
+
+    namespace detail
+    {
+      //! The node of <c>L Op R</c>, defined when one of the operands at least is an expression.
+      template <typename Op, typename L, typename R>
+      struct binary_expression_result
+      {
+        typedef expression<Op, typename as_expression<L>::type, typename as_expression<R>::type> type;
+      };
+    }
+
+    /**
+     * @Returns the terminal of @c x, so that the operators it takes part in build an expression tree.
+     */
+    template <int R, int P, typename RP, typename OP, typename F>
+    inline
+    expression<detail::terminal_op, real_t<R,P,RP,OP,F> >
+    lazy(real_t<R,P,RP,OP,F> const& x)
+    {
+      return expression<detail::terminal_op, real_t<R,P,RP,OP,F> >(x);
+    }
+
+    /**
+     * @Returns the terminal of @c x, so that the operators it takes part in build an expression tree.
+     */
+    template <int R, int P, typename RP, typename OP, typename F>
+    inline
+    expression<detail::terminal_op, ureal_t<R,P,RP,OP,F> >
+    lazy(ureal_t<R,P,RP,OP,F> const& x)
+    {
+      return expression<detail::terminal_op, ureal_t<R,P,RP,OP,F> >(x);
+    }
+
+    /**
+     * @Returns the expression tree of <c>lhs + rhs</c>, when one of them at least is an expression.
+     */
+    template <typename L, typename R>
+    inline
+    typename lazy_enable_if_c<is_expression<L>::value || is_expression<R>::value,
+        detail::binary_expression_result<detail::plus_op, L, R> >::type
+    operator+(L const& lhs, R const& rhs)
+    {
+      typedef typename detail::binary_expression_result<detail::plus_op, L, R>::type result_type;
+      return result_type(as_expression<L>::apply(lhs), as_expression<R>::apply(rhs));
+    }
+
+    /**
+     * @Returns the expression tree of <c>lhs - rhs</c>, when one of them at least is an expression.
+     */
+    template <typename L, typename R>
+    inline
+    typename lazy_enable_if_c<is_expression<L>::value || is_expression<R>::value,
+        detail::binary_expression_result<detail::minus_op, L, R> >::type
+    operator-(L const& lhs, R const& rhs)
+    {
+      typedef typename detail::binary_expression_result<detail::minus_op, L, R>::type result_type;
+      return result_type(as_expression<L>::apply(lhs), as_expression<R>::apply(rhs));
+    }
+
+    /**
+     * @Returns the expression tree of <c>lhs * rhs</c>, when one of them at least is an expression.
+     */
+    template <typename L, typename R>
+    inline
+    typename lazy_enable_if_c<is_expression<L>::value || is_expression<R>::value,
+        detail::binary_expression_result<detail::multiplies_op, L, R> >::type
+    operator*(L const& lhs, R const& rhs)
+    {
+      typedef typename detail::binary_expression_result<detail::multiplies_op, L, R>::type result_type;
+      return result_type(as_expression<L>::apply(lhs), as_expression<R>::apply(rhs));
+    }
+
+    /**
+     * @Returns the expression tree of <c>-e</c>.
+     */
+    template <typename Op, typename L, typename R>
+    inline
+    expression<detail::negate_op, expression<Op, L, R> >
+    operator-(expression<Op, L, R> const& e)
+    {
+      return expression<detail::negate_op, expression<Op, L, R> >(e);
+    }
+
+    namespace detail
+    {
+      /**
+       * number_cast of an expression tree: the tree is evaluated on the smallest integer holding its exact value,
+       * without any intermediate number, and the exact value is converted once to @c To, with its rounding and
+       * overflow policies.
+       */
+      template <typename Op, typename L, typename R, typename To>
+      struct number_cast<expression<Op, L, R>, To, false>
+      {
+        typedef expression<Op, L, R> From;
+        typedef typename expression_value<From, To>::type exact_type;
+        typedef typename expression_integer<From>::type integer_type;
+
+        To operator()(From const& e) const
+        {
+          return number_cast<exact_type, To>()(exact_type(index(typename exact_type::underlying_type(
+              e.template evaluate<integer_type>()))));
+        }
+      };
+    }
+  }
+}
+
+#endif // header
@@ -0,0 +1,361 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Vicente J. Botet Escriba 2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/fixed_point for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file
+ * @brief Defines an in-place radix-2 fast Fourier transform of complex fixed point numbers, with a scaling of each
+ * stage that is none, unconditional or decided by a block floating point exponent.
+ *
+ * The real and the imaginary parts are stored in two arrays, and the twiddles of each stage are contiguous, so that
+ * the butterflies of a stage access memory with a unit stride. Each butterfly is computed exactly on the underlying
+ * integers and rounded once to the data type with its rounding and overflow policies.
+ */
+
+#ifndef BOOST_FIXED_POINT_FFT_HPP
+#define BOOST_FIXED_POINT_FFT_HPP
+
+#include <boost/fixed_point/number.hpp>
+#include <boost/fixed_point/trigonometric.hpp>
+#include <boost/assert.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace boost
+{
+  namespace fixed_point
+  {
+    namespace fft_scaling
+    {
+      /**
+       * The stages are not scaled: the outputs are the transform, and the inputs must leave log2(n) bits of headroom,
+       * otherwise the overflow policy of the data type applies.
+       */
+      struct none
+      {
+      };
+      /**
+       * Each stage is scaled by 1/2: the outputs are the transform divided by n, without overflow as long as the
+       * magnitudes of the inputs are below 2^Range.
+       */
+      struct unconditional
+      {
+      };
+      /**
+       * A stage is scaled by 1/2 only when the magnitudes could overflow, and the number of scaled stages is returned
+       * as the block exponent of the outputs, so that the small inputs keep the resolution of the data type.
+       */
+      struct block_floating
+      {
+      };
+    }
+
+    namespace detail
+    {
+      /**
+       * The default twiddles of the data type @c T: stored on as many bits as @c T, Q1.14 for Q15 data, as long as
+       * the exact butterflies fit on 64 bits.
+       */
+      template <typename T>
+      struct fft_twiddle
+      {
+        BOOST_STATIC_CONSTEXPR int data_bits = T::range_exp - T::resolution_exp;
+        BOOST_STATIC_CONSTEXPR int fraction_bits = (61 - data_bits < data_bits - 1) ? 61 - data_bits : data_bits - 1;
+        typedef real_t<1, -fraction_bits, typename T::rounding_type, typename T::overflow_type,
+            typename T::family_type> type;
+      };
+
+      /**
+       * The exact types of the sums and of the twiddled differences of a butterfly, divided by 2 if @c Scaled. As the
+       * twiddles are at most 1 in magnitude, a part of a twiddled difference is below sqrt(2) * 2^(Range+1).
+       */
+      template <typename T, typename Twiddle, bool Scaled>
+      struct fft_butterfly_types
+      {
+        typedef typename T::rounding_type RP;
+        typedef typename T::overflow_type OP;
+        typedef typename T::family_type F;
+        BOOST_STATIC_CONSTEXPR int R = T::range_exp;
+        BOOST_STATIC_CONSTEXPR int P = T::resolution_exp;
+        BOOST_STATIC_CONSTEXPR int PT = Twiddle::resolution_exp;
+        BOOST_STATIC_CONSTEXPR int scale = Scaled ? 1 : 0;
+        typedef real_t<R + 1 - scale, P - scale, RP, OP, F> sum_type;
+        typedef real_t<R + 2 - scale, P + PT - scale, RP, OP, F> product_type;
+        typedef typename product_type::underlying_type underlying_type;
+      };
+
+      /**
+       * Converts the exact value @c v of type @c From to @c T, with the rounding and overflow policies of @c T. The
+       * conversions rounding to nearest even and saturating are computed without branches, so that the butterflies
+       * can be vectorized.
+       */
+      template <typename T, typename From,
+          bool Branchless = is_same<typename T::rounding_type, round::nearest_even>::value
+              && is_same<typename T::overflow_type, overflow::saturate>::value>
+      struct fft_convert
+      {
+        template <typename W>
+        static T apply(W v)
+        {
+          return fixed_point::number_cast<T>(From(index(v)));
+        }
+      };
+
+      template <typename T, typename From>
+      struct fft_convert<T, From, true>
+      {
+        BOOST_STATIC_CONSTEXPR int shift = T::resolution_exp - From::resolution_exp;
+
+        template <typename W>
+        static T apply(W v)
+        {
+          if (shift > 0)
+          {
+            // adds half an unit, less the ulp when the quotient is even
+            const int s = shift > 0 ? shift : 1;
+            v = (v + ((W(1) << (s - 1)) - 1) + ((v >> s) & 1)) >> s;
+          }
+          v = v < W(T::min_index) ? W(T::min_index) : v;
+          v = v > W(T::max_index) ? W(T::max_index) : v;
+          return T(index(typename T::underlying_type(v)));
+        }
+      };
+    }
+
+    /**
+     * @brief Fast Fourier transform of @c n complex numbers.
+     *
+     * The transform is a decimation in frequency: the stages of the sub-transforms larger than @c block_size are
+     * computed over the whole arrays, and the remaining ones block by block, so that a block stays in the cache. The
+     * outputs are permuted back to the natural order.
+     *
+     * @TParams
+     * @Param{T,the signed type of the real and imaginary parts}
+     * @Param{Scaling,@c fft_scaling::none, @c fft_scaling::unconditional or @c fft_scaling::block_floating}
+     * @Param{Twiddle,the type of the twiddles, with a range of 1}
+     *
+     * @Example
+     * @code
+     * fft<real_t<0,-15,round::nearest_even,overflow::saturate> > f(1024);
+     * int e = f.forward(re, im); // the transform is (re[k] + i * im[k]) * 2^e
+     * @endcode
+     */
+    template <typename T, typename Scaling = fft_scaling::block_floating,
+        typename Twiddle = typename detail::fft_twiddle<T>::type>
+    class fft
+    {
+      BOOST_STATIC_ASSERT_MSG(T::is_signed, "The parts of a complex number must be signed");
+      BOOST_STATIC_ASSERT_MSG(Twiddle::range_exp == 1, "The twiddles need a range of 1");
+      typedef real_t<1, Twiddle::resolution_exp, typename T::rounding_type, typename T::overflow_type,
+          typename T::family_type> twiddle_type;
+      typedef real_t<1, Twiddle::resolution_exp, round::nearest_even, overflow::saturate,
+          typename T::family_type> rounded_twiddle_type;
+      typedef detail::fft_butterfly_types<T, twiddle_type, false> unscaled_types;
+      typedef detail::fft_butterfly_types<T, twiddle_type, true> scaled_types;
+      typedef typename unscaled_types::underlying_type underlying_type;
+    public:
+      typedef T value_type;
+      typedef Scaling scaling_type;
+
+      //! The number of complex numbers whose stages are computed together.
+      BOOST_STATIC_CONSTEXPR std::size_t block_size = 1024;
+
+      /**
+       * @Requires @c n is a power of 2, between 2 and 2^32.
+       * @Effects precomputes the twiddles, rounded to nearest, and the permutation of the outputs.
+       */
+      explicit fft(std::size_t n) :
+        n_(n), log2n_(0)
+      {
+        BOOST_ASSERT(n >= 2 && (n & (n - 1)) == 0);
+        while ((std::size_t(1) << log2n_) < n)
+          ++log2n_;
+        BOOST_ASSERT(log2n_ <= 32);
+        // the h twiddles exp(-2 * pi * i * k / (2 * h)) of the stage of half span h start at h - 1
+        wr_.resize(n - 1, twiddle_type(index(0)));
+        wi_.resize(n - 1, twiddle_type(index(0)));
+        for (std::size_t h = 1; h < n; h <<= 1)
+        {
+          int log2m = 0;
+          while ((std::size_t(2) << log2m) <= h)
+            ++log2m;
+          for (std::size_t k = 0; k < h; ++k)
+          {
+            // k / (2 * h) turn
+            ureal_t<0, -32> turns = ureal_t<0, -32>(index(boost::uint32_t(k << (31 - log2m))));
+            wr_[h - 1 + k] = twiddle_type(index(fixed_point::cos<rounded_twiddle_type>(turns).count()));
+            wi_[h - 1 + k] = twiddle_type(index(-fixed_point::sin<rounded_twiddle_type>(turns).count()));
+          }
+        }
+        for (std::size_t i = 0; i < n; ++i)
+        {
+          std::size_t r = 0;
+          for (int b = 0; b < log2n_; ++b)
+            r |= ((i >> b) & 1) << (log2n_ - 1 - b);
+          if (i < r)
+          {
+            swaps_.push_back(i);
+            swaps_.push_back(r);
+          }
+        }
+      }
+
+      //! @Returns the number of complex numbers.
+      std::size_t size() const
+      {
+        return n_;
+      }
+
+      /**
+       * @Requires @c re and @c im point to size() numbers.
+       * @Effects replaces the complex numbers <c>re[j] + i * im[j]</c> by their transform
+       * <c>X[k] = sum of x[j] * exp(-2 * pi * i * j * k / n)</c>, scaled by 2^-e.
+       * @Returns e: 0 for @c fft_scaling::none, log2(n) for @c fft_scaling::unconditional, and the number of scaled
+       * stages for @c fft_scaling::block_floating.
+       */
+      int forward(T* re, T* im) const
+      {
+        int e = 0;
+        std::size_t h = n_ / 2;
+        for (; h > 0 && 2 * h > block_size; h >>= 1)
+          e += stage(re, im, 0, n_, h, scale_stage(peak(re, im)));
+        if (h > 0)
+        {
+          // the scaling of the blocked stages is decided on a bound of the magnitudes, the same for all the blocks
+          std::vector<bool> scaled;
+          underlying_type m = peak(re, im);
+          for (std::size_t g = h; g > 0; g >>= 1)
+          {
+            scaled.push_back(scale_stage(m));
+            m = scaled.back() ? m + 1 : 2 * m;
+          }
+          for (std::size_t base = 0; base < n_; base += 2 * h)
+          {
+            std::size_t s = 0;
+            for (std::size_t g = h; g > 0; g >>= 1, ++s)
+              stage(re, im, base, 2 * h, g, scaled[s]);
+          }
+          for (std::size_t s = 0; s < scaled.size(); ++s)
+            e += scaled[s] ? 1 : 0;
+        }
+        for (std::size_t i = 0; i < swaps_.size(); i += 2)
+        {
+          std::swap(re[swaps_[i]], re[swaps_[i + 1]]);
+          std::swap(im[swaps_[i]], im[swaps_[i + 1]]);
+        }
+        return e;
+      }
+
+      /**
+       * @Requires @c re and @c im point to size() numbers.
+       * @Effects replaces the complex numbers by their inverse transform without the factor 1/n,
+       * <c>x[j] = sum of X[k] * exp(2 * pi * i * j * k / n)</c>, scaled by 2^-e.
+       * @Returns e, as forward().
+       */
+      int inverse(T* re, T* im) const
+      {
+        conjugate(im);
+        int e = forward(re, im);
+        conjugate(im);
+        return e;
+      }
+
+    private:
+      std::size_t n_;
+      int log2n_;
+      std::vector<twiddle_type> wr_;
+      std::vector<twiddle_type> wi_;
+      std::vector<std::size_t> swaps_;
+
+      void conjugate(T* im) const
+      {
+        for (std::size_t i = 0; i < n_; ++i)
+          im[i] = T(index(-im[i].count()));
+      }
+
+      //! A bound of the magnitudes: the largest absolute value of the parts times 3/2, above sqrt(2).
+      underlying_type peak(T const* re, T const* im) const
+      {
+        underlying_type m = 0;
+        if (!is_same<Scaling, fft_scaling::block_floating>::value)
+          return m;
+        for (std::size_t i = 0; i < n_; ++i)
+        {
+          underlying_type r = re[i].count();
+          underlying_type j = im[i].count();
+          m = std::max(m, std::max(r < 0 ? -r : r, j < 0 ? -j : j));
+        }
+        return m + m / 2 + 1;
+      }
+
+      /**
+       * Whether a stage whose magnitudes are below @c m, on the underlying integers, is scaled: an unscaled stage at
+       * most doubles them.
+       */
+      static bool scale_stage(underlying_type m)
+      {
+        if (is_same<Scaling, fft_scaling::none>::value)
+          return false;
+        if (is_same<Scaling, fft_scaling::unconditional>::value)
+          return true;
+        return 2 * m > underlying_type(T::max_index);
+      }
+
+      /**
+       * The butterflies of half span @c h of the sub-transforms of the @c len numbers from @c base.
+       * @Returns 1 if the stage is scaled, 0 otherwise.
+       */
+      int stage(T* re, T* im, std::size_t base, std::size_t len, std::size_t h, bool scaled) const
+      {
+        if (scaled)
+          butterflies<scaled_types>(re + base, im + base, len, h);
+        else
+          butterflies<unscaled_types>(re + base, im + base, len, h);
+        return scaled ? 1 : 0;
+      }
+
+      template <typename Types>
+      void butterflies(T* re, T* im, std::size_t len, std::size_t h) const
+      {
+        for (std::size_t j = 0; j < len; j += 2 * h)
+          row<Types>(re + j, im + j, re + j + h, im + j + h, &wr_[h - 1], &wi_[h - 1], h);
+      }
+
+      //! The @c h butterflies of a sub-transform, whose halves @c a and @c b are disjoint.
+      template <typename Types>
+      static void row(T* BOOST_RESTRICT ar, T* BOOST_RESTRICT ai, T* BOOST_RESTRICT br, T* BOOST_RESTRICT bi,
+          const twiddle_type* BOOST_RESTRICT wr, const twiddle_type* BOOST_RESTRICT wi, std::size_t h)
+      {
+        typedef typename Types::sum_type sum_type;
+        typedef typename Types::product_type product_type;
+        for (std::size_t k = 0; k < h; ++k)
+        {
+          underlying_type xr = ar[k].count();
+          underlying_type xi = ai[k].count();
+          underlying_type yr = br[k].count();
+          underlying_type yi = bi[k].count();
+          underlying_type dr = xr - yr;
+          underlying_type di = xi - yi;
+          underlying_type cr = wr[k].count();
+          underlying_type ci = wi[k].count();
+          ar[k] = detail::fft_convert<T, sum_type>::apply(xr + yr);
+          ai[k] = detail::fft_convert<T, sum_type>::apply(xi + yi);
+          br[k] = detail::fft_convert<T, product_type>::apply(dr * cr - di * ci);
+          bi[k] = detail::fft_convert<T, product_type>::apply(dr * ci + di * cr);
+        }
+      }
+    };
+  }
+}
+
+#endif // header
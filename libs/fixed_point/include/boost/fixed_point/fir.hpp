@@ -0,0 +1,378 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Vicente J. Botet Escriba 2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/fixed_point for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file
+ * @brief Defines finite impulse response filters on fixed point samples, with polyphase decimation and interpolation.
+ *
+ * Each output is the exact sum of the products of the samples and the coefficients, computed on the underlying
+ * integer of an accumulator and converted once to the result type with its rounding and overflow policies. When both
+ * the samples and the coefficients are stored on 16 bits, the multiply-accumulate uses the SIMD kernels of batch.hpp.
+ */
+
+#ifndef BOOST_FIXED_POINT_FIR_HPP
+#define BOOST_FIXED_POINT_FIR_HPP
+
+#include <boost/fixed_point/number.hpp>
+#include <boost/fixed_point/accumulator.hpp>
+#include <boost/fixed_point/batch.hpp>
+#include <boost/assert.hpp>
+#include <boost/cstdint.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace boost
+{
+  namespace fixed_point
+  {
+    namespace detail
+    {
+      //! Whether @c T is a @c real_t stored on an int16.
+      template <typename T>
+      struct is_int16
+      {
+        BOOST_STATIC_CONSTEXPR bool value = T::is_signed && sizeof(T) == 2
+            && sizeof(typename T::underlying_type) == 2;
+      };
+
+      /**
+       * fir_dot<Sample, Coefficient, Acc>::apply(x, h, n, simd) is the sum of the products of the indices of
+       * <c>x[0, n)</c> and <c>h[0, n)</c>, on the integer @c Acc. The products are computed on the underlying integer
+       * of their exact type.
+       */
+      template <typename Sample, typename Coefficient, typename Acc,
+          bool Enabled = is_int16<Sample>::value && is_int16<Coefficient>::value>
+      struct fir_dot
+      {
+        typedef typename multiply_result<Sample, Coefficient>::type::underlying_type product_type;
+
+        static bool simd(Coefficient const*, std::size_t)
+        {
+          return false;
+        }
+
+        static Acc apply(Sample const* x, Coefficient const* h, std::size_t n, bool)
+        {
+          Acc acc = 0;
+          for (std::size_t i = 0; i < n; ++i)
+            acc += Acc(product_type(x[i].count()) * product_type(h[i].count()));
+          return acc;
+        }
+      };
+#if defined(BOOST_FIXED_POINT_SIMD_X86)
+      //! The pmaddwd kernels, when the coefficients don't contain -32768.
+      template <typename Sample, typename Coefficient, typename Acc>
+      struct fir_dot<Sample, Coefficient, Acc, true>
+      {
+        static bool simd(Coefficient const* h, std::size_t n)
+        {
+          for (std::size_t i = 0; i < n; ++i)
+            if (h[i].count() == -32768)
+              return false;
+          return true;
+        }
+
+        static Acc apply(Sample const* x, Coefficient const* h, std::size_t n, bool simd)
+        {
+          boost::int64_t acc = 0;
+          std::size_t i = simd ? simd::detail::mac_int16(reinterpret_cast<const boost::int16_t*>(x),
+              reinterpret_cast<const boost::int16_t*>(h), n, acc) : 0;
+          for (; i < n; ++i)
+            acc += boost::int32_t(x[i].count()) * h[i].count();
+          return Acc(acc);
+        }
+      };
+#endif
+
+      /**
+       * The coefficients and the delay line shared by the filters.
+       *
+       * The delay line holds the last @c history samples followed by the samples of the block being processed, so that
+       * the window of each output is contiguous. The coefficients are stored in reverse order, so that an output is
+       * the dot product of a window and a row of coefficients.
+       */
+      template <typename Sample, typename Coefficient, typename Result, int N>
+      class fir_base
+      {
+      public:
+        //! The type of the products of a sample and a coefficient.
+        typedef typename multiply_result<Sample, Coefficient>::type product_type;
+        //! The accumulator of the products of an output.
+        typedef fixed_point::accumulator<product_type, N> accumulator_type;
+
+      protected:
+        typedef typename accumulator_type::value_type value_type;
+        typedef typename accumulator_type::underlying_type underlying_type;
+
+        explicit fir_base(std::size_t history) :
+          history_(history), simd_(false), line_(history, Sample(index(0)))
+        {
+        }
+
+        //! Enables the SIMD kernels when there are some for the types and the coefficients.
+        void check_coefficients()
+        {
+          simd_ = fir_dot<Sample, Coefficient, underlying_type>::simd(&coefficients_[0], coefficients_.size());
+        }
+
+        //! Appends the block @c in of @c n samples to the delay line.
+        Sample const* load(Sample const* in, std::size_t n)
+        {
+          line_.resize(history_ + n, Sample(index(0)));
+          std::copy(in, in + n, line_.begin() + history_);
+          return line_.empty() ? 0 : &line_[0];
+        }
+
+        //! Keeps the last @c history samples of the delay line, once a block of @c n samples has been processed.
+        void shift(std::size_t n)
+        {
+          std::copy(line_.begin() + n, line_.begin() + n + history_, line_.begin());
+          line_.erase(line_.begin() + history_, line_.end());
+        }
+
+        //! The output of the window @c x and of the row @c h of @c n coefficients.
+        Result output(Sample const* x, Coefficient const* h, std::size_t n) const
+        {
+          underlying_type acc = fir_dot<Sample, Coefficient, underlying_type>::apply(x, h, n, simd_);
+          return fixed_point::number_cast<Result>(value_type(index(acc)));
+        }
+
+        void clear()
+        {
+          std::fill(line_.begin(), line_.end(), Sample(index(0)));
+        }
+
+        std::size_t history_;
+        bool simd_;
+        std::vector<Coefficient> coefficients_;
+        std::vector<Sample> line_;
+      };
+    }
+
+    /**
+     * @brief Finite impulse response filter, <c>y[n] = h[0] * x[n] + h[1] * x[n-1] + ... + h[taps-1] * x[n-taps+1]</c>.
+     *
+     * The sum is exact, computed on an @c accumulator of the products, and converted once to @c Result with its
+     * rounding and overflow policies.
+     *
+     * @TParams
+     * @Param{Sample,the type of the input samples}
+     * @Param{Coefficient,the type of the coefficients}
+     * @Param{Result,the type of the output samples}
+     * @Param{N,the base 2 logarithm of the maximum number of taps}
+     *
+     * @Example
+     * @code
+     * fir_filter<real_t<15,0>, real_t<0,-15> > f(h, taps);
+     * f.process(in, out, n);
+     * @endcode
+     */
+    template <typename Sample, typename Coefficient, typename Result = Sample, int N = 16>
+    class fir_filter : public detail::fir_base<Sample, Coefficient, Result, N>
+    {
+      typedef detail::fir_base<Sample, Coefficient, Result, N> base_type;
+    public:
+      /**
+       * @Requires @c h points to @c taps coefficients, with @c taps in <c>[1, 2^N]</c>.
+       * @Effects constructs a filter with the coefficients @c h and a delay line of zeros.
+       */
+      fir_filter(Coefficient const* h, std::size_t taps) :
+        base_type(taps - 1)
+      {
+        BOOST_ASSERT_MSG(taps >= 1 && (taps - 1) >> (N - 1) >> 1 == 0, "Invalid number of taps");
+        this->coefficients_.assign(h, h + taps);
+        std::reverse(this->coefficients_.begin(), this->coefficients_.end());
+        this->check_coefficients();
+      }
+
+      //! @Returns the number of coefficients.
+      std::size_t taps() const
+      {
+        return this->coefficients_.size();
+      }
+
+      //! @Effects fills the delay line with zeros.
+      void reset()
+      {
+        this->clear();
+      }
+
+      /**
+       * @Effects filters the sample @c x.
+       * @Returns the output of @c x.
+       */
+      Result operator()(Sample const& x)
+      {
+        Result y;
+        process(&x, &y, 1);
+        return y;
+      }
+
+      /**
+       * @Requires @c in and @c out point to @c n samples.
+       * @Effects filters the block of samples @c in, storing the outputs in @c out.
+       */
+      void process(Sample const* in, Result* out, std::size_t n)
+      {
+        Sample const* x = this->load(in, n);
+        Coefficient const* h = &this->coefficients_[0];
+        for (std::size_t i = 0; i < n; ++i)
+          out[i] = this->output(x + i, h, taps());
+        this->shift(n);
+      }
+    };
+
+    /**
+     * @brief Finite impulse response filter followed by a decimation by @c factor: only the outputs of the samples
+     * <c>0, factor, 2 * factor...</c> of the input stream are computed.
+     *
+     * This is the polyphase decimator: each output costs @c taps multiply-accumulates, as the outputs which would be
+     * dropped are not computed.
+     */
+    template <typename Sample, typename Coefficient, typename Result = Sample, int N = 16>
+    class fir_decimator : public detail::fir_base<Sample, Coefficient, Result, N>
+    {
+      typedef detail::fir_base<Sample, Coefficient, Result, N> base_type;
+    public:
+      /**
+       * @Requires @c h points to @c taps coefficients, with @c taps in <c>[1, 2^N]</c>, and @c factor is positive.
+       * @Effects constructs a decimator with the coefficients @c h and a delay line of zeros.
+       */
+      fir_decimator(Coefficient const* h, std::size_t taps, std::size_t factor) :
+        base_type(taps - 1), factor_(factor), phase_(0)
+      {
+        BOOST_ASSERT_MSG(taps >= 1 && (taps - 1) >> (N - 1) >> 1 == 0, "Invalid number of taps");
+        BOOST_ASSERT_MSG(factor >= 1, "Invalid decimation factor");
+        this->coefficients_.assign(h, h + taps);
+        std::reverse(this->coefficients_.begin(), this->coefficients_.end());
+        this->check_coefficients();
+      }
+
+      //! @Returns the number of coefficients.
+      std::size_t taps() const
+      {
+        return this->coefficients_.size();
+      }
+
+      //! @Returns the decimation factor.
+      std::size_t factor() const
+      {
+        return factor_;
+      }
+
+      //! @Effects fills the delay line with zeros, so that the next sample gives an output.
+      void reset()
+      {
+        this->clear();
+        phase_ = 0;
+      }
+
+      /**
+       * @Requires @c in points to @c n samples, and @c out to <c>n / factor() + 1</c> samples.
+       * @Effects filters and decimates the block of samples @c in, storing the outputs in @c out.
+       * @Returns the number of outputs.
+       */
+      std::size_t process(Sample const* in, Result* out, std::size_t n)
+      {
+        Sample const* x = this->load(in, n);
+        Coefficient const* h = &this->coefficients_[0];
+        std::size_t k = 0;
+        std::size_t i = phase_;
+        for (; i < n; i += factor_)
+          out[k++] = this->output(x + i, h, taps());
+        phase_ = i - n;
+        this->shift(n);
+        return k;
+      }
+
+    private:
+      std::size_t factor_;
+      //! The number of samples to skip before the next output.
+      std::size_t phase_;
+    };
+
+    /**
+     * @brief Interpolation by @c factor followed by a finite impulse response filter: the filter of the input stream
+     * with <c>factor - 1</c> zeros inserted after each sample.
+     *
+     * This is the polyphase interpolator: the coefficients are split in @c factor phases of
+     * <c>ceil(taps / factor)</c> coefficients, the output @c p of each input sample being the dot product of the
+     * delay line and the phase @c p, so that the products of the inserted zeros are not computed. The gain is the
+     * one of the coefficients; scale them by @c factor to keep the amplitude of the input.
+     */
+    template <typename Sample, typename Coefficient, typename Result = Sample, int N = 16>
+    class fir_interpolator : public detail::fir_base<Sample, Coefficient, Result, N>
+    {
+      typedef detail::fir_base<Sample, Coefficient, Result, N> base_type;
+    public:
+      /**
+       * @Requires @c h points to @c taps coefficients, with @c taps in <c>[1, 2^N]</c>, and @c factor is positive.
+       * @Effects constructs an interpolator with the coefficients @c h and a delay line of zeros.
+       */
+      fir_interpolator(Coefficient const* h, std::size_t taps, std::size_t factor) :
+        base_type((taps + factor - 1) / factor - 1), taps_(taps), factor_(factor)
+      {
+        BOOST_ASSERT_MSG(taps >= 1 && (taps - 1) >> (N - 1) >> 1 == 0, "Invalid number of taps");
+        BOOST_ASSERT_MSG(factor >= 1, "Invalid interpolation factor");
+        std::size_t length = phase_length();
+        // the phase p holds h[p], h[p + factor]... in reverse order, padded with zeros
+        this->coefficients_.assign(factor * length, Coefficient(index(0)));
+        for (std::size_t p = 0; p < factor; ++p)
+          for (std::size_t j = 0; j * factor + p < taps; ++j)
+            this->coefficients_[p * length + length - 1 - j] = h[j * factor + p];
+        this->check_coefficients();
+      }
+
+      //! @Returns the number of coefficients.
+      std::size_t taps() const
+      {
+        return taps_;
+      }
+
+      //! @Returns the interpolation factor.
+      std::size_t factor() const
+      {
+        return factor_;
+      }
+
+      //! @Effects fills the delay line with zeros.
+      void reset()
+      {
+        this->clear();
+      }
+
+      /**
+       * @Requires @c in points to @c n samples, and @c out to <c>n * factor()</c> samples.
+       * @Effects interpolates and filters the block of samples @c in, storing the outputs in @c out.
+       */
+      void process(Sample const* in, Result* out, std::size_t n)
+      {
+        Sample const* x = this->load(in, n);
+        std::size_t length = phase_length();
+        for (std::size_t i = 0; i < n; ++i)
+          for (std::size_t p = 0; p < factor_; ++p)
+            *out++ = this->output(x + i, &this->coefficients_[p * length], length);
+        this->shift(n);
+      }
+
+    private:
+      std::size_t phase_length() const
+      {
+        return this->history_ + 1;
+      }
+
+      std::size_t taps_;
+      std::size_t factor_;
+    };
+  }
+}
+
+#endif // header
@@ -0,0 +1,810 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Vicente J. Botet Escriba 2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/fixed_point for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file
+ * @brief Defines the products of matrices, and of a matrix and a vector, of fixed point numbers.
+ *
+ * Each element of a product is the exact dot product of a row and a column, computed on the underlying integer of
+ * dot_result and converted once to the result type with number_cast, as batch::dot would.
+ *
+ * The products of matrices pack the rows of the first operand, and the columns of the second one in panels where the
+ * elements of a few consecutive rows of a column are contiguous, so that a tile of results is updated by multiplying
+ * a broadcast group of elements of a row by a vector of the panel. The tiles run on blocks of the operands that stay
+ * in the caches. The products of a matrix and a vector are computed as dot products of its rows and of the vector.
+ *
+ * When both operands are stored on 8 bits, the tiles use the vpdpbusd of AVX-512 VNNI, or the vpmaddubsw of AVX2;
+ * when both are stored on 16 bits, they use the vpmaddwd of AVX2. The instruction set is selected at run time as for
+ * the kernels of batch.hpp.
+ */
+
+#ifndef BOOST_FIXED_POINT_GEMM_HPP
+#define BOOST_FIXED_POINT_GEMM_HPP
+
+#include <boost/fixed_point/number.hpp>
+#include <boost/fixed_point/batch.hpp>
+#include <boost/fixed_point/reduce.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+namespace boost
+{
+  namespace fixed_point
+  {
+#if defined(BOOST_FIXED_POINT_SIMD_X86)
+    namespace simd
+    {
+      namespace detail
+      {
+        inline bool detect_vnni()
+        {
+          __builtin_cpu_init();
+          return __builtin_cpu_supports("avx512vnni") != 0;
+        }
+
+        //! Whether the processor supports the AVX-512 VNNI instructions, used at the avx512 level.
+        inline bool vnni_supported()
+        {
+          static const bool res = detect_vnni();
+          return res;
+        }
+
+        //! The four bytes at @c p, to be broadcast.
+        inline boost::int32_t load_group(const void* p)
+        {
+          boost::int32_t res;
+          std::memcpy(&res, p, sizeof(res));
+          return res;
+        }
+
+        //! Adds the eight int32 lanes of @c v to <c>acc[0, 8)</c>.
+        __attribute__((target("avx2")))
+        inline void add_lanes_avx2(__m256i v, boost::int64_t* acc)
+        {
+          __m256i* lo = reinterpret_cast<__m256i*>(acc);
+          __m256i* hi = reinterpret_cast<__m256i*>(acc + 4);
+          _mm256_storeu_si256(lo, _mm256_add_epi64(_mm256_loadu_si256(lo),
+              _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v))));
+          _mm256_storeu_si256(hi, _mm256_add_epi64(_mm256_loadu_si256(hi),
+              _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1))));
+        }
+
+        /**
+         * Tiles of the products of matrices of numbers on 8 bits: adds to <c>acc[r * ldacc + c]</c> the dot product
+         * of the row @c r of @c a and of the column @c c of the panel @c b, for @c r in <c>[0, 4)</c> and @c c in
+         * <c>[0, 32)</c>. The rows of @c a are @c lda bytes apart, and the panel holds the groups of 4 elements of
+         * the 32 columns one after the other. @c kc is a multiple of 4.
+         *
+         * The int32 lanes hold the sums of kc products, so they don't overflow for the blocks of 2048 elements of
+         * the callers.
+         */
+        __attribute__((target("avx512f,avx512vnni")))
+        inline void gemm_tile_u8s8_vnni(const boost::uint8_t* a, std::size_t lda, const boost::int8_t* b,
+            std::size_t kc, boost::int64_t* acc, std::size_t ldacc)
+        {
+          __m512i sum[4][2];
+          for (std::size_t r = 0; r < 4; ++r)
+            sum[r][0] = sum[r][1] = _mm512_setzero_si512();
+          for (std::size_t p = 0; p < kc; p += 4)
+          {
+            __m512i y0 = _mm512_loadu_si512(b + p * 32);
+            __m512i y1 = _mm512_loadu_si512(b + p * 32 + 64);
+            for (std::size_t r = 0; r < 4; ++r)
+            {
+              __m512i x = _mm512_set1_epi32(load_group(a + r * lda + p));
+              sum[r][0] = _mm512_dpbusd_epi32(sum[r][0], x, y0);
+              sum[r][1] = _mm512_dpbusd_epi32(sum[r][1], x, y1);
+            }
+          }
+          for (std::size_t r = 0; r < 4; ++r)
+            for (std::size_t v = 0; v < 2; ++v)
+            {
+              boost::int32_t lanes[16];
+              _mm512_storeu_si512(lanes, sum[r][v]);
+              for (std::size_t c = 0; c < 16; ++c)
+                acc[r * ldacc + v * 16 + c] += lanes[c];
+            }
+        }
+
+        /**
+         * As gemm_tile_u8s8_vnni, with vpmaddubsw. Unless @c Split, @c b must be in [-64, 64], so that the sums of
+         * two products of vpmaddubsw don't saturate. When @c Split, the elements of @c a are split in two halves of
+         * 4 bits, whose sums of two products don't saturate whatever @c b.
+         */
+        template <bool Split>
+        __attribute__((target("avx2")))
+        inline void gemm_tile_u8s8_avx2(const boost::uint8_t* a, std::size_t lda, const boost::int8_t* b,
+            std::size_t kc, boost::int64_t* acc, std::size_t ldacc)
+        {
+          const __m256i ones = _mm256_set1_epi16(1);
+          const __m256i sixteen = _mm256_set1_epi16(16);
+          const __m256i nibble = _mm256_set1_epi8(0x0f);
+          // the 32 columns, 16 at a time
+          for (std::size_t h = 0; h < 2; ++h)
+          {
+            __m256i sum[4][2];
+            for (std::size_t r = 0; r < 4; ++r)
+              sum[r][0] = sum[r][1] = _mm256_setzero_si256();
+            for (std::size_t p = 0; p < kc; p += 4)
+            {
+              __m256i y0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + p * 32 + h * 64));
+              __m256i y1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + p * 32 + h * 64 + 32));
+              for (std::size_t r = 0; r < 4; ++r)
+              {
+                __m256i x = _mm256_set1_epi32(load_group(a + r * lda + p));
+                if (Split)
+                {
+                  __m256i lo = _mm256_and_si256(x, nibble);
+                  __m256i hi = _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble);
+                  sum[r][0] = _mm256_add_epi32(sum[r][0], _mm256_add_epi32(
+                      _mm256_madd_epi16(_mm256_maddubs_epi16(hi, y0), sixteen),
+                      _mm256_madd_epi16(_mm256_maddubs_epi16(lo, y0), ones)));
+                  sum[r][1] = _mm256_add_epi32(sum[r][1], _mm256_add_epi32(
+                      _mm256_madd_epi16(_mm256_maddubs_epi16(hi, y1), sixteen),
+                      _mm256_madd_epi16(_mm256_maddubs_epi16(lo, y1), ones)));
+                }
+                else
+                {
+                  sum[r][0] = _mm256_add_epi32(sum[r][0], _mm256_madd_epi16(_mm256_maddubs_epi16(x, y0), ones));
+                  sum[r][1] = _mm256_add_epi32(sum[r][1], _mm256_madd_epi16(_mm256_maddubs_epi16(x, y1), ones));
+                }
+              }
+            }
+            for (std::size_t r = 0; r < 4; ++r)
+            {
+              add_lanes_avx2(sum[r][0], acc + r * ldacc + h * 16);
+              add_lanes_avx2(sum[r][1], acc + r * ldacc + h * 16 + 8);
+            }
+          }
+        }
+
+        /**
+         * Tiles of the products of matrices of numbers on 16 bits, of 2 rows and 16 columns, the panel holding the
+         * pairs of elements of the columns. @c a or @c b must not contain -32768, so that the sums of two products
+         * of vpmaddwd don't overflow. These sums are added on two int32 lanes, one for their 16 low bits and one for
+         * their 16 high bits, which don't overflow for the blocks of 1024 elements of the callers.
+         */
+        __attribute__((target("avx2")))
+        inline void gemm_tile_s16_avx2(const boost::int16_t* a, std::size_t lda, const boost::int16_t* b,
+            std::size_t kc, boost::int64_t* acc, std::size_t ldacc)
+        {
+          const __m256i low = _mm256_set1_epi32(0xffff);
+          __m256i sum_lo[2][2], sum_hi[2][2];
+          for (std::size_t r = 0; r < 2; ++r)
+            for (std::size_t v = 0; v < 2; ++v)
+              sum_lo[r][v] = sum_hi[r][v] = _mm256_setzero_si256();
+          for (std::size_t p = 0; p < kc; p += 2)
+          {
+            __m256i y[2];
+            y[0] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + p * 16));
+            y[1] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + p * 16 + 16));
+            for (std::size_t r = 0; r < 2; ++r)
+            {
+              __m256i x = _mm256_set1_epi32(load_group(a + r * lda + p));
+              for (std::size_t v = 0; v < 2; ++v)
+              {
+                __m256i m = _mm256_madd_epi16(x, y[v]);
+                sum_lo[r][v] = _mm256_add_epi32(sum_lo[r][v], _mm256_and_si256(m, low));
+                sum_hi[r][v] = _mm256_add_epi32(sum_hi[r][v], _mm256_srai_epi32(m, 16));
+              }
+            }
+          }
+          for (std::size_t r = 0; r < 2; ++r)
+            for (std::size_t v = 0; v < 2; ++v)
+            {
+              boost::int32_t lo[8], hi[8];
+              _mm256_storeu_si256(reinterpret_cast<__m256i*>(lo), sum_lo[r][v]);
+              _mm256_storeu_si256(reinterpret_cast<__m256i*>(hi), sum_hi[r][v]);
+              for (std::size_t c = 0; c < 8; ++c)
+                acc[r * ldacc + v * 8 + c] += boost::int64_t(hi[c]) * 65536 + lo[c];
+            }
+        }
+
+        /**
+         * Dot products of numbers on 8 bits: adds to <c>acc[c]</c> the dot product of @c a and of the row @c c of
+         * @c b, for @c c in <c>[0, 4)</c>. The rows of @c b are @c ld bytes apart and @c kc is a multiple of 64.
+         * The int32 lanes hold the sums of at most kc / 8 products, so they don't overflow for the blocks of 2048
+         * elements of the callers.
+         */
+        __attribute__((target("avx512f,avx512vnni")))
+        inline void dot_tile_u8s8_vnni(const boost::uint8_t* a, const boost::int8_t* b, std::size_t ld,
+            std::size_t kc, boost::int64_t* acc)
+        {
+          __m512i sum[4];
+          for (std::size_t c = 0; c < 4; ++c)
+            sum[c] = _mm512_setzero_si512();
+          for (std::size_t p = 0; p < kc; p += 64)
+          {
+            __m512i x = _mm512_loadu_si512(a + p);
+            for (std::size_t c = 0; c < 4; ++c)
+              sum[c] = _mm512_dpbusd_epi32(sum[c], x, _mm512_loadu_si512(b + c * ld + p));
+          }
+          for (std::size_t c = 0; c < 4; ++c)
+          {
+            boost::int32_t lanes[16];
+            _mm512_storeu_si512(lanes, sum[c]);
+            boost::int32_t s = 0;
+            for (std::size_t l = 0; l < 16; ++l)
+              s += lanes[l];
+            acc[c] += s;
+          }
+        }
+
+        /**
+         * As dot_tile_u8s8_vnni, with vpmaddubsw, splitting the elements of @c a as gemm_tile_u8s8_avx2<true> does,
+         * so that @c b needn't be scanned for its range. @c kc is a multiple of 32.
+         */
+        __attribute__((target("avx2")))
+        inline void dot_tile_u8s8_avx2(const boost::uint8_t* a, const boost::int8_t* b, std::size_t ld,
+            std::size_t kc, boost::int64_t* acc)
+        {
+          const __m256i ones = _mm256_set1_epi16(1);
+          const __m256i sixteen = _mm256_set1_epi16(16);
+          const __m256i nibble = _mm256_set1_epi8(0x0f);
+          __m256i sum[4];
+          for (std::size_t c = 0; c < 4; ++c)
+            sum[c] = _mm256_setzero_si256();
+          for (std::size_t p = 0; p < kc; p += 32)
+          {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + p));
+            __m256i lo = _mm256_and_si256(x, nibble);
+            __m256i hi = _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble);
+            for (std::size_t c = 0; c < 4; ++c)
+            {
+              __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + c * ld + p));
+              sum[c] = _mm256_add_epi32(sum[c], _mm256_add_epi32(
+                  _mm256_madd_epi16(_mm256_maddubs_epi16(hi, y), sixteen),
+                  _mm256_madd_epi16(_mm256_maddubs_epi16(lo, y), ones)));
+            }
+          }
+          for (std::size_t c = 0; c < 4; ++c)
+          {
+            __m128i t = _mm_add_epi32(_mm256_castsi256_si128(sum[c]), _mm256_extracti128_si256(sum[c], 1));
+            t = _mm_add_epi32(t, _mm_shuffle_epi32(t, 0x4e));
+            t = _mm_add_epi32(t, _mm_shuffle_epi32(t, 0xb1));
+            acc[c] += _mm_cvtsi128_si32(t);
+          }
+        }
+
+        //! As dot_tile_u8s8_vnni, on numbers on 16 bits, as gemm_tile_s16_avx2 does. @c kc is a multiple of 16.
+        __attribute__((target("avx2")))
+        inline void dot_tile_s16_avx2(const boost::int16_t* a, const boost::int16_t* b, std::size_t ld,
+            std::size_t kc, boost::int64_t* acc)
+        {
+          const __m256i low = _mm256_set1_epi32(0xffff);
+          __m256i sum_lo[4], sum_hi[4];
+          for (std::size_t c = 0; c < 4; ++c)
+            sum_lo[c] = sum_hi[c] = _mm256_setzero_si256();
+          for (std::size_t p = 0; p < kc; p += 16)
+          {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + p));
+            for (std::size_t c = 0; c < 4; ++c)
+            {
+              __m256i m = _mm256_madd_epi16(x, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + c * ld + p)));
+              sum_lo[c] = _mm256_add_epi32(sum_lo[c], _mm256_and_si256(m, low));
+              sum_hi[c] = _mm256_add_epi32(sum_hi[c], _mm256_srai_epi32(m, 16));
+            }
+          }
+          for (std::size_t c = 0; c < 4; ++c)
+          {
+            boost::int32_t lo[8], hi[8];
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(lo), sum_lo[c]);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(hi), sum_hi[c]);
+            for (std::size_t l = 0; l < 8; ++l)
+              acc[c] += boost::int64_t(hi[l]) * 65536 + lo[l];
+          }
+        }
+      }
+    }
+#endif
+
+    namespace batch
+    {
+      //! The order in which the elements of a matrix are stored.
+      enum layout
+      {
+        row_major, column_major
+      };
+
+      namespace detail
+      {
+        //! The rows and the columns of the blocks of the products of matrices.
+        BOOST_STATIC_CONSTEXPR std::size_t gemm_mc = 64;
+        BOOST_STATIC_CONSTEXPR std::size_t gemm_nc = 128;
+
+        //! Whether @c T is a fixed point stored on 8 bits.
+        template <typename T>
+        struct is_8_bits
+        {
+          BOOST_STATIC_CONSTEXPR bool value = sizeof(T) == 1 && sizeof(typename T::underlying_type) == 1;
+        };
+        //! Whether @c T is a @c real_t stored on an int16.
+        template <typename T>
+        struct is_int16
+        {
+          BOOST_STATIC_CONSTEXPR bool value = T::is_signed && sizeof(T) == 2
+              && sizeof(typename T::underlying_type) == 2;
+        };
+
+        /**
+         * The tile of MR x NR results of the products of matrices, as the SIMD tiles do, the panel @c b holding the
+         * groups of @c G elements of its columns one after the other. The products are added on @c S.
+         */
+        template <std::size_t MR, std::size_t NR, std::size_t G, typename P, typename S, typename W, typename A,
+            typename B>
+        void gemm_tile(const A* a, std::size_t lda, const B* b, std::size_t kc, W* acc, std::size_t ldacc)
+        {
+          S sum[MR][NR];
+          for (std::size_t r = 0; r < MR; ++r)
+            for (std::size_t c = 0; c < NR; ++c)
+              sum[r][c] = 0;
+          for (std::size_t p = 0; p < kc; p += G)
+            for (std::size_t r = 0; r < MR; ++r)
+              for (std::size_t g = 0; g < G; ++g)
+              {
+                P x = P(a[r * lda + p + g]);
+                for (std::size_t c = 0; c < NR; ++c)
+                  sum[r][c] += S(x * P(b[p * NR + c * G + g]));
+              }
+          for (std::size_t r = 0; r < MR; ++r)
+            for (std::size_t c = 0; c < NR; ++c)
+              acc[r * ldacc + c] += W(sum[r][c]);
+        }
+
+        //! The dot products of @c a and of 4 rows of @c b, as the SIMD tiles do. The products are added on @c S.
+        template <typename P, typename S, typename W, typename A, typename B>
+        void dot_tile(const A* a, const B* b, std::size_t ld, std::size_t kc, W* acc)
+        {
+          for (std::size_t c = 0; c < 4; ++c)
+          {
+            S sum = 0;
+            for (std::size_t p = 0; p < kc; ++p)
+              sum += S(P(a[p]) * P(b[c * ld + p]));
+            acc[c] += W(sum);
+          }
+        }
+
+        /**
+         * gemm_scheme<T1, T2> defines how the operands are packed and which tiles compute their products:
+         * - @c a_type and @c b_type, the packed types, @c acc_type, the accumulator,
+         * - @c mr x @c nr, the results of a tile of the products of matrices, <c>group()</c>, the elements of a
+         *   column that are contiguous in a panel for the active instruction set, @c dot_step, the multiple of which
+         *   the rows of the dot products are made, and @c kc, the elements of the blocks, a multiple of both,
+         * - @c a_bias and @c b_bias: the packed numbers are <c>a + a_bias</c> and <c>b - b_bias</c>,
+         * - <c>pack_a::apply(x)</c> and <c>pack_b::apply(x)</c>,
+         * - <c>gemm_tile(pa, pb)</c>, the tile for the packed operands, and <c>dot_tile(x, k, a, n)</c>, the tile for
+         *   the @c k elements of the vector and the @c n elements of the matrix.
+         *
+         * The generic scheme packs the indices and uses the scalar tiles.
+         */
+        template <typename T1, typename T2, int Kind = is_8_bits<T1>::value && is_8_bits<T2>::value ? 1
+            : is_int16<T1>::value && is_int16<T2>::value ? 2 : 0>
+        struct gemm_scheme
+        {
+          typedef typename T1::underlying_type a_type;
+          typedef typename T2::underlying_type b_type;
+          typedef typename dot_result<T1, T2>::type::underlying_type acc_type;
+          typedef typename multiply_result<T1, T2>::type::underlying_type product_type;
+          BOOST_STATIC_CONSTEXPR std::size_t mr = 4;
+          BOOST_STATIC_CONSTEXPR std::size_t nr = 8;
+          BOOST_STATIC_CONSTEXPR std::size_t dot_step = 1;
+          BOOST_STATIC_CONSTEXPR std::size_t kc = 1024;
+          BOOST_STATIC_CONSTEXPR int a_bias = 0;
+          BOOST_STATIC_CONSTEXPR int b_bias = 0;
+
+          struct pack_a
+          {
+            static a_type apply(T1 const& x)
+            {
+              return x.count();
+            }
+          };
+          struct pack_b
+          {
+            static b_type apply(T2 const& x)
+            {
+              return x.count();
+            }
+          };
+
+          static std::size_t group()
+          {
+            return 1;
+          }
+          typedef void (*gemm_tile_type)(const a_type*, std::size_t, const b_type*, std::size_t, acc_type*,
+              std::size_t);
+          static gemm_tile_type gemm_tile(std::vector<a_type> const&, std::vector<b_type> const&)
+          {
+            return &detail::gemm_tile<mr, nr, 1, product_type, acc_type, acc_type, a_type, b_type>;
+          }
+          typedef void (*dot_tile_type)(const a_type*, const b_type*, std::size_t, std::size_t, acc_type*);
+          static dot_tile_type dot_tile(const a_type*, std::size_t, const b_type*, std::size_t)
+          {
+            return &detail::dot_tile<product_type, acc_type, acc_type, a_type, b_type>;
+          }
+        };
+
+        /**
+         * The numbers on 8 bits are packed as unsigned numbers for the first operand and as signed numbers for the
+         * second one, as vpmaddubsw and vpdpbusd expect, shifting them by 128 when needed. The products are added on
+         * int32 within a block of 2048 elements.
+         */
+        template <typename T1, typename T2>
+        struct gemm_scheme<T1, T2, 1>
+        {
+          typedef boost::uint8_t a_type;
+          typedef boost::int8_t b_type;
+          typedef boost::int64_t acc_type;
+          typedef boost::int32_t product_type;
+          BOOST_STATIC_CONSTEXPR std::size_t mr = 4;
+          BOOST_STATIC_CONSTEXPR std::size_t nr = 32;
+          BOOST_STATIC_CONSTEXPR std::size_t dot_step = 64;
+          BOOST_STATIC_CONSTEXPR std::size_t kc = 2048;
+          BOOST_STATIC_CONSTEXPR int a_bias = T1::is_signed ? 128 : 0;
+          BOOST_STATIC_CONSTEXPR int b_bias = T2::is_signed ? 0 : 128;
+
+          struct pack_a
+          {
+            static a_type apply(T1 const& x)
+            {
+              return a_type(int(x.count()) + a_bias);
+            }
+          };
+          struct pack_b
+          {
+            static b_type apply(T2 const& x)
+            {
+              return b_type(int(x.count()) - b_bias);
+            }
+          };
+
+          //! Whether the sums of two products of vpmaddubsw can't saturate.
+          static bool narrow(const b_type* b, std::size_t n)
+          {
+            bool res = true;
+            for (std::size_t i = 0; i < n; ++i)
+              res &= b[i] >= -64 && b[i] <= 64;
+            return res;
+          }
+
+          //! The SIMD tiles broadcast groups of 4 elements; the scalar tile reads a single column at a time.
+          static std::size_t group()
+          {
+#if defined(BOOST_FIXED_POINT_SIMD_X86)
+            return simd::active() >= simd::avx2 ? 4 : 1;
+#else
+            return 1;
+#endif
+          }
+          typedef void (*gemm_tile_type)(const a_type*, std::size_t, const b_type*, std::size_t, acc_type*,
+              std::size_t);
+          static gemm_tile_type gemm_tile(std::vector<a_type> const&, std::vector<b_type> const& pb)
+          {
+#if defined(BOOST_FIXED_POINT_SIMD_X86)
+            if (simd::active() >= simd::avx512 && simd::detail::vnni_supported())
+              return &simd::detail::gemm_tile_u8s8_vnni;
+            if (simd::active() >= simd::avx2)
+              return narrow(&pb[0], pb.size()) ? &simd::detail::gemm_tile_u8s8_avx2<false>
+                  : &simd::detail::gemm_tile_u8s8_avx2<true>;
+#else
+            (void)pb;
+#endif
+            return &detail::gemm_tile<mr, nr, 1, boost::int32_t, boost::int32_t, acc_type, a_type, b_type>;
+          }
+          typedef void (*dot_tile_type)(const a_type*, const b_type*, std::size_t, std::size_t, acc_type*);
+          static dot_tile_type dot_tile(const a_type*, std::size_t, const b_type*, std::size_t)
+          {
+#if defined(BOOST_FIXED_POINT_SIMD_X86)
+            if (simd::active() >= simd::avx512 && simd::detail::vnni_supported())
+              return &simd::detail::dot_tile_u8s8_vnni;
+            if (simd::active() >= simd::avx2)
+              return &simd::detail::dot_tile_u8s8_avx2;
+#endif
+            return &detail::dot_tile<boost::int32_t, boost::int32_t, acc_type, a_type, b_type>;
+          }
+        };
+
+        /**
+         * The numbers on 16 bits are packed as they are. The products are added on int64, unless a SIMD tile adds
+         * them on two int32, within a block of 1024 elements.
+         */
+        template <typename T1, typename T2>
+        struct gemm_scheme<T1, T2, 2>
+        {
+          typedef boost::int16_t a_type;
+          typedef boost::int16_t b_type;
+          typedef boost::int64_t acc_type;
+          typedef boost::int32_t product_type;
+          BOOST_STATIC_CONSTEXPR std::size_t mr = 2;
+          BOOST_STATIC_CONSTEXPR std::size_t nr = 16;
+          BOOST_STATIC_CONSTEXPR std::size_t dot_step = 16;
+          BOOST_STATIC_CONSTEXPR std::size_t kc = 1024;
+          BOOST_STATIC_CONSTEXPR int a_bias = 0;
+          BOOST_STATIC_CONSTEXPR int b_bias = 0;
+
+          struct pack_a
+          {
+            static a_type apply(T1 const& x)
+            {
+              return x.count();
+            }
+          };
+          struct pack_b
+          {
+            static b_type apply(T2 const& x)
+            {
+              return x.count();
+            }
+          };
+
+          //! Whether the sums of two products of vpmaddwd can't overflow.
+          static bool narrow(const a_type* a, std::size_t na, const b_type* b, std::size_t nb)
+          {
+            return std::find(a, a + na, -32768) == a + na || std::find(b, b + nb, -32768) == b + nb;
+          }
+
+          //! The tiles read the pairs of elements of the columns, as vpmaddwd does.
+          static std::size_t group()
+          {
+            return 2;
+          }
+          typedef void (*gemm_tile_type)(const a_type*, std::size_t, const b_type*, std::size_t, acc_type*,
+              std::size_t);
+          static gemm_tile_type gemm_tile(std::vector<a_type> const& pa, std::vector<b_type> const& pb)
+          {
+#if defined(BOOST_FIXED_POINT_SIMD_X86)
+            if (simd::active() >= simd::avx2 && narrow(&pa[0], pa.size(), &pb[0], pb.size()))
+              return &simd::detail::gemm_tile_s16_avx2;
+#else
+            (void)pa;
+            (void)pb;
+#endif
+            return &detail::gemm_tile<mr, nr, 2, boost::int32_t, boost::int64_t, acc_type, a_type, b_type>;
+          }
+          typedef void (*dot_tile_type)(const a_type*, const b_type*, std::size_t, std::size_t, acc_type*);
+          static dot_tile_type dot_tile(const a_type* x, std::size_t k, const b_type* a, std::size_t n)
+          {
+#if defined(BOOST_FIXED_POINT_SIMD_X86)
+            if (simd::active() >= simd::avx2 && narrow(x, k, a, n))
+              return &simd::detail::dot_tile_s16_avx2;
+#else
+            (void)x;
+            (void)k;
+            (void)a;
+            (void)n;
+#endif
+            return &detail::dot_tile<boost::int32_t, boost::int64_t, acc_type, a_type, b_type>;
+          }
+        };
+
+        inline std::size_t gemm_round_up(std::size_t n, std::size_t m)
+        {
+          return (n + m - 1) / m * m;
+        }
+
+        /**
+         * Packs the matrix @c p of @c rows x @c k elements, or of @c k x @c rows elements when the @c k elements of
+         * a row are not contiguous, in rows of @c ld elements padded with zeros, converted by @c F. @c sums receives
+         * the sums of the packed rows.
+         */
+        template <typename F, typename P, typename T, typename W>
+        void gemm_pack_rows(T const* p, bool contiguous, std::size_t rows, std::size_t k, std::size_t ld, P* res,
+            W* sums)
+        {
+          for (std::size_t r = 0; r < rows; ++r)
+          {
+            W s = 0;
+            for (std::size_t q = 0; q < k; ++q)
+            {
+              P v = F::apply(contiguous ? p[r * k + q] : p[q * rows + r]);
+              res[r * ld + q] = v;
+              s += W(v);
+            }
+            sums[r] = s;
+          }
+        }
+
+        /**
+         * As gemm_pack_rows, in panels of NR rows of @c ld elements, where the groups of G elements of each row
+         * follow each other.
+         */
+        template <std::size_t NR, std::size_t G, typename F, typename P, typename T, typename W>
+        void gemm_pack_panels(T const* p, bool contiguous, std::size_t rows, std::size_t k, std::size_t ld, P* res,
+            W* sums)
+        {
+          for (std::size_t r = 0; r < rows; ++r)
+          {
+            P* panel = res + r / NR * NR * ld + r % NR * G;
+            W s = 0;
+            for (std::size_t q = 0; q < k; ++q)
+            {
+              P v = F::apply(contiguous ? p[r * k + q] : p[q * rows + r]);
+              panel[q / G * NR * G + q % G] = v;
+              s += W(v);
+            }
+            sums[r] = s;
+          }
+        }
+
+        //! The dot product @c s of packed rows of sums @c sa and @c sb, without the biases of the packed numbers.
+        template <typename Scheme, typename W>
+        W gemm_unbias(W s, W sa, W sb, std::size_t k)
+        {
+          // a * b = (u - a_bias) * (v + b_bias), where u and v are the packed numbers
+          if (Scheme::a_bias != 0 || Scheme::b_bias != 0)
+            s += W(Scheme::b_bias) * sa - W(Scheme::a_bias) * sb - W(Scheme::a_bias) * W(Scheme::b_bias) * W(k);
+          return s;
+        }
+
+        /**
+         * <c>y[i] = number_cast<To>(RT(dot(row i of a, x)))</c>, where the rows of @c a are contiguous when
+         * @c a_rows. The vector is the first operand of the tiles. The contiguous rows of a matrix whose numbers
+         * are packed as they are stored are used in place.
+         */
+        template <typename RT, typename To, typename TA, typename TX>
+        void gemv(TA const* a, bool a_rows, TX const* x, To* y, std::size_t m, std::size_t k)
+        {
+          typedef gemm_scheme<TX, TA> scheme;
+          typedef typename scheme::a_type X;
+          typedef typename scheme::b_type A;
+          typedef typename scheme::acc_type W;
+          typedef typename scheme::product_type P;
+          const std::size_t step = scheme::dot_step, kc = scheme::kc;
+          BOOST_STATIC_ASSERT(scheme::kc % scheme::dot_step == 0);
+          check_reduce_size(k);
+          if (m == 0) return;
+
+          std::vector<X> px(k + 1);
+          std::vector<W> x_sum(1), a_sums(m, W(0));
+          gemm_pack_rows<typename scheme::pack_a>(x, true, 1, k, k, &px[0], &x_sum[0]);
+          std::vector<A> packed;
+          const A* pa;
+          if (a_rows && scheme::b_bias == 0 && sizeof(TA) == sizeof(A))
+          {
+            pa = reinterpret_cast<const A*>(a);
+            if (scheme::a_bias != 0)
+              for (std::size_t i = 0; i < m; ++i)
+                for (std::size_t p = 0; p < k; ++p)
+                  a_sums[i] += W(pa[i * k + p]);
+          }
+          else
+          {
+            packed.resize(m * k + 1);
+            gemm_pack_rows<typename scheme::pack_b>(a, a_rows, m, k, k, &packed[0], &a_sums[0]);
+            pa = &packed[0];
+          }
+          typename scheme::dot_tile_type tile = scheme::dot_tile(&px[0], k, pa, m * k);
+
+          // the tiles on the first rows and columns, then the last columns and the last rows
+          const std::size_t kk = k / step * step, mm = m / 4 * 4;
+          std::vector<W> acc(m, W(0));
+          for (std::size_t pc = 0; pc < kk; pc += kc)
+          {
+            const std::size_t kb = std::min(kc, kk - pc);
+            for (std::size_t i = 0; i < mm; i += 4)
+              tile(&px[pc], pa + i * k + pc, k, kb, &acc[i]);
+          }
+          for (std::size_t i = 0; i < m; ++i)
+            for (std::size_t p = i < mm ? kk : 0; p < k; ++p)
+              acc[i] += W(P(px[p]) * P(pa[i * k + p]));
+          for (std::size_t i = 0; i < m; ++i)
+            y[i] = fixed_point::number_cast<To>(RT(index(gemm_unbias<scheme>(acc[i], x_sum[0], a_sums[i], k))));
+        }
+
+        /**
+         * <c>c[i * n + j] = number_cast<To>(dot(row i of a, column j of b))</c>, where the rows of @c a are contiguous
+         * when @c a_rows and the columns of @c b are contiguous when @c b_columns.
+         */
+        template <typename To, typename T1, typename T2>
+        void gemm(T1 const* a, bool a_rows, T2 const* b, bool b_columns, To* c, std::size_t m, std::size_t n,
+            std::size_t k)
+        {
+          typedef gemm_scheme<T1, T2> scheme;
+          typedef typename scheme::a_type A;
+          typedef typename scheme::b_type B;
+          typedef typename scheme::acc_type W;
+          typedef typename dot_result<T1, T2>::type RT;
+          const std::size_t mr = scheme::mr, nr = scheme::nr, kc = scheme::kc;
+          BOOST_STATIC_ASSERT(gemm_mc % scheme::mr == 0 && gemm_nc % scheme::nr == 0);
+          check_reduce_size(k);
+          if (m == 0 || n == 0) return;
+          if (n == 1)
+          {
+            // the product of a and of the column b: the dot products of the rows of a and of b
+            detail::gemv<RT>(a, a_rows, b, c, m, k);
+            return;
+          }
+
+          const std::size_t group = scheme::group();
+          const std::size_t ld = gemm_round_up(k == 0 ? 1 : k, group);
+          const std::size_t mp = gemm_round_up(m, mr);
+          const std::size_t np = gemm_round_up(n, nr);
+          std::vector<A> pa(mp * ld, A(0));
+          std::vector<B> pb(np * ld, B(0));
+          std::vector<W> a_sums(mp, W(0)), b_sums(np, W(0));
+          gemm_pack_rows<typename scheme::pack_a>(a, a_rows, m, k, ld, &pa[0], &a_sums[0]);
+          typedef typename scheme::pack_b pack_b;
+          (group == 4 ? &gemm_pack_panels<scheme::nr, 4, pack_b, B, T2, W>
+              : group == 2 ? &gemm_pack_panels<scheme::nr, 2, pack_b, B, T2, W>
+              : &gemm_pack_panels<scheme::nr, 1, pack_b, B, T2, W>)(b, b_columns, n, k, ld, &pb[0], &b_sums[0]);
+          typename scheme::gemm_tile_type tile = scheme::gemm_tile(pa, pb);
+
+          // the dot products of a block of columns, for all the rows
+          const std::size_t nc = std::min(std::size_t(gemm_nc), np);
+          std::vector<W> acc(mp * nc);
+          for (std::size_t jc = 0; jc < np; jc += nc)
+          {
+            const std::size_t nb = std::min(nc, np - jc);
+            std::fill(acc.begin(), acc.end(), W(0));
+            for (std::size_t pc = 0; pc < ld; pc += kc)
+            {
+              const std::size_t kb = std::min(kc, ld - pc);
+              for (std::size_t ic = 0; ic < mp; ic += gemm_mc)
+              {
+                const std::size_t ie = std::min(ic + gemm_mc, mp);
+                for (std::size_t jr = 0; jr < nb; jr += nr)
+                  for (std::size_t ir = ic; ir < ie; ir += mr)
+                    tile(&pa[ir * ld + pc], ld, &pb[(jc + jr) * ld + pc * nr], kb, &acc[ir * nc + jr], nc);
+              }
+            }
+            for (std::size_t i = 0; i < m; ++i)
+              for (std::size_t j = jc; j < jc + nb && j < n; ++j)
+                c[i * n + j] = fixed_point::number_cast<To>(RT(index(
+                    gemm_unbias<scheme>(acc[i * nc + j - jc], a_sums[i], b_sums[j], k))));
+          }
+        }
+      }
+
+      /**
+       * Product of the matrices @c a, of @c m x @c k elements, and @c b, of @c k x @c n elements.
+       *
+       * @Requires @c a and @c b point to their elements stored in the order @c la and @c lb, @c c points to
+       * <c>m * n</c> elements, and @c k is at most 2^32.
+       * @Effects <c>c[i * n + j] = number_cast<To>(dot(a_i, b_j))</c> for every @c i in <c>[0, m)</c> and @c j in
+       * <c>[0, n)</c>, where @c a_i is the row @c i of @c a, @c b_j the column @c j of @c b and @c dot is the exact
+       * dot product of batch::dot. @c c is stored in row major order.
+       *
+       * @Example
+       * @code
+       * // a layer of a quantized network: the activations in [0, 1) and the weights in [-1, 1), on 8 bits.
+       * typedef ureal_t<0, -8> activation;
+       * typedef real_t<0, -7> weight;
+       * typedef real_t<7, -8, round::nearest_even, overflow::saturate> output;
+       * batch::gemm(&x[0], batch::row_major, &w[0], batch::column_major, &y[0], batch_size, outputs, inputs);
+       * @endcode
+       */
+      template <typename To, typename T1, typename T2>
+      void gemm(T1 const* a, layout la, T2 const* b, layout lb, To* c, std::size_t m, std::size_t n, std::size_t k)
+      {
+        detail::gemm(a, la == row_major, b, lb == column_major, c, m, n, k);
+      }
+
+      /**
+       * Product of the matrix @c a, of @c m x @c k elements, and of the vector @c x, of @c k elements.
+       *
+       * @Requires @c a points to its elements stored in the order @c la, @c x to @c k elements, @c y to @c m
+       * elements, and @c k is at most 2^32.
+       * @Effects <c>y[i] = number_cast<To>(dot(a_i, x))</c> for every @c i in <c>[0, m)</c>, where @c a_i is the row
+       * @c i of @c a and @c dot is the exact dot product of batch::dot.
+       */
+      template <typename To, typename T1, typename T2>
+      void gemv(T1 const* a, layout la, T2 const* x, To* y, std::size_t m, std::size_t k)
+      {
+        detail::gemv<typename dot_result<T1, T2>::type>(a, la == row_major, x, y, m, k);
+      }
+    }
+  }
+}
+
+#endif // header
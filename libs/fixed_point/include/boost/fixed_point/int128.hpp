@@ -0,0 +1,568 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Vicente J. Botet Escriba 2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/fixed_point for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file
+ * @brief Defines 128 bits integers stored on two 64 bits limbs, for the compilers without a builtin 128 bits integer.
+ *
+ */
+
+#ifndef BOOST_FIXED_POINT_INT128_HPP
+#define BOOST_FIXED_POINT_INT128_HPP
+
+#include <boost/fixed_point/number.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/assert.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <boost/type_traits/integral_constant.hpp>
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/type_traits/is_signed.hpp>
+#include <limits>
+
+namespace boost
+{
+  namespace fixed_point
+  {
+    template <bool Signed>
+    class integer128;
+
+    //! Signed 128 bits integer.
+    typedef integer128<true> int128;
+    //! Unsigned 128 bits integer.
+    typedef integer128<false> uint128;
+
+    namespace detail
+    {
+      /**
+       * Low half of the product of two boost::uint64_t, the high half being stored in @c hi.
+       */
+      inline boost::uint64_t multiply_64x64(boost::uint64_t a, boost::uint64_t b, boost::uint64_t& hi)
+      {
+#if defined(BOOST_FIXED_POINT_HAS_INT128)
+        boost::uint128_type p = boost::uint128_type(a) * b;
+        hi = boost::uint64_t(p >> 64);
+        return boost::uint64_t(p);
+#else
+        const boost::uint64_t mask = 0xFFFFFFFFu;
+        boost::uint64_t a_lo = a & mask, a_hi = a >> 32;
+        boost::uint64_t b_lo = b & mask, b_hi = b >> 32;
+        boost::uint64_t lo_lo = a_lo * b_lo;
+        boost::uint64_t hi_lo = a_hi * b_lo;
+        boost::uint64_t lo_hi = a_lo * b_hi;
+        boost::uint64_t cross = (lo_lo >> 32) + (hi_lo & mask) + lo_hi;
+        hi = a_hi * b_hi + (hi_lo >> 32) + (cross >> 32);
+        return (cross << 32) | (lo_lo & mask);
+#endif
+      }
+
+      /**
+       * high_limb<I>::apply(v) is the high limb of the 128 bits value of the integer @c v: its sign extension when
+       * @c I has at most 64 bits.
+       */
+      template <typename I, int Kind = (sizeof(I) > 8) ? 2 : is_signed<I>::value ? 1 : 0>
+      struct high_limb
+      {
+        static boost::uint64_t apply(I)
+        {
+          return 0;
+        }
+      };
+      template <typename I>
+      struct high_limb<I, 1>
+      {
+        static boost::uint64_t apply(I v)
+        {
+          return boost::uint64_t(boost::int64_t(v) >> 63);
+        }
+      };
+      template <typename I>
+      struct high_limb<I, 2>
+      {
+        static boost::uint64_t apply(I v)
+        {
+          return boost::uint64_t(v >> 64);
+        }
+      };
+
+      //! The builtin integer @c I with the low bits of the value whose limbs are @c hi and @c lo.
+      template <typename I, bool Wide = (sizeof(I) > 8)>
+      struct from_limbs
+      {
+        static I apply(boost::uint64_t, boost::uint64_t lo)
+        {
+          return I(lo);
+        }
+      };
+      template <typename I>
+      struct from_limbs<I, true>
+      {
+        static I apply(boost::uint64_t hi, boost::uint64_t lo)
+        {
+          return I((I(hi) << 64) | I(lo));
+        }
+      };
+    }
+
+    /**
+     * @brief 128 bits integer in two's complement, stored on two 64 bits limbs.
+     *
+     * It is the underlying integer of the accumulators whose sums need more than 64 bits when the compiler provides no
+     * 128 bits integer, and the type on which the exact sums of financial amounts can be kept on every platform.
+     * The additions and subtractions propagate the carry from the low limb to the high one, the products are built
+     * from 64x64->128 multiplications, which use the builtin 128 bits integer when there is one, and the divisions
+     * are done one bit at a time.
+     *
+     * The arithmetic wraps modulo 2^128 as the one of the unsigned builtin integers, also when @c Signed is true.
+     *
+     * @TParams
+     * @Param{Signed,whether the integer is signed}
+     *
+     * @Example
+     * @code
+     * int128 x = wide_multiply(boost::int64_t(-3), boost::int64_t(1) << 62);
+     * x += 1;
+     * x >>= 60; // -12
+     * @endcode
+     */
+    template <bool Signed>
+    class integer128
+    {
+    public:
+      /**
+       * @Effects constructs a 0.
+       */
+      integer128() :
+        lo_(0), hi_(0)
+      {
+      }
+
+      /**
+       * @Effects constructs the 128 bits value of the builtin integer @c v, sign extended when @c v is signed.
+       */
+      template <typename I>
+      integer128(I v, typename enable_if<is_integral<I> >::type* = 0) :
+        lo_(boost::uint64_t(v)), hi_(detail::high_limb<I>::apply(v))
+      {
+      }
+
+      /**
+       * @Effects constructs the value with the same bits as @c x.
+       */
+      explicit integer128(integer128<!Signed> const& x) :
+        lo_(x.low()), hi_(x.high())
+      {
+      }
+
+      /**
+       * @Returns the value whose high limb is @c hi and low limb is @c lo.
+       */
+      static integer128 from_limbs(boost::uint64_t hi, boost::uint64_t lo)
+      {
+        integer128 res;
+        res.hi_ = hi;
+        res.lo_ = lo;
+        return res;
+      }
+
+      //! @Returns the low 64 bits.
+      boost::uint64_t low() const
+      {
+        return lo_;
+      }
+      //! @Returns the high 64 bits.
+      boost::uint64_t high() const
+      {
+        return hi_;
+      }
+
+      /**
+       * @Returns the builtin integer @c I with the low bits of the value.
+       */
+      template <typename I>
+      I convert_to() const
+      {
+        return detail::from_limbs<I>::apply(hi_, lo_);
+      }
+
+      /**
+       * @Returns the nearest double to the value.
+       */
+      double as_double() const
+      {
+        const double two_64 = 18446744073709551616.0;
+        if (Signed && is_negative())
+        {
+          integer128 m = -*this;
+          return -(double(m.hi_) * two_64 + double(m.lo_));
+        }
+        return double(hi_) * two_64 + double(lo_);
+      }
+
+      integer128& operator+=(integer128 const& rhs)
+      {
+        boost::uint64_t lo = lo_ + rhs.lo_;
+        hi_ += rhs.hi_ + (lo < lo_);
+        lo_ = lo;
+        return *this;
+      }
+      integer128& operator-=(integer128 const& rhs)
+      {
+        boost::uint64_t lo = lo_ - rhs.lo_;
+        hi_ -= rhs.hi_ + (lo_ < rhs.lo_);
+        lo_ = lo;
+        return *this;
+      }
+      //! The low 128 bits of the product.
+      integer128& operator*=(integer128 const& rhs)
+      {
+        boost::uint64_t hi;
+        boost::uint64_t lo = detail::multiply_64x64(lo_, rhs.lo_, hi);
+        hi_ = hi + lo_ * rhs.hi_ + hi_ * rhs.lo_;
+        lo_ = lo;
+        return *this;
+      }
+      /**
+       * The quotient truncated toward zero.
+       * @Requires @c rhs is not 0.
+       */
+      integer128& operator/=(integer128 const& rhs)
+      {
+        integer128 r;
+        divide(*this, rhs, *this, r);
+        return *this;
+      }
+      /**
+       * The remainder, with the sign of the dividend.
+       * @Requires @c rhs is not 0.
+       */
+      integer128& operator%=(integer128 const& rhs)
+      {
+        integer128 q;
+        divide(*this, rhs, q, *this);
+        return *this;
+      }
+      integer128& operator&=(integer128 const& rhs)
+      {
+        lo_ &= rhs.lo_;
+        hi_ &= rhs.hi_;
+        return *this;
+      }
+      integer128& operator|=(integer128 const& rhs)
+      {
+        lo_ |= rhs.lo_;
+        hi_ |= rhs.hi_;
+        return *this;
+      }
+      integer128& operator^=(integer128 const& rhs)
+      {
+        lo_ ^= rhs.lo_;
+        hi_ ^= rhs.hi_;
+        return *this;
+      }
+      /**
+       * @Requires <c>0 <= n < 128</c>.
+       */
+      integer128& operator<<=(int n)
+      {
+        BOOST_ASSERT(n >= 0 && n < 128);
+        if (n >= 64)
+        {
+          hi_ = lo_ << (n - 64);
+          lo_ = 0;
+        }
+        else if (n > 0)
+        {
+          hi_ = (hi_ << n) | (lo_ >> (64 - n));
+          lo_ <<= n;
+        }
+        return *this;
+      }
+      /**
+       * Arithmetic shift when @c Signed is true, logical one otherwise.
+       * @Requires <c>0 <= n < 128</c>.
+       */
+      integer128& operator>>=(int n)
+      {
+        BOOST_ASSERT(n >= 0 && n < 128);
+        const boost::uint64_t fill = Signed ? boost::uint64_t(boost::int64_t(hi_) >> 63) : 0;
+        if (n >= 64)
+        {
+          lo_ = Signed ? boost::uint64_t(boost::int64_t(hi_) >> (n - 64)) : hi_ >> (n - 64);
+          hi_ = fill;
+        }
+        else if (n > 0)
+        {
+          lo_ = (lo_ >> n) | (hi_ << (64 - n));
+          hi_ = Signed ? boost::uint64_t(boost::int64_t(hi_) >> n) : hi_ >> n;
+        }
+        return *this;
+      }
+
+      integer128 operator+() const
+      {
+        return *this;
+      }
+      integer128 operator-() const
+      {
+        return from_limbs(~hi_ + (lo_ == 0), ~lo_ + 1);
+      }
+      integer128 operator~() const
+      {
+        return from_limbs(~hi_, ~lo_);
+      }
+
+      friend integer128 operator+(integer128 lhs, integer128 const& rhs)
+      {
+        return lhs += rhs;
+      }
+      friend integer128 operator-(integer128 lhs, integer128 const& rhs)
+      {
+        return lhs -= rhs;
+      }
+      friend integer128 operator*(integer128 lhs, integer128 const& rhs)
+      {
+        return lhs *= rhs;
+      }
+      friend integer128 operator/(integer128 lhs, integer128 const& rhs)
+      {
+        return lhs /= rhs;
+      }
+      friend integer128 operator%(integer128 lhs, integer128 const& rhs)
+      {
+        return lhs %= rhs;
+      }
+      friend integer128 operator&(integer128 lhs, integer128 const& rhs)
+      {
+        return lhs &= rhs;
+      }
+      friend integer128 operator|(integer128 lhs, integer128 const& rhs)
+      {
+        return lhs |= rhs;
+      }
+      friend integer128 operator^(integer128 lhs, integer128 const& rhs)
+      {
+        return lhs ^= rhs;
+      }
+      friend integer128 operator<<(integer128 lhs, int n)
+      {
+        return lhs <<= n;
+      }
+      friend integer128 operator>>(integer128 lhs, int n)
+      {
+        return lhs >>= n;
+      }
+
+      friend bool operator==(integer128 const& lhs, integer128 const& rhs)
+      {
+        return lhs.lo_ == rhs.lo_ && lhs.hi_ == rhs.hi_;
+      }
+      friend bool operator!=(integer128 const& lhs, integer128 const& rhs)
+      {
+        return !(lhs == rhs);
+      }
+      friend bool operator<(integer128 const& lhs, integer128 const& rhs)
+      {
+        if (lhs.hi_ != rhs.hi_)
+          return Signed ? boost::int64_t(lhs.hi_) < boost::int64_t(rhs.hi_) : lhs.hi_ < rhs.hi_;
+        return lhs.lo_ < rhs.lo_;
+      }
+      friend bool operator>(integer128 const& lhs, integer128 const& rhs)
+      {
+        return rhs < lhs;
+      }
+      friend bool operator<=(integer128 const& lhs, integer128 const& rhs)
+      {
+        return !(rhs < lhs);
+      }
+      friend bool operator>=(integer128 const& lhs, integer128 const& rhs)
+      {
+        return !(lhs < rhs);
+      }
+
+    private:
+      bool is_negative() const
+      {
+        return (hi_ >> 63) != 0;
+      }
+
+      // Long division of the magnitudes, one bit of the quotient at a time.
+      static void divide(integer128 const& n, integer128 const& d, integer128& q, integer128& r)
+      {
+        BOOST_ASSERT(d != 0);
+        const bool nn = Signed && n.is_negative(), dn = Signed && d.is_negative();
+        uint128 un(nn ? -n : n), ud(dn ? -d : d), uq, ur;
+        for (int i = 127; i >= 0; --i)
+        {
+          ur <<= 1;
+          ur |= (un >> i) & 1;
+          uq <<= 1;
+          if (ur >= ud)
+          {
+            ur -= ud;
+            uq |= 1;
+          }
+        }
+        q = integer128(uq);
+        r = integer128(ur);
+        if (nn != dn) q = -q;
+        if (nn) r = -r;
+      }
+
+      boost::uint64_t lo_;
+      boost::uint64_t hi_;
+    };
+
+    /**
+     * @Returns the exact product of @c a and @c b.
+     */
+    inline uint128 wide_multiply(boost::uint64_t a, boost::uint64_t b)
+    {
+      boost::uint64_t hi;
+      boost::uint64_t lo = detail::multiply_64x64(a, b, hi);
+      return uint128::from_limbs(hi, lo);
+    }
+    /**
+     * @Returns the exact product of @c a and @c b.
+     *
+     * The unsigned product of the bits of @c a and @c b is corrected on its high limb, by subtracting @c b when @c a
+     * is negative and @c a when @c b is negative.
+     */
+    inline int128 wide_multiply(boost::int64_t a, boost::int64_t b)
+    {
+      boost::uint64_t hi;
+      boost::uint64_t lo = detail::multiply_64x64(boost::uint64_t(a), boost::uint64_t(b), hi);
+      hi -= (a < 0 ? boost::uint64_t(b) : 0) + (b < 0 ? boost::uint64_t(a) : 0);
+      return int128::from_limbs(hi, lo);
+    }
+
+    /**
+     * @Returns the high 128 bits of the 256 bits product of @c a and @c b.
+     *
+     * Together with <c>a * b</c>, the low 128 bits, it gives the exact product, as the one of two Q63.64 numbers.
+     */
+    inline uint128 multiply_high(uint128 const& a, uint128 const& b)
+    {
+      uint128 ll = wide_multiply(a.low(), b.low());
+      uint128 lh = wide_multiply(a.low(), b.high());
+      uint128 hl = wide_multiply(a.high(), b.low());
+      uint128 hh = wide_multiply(a.high(), b.high());
+      // the middle column, below 3 * 2^64, so that its carries are its high limb
+      uint128 mid = uint128(ll.high()) + uint128(lh.low()) + uint128(hl.low());
+      return hh + uint128(lh.high()) + uint128(hl.high()) + uint128(mid.high());
+    }
+    /**
+     * @Returns the high 128 bits of the 256 bits product of @c a and @c b.
+     *
+     * The unsigned high product is corrected as the one of wide_multiply.
+     */
+    inline int128 multiply_high(int128 const& a, int128 const& b)
+    {
+      uint128 res = multiply_high(uint128(a), uint128(b));
+      if (a < 0) res -= uint128(b);
+      if (b < 0) res -= uint128(a);
+      return int128(res);
+    }
+  }
+
+  // The rounding of the quotients in the accumulators relies on the sign of int128.
+  template <>
+  struct is_signed<fixed_point::int128> : true_type
+  {
+  };
+}
+
+namespace std
+{
+  template <bool Signed>
+  class numeric_limits<boost::fixed_point::integer128<Signed> >
+  {
+    typedef boost::fixed_point::integer128<Signed> rep;
+  public:
+    BOOST_STATIC_CONSTEXPR
+    bool is_specialized = true;
+    inline static rep min()
+    {
+      return Signed ? rep::from_limbs(boost::uint64_t(1) << 63, 0) : rep();
+    }
+    inline static rep max()
+    {
+      return Signed ? rep::from_limbs(~boost::uint64_t(0) >> 1, ~boost::uint64_t(0))
+          : rep::from_limbs(~boost::uint64_t(0), ~boost::uint64_t(0));
+    }
+    BOOST_STATIC_CONSTEXPR
+    int digits = Signed ? 127 : 128;
+    BOOST_STATIC_CONSTEXPR
+    int digits10 = 38;
+    BOOST_STATIC_CONSTEXPR
+    bool is_signed = Signed;
+    BOOST_STATIC_CONSTEXPR
+    bool is_integer = true;
+    BOOST_STATIC_CONSTEXPR
+    bool is_exact = true;
+    BOOST_STATIC_CONSTEXPR
+    int radix = 2;
+    inline static rep epsilon()
+    {
+      return rep();
+    }
+    inline static rep round_error()
+    {
+      return rep();
+    }
+    BOOST_STATIC_CONSTEXPR
+    int min_exponent = 0;
+    BOOST_STATIC_CONSTEXPR
+    int min_exponent10 = 0;
+    BOOST_STATIC_CONSTEXPR
+    int max_exponent = 0;
+    BOOST_STATIC_CONSTEXPR
+    int max_exponent10 = 0;
+    BOOST_STATIC_CONSTEXPR
+    bool has_infinity = false;
+    BOOST_STATIC_CONSTEXPR
+    bool has_quiet_NaN = false;
+    BOOST_STATIC_CONSTEXPR
+    bool has_signaling_NaN = false;
+    BOOST_STATIC_CONSTEXPR
+    float_denorm_style has_denorm = denorm_absent;
+    BOOST_STATIC_CONSTEXPR
+    bool has_denorm_loss = false;
+    inline static rep infinity()
+    {
+      return rep();
+    }
+    inline static rep quiet_NaN()
+    {
+      return rep();
+    }
+    inline static rep signaling_NaN()
+    {
+      return rep();
+    }
+    inline static rep denorm_min()
+    {
+      return rep();
+    }
+    BOOST_STATIC_CONSTEXPR
+    bool is_iec559 = false;
+    BOOST_STATIC_CONSTEXPR
+    bool is_bounded = true;
+    BOOST_STATIC_CONSTEXPR
+    bool is_modulo = true;
+    BOOST_STATIC_CONSTEXPR
+    bool traps = false;
+    BOOST_STATIC_CONSTEXPR
+    bool tinyness_before = false;
+    BOOST_STATIC_CONSTEXPR
+    float_round_style round_style = round_toward_zero;
+  };
+}
+
+#endif // header
@@ -0,0 +1,679 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Vicente J. Botet Escriba 2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/fixed_point for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file
+ * @brief Defines the square root, reciprocal square root, reciprocal, base 2 exponential and base 2 logarithm of
+ * fixed point numbers, computed on integers only.
+ *
+ */
+
+#ifndef BOOST_FIXED_POINT_MATH_HPP
+#define BOOST_FIXED_POINT_MATH_HPP
+
+#include <boost/fixed_point/number.hpp>
+#include <boost/fixed_point/divisor.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/assert.hpp>
+#include <boost/static_assert.hpp>
+#include <climits>
+
+namespace boost
+{
+  namespace fixed_point
+  {
+    namespace detail
+    {
+      //! floor(N/2) and ceil(N/2), as the division of a negative integer truncates.
+      template <int N>
+      struct floor_half
+      {
+        BOOST_STATIC_CONSTEXPR int value = (N >= 0) ? N / 2 : -((1 - N) / 2);
+      };
+      template <int N>
+      struct ceil_half
+      {
+        BOOST_STATIC_CONSTEXPR int value = N - floor_half<N>::value;
+      };
+
+      BOOST_STATIC_CONSTEXPR int uintmax_digits = sizeof(boost::uintmax_t) * CHAR_BIT;
+
+      //! The position of the most significant bit of <c>v != 0</c>.
+      inline int log2_floor(boost::uintmax_t v)
+      {
+#if defined(__GNUC__)
+        BOOST_STATIC_ASSERT(sizeof(boost::uintmax_t) == sizeof(unsigned long long));
+        return uintmax_digits - 1 - __builtin_clzll(v);
+#else
+        int res = 0;
+        for (int s = uintmax_digits / 2; s != 0; s /= 2)
+        {
+          if (v >> s)
+          {
+            v >>= s;
+            res += s;
+          }
+        }
+        return res;
+#endif
+      }
+
+      //! <c>values[i]</c> is 1/sqrt(1+(i+1/2)/32) in Q0.31, the seed of the reciprocal square roots on its interval.
+      template <typename T>
+      struct rsqrt_table
+      {
+        static const T values[96];
+      };
+      template <typename T>
+      const T rsqrt_table<T>::values[96] =
+      {
+        0x7f02f622, 0x7d19fca0, 0x7b466dd7, 0x7986c4e3, 0x77d9a26d, 0x763dc823, 0x74b214d3, 0x73358117,
+        0x71c71c71, 0x70660acb, 0x6f11824b, 0x6dc8c96d, 0x6c8b355b, 0x6b582874, 0x6a2f1106, 0x690f682b,
+        0x67f8b0c5, 0x66ea769b, 0x65e44d8c, 0x64e5d0da, 0x63eea286, 0x62fe6ac1, 0x6214d764, 0x61319b7c,
+        0x60546ee1, 0x5f7d0dd5, 0x5eab38ab, 0x5ddeb37a, 0x5d1745d1, 0x5c54ba7d, 0x5b96df45, 0x5add84bb,
+        0x5a287e03, 0x5977a0ab, 0x58cac480, 0x5821c364, 0x577c792f, 0x56dac38d, 0x563c81df, 0x55a19521,
+        0x5509dfd0, 0x547545d0, 0x53e3ac5a, 0x5354f9e6, 0x52c91617, 0x523fe9ab, 0x51b95e6b, 0x51355f19,
+        0x50b3d768, 0x5034b3e6, 0x4fb7e1fa, 0x4f3d4fce, 0x4ec4ec4e, 0x4e4ea718, 0x4dda7072, 0x4d683948,
+        0x4cf7f31b, 0x4c898fff, 0x4c1d0293, 0x4bb23df9, 0x4b4935ce, 0x4ae1de2a, 0x4a7c2b92, 0x4a1812fa,
+        0x49b589bb, 0x49548591, 0x48f4fc96, 0x4896e53c, 0x483a364c, 0x47dee6e0, 0x4784ee5f, 0x472c447c,
+        0x46d4e130, 0x467ebcb9, 0x4629cf98, 0x45d61289, 0x45837e88, 0x45320cc8, 0x44e1b6b4, 0x449275ec,
+        0x44444444, 0x43f71bbe, 0x43aaf68f, 0x435fcf14, 0x43159fdb, 0x42cc6398, 0x42841527, 0x423caf8c,
+        0x41f62df1, 0x41b08ba2, 0x416bc40d, 0x4127d2c3, 0x40e4b374, 0x40a261ef, 0x4060da21, 0x40201814
+      };
+
+      /**
+       * Integer square root of a number of @c Digits bits.
+       *
+       * @Returns the floor of the square root of @c n, and its remainder <c>n - res * res</c> in @c rem.
+       */
+      template <int Digits, bool Newton = (Digits <= 48)>
+      struct isqrt_impl
+      {
+        /**
+         * The root is computed one bit at a time from the most significant one. The number of steps only depends on
+         * @c Digits, so that the loop is unrolled and doesn't branch.
+         */
+        static boost::uintmax_t apply(boost::uintmax_t n, boost::uintmax_t& rem)
+        {
+          BOOST_STATIC_ASSERT(Digits > 0 && Digits <= uintmax_digits);
+          boost::uintmax_t res = 0;
+          for (boost::uintmax_t one = boost::uintmax_t(1) << ((Digits - 1) & ~1); one != 0; one >>= 2)
+          {
+            boost::uintmax_t t = res + one;
+            // all the bits set when n >= t, without branching on the bits of the root
+            boost::uintmax_t ge = boost::uintmax_t(0) - boost::uintmax_t(n >= t);
+            n -= t & ge;
+            res = (res >> 1) + (one & ge);
+          }
+          rem = n;
+          return res;
+        }
+      };
+      template <int Digits>
+      struct isqrt_impl<Digits, true>
+      {
+        /**
+         * n is normalized to m = n * 4^k in [2^62, 2^64[. Two Newton iterations y = y * (3 - x * y^2) / 2 on the
+         * reciprocal square root of x = m / 2^62 in [1, 4[, seeded from rsqrt_table, give it with a relative error
+         * below 2^-28, so that sqrt(m) = x * y * 2^31 shifted by k is the root with an error below 2^-4 for roots of up
+         * to 24 bits. A last step corrects the truncations.
+         */
+        static boost::uintmax_t apply(boost::uintmax_t n, boost::uintmax_t& rem)
+        {
+          if (n == 0)
+          {
+            rem = 0;
+            return 0;
+          }
+          int sh = (uintmax_digits - 1 - log2_floor(n)) & ~1;
+          boost::uintmax_t m = n << sh;
+          // x in Q2.30 and y in Q0.31
+          boost::uintmax_t x = m >> 32;
+          boost::uintmax_t y = rsqrt_table<boost::uint32_t>::values[(m >> 57) - 32];
+          for (int i = 0; i < 2; ++i)
+          {
+            boost::uintmax_t xy2 = (x * ((y * y) >> 30)) >> 32;
+            y = (y * ((boost::uintmax_t(3) << 30) - xy2)) >> 31;
+          }
+          boost::uintmax_t res = ((x * y) >> 30) >> (sh / 2);
+          res -= boost::uintmax_t(res * res > n);
+          res += boost::uintmax_t((res + 1) * (res + 1) <= n);
+          rem = n - res * res;
+          return res;
+        }
+      };
+
+      template <int Digits>
+      boost::uintmax_t isqrt(boost::uintmax_t n, boost::uintmax_t& rem)
+      {
+        return isqrt_impl<Digits>::apply(n, rem);
+      }
+
+      /**
+       * Square root of <c>n + num / den</c>, with <c>n < 2^Digits</c> and <c>num < den</c>, rounded with the policy
+       * @c RP.
+       *
+       * The position of the fractional part of the root with respect to one half is given to
+       * <c>RP::round_quotient</c> as an equivalent remainder of a division, so that all the policies apply.
+       */
+      template <typename RP, int Digits>
+      boost::uintmax_t round_sqrt(boost::uintmax_t n, boost::uintmax_t num, boost::uintmax_t den)
+      {
+        boost::uintmax_t rem;
+        boost::uintmax_t r = isqrt<Digits>(n, rem);
+        // (r + 1/2)^2 = r^2 + r + 1/4, so the root is above the half if rem + num / den > r + 1/4.
+        boost::uintmax_t frac = 0;
+        boost::uintmax_t d = 1;
+        if (rem == 0 && num == 0)
+        {
+        }
+        else if (rem < r)
+        {
+          frac = 1;
+          d = 3;
+        }
+        else if (rem > r || num > den / 4)
+        {
+          frac = 2;
+          d = 3;
+        }
+        else if (den % 4 == 0 && num == den / 4)
+        {
+          frac = 1;
+          d = 2;
+        }
+        else
+        {
+          frac = 1;
+          d = 3;
+        }
+        return RP::template round_quotient<boost::uintmax_t>(r, frac, d);
+      }
+
+      //! @Returns <c>v / 2^k</c> rounded with the policy @c RP, for <c>v < 2^(uintmax_digits-1)</c> and <c>k > 0</c>.
+      template <typename RP>
+      boost::uintmax_t round_shift(boost::uintmax_t v, boost::intmax_t k)
+      {
+        if (k < uintmax_digits)
+        {
+          boost::uintmax_t d = boost::uintmax_t(1) << k;
+          return RP::template round_quotient<boost::uintmax_t>(v >> k, v & (d - 1), d);
+        }
+        // v is less than the half of 2^k.
+        return RP::template round_quotient<boost::uintmax_t>(0, v != 0, 3);
+      }
+
+      //! @Returns the product of two Q1.62 numbers, as long as it is less than 4.
+      inline boost::uintmax_t mul_q62(boost::uintmax_t a, boost::uintmax_t b)
+      {
+        BOOST_STATIC_ASSERT(uintmax_digits == 64);
+        return (mul_hi(a, b) << 2) | ((a * b) >> 62);
+      }
+
+      //! <c>values[j-1]</c> is 2^(2^-j) in Q1.62, rounded to nearest.
+      template <typename T>
+      struct exp2_table
+      {
+        static const T values[62];
+      };
+      template <typename T>
+      const T exp2_table<T>::values[62] =
+      {
+        UINTMAX_C(0x5a827999fcef3242), UINTMAX_C(0x4c1bf828c6dc54b8), UINTMAX_C(0x45cae0f1f545eb73),
+        UINTMAX_C(0x42d561b3e6243d8a), UINTMAX_C(0x4166c34c5615d0ec), UINTMAX_C(0x40b268f9de0183ba),
+        UINTMAX_C(0x4058f6a7ecccd5b6), UINTMAX_C(0x402c6be96af2fb58), UINTMAX_C(0x4016321b687027a8),
+        UINTMAX_C(0x400b18178ba33b14), UINTMAX_C(0x40058bce410147e8), UINTMAX_C(0x4002c5d7bff71daf),
+        UINTMAX_C(0x400162e807ee7e5b), UINTMAX_C(0x4000b1730df6a524), UINTMAX_C(0x400058b9497b8152),
+        UINTMAX_C(0x40002c5c955dd701), UINTMAX_C(0x4000162e46d6f26c), UINTMAX_C(0x40000b1722757b1b),
+        UINTMAX_C(0x4000058b90fd3e0c), UINTMAX_C(0x400002c5c86f3f26), UINTMAX_C(0x40000162e433c79b),
+        UINTMAX_C(0x400000b17218edd0), UINTMAX_C(0x40000058b90c3968), UINTMAX_C(0x4000002c5c860d54),
+        UINTMAX_C(0x400000162e4302d2), UINTMAX_C(0x4000000b17218073), UINTMAX_C(0x400000058b90bffc),
+        UINTMAX_C(0x40000002c5c85fef), UINTMAX_C(0x4000000162e42ff3), UINTMAX_C(0x40000000b17217f9),
+        UINTMAX_C(0x4000000058b90bfc), UINTMAX_C(0x400000002c5c85fe), UINTMAX_C(0x40000000162e42ff),
+        UINTMAX_C(0x400000000b17217f), UINTMAX_C(0x40000000058b90c0), UINTMAX_C(0x4000000002c5c860),
+        UINTMAX_C(0x400000000162e430), UINTMAX_C(0x4000000000b17218), UINTMAX_C(0x400000000058b90c),
+        UINTMAX_C(0x40000000002c5c86), UINTMAX_C(0x4000000000162e43), UINTMAX_C(0x40000000000b1721),
+        UINTMAX_C(0x4000000000058b91), UINTMAX_C(0x400000000002c5c8), UINTMAX_C(0x40000000000162e4),
+        UINTMAX_C(0x400000000000b172), UINTMAX_C(0x40000000000058b9), UINTMAX_C(0x4000000000002c5d),
+        UINTMAX_C(0x400000000000162e), UINTMAX_C(0x4000000000000b17), UINTMAX_C(0x400000000000058c),
+        UINTMAX_C(0x40000000000002c6), UINTMAX_C(0x4000000000000163), UINTMAX_C(0x40000000000000b1),
+        UINTMAX_C(0x4000000000000059), UINTMAX_C(0x400000000000002c), UINTMAX_C(0x4000000000000016),
+        UINTMAX_C(0x400000000000000b), UINTMAX_C(0x4000000000000006), UINTMAX_C(0x4000000000000003),
+        UINTMAX_C(0x4000000000000001), UINTMAX_C(0x4000000000000001)
+      };
+
+      /**
+       * The index of @c Res for the value @c v, handled by the overflow policy of @c Res when out of its range.
+       */
+      template <typename Res>
+      typename Res::underlying_type math_index(boost::uintmax_t v)
+      {
+        typedef typename Res::overflow_type overflow_type;
+        if (v > boost::uintmax_t(Res::max_index))
+          return overflow_type::template on_positive_overflow<Res, boost::uintmax_t>(v);
+        return typename Res::underlying_type(v);
+      }
+      template <typename Res>
+      typename Res::underlying_type math_index(boost::intmax_t v)
+      {
+        typedef typename Res::overflow_type overflow_type;
+        if (v > 0 && boost::uintmax_t(v) > boost::uintmax_t(Res::max_index))
+          return overflow_type::template on_positive_overflow<Res, boost::intmax_t>(v);
+        if (v < 0 && v < boost::intmax_t(Res::min_index))
+          return overflow_type::template on_negative_overflow<Res, boost::intmax_t>(v);
+        return typename Res::underlying_type(v);
+      }
+
+      template <typename Res, typename From>
+      Res sqrt_impl(From const& x)
+      {
+        BOOST_STATIC_CONSTEXPR int e = From::resolution_exp - 2 * Res::resolution_exp;
+        BOOST_STATIC_ASSERT_MSG((e < 0 || int(From::digits) + e <= uintmax_digits),
+            "The square root needs more bits than boost::uintmax_t");
+        BOOST_STATIC_ASSERT_MSG((e >= 0 || -e < uintmax_digits), "The square root resolution is too coarse");
+        BOOST_ASSERT_MSG(x.count() >= 0, "Square root of a negative number");
+
+        boost::uintmax_t c = boost::uintmax_t(x.count());
+        boost::uintmax_t res;
+        if (e >= 0)
+        {
+          BOOST_STATIC_CONSTEXPR int k = (e >= 0) ? e : 0;
+          res = round_sqrt<typename Res::rounding_type, From::digits + k>(c << k, 0, 1);
+        }
+        else
+        {
+          BOOST_STATIC_CONSTEXPR int k = (e >= 0) ? 0 : -e;
+          boost::uintmax_t den = boost::uintmax_t(1) << k;
+          res = round_sqrt<typename Res::rounding_type, (From::digits > k) ? From::digits - k : 1>(c >> k,
+              c & (den - 1), den);
+        }
+        return Res(index(math_index<Res>(res)));
+      }
+
+      template <typename Res, typename From>
+      Res rsqrt_impl(From const& x)
+      {
+        BOOST_STATIC_CONSTEXPR int k = -From::resolution_exp - 2 * Res::resolution_exp;
+        BOOST_STATIC_CONSTEXPR int num_shift = (k >= 0) ? k : 0;
+        BOOST_STATIC_CONSTEXPR int den_shift = (k >= 0) ? 0 : -k;
+        BOOST_STATIC_ASSERT_MSG((num_shift < uintmax_digits && int(From::digits) + den_shift <= uintmax_digits),
+            "The reciprocal square root needs more bits than boost::uintmax_t");
+        BOOST_ASSERT_MSG(x.count() > 0, "Reciprocal square root of a non positive number");
+
+        boost::uintmax_t num = boost::uintmax_t(1) << num_shift;
+        boost::uintmax_t den = boost::uintmax_t(x.count()) << den_shift;
+        return Res(index(math_index<Res>(round_sqrt<typename Res::rounding_type, num_shift + 1>(num / den, num % den,
+            den))));
+      }
+
+      template <typename Res, typename From>
+      Res reciprocal_impl(From const& x)
+      {
+        typedef typename max_type<From::is_signed>::type I;
+        BOOST_STATIC_CONSTEXPR int k = -From::resolution_exp - Res::resolution_exp;
+        BOOST_STATIC_CONSTEXPR int num_shift = (k >= 0) ? k : 0;
+        BOOST_STATIC_CONSTEXPR int den_shift = (k >= 0) ? 0 : -k;
+        BOOST_STATIC_ASSERT((Res::is_signed==From::is_signed));
+        BOOST_STATIC_ASSERT_MSG((num_shift < int(sizeof(I) * CHAR_BIT) - int(From::is_signed)
+                && int(From::digits) + den_shift <= int(sizeof(I) * CHAR_BIT)),
+            "The reciprocal needs more bits than boost::intmax_t");
+        BOOST_ASSERT_MSG(x.count() != 0, "Division by 0");
+
+        I num = I(1) << num_shift;
+        I den = I(x.count()) * (I(1) << den_shift);
+        I q = Res::rounding_type::template round_quotient<I>(num / den, num % den, den);
+        return Res(index(math_index<Res>(q)));
+      }
+
+      template <typename Res, typename From>
+      Res exp2_impl(From const& x)
+      {
+        BOOST_STATIC_CONSTEXPR int P = From::resolution_exp;
+        BOOST_STATIC_CONSTEXPR int F = (P < 0) ? -P : 0;
+        BOOST_STATIC_ASSERT_MSG((From::range_exp < uintmax_digits - 1 && int(From::digits) <= uintmax_digits),
+            "The exponent range is too large");
+
+        // x = i + f / 2^F with 0 <= f < 2^F, of which only the 62 most significant bits are taken in account
+        typedef typename From::underlying_type underlying_type;
+        underlying_type c = x.count();
+        boost::intmax_t i;
+        boost::uintmax_t f;
+        int bits = F;
+        if (F == 0)
+        {
+          i = boost::intmax_t(c) * (boost::intmax_t(1) << (P >= 0 ? P : 0));
+          f = 0;
+        }
+        else if (F < uintmax_digits)
+        {
+          BOOST_STATIC_CONSTEXPR int k = (F < uintmax_digits) ? F : 0;
+          i = boost::intmax_t(c >> k);
+          f = boost::uintmax_t(c) & ((boost::uintmax_t(1) << k) - 1);
+          if (bits > 62)
+          {
+            f >>= bits - 62;
+            bits = 62;
+          }
+        }
+        else
+        {
+          // the bits of f above those of c are copies of its sign, so c is shifted in its own type; shifting by
+          // k - 1 then 1 leaves the sign of c (0 when unsigned) when all its bits are shifted out
+          BOOST_STATIC_CONSTEXPR int width = int(sizeof(underlying_type) * CHAR_BIT);
+          BOOST_STATIC_CONSTEXPR int k = (F - 62 < width) ? ((F > 62) ? F - 62 : 1) : width;
+          i = boost::intmax_t(sign_mask<underlying_type>::apply(c));
+          f = boost::uintmax_t(underlying_type(c >> (k - 1)) >> 1) & ((boost::uintmax_t(1) << 62) - 1);
+          bits = 62;
+        }
+
+        // 2^f = product of 2^(2^-j) for the bits j set in f
+        boost::uintmax_t m = boost::uintmax_t(1) << 62;
+        while (f != 0)
+        {
+          int p = log2_floor(f);
+          m = mul_q62(m, exp2_table<boost::uintmax_t>::values[bits - p - 1]);
+          f ^= boost::uintmax_t(1) << p;
+        }
+
+        // 2^x = m * 2^(i - 62), whose index is m * 2^s
+        boost::intmax_t s = i - 62 - Res::resolution_exp;
+        if (s >= 0)
+        {
+          if (s >= uintmax_digits || m > (boost::uintmax_t(Res::max_index) >> s))
+            return Res(index(Res::overflow_type::template on_positive_overflow<Res, boost::uintmax_t>(
+                s < uintmax_digits ? m << s : boost::uintmax_t(0))));
+          return Res(index(typename Res::underlying_type(m << s)));
+        }
+        return Res(index(math_index<Res>(round_shift<typename Res::rounding_type>(m, -s))));
+      }
+
+      template <typename Res, typename From>
+      Res log2_impl(From const& x)
+      {
+        // fraction bits computed, including two guard bits below the resolution of Res
+        BOOST_STATIC_CONSTEXPR int F = (2 - Res::resolution_exp < 0) ? 0 :
+            ((2 - Res::resolution_exp > 60) ? 60 : 2 - Res::resolution_exp);
+        BOOST_STATIC_CONSTEXPR int shift = F + Res::resolution_exp;
+        BOOST_STATIC_ASSERT_MSG((shift < uintmax_digits - 1), "The logarithm resolution is too coarse");
+        BOOST_ASSERT_MSG(x.count() > 0, "Logarithm of a non positive number");
+
+        // x = m * 2^(P + e - 62) with m in [2^62, 2^63[
+        boost::uintmax_t c = boost::uintmax_t(x.count());
+        int e = log2_floor(c);
+        boost::uintmax_t m = (e <= 62) ? c << (62 - e) : c >> (e - 62);
+
+        // each squaring of m doubles its logarithm, whose integral part is the next bit
+        boost::intmax_t y = boost::intmax_t(From::resolution_exp + e) * (boost::intmax_t(1) << F);
+        for (int j = F - 1; j >= 0; --j)
+        {
+          m = mul_q62(m, m);
+          boost::uintmax_t b = m >> 63;
+          y |= boost::intmax_t(b) << j;
+          m >>= b;
+        }
+
+        boost::intmax_t res;
+        if (shift >= 0)
+        {
+          boost::intmax_t d = boost::intmax_t(1) << (shift >= 0 ? shift : 0);
+          res = Res::rounding_type::template round_quotient<boost::intmax_t>(y / d, y % d, d);
+        }
+        else
+          res = y * (boost::intmax_t(1) << (shift >= 0 ? 0 : -shift));
+        return Res(index(math_index<Res>(res)));
+      }
+    }
+
+    /**
+     * Square root type metafunction.
+     *
+     * The result type depends on whether the type is open/closed:
+     * - closed: the nested typedef type is @c T.
+     * - open: <c>real_t<ceil(R/2), floor(P/2), RP, OP, F></c>, or @c ureal_t for an @c ureal_t, which holds all the
+     *   square roots of the values of @c T.
+     */
+    template <typename T, bool B=is_open<T>::value>
+    struct sqrt_result
+    {
+      typedef T type;
+    };
+#if ! defined(BOOST_FIXED_POINT_DOXYGEN_INVOKED)
+    template <int R, int P, typename RP, typename OP, typename F>
+    struct sqrt_result<real_t<R,P,RP,OP,F>, true>
+    {
+      typedef real_t<detail::ceil_half<R>::value, detail::floor_half<P>::value, RP, OP, F> type;
+    };
+    template <int R, int P, typename RP, typename OP, typename F>
+    struct sqrt_result<ureal_t<R,P,RP,OP,F>, true>
+    {
+      typedef ureal_t<detail::ceil_half<R>::value, detail::floor_half<P>::value, RP, OP, F> type;
+    };
+#endif
+
+    /**
+     * Reciprocal type metafunction, the type of the quotient of 1 by a @c T.
+     *
+     * The result type depends on whether the type is open/closed:
+     * - closed: the nested typedef type is @c T.
+     * - open: <c>real_t<1-P, -R, RP, OP, F></c>, or @c ureal_t for an @c ureal_t, as divide_result gives for
+     *   <c>ureal_t<1,0></c> and @c T.
+     */
+    template <typename T, bool B=is_open<T>::value>
+    struct reciprocal_result
+    {
+      typedef T type;
+    };
+#if ! defined(BOOST_FIXED_POINT_DOXYGEN_INVOKED)
+    template <int R, int P, typename RP, typename OP, typename F>
+    struct reciprocal_result<real_t<R,P,RP,OP,F>, true>
+    {
+      typedef real_t<1-P, -R, RP, OP, F> type;
+    };
+    template <int R, int P, typename RP, typename OP, typename F>
+    struct reciprocal_result<ureal_t<R,P,RP,OP,F>, true>
+    {
+      typedef ureal_t<1-P, -R, RP, OP, F> type;
+    };
+#endif
+
+    /**
+     * Reciprocal square root type metafunction.
+     *
+     * The result type depends on whether the type is open/closed:
+     * - closed: the nested typedef type is @c T.
+     * - open: the square root type of the reciprocal type of @c T,
+     *   <c>real_t<ceil((1-P)/2), floor(-R/2), RP, OP, F></c>, or @c ureal_t for an @c ureal_t.
+     */
+    template <typename T, bool B=is_open<T>::value>
+    struct rsqrt_result
+    {
+      typedef T type;
+    };
+#if ! defined(BOOST_FIXED_POINT_DOXYGEN_INVOKED)
+    template <int R, int P, typename RP, typename OP, typename F>
+    struct rsqrt_result<real_t<R,P,RP,OP,F>, true>
+    : sqrt_result<typename reciprocal_result<real_t<R,P,RP,OP,F> >::type>
+    {
+    };
+    template <int R, int P, typename RP, typename OP, typename F>
+    struct rsqrt_result<ureal_t<R,P,RP,OP,F>, true>
+    : sqrt_result<typename reciprocal_result<ureal_t<R,P,RP,OP,F> >::type>
+    {
+    };
+#endif
+
+    /**
+     * Square root giving the expected result type.
+     *
+     * The root is computed on integers and is correctly rounded: the error is below one unit of the resolution of
+     * @c Res, and below the half of it for the round to nearest policies. The integer root of at most 48 bits is
+     * estimated by Newton iterations on its reciprocal, seeded from a table, and then corrected. The wider ones are
+     * computed one bit at a time.
+     *
+     * @Requires <c>x >= 0</c>.
+     * @Returns the square root of @c x taking in account the rounding policy of the result type @c Res.
+     */
+    template <typename Res, typename T>
+    inline
+    Res
+    sqrt(T const& x)
+    {
+      return detail::sqrt_impl<Res>(x);
+    }
+
+    /**
+     * @Requires <c>x >= 0</c>.
+     * @Returns <c>sqrt<RT>(x)</c>, where @c RT is <c>sqrt_result<real_t<R,P,RP,OP,F> >::type</c>.
+     */
+    template <int R, int P, typename RP, typename OP, typename F>
+    inline
+    typename sqrt_result<real_t<R,P,RP,OP,F> >::type
+    sqrt(real_t<R,P,RP,OP,F> const& x)
+    {
+      return detail::sqrt_impl<typename sqrt_result<real_t<R,P,RP,OP,F> >::type>(x);
+    }
+
+    /**
+     * @Returns <c>sqrt<RT>(x)</c>, where @c RT is <c>sqrt_result<ureal_t<R,P,RP,OP,F> >::type</c>.
+     */
+    template <int R, int P, typename RP, typename OP, typename F>
+    inline
+    typename sqrt_result<ureal_t<R,P,RP,OP,F> >::type
+    sqrt(ureal_t<R,P,RP,OP,F> const& x)
+    {
+      return detail::sqrt_impl<typename sqrt_result<ureal_t<R,P,RP,OP,F> >::type>(x);
+    }
+
+    /**
+     * Reciprocal square root giving the expected result type.
+     *
+     * The root of the quotient is computed on integers with a division and the bit by bit square root, and is
+     * correctly rounded: the error is below one unit of the resolution of @c Res, and below the half of it for the
+     * round to nearest policies.
+     *
+     * @Requires <c>x > 0</c>.
+     * @Returns <c>1 / sqrt(x)</c> taking in account the rounding policy of the result type @c Res.
+     */
+    template <typename Res, typename T>
+    inline
+    Res
+    rsqrt(T const& x)
+    {
+      return detail::rsqrt_impl<Res>(x);
+    }
+
+    /**
+     * @Requires <c>x > 0</c>.
+     * @Returns <c>rsqrt<RT>(x)</c>, where @c RT is <c>rsqrt_result<real_t<R,P,RP,OP,F> >::type</c>.
+     */
+    template <int R, int P, typename RP, typename OP, typename F>
+    inline
+    typename rsqrt_result<real_t<R,P,RP,OP,F> >::type
+    rsqrt(real_t<R,P,RP,OP,F> const& x)
+    {
+      return detail::rsqrt_impl<typename rsqrt_result<real_t<R,P,RP,OP,F> >::type>(x);
+    }
+
+    /**
+     * @Requires <c>x > 0</c>.
+     * @Returns <c>rsqrt<RT>(x)</c>, where @c RT is <c>rsqrt_result<ureal_t<R,P,RP,OP,F> >::type</c>.
+     */
+    template <int R, int P, typename RP, typename OP, typename F>
+    inline
+    typename rsqrt_result<ureal_t<R,P,RP,OP,F> >::type
+    rsqrt(ureal_t<R,P,RP,OP,F> const& x)
+    {
+      return detail::rsqrt_impl<typename rsqrt_result<ureal_t<R,P,RP,OP,F> >::type>(x);
+    }
+
+    /**
+     * Reciprocal giving the expected result type.
+     *
+     * The quotient is computed with a single integer division and is correctly rounded, as @c divide.
+     *
+     * @Requires <c>x != 0</c>.
+     * @Returns <c>1 / x</c> taking in account the rounding policy of the result type @c Res.
+     */
+    template <typename Res, typename T>
+    inline
+    Res
+    reciprocal(T const& x)
+    {
+      return detail::reciprocal_impl<Res>(x);
+    }
+
+    /**
+     * @Requires <c>x != 0</c>.
+     * @Returns <c>reciprocal<RT>(x)</c>, where @c RT is <c>reciprocal_result<real_t<R,P,RP,OP,F> >::type</c>.
+     */
+    template <int R, int P, typename RP, typename OP, typename F>
+    inline
+    typename reciprocal_result<real_t<R,P,RP,OP,F> >::type
+    reciprocal(real_t<R,P,RP,OP,F> const& x)
+    {
+      return detail::reciprocal_impl<typename reciprocal_result<real_t<R,P,RP,OP,F> >::type>(x);
+    }
+
+    /**
+     * @Requires <c>x != 0</c>.
+     * @Returns <c>reciprocal<RT>(x)</c>, where @c RT is <c>reciprocal_result<ureal_t<R,P,RP,OP,F> >::type</c>.
+     */
+    template <int R, int P, typename RP, typename OP, typename F>
+    inline
+    typename reciprocal_result<ureal_t<R,P,RP,OP,F> >::type
+    reciprocal(ureal_t<R,P,RP,OP,F> const& x)
+    {
+      return detail::reciprocal_impl<typename reciprocal_result<ureal_t<R,P,RP,OP,F> >::type>(x);
+    }
+
+    /**
+     * Base 2 exponential.
+     *
+     * The range of 2^x depends on the value of @c x, so the result type must be given.
+     * 2^x is the product of 2^i, a shift, by the factors 2^(2^-j) of a table for the bits j set in the fraction of
+     * @c x. The factors and the products are Q1.62 integers, so the relative error before the rounding to @c Res is
+     * below 2^-56: the result is faithfully rounded, with an error below one unit of the resolution of @c Res, as long
+     * as @c Res has less than 56 significant bits.
+     *
+     * @Returns 2^x taking in account the rounding and the overflow policies of the result type @c Res.
+     */
+    template <typename Res, typename T>
+    inline
+    Res
+    exp2(T const& x)
+    {
+      return detail::exp2_impl<Res>(x);
+    }
+
+    /**
+     * Base 2 logarithm.
+     *
+     * The range of the result is given by the range and the resolution of @c x, but as the resolution of the result
+     * is a matter of choice the result type must be given.
+     * The integral part of the logarithm is the position of the most significant bit of @c x, and the bits of the
+     * fraction are obtained one at a time by squaring the normalized Q1.62 mantissa. Two more bits than the resolution
+     * of @c Res are computed, so the result is faithfully rounded, with an error below one unit of the resolution of
+     * @c Res, as long as @c Res has less than 58 fractional bits.
+     *
+     * @Requires <c>x > 0</c>.
+     * @Returns log2(x) taking in account the rounding and the overflow policies of the result type @c Res.
+     */
+    template <typename Res, typename T>
+    inline
+    Res
+    log2(T const& x)
+    {
+      return detail::log2_impl<Res>(x);
+    }
+
+  }
+}
+
+#endif // header
@@ -18,6 +18,7 @@
 #define BOOST_FIXED_POINT_NUMBER_HPP
 
 #include <boost/mpl/logical.hpp>
+#include <boost/mpl/if.hpp>
 #include <boost/mpl/comparison.hpp>
 #include <boost/mpl/max.hpp>
 #include <boost/mpl/min.hpp>
@@ -38,6 +39,7 @@
 #include <limits>
 #include <stdexcept>
 #include <cmath>
+#include <climits>
 #include <boost/integer_traits.hpp>
 
 #include <boost/config.hpp>
@@ -49,6 +51,31 @@
 
 #include <limits>
 
+/**
+ * The storage class of the per thread variables, as the sticky overflow status. Without any thread local storage the
+ * variables are shared by all the threads.
+ */
+#if !defined(BOOST_FIXED_POINT_THREAD_LOCAL)
+#if !defined(BOOST_NO_CXX11_THREAD_LOCAL)
+#define BOOST_FIXED_POINT_THREAD_LOCAL thread_local
+#elif defined(__GNUC__)
+#define BOOST_FIXED_POINT_THREAD_LOCAL __thread
+#elif defined(BOOST_MSVC)
+#define BOOST_FIXED_POINT_THREAD_LOCAL __declspec(thread)
+#else
+#define BOOST_FIXED_POINT_THREAD_LOCAL
+#endif
+#endif
+
+/**
+ * Defined when the underlying integers can be the builtin 128 bits integer of the compiler. Defining
+ * BOOST_FIXED_POINT_NO_INT128 stops at 64 bits as on the compilers without it, the accumulators wider than 64 bits
+ * being then stored on the two limbs of int128.hpp.
+ */
+#if defined(BOOST_HAS_INT128) && !defined(BOOST_FIXED_POINT_NO_INT128)
+#define BOOST_FIXED_POINT_HAS_INT128
+#endif
+
 namespace boost
 {
   namespace fixed_point
@@ -57,6 +84,66 @@ namespace boost
     namespace detail
     {
 
+      /**
+       * int_t<Bits> and uint_t<Bits> behave as boost::int_t and boost::uint_t, but when the compiler provides a 128
+       * bits integer (BOOST_FIXED_POINT_HAS_INT128) they go up to 128 bits instead of stopping at boost::intmax_t.
+       *
+       * The product of two Q32.32 numbers needs 129 bits, which fits in a register pair on most 64 bits platforms.
+       */
+      template <int Bits, bool Wide = (Bits > int(sizeof(boost::intmax_t) * CHAR_BIT))>
+      struct int_t
+      {
+        typedef typename ::boost::int_t<Bits>::least least;
+        typedef typename ::boost::int_t<Bits>::fast fast;
+      };
+      template <int Bits, bool Wide = (Bits > int(sizeof(boost::uintmax_t) * CHAR_BIT))>
+      struct uint_t
+      {
+        typedef typename ::boost::uint_t<Bits>::least least;
+        typedef typename ::boost::uint_t<Bits>::fast fast;
+      };
+#if defined(BOOST_FIXED_POINT_HAS_INT128)
+      template <int Bits>
+      struct int_t<Bits, true>
+      {
+        BOOST_STATIC_ASSERT_MSG(Bits <= 128, "No suitable signed integer type with the requested number of bits is available.");
+        typedef boost::int128_type least;
+        typedef boost::int128_type fast;
+      };
+      template <int Bits>
+      struct uint_t<Bits, true>
+      {
+        BOOST_STATIC_ASSERT_MSG(Bits <= 128, "No suitable unsigned integer type with the requested number of bits is available.");
+        typedef boost::uint128_type least;
+        typedef boost::uint128_type fast;
+      };
+#endif
+
+      //! The integers of the width of the registers of the machine.
+#if defined(BOOST_HAS_INTPTR_T)
+      typedef boost::intptr_t register_int;
+      typedef boost::uintptr_t register_uint;
+#else
+      typedef boost::intmax_t register_int;
+      typedef boost::uintmax_t register_uint;
+#endif
+
+      /**
+       * low_bits_mask<T, Digits>::value is the value of type @c T with the @c Digits lower bits set.
+       *
+       * It is built one bit at a time, so that it doesn't overflow for any @c Digits up to the number of bits of @c T.
+       */
+      template <typename T, std::size_t Digits>
+      struct low_bits_mask
+      {
+        BOOST_STATIC_CONSTEXPR T value = T((low_bits_mask<T, Digits - 1>::value << 1) | 1);
+      };
+      template <typename T>
+      struct low_bits_mask<T, 0>
+      {
+        BOOST_STATIC_CONSTEXPR T value = 0;
+      };
+
       template <typename From, typename To, bool IsPositive = (To::resolution_exp > 0)>
       struct shift_impl;
       template <typename From, typename To>
@@ -76,7 +163,7 @@ namespace boost
       {
         BOOST_STATIC_CONSTEXPR
         std::size_t digits = From::digits - To::resolution_exp;
-        typedef typename ::boost::int_t<digits>::fast result_type;
+        typedef typename detail::int_t<digits>::fast result_type;
         //typedef typename From::underlying_type result_type;
         static result_type apply(typename From::underlying_type v)
         {
@@ -133,6 +220,270 @@ namespace boost
         typedef boost::uintmax_t type;
       };
 
+      /**
+       * The widest of max_type<IsSigned>::type and @c T, used to round values of types wider than boost::intmax_t.
+       */
+      template <bool IsSigned, typename T>
+      struct wide_type
+      {
+        typedef typename max_type<IsSigned>::type max_t;
+        typedef typename mpl::if_c<(sizeof(T) > sizeof(max_t)), T, max_t>::type type;
+      };
+
+      //! The maximum value of the integer type @c T.
+      template <typename T>
+      struct integer_max
+      {
+        BOOST_STATIC_CONSTEXPR T value = low_bits_mask<T, 8 * sizeof(T) - (is_signed<T>::value ? 1 : 0)>::value;
+      };
+
+      /**
+       * sign_mask<T>::apply(v) is -1 (all the bits set) when @c v is negative and 0 otherwise, without branching.
+       */
+      template <typename T, bool IsSigned = is_signed<T>::value>
+      struct sign_mask;
+      template <typename T>
+      struct sign_mask<T, true>
+      {
+        static T apply(T v)
+        {
+          return v >> (8 * sizeof(T) - 1);
+        }
+      };
+      template <typename T>
+      struct sign_mask<T, false>
+      {
+        static T apply(T)
+        {
+          return 0;
+        }
+      };
+
+      /**
+       * The integer type on which a floating point value is rounded before being converted to the underlying type
+       * of @c To, wide enough to detect the overflows of this type.
+       */
+      template <typename To>
+      struct float_index
+      {
+        typedef typename To::underlying_type underlying_type;
+        typedef typename wide_type<is_signed<underlying_type>::value, underlying_type>::type type;
+      };
+
+      /**
+       * The largest integer not greater than @c x, computed from the conversion towards zero (cvttsd2si on x86)
+       * corrected by one unit, so that neither std::floor nor a branch is needed.
+       */
+      template <typename I, typename F>
+      I floor_to(F x)
+      {
+        I t = I(x);
+        return t - I(F(t) > x);
+      }
+      //! The smallest integer not less than @c x.
+      template <typename I, typename F>
+      I ceil_to(F x)
+      {
+        I t = I(x);
+        return t + I(F(t) < x);
+      }
+
+      /**
+       * Rounds to nearest the value @c v shifted right by @c D bits.
+       *
+       * As the shift of a signed value rounds towards negative infinity, the bias added before shifting is
+       * <c>2^(D-1)-1</c> plus 0 or 1 depending on how the exactly-half values must be rounded, which is what
+       * @c Tie::apply computes from the sign of @c v or from the quotient bit.
+       */
+      template <typename Tie, boost::uintmax_t D>
+      struct nearest_shift
+      {
+        template <typename T>
+        static T apply(T v)
+        {
+          return (v + ((T(1) << (D - 1)) - 1) + Tie::template apply<D>(v)) >> D;
+        }
+      };
+      template <typename Tie>
+      struct nearest_shift<Tie, 0>
+      {
+        template <typename T>
+        static T apply(T v)
+        {
+          return v;
+        }
+      };
+
+      //! exactly-half values go away from zero.
+      struct tie_half_up
+      {
+        template <boost::uintmax_t D, typename T>
+        static T apply(T v)
+        {
+          return T(1) + sign_mask<T>::apply(v);
+        }
+        template <typename T>
+        static bool apply_divide(T)
+        {
+          return true;
+        }
+        template <typename T>
+        static bool apply_floor(T f)
+        {
+          return sign_mask<T>::apply(f) == 0;
+        }
+      };
+      //! exactly-half values go towards zero.
+      struct tie_half_down
+      {
+        template <boost::uintmax_t D, typename T>
+        static T apply(T v)
+        {
+          return T(0) - sign_mask<T>::apply(v);
+        }
+        template <typename T>
+        static bool apply_divide(T)
+        {
+          return false;
+        }
+        template <typename T>
+        static bool apply_floor(T f)
+        {
+          return sign_mask<T>::apply(f) != 0;
+        }
+      };
+      //! exactly-half values go to the even quotient.
+      struct tie_even
+      {
+        template <boost::uintmax_t D, typename T>
+        static T apply(T v)
+        {
+          return (v >> D) & T(1);
+        }
+        template <typename T>
+        static bool apply_divide(T q)
+        {
+          return (q & T(1)) != 0;
+        }
+        template <typename T>
+        static bool apply_floor(T f)
+        {
+          return (f & T(1)) != 0;
+        }
+      };
+      //! exactly-half values go to the odd quotient.
+      struct tie_odd
+      {
+        template <boost::uintmax_t D, typename T>
+        static T apply(T v)
+        {
+          return T(1) - ((v >> D) & T(1));
+        }
+        template <typename T>
+        static bool apply_divide(T q)
+        {
+          return (q & T(1)) == 0;
+        }
+        template <typename T>
+        static bool apply_floor(T f)
+        {
+          return (f & T(1)) == 0;
+        }
+      };
+
+      /**
+       * Rounds to nearest the quotient of a division by @c d, given the truncated quotient @c q and the remainder
+       * @c r, which has the sign of the dividend.
+       *
+       * The truncated quotient is corrected by one unit in the direction of the exact result when the remainder is
+       * greater than the half of the divisor, or when it is exactly the half and @c Tie decides so.
+       */
+      template <typename Tie, typename T, bool IsSigned = is_signed<T>::value>
+      struct nearest_quotient
+      {
+        static T apply(T q, T r, T d)
+        {
+          T sr = sign_mask<T>::apply(r);
+          T sd = sign_mask<T>::apply(d);
+          T ar = (r ^ sr) - sr;
+          T ad = (d ^ sd) - sd;
+          T rest = ad - ar;
+          T s = sr ^ sd;
+          // bitwise operators, as the short-circuit ones would branch on the remainder
+          T up = T((ar > rest) | ((ar == rest) & (ar != 0) & Tie::template apply_divide<T>(q)));
+          return q + ((up ^ s) - s);
+        }
+      };
+      template <typename Tie, typename T>
+      struct nearest_quotient<Tie, T, false>
+      {
+        static T apply(T q, T r, T d)
+        {
+          T rest = d - r;
+          return q + T((r > rest) | ((r == rest) & (r != 0) & Tie::template apply_divide<T>(q)));
+        }
+      };
+
+      /**
+       * Common implementation of the round to nearest policies, which differ only on the way exactly-half values are
+       * rounded.
+       */
+      template <typename Tie>
+      struct nearest
+      {
+        template <typename From, typename To>
+        static typename To::underlying_type round_integral(From const& rhs)
+        {
+          BOOST_STATIC_CONSTEXPR boost::uintmax_t d = To::resolution_exp;
+          typedef typename max_type<is_signed<typename To::underlying_type>::value>::type tmp_type;
+          BOOST_STATIC_ASSERT(d < (8 * sizeof(tmp_type)));
+
+          tmp_type res = nearest_shift<Tie, d>::apply(tmp_type(rhs));
+          return res;
+        }
+
+        template <typename From, typename To>
+        static typename float_index<To>::type round_float_point(From const& rhs)
+        {
+          typedef typename float_index<To>::type tmp_type;
+          From y = rhs * To::template inverse_factor<From>();
+          tmp_type f = floor_to<tmp_type>(y);
+          From r = y - From(f);
+          // bitwise operators, as the short-circuit ones would branch on the fractional part
+          return f + tmp_type((r > From(0.5)) | ((r == From(0.5)) & Tie::apply_floor(f)));
+        }
+
+        template <typename From, typename To>
+        static typename To::underlying_type round(From const& rhs)
+        {
+          BOOST_STATIC_CONSTEXPR boost::uintmax_t d = To::resolution_exp-From::resolution_exp;
+          typedef typename wide_type<is_signed<typename To::underlying_type>::value,
+              typename From::underlying_type>::type tmp_type;
+          BOOST_STATIC_ASSERT(d < (8 * sizeof(tmp_type)));
+
+          tmp_type res = nearest_shift<Tie, d>::apply(tmp_type(rhs.count()));
+          BOOST_ASSERT(res <= To::max_index);
+          BOOST_ASSERT(res >= To::min_index);
+          return res;
+        }
+        template <typename To, typename From>
+        static typename To::underlying_type round_divide(From const& lhs, From const& rhs)
+        {
+          typedef typename shift_impl<From, To>::result_type result_type;
+          result_type n = shift<From, To>(lhs.count());
+          result_type d = rhs.count();
+          result_type ci = round_quotient<result_type>(n / d, n % d, d);
+          BOOST_ASSERT(ci <= To::max_index);
+          BOOST_ASSERT(ci >= To::min_index);
+          return ci;
+        }
+        template <typename T>
+        static T round_quotient(T q, T r, T d)
+        {
+          return nearest_quotient<Tie, T>::apply(q, r, d);
+        }
+      };
+
     }
 
     //#include <boost/fixed_point/overflow/exceptions.hpp>
@@ -196,6 +547,12 @@ namespace boost
         static typename To::underlying_type round(From const& rhs);
         template <typename To, typename From>
         static typename To::underlying_type round_divide(From const& lhs, From const& rhs);
+        /**
+         * Rounds the truncated quotient @c q of a division by @c d whose remainder is @c r.
+         * The remainder has the sign of the dividend.
+         */
+        template <typename T>
+        static T round_quotient(T q, T r, T d);
       };
 #endif
       /**
@@ -229,16 +586,17 @@ namespace boost
         }
 
         template <typename From, typename To>
-        static typename To::underlying_type round_float_point(From const& rhs)
+        static typename detail::float_index<To>::type round_float_point(From const& rhs)
         {
-          return To::integer_part(rhs / To::template factor<From>());
+          return detail::floor_to<typename detail::float_index<To>::type>(rhs * To::template inverse_factor<From>());
         }
 
         template <typename From, typename To>
         static typename To::underlying_type round(From const& rhs)
         {
           BOOST_STATIC_CONSTEXPR boost::uintmax_t d = To::resolution_exp-From::resolution_exp;
-          typedef typename detail::max_type<is_signed<typename To::underlying_type>::value>::type tmp_type;
+          typedef typename detail::wide_type<is_signed<typename To::underlying_type>::value,
+              typename From::underlying_type>::type tmp_type;
           BOOST_STATIC_ASSERT(d < (8 * sizeof(tmp_type)));
           //BOOST_MPL_ASSERT_MSG(d<(8*sizeof(tmp_type)), OVERFLOW, (mpl::int_<8*sizeof(tmp_type)>, mpl::int_<d>));
 
@@ -251,29 +609,17 @@ namespace boost
         static typename To::underlying_type round_divide(From const& lhs, From const& rhs)
         {
           typedef typename detail::shift_impl<From, To>::result_type result_type;
-          result_type ci = detail::shift<From, To>(lhs.count()) / rhs.count();
-          if (ci >= 0)
-          {
-            BOOST_ASSERT(ci <= To::max_index);
-            BOOST_ASSERT(ci >= To::min_index);
-            return ci;
-          }
-          else
-          {
-            result_type ri = detail::shift<From, To>(lhs.count()) % rhs.count();
-            if (ri == 0)
-            {
-              BOOST_ASSERT(ci <= To::max_index);
-              BOOST_ASSERT(ci >= To::min_index);
-              return ci;
-            }
-            else
-            {
-              BOOST_ASSERT(ci - 1 <= To::max_index);
-              BOOST_ASSERT(ci >= (To::min_index + 1));
-              return ci - 1;
-            }
-          }
+          result_type n = detail::shift<From, To>(lhs.count());
+          result_type d = rhs.count();
+          result_type ci = round_quotient<result_type>(n / d, n % d, d);
+          BOOST_ASSERT(ci <= To::max_index);
+          BOOST_ASSERT(ci >= To::min_index);
+          return ci;
+        }
+        template <typename T>
+        static T round_quotient(T q, T r, T d)
+        {
+          return q + ((r != 0) ? detail::sign_mask<T>::apply(r ^ d) : T(0));
         }
       };
       /**
@@ -301,16 +647,17 @@ namespace boost
         }
 
         template <typename From, typename To>
-        static typename To::underlying_type round_float_point(From const& rhs)
+        static typename detail::float_index<To>::type round_float_point(From const& rhs)
         {
-          return To::integer_part(rhs / To::template factor<From>());
+          return typename detail::float_index<To>::type(rhs * To::template inverse_factor<From>());
         }
 
         template <typename From, typename To>
         static typename To::underlying_type round(From const& rhs)
         {
           BOOST_STATIC_CONSTEXPR boost::uintmax_t d = To::resolution_exp-From::resolution_exp;
-          typedef typename detail::max_type<is_signed<typename To::underlying_type>::value>::type tmp_type;
+          typedef typename detail::wide_type<is_signed<typename To::underlying_type>::value,
+              typename From::underlying_type>::type tmp_type;
           BOOST_STATIC_ASSERT(d < (8 * sizeof(tmp_type)));
 
           tmp_type m( ( (rhs.count() > 0) ? rhs.count() : -rhs.count()));
@@ -330,6 +677,11 @@ namespace boost
           BOOST_ASSERT(ci >= To::min_index);
           return ci;
         }
+        template <typename T>
+        static T round_quotient(T q, T, T)
+        {
+          return q;
+        }
       };
       /**
        * Rounds toward positive infinity.
@@ -348,32 +700,33 @@ namespace boost
           typedef typename detail::max_type<is_signed<typename To::underlying_type>::value>::type tmp_type;
           BOOST_STATIC_ASSERT(d < (8 * sizeof(tmp_type)));
 
-          BOOST_STATIC_CONSTEXPR tmp_type w = (1<<d)-1;
+          BOOST_STATIC_CONSTEXPR tmp_type w = detail::low_bits_mask<tmp_type, d>::value;
           tmp_type i = rhs;
 
-          BOOST_ASSERT(i <= (integer_traits<tmp_type>::const_max - w));
+          BOOST_ASSERT(i <= (detail::integer_max<tmp_type>::value - w));
 
           tmp_type res = (i + w) >> d;
           return res;
         }
 
         template <typename From, typename To>
-        static typename To::underlying_type round_float_point(From const& rhs)
+        static typename detail::float_index<To>::type round_float_point(From const& rhs)
         {
-          return To::integer_part(rhs / To::template factor<From>());
+          return detail::ceil_to<typename detail::float_index<To>::type>(rhs * To::template inverse_factor<From>());
         }
 
         template <typename From, typename To>
         static typename To::underlying_type round(From const& rhs)
         {
           BOOST_STATIC_CONSTEXPR boost::uintmax_t d = To::resolution_exp-From::resolution_exp;
-          typedef typename detail::max_type<is_signed<typename To::underlying_type>::value>::type tmp_type;
+          typedef typename detail::wide_type<is_signed<typename To::underlying_type>::value,
+              typename From::underlying_type>::type tmp_type;
           BOOST_STATIC_ASSERT(d < (8 * sizeof(tmp_type)));
 
-          BOOST_STATIC_CONSTEXPR tmp_type w = (1<<d)-1;
+          BOOST_STATIC_CONSTEXPR tmp_type w = detail::low_bits_mask<tmp_type, d>::value;
           tmp_type i = rhs.count();
 
-          BOOST_ASSERT(i <= (integer_traits<tmp_type>::const_max - w));
+          BOOST_ASSERT(i <= (detail::integer_max<tmp_type>::value - w));
 
           tmp_type res = (i + w) >> d;
           BOOST_ASSERT(res <= To::max_index);
@@ -384,29 +737,17 @@ namespace boost
         static typename To::underlying_type round_divide(From const& lhs, From const& rhs)
         {
           typedef typename detail::shift_impl<From, To>::result_type result_type;
-          result_type ci = detail::shift<From, To>(lhs.count()) / rhs.count();
-          if (ci >= 0)
-          {
-            result_type ri = detail::shift<From, To>(lhs.count()) % rhs.count();
-            if (ri == 0)
-            {
-              BOOST_ASSERT(ci <= To::max_index);
-              BOOST_ASSERT(ci >= To::min_index);
-              return ci;
-            }
-            else
-            {
-              BOOST_ASSERT(ci <= To::max_index - 1);
-              BOOST_ASSERT(ci + 1 >= To::min_index);
-              return ci + 1;
-            }
-          }
-          else
-          {
-            BOOST_ASSERT(ci <= To::max_index);
-            BOOST_ASSERT(ci >= To::min_index);
-            return ci;
-          }
+          result_type n = detail::shift<From, To>(lhs.count());
+          result_type d = rhs.count();
+          result_type ci = round_quotient<result_type>(n / d, n % d, d);
+          BOOST_ASSERT(ci <= To::max_index);
+          BOOST_ASSERT(ci >= To::min_index);
+          return ci;
+        }
+        template <typename T>
+        static T round_quotient(T q, T r, T d)
+        {
+          return q + ((r != 0) ? T(1) + detail::sign_mask<T>::apply(r ^ d) : T(0));
         }
       };
       /**
@@ -414,15 +755,15 @@ namespace boost
        *
        * This mode is the standard school algorithm.
        */
-      struct nearest_half_up
+      struct nearest_half_up: detail::nearest<detail::tie_half_up>
       {
         BOOST_STATIC_CONSTEXPR
         std::float_round_style round_style = std::round_to_nearest;
       };
       /**
-       * Rounds to nearest half down.
+       * Round towards the nearest value, but exactly-half values are rounded towards minimum magnitude.
        */
-      struct nearest_half_down
+      struct nearest_half_down: detail::nearest<detail::tie_half_down>
       {
         BOOST_STATIC_CONSTEXPR
         std::float_round_style round_style = std::round_to_nearest;
@@ -431,7 +772,7 @@ namespace boost
        * Round towards the nearest value, but exactly-half values are rounded towards even values.
        * This mode has more balance than the classic mode.
        */
-      struct nearest_even
+      struct nearest_even: detail::nearest<detail::tie_even>
       {
         BOOST_STATIC_CONSTEXPR
         std::float_round_style round_style = std::round_to_nearest;
@@ -440,7 +781,7 @@ namespace boost
        * Round towards the nearest value, but exactly-half values are rounded towards odd values.
        * This mode has as much balance as the near_even mode, but preserves more information.
        */
-      struct nearest_odd
+      struct nearest_odd: detail::nearest<detail::tie_odd>
       {
         BOOST_STATIC_CONSTEXPR
         std::float_round_style round_style = std::round_to_nearest;
@@ -530,43 +871,31 @@ namespace boost
       namespace detail
       {
         template <typename T, typename U, bool TisSigned = T::is_signed>
-        struct modulus_on_negative_overflow;
+        struct modulus_wrap;
 
+        // The range of an unsigned number is 2^digits, so the value modulo the range is its low bits, also for the
+        // negative values in two's complement.
         template <typename T, typename U>
-        struct modulus_on_negative_overflow<T, U, false>
+        struct modulus_wrap<T, U, false>
         {
-          static BOOST_CONSTEXPR typename T::underlying_type value(U value)
+          static BOOST_CONSTEXPR typename T::underlying_type value(U val)
           {
-            return (value%(T::max_index-T::min_index+1))+(T::max_index-T::min_index+1);
+            return typename T::underlying_type(val & U(T::max_index));
           }
         };
 
+        // The range of a signed number, from -max_index to max_index, is not a power of two.
         template <typename T, typename U>
-        struct modulus_on_negative_overflow<T, U, true>
+        struct modulus_wrap<T, U, true>
         {
-          static BOOST_CONSTEXPR typename T::underlying_type value(U value)
-          {
-            return ((value-T::min_index)%(T::max_index-T::min_index+1))-T::min_index;
-          }
-        };
+          typedef typename fixed_point::detail::wide_type<true, U>::type tmp_type;
 
-        template <typename T, typename U, bool TisSigned = T::is_signed>
-        struct modulus_on_positive_overflow;
-
-        template <typename T, typename U>
-        struct modulus_on_positive_overflow<T, U, true>
-        {
-          static BOOST_CONSTEXPR typename T::underlying_type value(U value)
-          {
-            return ((value-T::max_index)%(T::max_index-T::min_index+1))-T::max_index;
-          }
-        };
-        template <typename T, typename U>
-        struct modulus_on_positive_overflow<T, U, false>
-        {
-          static BOOST_CONSTEXPR typename T::underlying_type value(U value)
+          static typename T::underlying_type value(U val)
           {
-            return value%(T::max_index-T::min_index+1);
+            const tmp_type range = tmp_type(T::max_index) - tmp_type(T::min_index) + 1;
+            tmp_type r = (tmp_type(val) - tmp_type(T::min_index)) % range;
+            r += range & fixed_point::detail::sign_mask<tmp_type>::apply(r);
+            return typename T::underlying_type(r + tmp_type(T::min_index));
           }
         };
       }
@@ -574,7 +903,8 @@ namespace boost
 
       /**
        * The assigned value is the dynamic value @c mod the range of the variable.
-       * This mode makes sense only with unsigned numbers. It is useful for angular measures.
+       * This mode makes sense only with unsigned numbers, whose range is a power of two so that the value is wrapped
+       * by masking its low bits. It is useful for angular measures.
        */
       struct modulus
       {
@@ -584,13 +914,13 @@ namespace boost
         template <typename T, typename U>
         static BOOST_CONSTEXPR typename T::underlying_type on_negative_overflow(U val)
         {
-          return detail::modulus_on_negative_overflow<T,U>::value(val);
+          return detail::modulus_wrap<T,U>::value(val);
         }
 
         template <typename T, typename U>
-        static BOOST_CONSTEXPR typename T::underlying_type modulus_on_positive_overflow(U val)
+        static BOOST_CONSTEXPR typename T::underlying_type on_positive_overflow(U val)
         {
-          return detail::modulus_on_negative_overflow<T,U>::value(val);
+          return detail::modulus_wrap<T,U>::value(val);
         }
       };
       /**
@@ -633,6 +963,71 @@ namespace boost
         }
 
       };
+
+      /**
+       * Flags recorded by the overflow::sticky policy.
+       */
+      enum sticky_flags
+      {
+        no_overflow = 0, positive_overflow_flag = 1, negative_overflow_flag = 2
+      };
+
+#if ! defined(BOOST_FIXED_POINT_DOXYGEN_INVOKED)
+      namespace detail
+      {
+        inline unsigned& sticky_word()
+        {
+          static BOOST_FIXED_POINT_THREAD_LOCAL unsigned word = no_overflow;
+          return word;
+        }
+      }
+#endif
+
+      /**
+       * @Returns the sticky_flags of the overflows that occurred on the current thread since the last reset.
+       */
+      inline unsigned sticky_status()
+      {
+        return detail::sticky_word();
+      }
+
+      /**
+       * @Effects Clears the sticky_flags of the current thread.
+       * @Returns the sticky_flags before clearing them.
+       */
+      inline unsigned reset_sticky_status()
+      {
+        unsigned res = detail::sticky_word();
+        detail::sticky_word() = no_overflow;
+        return res;
+      }
+
+      /**
+       * If the dynamic value exceeds the range of the variable, the value is handled by the @c Handling policy,
+       * saturated by default, and the overflow is recorded in a per thread sticky status word.
+       *
+       * Unlike overflow::exception, nothing prevents the conversions from being inlined and vectorized; the status is
+       * checked once after a sequence of operations with sticky_status() or reset_sticky_status().
+       */
+      template <typename Handling = saturate>
+      struct sticky
+      {
+        BOOST_STATIC_CONSTEXPR
+        bool is_modulo = Handling::is_modulo;
+
+        template <typename T, typename U>
+        static typename T::underlying_type on_negative_overflow(U value)
+        {
+          detail::sticky_word() |= negative_overflow_flag;
+          return Handling::template on_negative_overflow<T, U>(value);
+        }
+        template <typename T, typename U>
+        static typename T::underlying_type on_positive_overflow(U value)
+        {
+          detail::sticky_word() |= positive_overflow_flag;
+          return Handling::template on_positive_overflow<T, U>(value);
+        }
+      };
     }
   } // namespace fixed_point
 
@@ -694,7 +1089,7 @@ namespace boost
         template <int Range, int Resolution>
         struct signed_integer_type
         {
-          typedef typename ::boost::int_t<Range - Resolution + 1>::least type;
+          typedef typename detail::int_t<Range - Resolution + 1>::least type;
         };
 
         /**
@@ -704,7 +1099,7 @@ namespace boost
         template <int Range, int Resolution>
         struct unsigned_integer_type
         {
-          typedef typename ::boost::uint_t<Range - Resolution>::least type;
+          typedef typename detail::uint_t<Range - Resolution>::least type;
         };
       };
       /**
@@ -715,12 +1110,12 @@ namespace boost
         template <int Range, int Resolution>
         struct signed_integer_type
         {
-          typedef typename ::boost::int_t<Range - Resolution + 1>::least type;
+          typedef typename detail::int_t<Range - Resolution + 1>::least type;
         };
         template <int Range, int Resolution>
         struct unsigned_integer_type
         {
-          typedef typename ::boost::uint_t<Range - Resolution>::least type;
+          typedef typename detail::uint_t<Range - Resolution>::least type;
         };
       };
       /**
@@ -731,15 +1126,39 @@ namespace boost
         template <int Range, int Resolution>
         struct signed_integer_type
         {
-          typedef typename ::boost::int_t<Range - Resolution + 1>::fast type;
+          typedef typename detail::int_t<Range - Resolution + 1>::fast type;
         };
         template <int Range, int Resolution>
         struct unsigned_integer_type
         {
-          typedef typename ::boost::uint_t<Range - Resolution>::fast type;
+          typedef typename detail::uint_t<Range - Resolution>::fast type;
         };
 
       };
+      /**
+       * The storage is the integer register of the machine, boost::intptr_t or boost::uintptr_t, or the least
+       * integer with enough bits when the number is wider.
+       *
+       * The results of the operations of the family keep this storage, so that a chain of operations works on
+       * registers without sign or zero extension between them. The arrays should rather hold the numbers of the same
+       * format with storage::space, which are converted exactly from and to these ones (see rebind_storage), so that
+       * the numbers are narrowed only when stored into an element.
+       */
+      struct native
+      {
+        template <int Range, int Resolution>
+        struct signed_integer_type
+        {
+          typedef typename mpl::if_c<(Range - Resolution + 1 <= int(sizeof(detail::register_int) * CHAR_BIT)),
+              detail::register_int, typename detail::int_t<Range - Resolution + 1>::least>::type type;
+        };
+        template <int Range, int Resolution>
+        struct unsigned_integer_type
+        {
+          typedef typename mpl::if_c<(Range - Resolution <= int(sizeof(detail::register_uint) * CHAR_BIT)),
+              detail::register_uint, typename detail::uint_t<Range - Resolution>::least>::type type;
+        };
+      };
     }
   } // namespace fixed_point
 
@@ -807,6 +1226,17 @@ namespace boost
     typedef Overflow type;
   };
 
+  template <typename Handling>
+  struct common_type<fixed_point::overflow::sticky<Handling>, fixed_point::overflow::undefined>
+  {
+    typedef fixed_point::overflow::sticky<Handling> type;
+  };
+  template <typename Handling>
+  struct common_type<fixed_point::overflow::undefined, fixed_point::overflow::sticky<Handling> >
+  {
+    typedef fixed_point::overflow::sticky<Handling> type;
+  };
+
   namespace fixed_point
   {
     /**
@@ -1132,7 +1562,7 @@ namespace boost
         BOOST_STATIC_CONSTEXPR std::size_t digits = (Range-Resolution)+1;
         BOOST_STATIC_ASSERT_MSG((sizeof(T)*8)>=digits, "LLLL");
         //BOOST_MPL_ASSERT_MSG((sizeof(T)*8)>=digits, LLLL, (mpl::int_<sizeof(T)*8>, mpl::int_<digits>));
-        BOOST_STATIC_CONSTEXPR T const_max = (1LL<<(digits-1)) - 1;
+        BOOST_STATIC_CONSTEXPR T const_max = low_bits_mask<T, digits-1>::value;
         BOOST_STATIC_CONSTEXPR T const_min = -const_max;
 
       };
@@ -1140,7 +1570,7 @@ namespace boost
       struct unsigned_integer_traits
       {
         BOOST_STATIC_CONSTEXPR std::size_t digits = (Range-Resolution);
-        BOOST_STATIC_CONSTEXPR T const_max = (1LL<<(digits)) - 1;
+        BOOST_STATIC_CONSTEXPR T const_max = low_bits_mask<T, digits>::value;
         BOOST_STATIC_CONSTEXPR T const_min = 0;
 
       };
@@ -1286,22 +1716,24 @@ namespace boost
         typedef real_t<R1,P1,RP1,OP1,F1> From;
         typedef ureal_t<R2,P2,RP2,OP2,F2> To;
         typedef typename To::underlying_type underlying_type;
+        // the negative values are shifted on the signed wide type, the unsigned underlying type of To can't hold them.
+        typedef typename detail::wide_type<From::is_signed, typename From::underlying_type>::type tmp_type;
 
         BOOST_CONSTEXPR To operator()(const From& rhs) const
         {
-          //          underlying_type indx((underlying_type(rhs.count()) << (P1-P2)));
+          //          tmp_type indx((tmp_type(rhs.count()) << (P1-P2)));
           //          // Overflow
-          //          if (indx < To::min_index)
-          //            return To(index(OP2::template on_negative_overflow<To,underlying_type>(indx)));
+          //          if (rhs.count() < 0)
+          //            return To(index(OP2::template on_negative_overflow<To,tmp_type>(indx)));
           //          else // No round needed
           //            return To(index(underlying_type(rhs.count()) << (P1-P2)));
 
           return
           (
-              (((underlying_type(rhs.count()) << (P1-P2))) < To::min_index)
+              (rhs.count() < typename From::underlying_type(0))
               ? To(index(
-                      OP2::template on_negative_overflow<To,underlying_type>(
-                          ((underlying_type(rhs.count()) << (P1-P2)))
+                      OP2::template on_negative_overflow<To,tmp_type>(
+                          ((tmp_type(rhs.count()) << (P1-P2)))
                       )
                   ))
               : To(index(underlying_type(rhs.count()) << (P1-P2)))
@@ -1322,6 +1754,8 @@ namespace boost
         typedef real_t<R1,P1,RP1,OP1,F1> From;
         typedef real_t<R2,P2,RP2,OP2,F2> To;
         typedef typename To::underlying_type underlying_type;
+        // the shifted value is compared before being converted to the underlying type of To.
+        typedef typename detail::wide_type<From::is_signed, typename From::underlying_type>::type tmp_type;
 
         BOOST_CONSTEXPR To operator()(const From& rhs) const
         {
@@ -1336,20 +1770,20 @@ namespace boost
 
           return
           (
-              (((underlying_type(rhs.count()) << (P1-P2))) > To::max_index)
+              (((tmp_type(rhs.count()) << (P1-P2))) > To::max_index)
               ? To(index(
-                      OP2::template on_positive_overflow<To,underlying_type>(
-                          ((underlying_type(rhs.count()) << (P1-P2)))
+                      OP2::template on_positive_overflow<To,tmp_type>(
+                          ((tmp_type(rhs.count()) << (P1-P2)))
                       )
                   ))
               : (
-                  (((underlying_type(rhs.count()) << (P1-P2))) < To::min_index)
+                  (((tmp_type(rhs.count()) << (P1-P2))) < To::min_index)
                   ? To(index(
-                          OP2::template on_negative_overflow<To,underlying_type>(
-                              ((underlying_type(rhs.count()) << (P1-P2)))
+                          OP2::template on_negative_overflow<To,tmp_type>(
+                              ((tmp_type(rhs.count()) << (P1-P2)))
                           )
                       ))
-                  : To(index(((underlying_type(rhs.count()) << (P1-P2)))))
+                  : To(index(((tmp_type(rhs.count()) << (P1-P2)))))
               )
           );
         }
@@ -1364,34 +1798,38 @@ namespace boost
         typedef real_t<R1,P1,RP1,OP1,F1> From;
         typedef ureal_t<R2,P2,RP2,OP2,F2> To;
         typedef typename To::underlying_type underlying_type;
+        // the shifted value is compared before being converted to the underlying type of To.
+        typedef typename detail::wide_type<From::is_signed, typename From::underlying_type>::type tmp_type;
 
         BOOST_CONSTEXPR To operator()(const From& rhs) const
         {
 
-          //          underlying_type indx((underlying_type(rhs.count()) << (P1-P2)));
-          //          // Overflow impossible
-          //          if (indx > To::max_index)
-          //            return To(index(OP2::template on_positive_overflow<To,underlying_type>(indx)));
-          //          else if (indx < To::min_index)
-          //            return To(index(OP2::template on_negative_overflow<To,underlying_type>(indx)));
+          //          tmp_type indx((tmp_type(rhs.count()) << (P1-P2)));
+          //          // Overflow
+          //          if (rhs.count() < 0)
+          //            return To(index(OP2::template on_negative_overflow<To,tmp_type>(indx)));
+          //          else if (indx > To::max_index)
+          //            return To(index(OP2::template on_positive_overflow<To,tmp_type>(indx)));
           //          else // No round needed
           //            return To(index(indx));
 
+          // the negative values are excluded first, as the comparison with the unsigned max_index would convert them
+          // to large positive values.
           return (
-              (((underlying_type(rhs.count()) << (P1-P2))) > To::max_index)
+              (rhs.count() < typename From::underlying_type(0))
               ? To(index(
-                      OP2::template on_positive_overflow<To,underlying_type>(
-                          ((underlying_type(rhs.count()) << (P1-P2)))
+                      OP2::template on_negative_overflow<To,tmp_type>(
+                          ((tmp_type(rhs.count()) << (P1-P2)))
                       )
                   ))
               : (
-                  (((underlying_type(rhs.count()) << (P1-P2))) < To::min_index)
+                  (((tmp_type(rhs.count()) << (P1-P2))) > To::max_index)
                   ? To(index(
-                          OP2::template on_negative_overflow<To,underlying_type>(
-                              ((underlying_type(rhs.count()) << (P1-P2)))
+                          OP2::template on_positive_overflow<To,tmp_type>(
+                              ((tmp_type(rhs.count()) << (P1-P2)))
                           )
                       ))
-                  : To(index(((underlying_type(rhs.count()) << (P1-P2)))))
+                  : To(index(((tmp_type(rhs.count()) << (P1-P2)))))
               )
           );
         }
@@ -1406,6 +1844,8 @@ namespace boost
         typedef ureal_t<R1,P1,RP1,OP1,F1> From;
         typedef ureal_t<R2,P2,RP2,OP2,F2> To;
         typedef typename To::underlying_type underlying_type;
+        // the shifted value is compared before being converted to the underlying type of To.
+        typedef typename detail::wide_type<From::is_signed, typename From::underlying_type>::type tmp_type;
 
         BOOST_CONSTEXPR To operator()(const From& rhs) const
         {
@@ -1419,13 +1859,13 @@ namespace boost
           //
           return
           (
-              (((underlying_type(rhs.count()) << (P1-P2))) > To::max_index)
+              (((tmp_type(rhs.count()) << (P1-P2))) > To::max_index)
               ? To(index(
-                      OP2::template on_positive_overflow<To,underlying_type>(
-                          ((underlying_type(rhs.count()) << (P1-P2)))
+                      OP2::template on_positive_overflow<To,tmp_type>(
+                          ((tmp_type(rhs.count()) << (P1-P2)))
                       )
                   ))
-              : To(index(((underlying_type(rhs.count()) << (P1-P2)))))
+              : To(index(((tmp_type(rhs.count()) << (P1-P2)))))
           );
         }
       };
@@ -1439,6 +1879,8 @@ namespace boost
         typedef ureal_t<R1,P1,RP1,OP1,F1> From;
         typedef real_t<R2,P2,RP2,OP2,F2> To;
         typedef typename To::underlying_type underlying_type;
+        // the shifted value is compared before being converted to the underlying type of To.
+        typedef typename detail::wide_type<From::is_signed, typename From::underlying_type>::type tmp_type;
 
         BOOST_CONSTEXPR To operator()(const From& rhs) const
         {
@@ -1452,11 +1894,11 @@ namespace boost
 
           return
           (
-              (((underlying_type(rhs.count()) << (P1-P2))) > To::max_index)
+              (((tmp_type(rhs.count()) << (P1-P2))) > To::max_index)
               ? To(index(
-                      OP2::template on_positive_overflow<To,underlying_type>(((underlying_type(rhs.count()) << (P1-P2))))
+                      OP2::template on_positive_overflow<To,tmp_type>(((tmp_type(rhs.count()) << (P1-P2))))
                   ))
-              : To(index(((underlying_type(rhs.count()) << (P1-P2)))))
+              : To(index(((tmp_type(rhs.count()) << (P1-P2)))))
           );
 
         }
@@ -2358,10 +2800,16 @@ namespace boost
       template <typename FP>
       static FP factor()
       {
-        if (Resolution>=0) return FP(detail::shift_left<Resolution>(1));
-        else return FP(1)/(detail::shift_left<-Resolution>(1));
+        // 2^Resolution is exact in any binary floating point type, even when 1 << |Resolution| overflows an int.
+        return std::ldexp(FP(1), Resolution);
 
       }
+      //! @Returns the inverse of the conversion factor, so that the conversions from @c FP multiply instead of dividing.
+      template <typename FP>
+      static FP inverse_factor()
+      {
+        return std::ldexp(FP(1), -Resolution);
+      }
 
       /**
        * Reconstructs a floating point type from the underlying type.
@@ -2430,7 +2878,7 @@ namespace boost
       template <typename FP>
       static underlying_type integer_part(FP x)
       {
-        return underlying_type(std::floor(x));
+        return detail::floor_to<underlying_type>(x);
       }
       template <typename I>
       static underlying_type classify(I i
@@ -2461,9 +2909,25 @@ namespace boost
 #endif
       )
       {
+        typedef typename detail::float_index<self_type>::type index_type;
+        // The values beyond the bounds by one unit or more overflow whatever the rounding, and converting them to an
+        // integer could overflow it. The policies wrapping the values need them, and only overflow beyond the
+        // integer.
+        const FP wide = FP(detail::integer_max<index_type>::value);
+        FP y = x * inverse_factor<FP>();
+        if (y >= (overflow_type::is_modulo ? wide : FP(max_index) + FP(1)))
+        {
+          return overflow_type::template on_positive_overflow<self_type,index_type>(
+              detail::integer_max<index_type>::value);
+        }
+        if (y <= (overflow_type::is_modulo ? -wide : FP(min_index) - FP(1)))
+        {
+          return overflow_type::template on_negative_overflow<self_type,index_type>(
+              -detail::integer_max<index_type>::value);
+        }
 
         // Round
-        underlying_type indx = rounding_type::template round_float_point<FP,self_type>(x);
+        index_type indx = rounding_type::template round_float_point<FP,self_type>(x);
         // Overflow
         if (indx > max_index)
         {
@@ -2860,13 +3324,19 @@ namespace boost
       template <typename FP>
       static FP factor()
       {
-        if (Resolution>=0) return FP(detail::shift_left<Resolution>(1));
-        else return FP(1)/(detail::shift_left<-Resolution>(1));
+        // 2^Resolution is exact in any binary floating point type, even when 1 << |Resolution| overflows an int.
+        return std::ldexp(FP(1), Resolution);
+      }
+      //! @Returns the inverse of the conversion factor, so that the conversions from @c FP multiply instead of dividing.
+      template <typename FP>
+      static FP inverse_factor()
+      {
+        return std::ldexp(FP(1), -Resolution);
       }
       template <typename FP>
       static underlying_type integer_part(FP x)
       {
-        return underlying_type(std::floor(x));
+        return detail::floor_to<underlying_type>(x);
       }
       template <typename FP>
       static FP reconstruct(underlying_type k)
@@ -2903,11 +3373,21 @@ namespace boost
 #endif
       )
       {
+        typedef typename detail::float_index<self_type>::type index_type;
         if (x<0)
         return overflow_type::template on_negative_overflow<self_type,underlying_type>(0);
+        // The values beyond the bound by one unit or more overflow whatever the rounding, and converting them to an
+        // integer could overflow it. The policies wrapping the values need them, and only overflow beyond the
+        // integer.
+        const FP wide = FP(detail::integer_max<index_type>::value);
+        if (x * inverse_factor<FP>() >= (overflow_type::is_modulo ? wide : FP(max_index) + FP(1)))
+        {
+          return overflow_type::template on_positive_overflow<self_type,index_type>(
+              detail::integer_max<index_type>::value);
+        }
 
         // Round
-        underlying_type indx = rounding_type::template round_float_point<FP,self_type>(x);
+        index_type indx = rounding_type::template round_float_point<FP,self_type>(x);
         // Overflow
         if (indx > max_index)
         {
@@ -2983,7 +3463,7 @@ namespace boost
 #ifndef BOOST_NO_EXPLICIT_CONVERSION_OPERATORS      //! explicit conversion to float.
       explicit operator unsigned int() const
       {
-        return as_unsigned_int());
+        return as_unsigned_int();
       }
       //! explicit conversion to float.
       explicit operator float() const
@@ -3507,6 +3987,28 @@ namespace boost
       return result_type(index(result_type(lhs).count()-result_type(rhs).count()));
     }
 
+    /**
+     * The fixed point type @c T with the storage policy @c Storage, as the numbers stored with storage::space of the
+     * ones computed with storage::native. The conversions between both types are exact and implicit, as they have the
+     * same range and resolution.
+     */
+    template <typename T, typename Storage>
+    struct rebind_storage;
+#if ! defined(BOOST_FIXED_POINT_DOXYGEN_INVOKED)
+    template <int R, int P, typename RP, typename OP, typename S, typename CFp, typename CB, typename A, typename B,
+        typename Storage>
+    struct rebind_storage<real_t<R, P, RP, OP, family<S, CFp, CB, A, B> >, Storage>
+    {
+      typedef real_t<R, P, RP, OP, family<Storage, CFp, CB, A, B> > type;
+    };
+    template <int R, int P, typename RP, typename OP, typename S, typename CFp, typename CB, typename A, typename B,
+        typename Storage>
+    struct rebind_storage<ureal_t<R, P, RP, OP, family<S, CFp, CB, A, B> >, Storage>
+    {
+      typedef ureal_t<R, P, RP, OP, family<Storage, CFp, CB, A, B> > type;
+    };
+#endif
+
     /**
      * Multiply type metafunction.
      *
@@ -3892,6 +4394,100 @@ namespace boost
       return divide<result_type>(lhs,rhs);
     }
 
+    // fused multiply-add
+
+    /**
+     * Fused multiply-add type metafunction, the exact type of <c>a * b + c</c>:
+     * <c>add_result<multiply_result<T1,T2>::type, T3>::type</c>.
+     */
+    template <typename T1, typename T2, typename T3>
+    struct fma_result : add_result<typename multiply_result<T1,T2>::type, T3>
+    {
+    };
+
+    namespace detail
+    {
+      /**
+       * The exact type of <c>a * b + c</c>, with the resolution min(P1+P2, P3) and one bit of range more than the
+       * product and the addend, whatever the arithmetic and the rounding policies of the arguments, and with the
+       * policies of @c Res.
+       */
+      template <typename Res, typename T1, typename T2, typename T3>
+      struct fma_exact
+      {
+        BOOST_STATIC_CONSTEXPR int product_resolution = T1::resolution_exp + T2::resolution_exp;
+        BOOST_STATIC_CONSTEXPR int resolution = (product_resolution < T3::resolution_exp) ? product_resolution
+            : T3::resolution_exp;
+        BOOST_STATIC_CONSTEXPR int product_range = T1::range_exp + T2::range_exp;
+        BOOST_STATIC_CONSTEXPR int range = ((product_range > T3::range_exp) ? product_range : T3::range_exp) + 1;
+        typedef typename mpl::if_c<T1::is_signed || T2::is_signed || T3::is_signed,
+            real_t<range, resolution, typename Res::rounding_type, typename Res::overflow_type,
+                typename Res::family_type>,
+            ureal_t<range, resolution, typename Res::rounding_type, typename Res::overflow_type,
+                typename Res::family_type> >::type type;
+      };
+
+      template <typename Res, typename T1, typename T2, typename T3>
+      Res fma_impl(T1 const& a, T2 const& b, T3 const& c)
+      {
+        typedef typename fma_exact<Res, T1, T2, T3>::type exact_type;
+        typedef typename exact_type::underlying_type W;
+        // the exact value at the resolution of exact_type: one of the shifts is 0
+        BOOST_STATIC_CONSTEXPR int product_shift = fma_exact<Res, T1, T2, T3>::product_resolution
+            - exact_type::resolution_exp;
+        BOOST_STATIC_CONSTEXPR int addend_shift = T3::resolution_exp - exact_type::resolution_exp;
+        W v = W(a.count()) * W(b.count()) * (W(1) << product_shift) + W(c.count()) * (W(1) << addend_shift);
+        // the single rounding, a shift, and the overflow check
+        return number_cast<exact_type, Res>()(exact_type(index(v)));
+      }
+    }
+
+    /**
+     * Fused multiply-add giving the expected result type.
+     *
+     * <c>a * b + c</c> is computed exactly on an integer wide enough, 128 bits when needed, with a multiplication
+     * and an addition, and rounded once with the rounding policy of @c Res, with a shift. The arguments may have
+     * different rounding policies, and closed types, whose operators would not be exact, are accepted.
+     *
+     * @Returns <c>number_cast<Res>(a * b + c)</c>, taking in account the rounding and the overflow policies of the
+     * result type @c Res.
+     */
+    template <typename Res, typename T1, typename T2, typename T3>
+    inline
+    Res
+    fma(T1 const& a, T2 const& b, T3 const& c)
+    {
+      return detail::fma_impl<Res>(a, b, c);
+    }
+
+    /**
+     * @Returns <c>a * b + c</c>, exactly, as a <c>fma_result<real_t,real_t,real_t>::type</c>.
+     */
+    template <int R1, int P1, typename RP1, typename OP1, typename F1,
+    int R2, int P2, typename RP2, typename OP2, typename F2,
+    int R3, int P3, typename RP3, typename OP3, typename F3>
+    inline
+    typename fma_result<real_t<R1,P1,RP1,OP1,F1>, real_t<R2,P2,RP2,OP2,F2>, real_t<R3,P3,RP3,OP3,F3> >::type
+    fma(real_t<R1,P1,RP1,OP1,F1> const& a, real_t<R2,P2,RP2,OP2,F2> const& b, real_t<R3,P3,RP3,OP3,F3> const& c)
+    {
+      return detail::fma_impl<typename fma_result<real_t<R1,P1,RP1,OP1,F1>, real_t<R2,P2,RP2,OP2,F2>,
+          real_t<R3,P3,RP3,OP3,F3> >::type>(a, b, c);
+    }
+
+    /**
+     * @Returns <c>a * b + c</c>, exactly, as a <c>fma_result<ureal_t,ureal_t,ureal_t>::type</c>.
+     */
+    template <int R1, int P1, typename RP1, typename OP1, typename F1,
+    int R2, int P2, typename RP2, typename OP2, typename F2,
+    int R3, int P3, typename RP3, typename OP3, typename F3>
+    inline
+    typename fma_result<ureal_t<R1,P1,RP1,OP1,F1>, ureal_t<R2,P2,RP2,OP2,F2>, ureal_t<R3,P3,RP3,OP3,F3> >::type
+    fma(ureal_t<R1,P1,RP1,OP1,F1> const& a, ureal_t<R2,P2,RP2,OP2,F2> const& b, ureal_t<R3,P3,RP3,OP3,F3> const& c)
+    {
+      return detail::fma_impl<typename fma_result<ureal_t<R1,P1,RP1,OP1,F1>, ureal_t<R2,P2,RP2,OP2,F2>,
+          ureal_t<R3,P3,RP3,OP3,F3> >::type>(a, b, c);
+    }
+
     // comparisons
 
     /**
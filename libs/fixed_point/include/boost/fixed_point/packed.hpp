@@ -0,0 +1,782 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Vicente J. Botet Escriba 2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/fixed_point for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file
+ * @brief Defines packed arrays of fixed point numbers, stored on their digits only.
+ *
+ * A @c packed_array<T> stores the underlying integers of its elements on <c>T::digits</c> bits each, one after the
+ * other in 64 bits words, instead of on the 8, 16, 32 or 64 bits of @c T. A @c real_t<4,-7> has 12 digits, so
+ * 1000 of them take 1500 bytes instead of 2000. The elements are read and written one by one through proxies, or
+ * converted from and to arrays of @c T by @c batch::unpack and @c batch::pack, with AVX2 or AVX-512 VBMI
+ * instructions for the numbers of at most 25 digits.
+ */
+
+#ifndef BOOST_FIXED_POINT_PACKED_HPP
+#define BOOST_FIXED_POINT_PACKED_HPP
+
+#include <boost/fixed_point/number.hpp>
+#include <boost/fixed_point/batch.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+namespace boost
+{
+  namespace fixed_point
+  {
+#if defined(BOOST_FIXED_POINT_SIMD_X86)
+    namespace simd
+    {
+      namespace detail
+      {
+        /**
+         * The layout of @c count consecutive elements of @c bits bits, the first one starting at the bit @c phase
+         * of the byte 0, unpacked to or packed from the 32 bits lanes of a vector.
+         *
+         * The element @c j is read from the 4 bytes <c>gather[4j..4j+3]</c> and shifted right by @c shift[j].
+         * When packing, the byte @c k of the result is the byte <c>even[k]</c>, or <c>odd[k]</c>, of the vector of
+         * the elements shifted left by @c shift, 0x80 standing for none. An element of at least 8 bits shares each
+         * of its bytes with at most one element, so the bytes of the even elements and of the odd ones don't
+         * overlap.
+         */
+        inline void packed_lanes(int bits, int phase, int count, boost::uint8_t* gather, boost::int32_t* shift,
+            boost::uint8_t* even, boost::uint8_t* odd)
+        {
+          for (int k = 0; even != 0 && k < 4 * count; ++k)
+            even[k] = odd[k] = 0x80;
+          for (int j = 0; j < count; ++j)
+          {
+            int r = phase + j * bits;
+            int off = r >> 3;
+            shift[j] = r & 7;
+            if (gather != 0)
+              for (int b = 0; b < 4; ++b)
+                gather[4 * j + b] = boost::uint8_t(off + b);
+            if (even != 0)
+              for (int k = off; k <= (r + bits - 1) >> 3; ++k)
+                ((j & 1) ? odd : even)[k] = boost::uint8_t(4 * j + k - off);
+          }
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // AVX2
+
+        /**
+         * The 8 elements starting at the byte @c p, the elements 4 to 7 starting at the byte <c>p + half</c>,
+         * extended to 32 bits lanes.
+         */
+        __attribute__((target("avx2")))
+        inline __m256i unpack8_avx2(const boost::uint8_t* p, std::size_t half, __m256i gather, __m256i shift,
+            __m128i left, __m256i mask, bool is_signed)
+        {
+          __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*) p)),
+              _mm_loadu_si128((const __m128i*) (p + half)), 1);
+          v = _mm256_srlv_epi32(_mm256_shuffle_epi8(v, gather), shift);
+          return is_signed ? _mm256_sra_epi32(_mm256_sll_epi32(v, left), left) : _mm256_and_si256(v, mask);
+        }
+
+        /**
+         * Unpacks the @c n elements of @c bits bits, at most 25, starting at the element @c first of the @c size
+         * bytes @c data, to the integers of @c res_size bytes @c res.
+         */
+        __attribute__((target("avx2")))
+        inline std::size_t unpack_avx2(const boost::uint8_t* data, std::size_t size, std::size_t first, int bits,
+            bool is_signed, void* res, std::size_t res_size, std::size_t n)
+        {
+          const int phase = int((first * bits) & 7);
+          const std::size_t half = std::size_t(phase + 4 * bits) >> 3;
+          boost::uint8_t gather[32];
+          boost::int32_t shift[8];
+          packed_lanes(bits, phase, 4, gather, shift, 0, 0);
+          packed_lanes(bits, (phase + 4 * bits) & 7, 4, gather + 16, shift + 4, 0, 0);
+          const __m256i g = _mm256_loadu_si256((const __m256i*) gather);
+          const __m256i s = _mm256_loadu_si256((const __m256i*) shift);
+          const __m128i left = _mm_cvtsi32_si128(32 - bits);
+          const __m256i mask = _mm256_set1_epi32(int((boost::uint32_t(1) << bits) - 1));
+          const std::size_t step = 32 / res_size;
+          const std::size_t start = (first * bits) >> 3;
+          std::size_t i = 0;
+          for (; i + step <= n; i += step)
+          {
+            if (start + (i + step - 8) / 8 * bits + half + 16 > size) break;
+            __m256i v[4];
+            for (std::size_t k = 0; k < step / 8; ++k)
+              v[k] = unpack8_avx2(data + start + (i / 8 + k) * bits, half, g, s, left, mask, is_signed);
+            __m256i r = v[0];
+            if (res_size == 2)
+              r = _mm256_permute4x64_epi64(is_signed ? _mm256_packs_epi32(v[0], v[1])
+                  : _mm256_packus_epi32(v[0], v[1]), 0xD8);
+            else if (res_size == 1)
+            {
+              __m256i ab = is_signed ? _mm256_packs_epi32(v[0], v[1]) : _mm256_packus_epi32(v[0], v[1]);
+              __m256i cd = is_signed ? _mm256_packs_epi32(v[2], v[3]) : _mm256_packus_epi32(v[2], v[3]);
+              r = _mm256_permutevar8x32_epi32(is_signed ? _mm256_packs_epi16(ab, cd) : _mm256_packus_epi16(ab, cd),
+                  _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+            }
+            _mm256_storeu_si256((__m256i*) ((boost::uint8_t*) res + i * res_size), r);
+          }
+          return i;
+        }
+
+        //! The integer @c j of @c res_size bytes of @c x, on its @c mask bits.
+        inline boost::uint32_t packed_input(const boost::uint8_t* x, std::size_t res_size, std::size_t j,
+            boost::uint32_t mask)
+        {
+          if (res_size == 4) return *(const boost::uint32_t*) (x + 4 * j) & mask;
+          if (res_size == 2) return *(const boost::uint16_t*) (x + 2 * j) & mask;
+          return x[j] & mask;
+        }
+
+        /**
+         * Packs the @c n integers of @c res_size bytes @c x to the elements of @c bits bits, from 8 to 25, starting
+         * at the element @c first of the @c size bytes @c data. The bits of the other elements are kept.
+         *
+         * Each group of 8 elements is stored as 32 bytes, of which the next group rewrites all but the first
+         * @c bits ones. The bits of the byte they share are carried in a register rather than read back from
+         * memory, which would wait for the previous store.
+         */
+        __attribute__((target("avx2")))
+        inline std::size_t pack_avx2(const void* x, std::size_t res_size, boost::uint8_t* data, std::size_t size,
+            std::size_t first, int bits, std::size_t n)
+        {
+          const int phase = int((first * bits) & 7);
+          boost::int32_t shift[8];
+          boost::uint8_t even[32], odd[32], table[4][32], keep[32];
+          packed_lanes(bits, phase, 8, 0, shift, even, odd);
+          // The byte k is taken from the lane k / 16 of v = [x0..x3 | x4..x7] or of w = [x4..x7 | x0..x3].
+          for (int k = 0; k < 32; ++k)
+          {
+            table[0][k] = table[1][k] = table[2][k] = table[3][k] = 0x80;
+            for (int t = 0; t < 2; ++t)
+            {
+              int c = (t == 0 ? even : odd)[k];
+              if (c != 0x80) table[((c >> 4) == (k >> 4) ? 0 : 2) + t][k] = boost::uint8_t(c & 15);
+            }
+            keep[k] = boost::uint8_t(k < bits ? 0 : (k == bits && phase != 0) ? 0xFF << phase & 0xFF : 0xFF);
+          }
+          const __m256i s = _mm256_loadu_si256((const __m256i*) shift);
+          const __m256i ve = _mm256_loadu_si256((const __m256i*) table[0]);
+          const __m256i vo = _mm256_loadu_si256((const __m256i*) table[1]);
+          const __m256i we = _mm256_loadu_si256((const __m256i*) table[2]);
+          const __m256i wo = _mm256_loadu_si256((const __m256i*) table[3]);
+          const boost::uint32_t m = (boost::uint32_t(1) << bits) - 1;
+          const __m256i mask = _mm256_set1_epi32(int(m));
+          const boost::uint8_t* in = (const boost::uint8_t*) x;
+          const std::size_t start = (first * bits) >> 3;
+          // the groups whose 32 bytes are in data
+          if (n < 8 || start + 32 > size) return 0;
+          const std::size_t groups = std::min(n / 8, (size - start - 32) / bits + 1);
+          // The bits after the last group, read before the stores of the previous groups overwrite them.
+          const __m256i tail = _mm256_and_si256(_mm256_loadu_si256((const __m256i*) (data + start + (groups - 1)
+              * bits)), _mm256_loadu_si256((const __m256i*) keep));
+          boost::uint32_t carry = data[start] & ((1u << phase) - 1);
+          for (std::size_t g = 0; g < groups; ++g)
+          {
+            const std::size_t i = 8 * g;
+            __m256i v;
+            if (res_size == 4)
+              v = _mm256_loadu_si256((const __m256i*) (in + 4 * i));
+            else if (res_size == 2)
+              v = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*) (in + 2 * i)));
+            else
+              v = _mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i*) (in + i)));
+            v = _mm256_sllv_epi32(_mm256_and_si256(v, mask), s);
+            __m256i w = _mm256_permute2x128_si256(v, v, 0x01);
+            __m256i r = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(v, ve), _mm256_shuffle_epi8(v, vo)),
+                _mm256_or_si256(_mm256_shuffle_epi8(w, we), _mm256_shuffle_epi8(w, wo)));
+            r = _mm256_or_si256(r, _mm256_setr_epi32(int(carry), 0, 0, 0, 0, 0, 0, 0));
+            carry = phase == 0 ? 0 : packed_input(in, res_size, i + 7, m) >> (bits - phase);
+            if (g + 1 == groups) r = _mm256_or_si256(r, tail);
+            _mm256_storeu_si256((__m256i*) (data + start + g * bits), r);
+          }
+          return 8 * groups;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // AVX-512 VBMI
+
+        //! As unpack_avx2, 16 elements at a time, gathered with @c vpermb from a masked load of their bytes.
+        __attribute__((target("avx512f,avx512bw,avx512vbmi")))
+        inline std::size_t unpack_vbmi(const boost::uint8_t* data, std::size_t, std::size_t first, int bits,
+            bool is_signed, void* res, std::size_t res_size, std::size_t n)
+        {
+          const int phase = int((first * bits) & 7);
+          boost::uint8_t gather[64];
+          boost::int32_t shift[16];
+          packed_lanes(bits, phase, 16, gather, shift, 0, 0);
+          const __m512i g = _mm512_loadu_si512(gather);
+          const __m512i s = _mm512_loadu_si512(shift);
+          const __m128i left = _mm_cvtsi32_si128(32 - bits);
+          const __m512i mask = _mm512_set1_epi32(int((boost::uint32_t(1) << bits) - 1));
+          const __mmask64 bytes = (__mmask64(1) << ((phase + 16 * bits + 7) >> 3)) - 1;
+          // the zero masked forms, as the others leave their undefined source uninitialized for gcc
+          const __mmask16 all = 0xFFFF;
+          const std::size_t start = (first * bits) >> 3;
+          boost::uint8_t* r = (boost::uint8_t*) res;
+          std::size_t i = 0;
+          for (; i + 16 <= n; i += 16)
+          {
+            __m512i v = _mm512_maskz_loadu_epi8(bytes, data + start + i / 8 * bits);
+            v = _mm512_maskz_srlv_epi32(all, _mm512_maskz_permutexvar_epi8(~__mmask64(0), g, v), s);
+            v = is_signed ? _mm512_maskz_sra_epi32(all, _mm512_maskz_sll_epi32(all, v, left), left)
+                : _mm512_and_si512(v, mask);
+            if (res_size == 4)
+              _mm512_storeu_si512(r + 4 * i, v);
+            else if (res_size == 2)
+              _mm512_mask_cvtepi32_storeu_epi16(r + 2 * i, 0xFFFF, v);
+            else
+              _mm512_mask_cvtepi32_storeu_epi8(r + i, 0xFFFF, v);
+          }
+          return i;
+        }
+
+        //! As pack_avx2, 16 elements at a time, with @c vpermb and masked stores of their bytes.
+        __attribute__((target("avx512f,avx512bw,avx512vbmi")))
+        inline std::size_t pack_vbmi(const void* x, std::size_t res_size, boost::uint8_t* data, std::size_t,
+            std::size_t first, int bits, std::size_t n)
+        {
+          const int phase = int((first * bits) & 7);
+          const int used = (phase + 16 * bits + 7) >> 3;
+          boost::int32_t shift[16];
+          boost::uint8_t even[64], odd[64], keep[64] = { 0 };
+          packed_lanes(bits, phase, 16, 0, shift, even, odd);
+          __mmask64 even_bytes = 0, odd_bytes = 0;
+          for (int k = 0; k < 64; ++k)
+          {
+            even_bytes |= __mmask64(even[k] != 0x80) << k;
+            odd_bytes |= __mmask64(odd[k] != 0x80) << k;
+          }
+          // the bits of the last byte that belong to the next element
+          keep[used - 1] = boost::uint8_t(phase == 0 ? 0 : 0xFF << phase & 0xFF);
+          const __mmask64 bytes = (__mmask64(1) << used) - 1;
+          const __mmask16 all = 0xFFFF;
+          const __m512i s = _mm512_loadu_si512(shift);
+          const __m512i e = _mm512_loadu_si512(even);
+          const __m512i o = _mm512_loadu_si512(odd);
+          const __m512i k = _mm512_loadu_si512(keep);
+          const boost::uint32_t m = (boost::uint32_t(1) << bits) - 1;
+          const __m512i mask = _mm512_set1_epi32(int(m));
+          const boost::uint8_t* in = (const boost::uint8_t*) x;
+          const std::size_t start = (first * bits) >> 3;
+          boost::uint32_t carry = data[start] & ((1u << phase) - 1);
+          std::size_t i = 0;
+          for (; i + 16 <= n; i += 16)
+          {
+            boost::uint8_t* p = data + start + i / 8 * bits;
+            __m512i v;
+            if (res_size == 4)
+              v = _mm512_loadu_si512(in + 4 * i);
+            else if (res_size == 2)
+              v = _mm512_maskz_cvtepi16_epi32(all, _mm256_loadu_si256((const __m256i*) (in + 2 * i)));
+            else
+              v = _mm512_maskz_cvtepi8_epi32(all, _mm_loadu_si128((const __m128i*) (in + i)));
+            v = _mm512_maskz_sllv_epi32(all, _mm512_and_si512(v, mask), s);
+            v = _mm512_or_si512(_mm512_maskz_permutexvar_epi8(even_bytes, e, v),
+                _mm512_maskz_permutexvar_epi8(odd_bytes, o, v));
+            v = _mm512_or_si512(v, _mm512_maskz_set1_epi32(1, int(carry)));
+            carry = phase == 0 ? 0 : packed_input(in, res_size, i + 15, m) >> (bits - phase);
+            if (i + 32 > n)
+            {
+              v = _mm512_or_si512(v, _mm512_and_si512(_mm512_maskz_loadu_epi8(bytes, p), k));
+              _mm512_mask_storeu_epi8(p, bytes, v);
+              return i + 16;
+            }
+            _mm512_mask_storeu_epi8(p, bytes, v);
+          }
+          return i;
+        }
+
+        inline std::size_t unpack_bits(const boost::uint8_t* data, std::size_t size, std::size_t first, int bits,
+            bool is_signed, void* res, std::size_t res_size, std::size_t n)
+        {
+          switch (active())
+          {
+          case avx512:
+            return vbmi_supported() ? unpack_vbmi(data, size, first, bits, is_signed, res, res_size, n)
+                : unpack_avx2(data, size, first, bits, is_signed, res, res_size, n);
+          case avx2: return unpack_avx2(data, size, first, bits, is_signed, res, res_size, n);
+          default: return 0;
+          }
+        }
+
+        inline std::size_t pack_bits(const void* x, std::size_t res_size, boost::uint8_t* data, std::size_t size,
+            std::size_t first, int bits, std::size_t n)
+        {
+          if (bits < 8) return 0;
+          switch (active())
+          {
+          case avx512:
+            return vbmi_supported() ? pack_vbmi(x, res_size, data, size, first, bits, n)
+                : pack_avx2(x, res_size, data, size, first, bits, n);
+          case avx2: return pack_avx2(x, res_size, data, size, first, bits, n);
+          default: return 0;
+          }
+        }
+      }
+    }
+#endif
+
+    namespace detail
+    {
+      //! The underlying integers of @c T on their @c T::digits low bits.
+      template <typename T>
+      struct packed_traits
+      {
+        typedef typename T::underlying_type underlying_type;
+        BOOST_STATIC_CONSTEXPR int bits = int(T::digits);
+        BOOST_STATIC_CONSTEXPR boost::uint64_t mask = (boost::uint64_t(1) << (bits - 1) << 1) - 1;
+
+        static boost::uint64_t encode(T const& x)
+        {
+          return boost::uint64_t(x.count()) & mask;
+        }
+        static T decode(boost::uint64_t v)
+        {
+          if (T::is_signed)
+            return T(index(underlying_type(boost::int64_t(v << (64 - bits)) >> (64 - bits))));
+          return T(index(underlying_type(v & mask)));
+        }
+      };
+
+      /**
+       * Random access iterator on the elements of a packed_array, whose @c Reference is a proxy to them or a copy
+       * of them.
+       */
+      template <typename Array, typename Reference>
+      class packed_iterator
+      {
+        template <typename A, typename R>
+        friend class packed_iterator;
+      public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef typename Array::value_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef void pointer;
+        typedef Reference reference;
+
+        packed_iterator() :
+          array_(0), i_(0)
+        {
+        }
+        packed_iterator(Array* a, std::size_t i) :
+          array_(a), i_(i)
+        {
+        }
+        //! Conversion from the iterator to the const_iterator.
+        template <typename A, typename R>
+        packed_iterator(packed_iterator<A, R> const& it) :
+          array_(it.array_), i_(it.i_)
+        {
+        }
+
+        reference operator*() const
+        {
+          return (*array_)[i_];
+        }
+        reference operator[](difference_type d) const
+        {
+          return (*array_)[i_ + d];
+        }
+        packed_iterator& operator++()
+        {
+          ++i_;
+          return *this;
+        }
+        packed_iterator operator++(int)
+        {
+          packed_iterator tmp(*this);
+          ++i_;
+          return tmp;
+        }
+        packed_iterator& operator--()
+        {
+          --i_;
+          return *this;
+        }
+        packed_iterator operator--(int)
+        {
+          packed_iterator tmp(*this);
+          --i_;
+          return tmp;
+        }
+        packed_iterator& operator+=(difference_type d)
+        {
+          i_ += d;
+          return *this;
+        }
+        packed_iterator& operator-=(difference_type d)
+        {
+          i_ -= d;
+          return *this;
+        }
+        packed_iterator operator+(difference_type d) const
+        {
+          return packed_iterator(array_, i_ + d);
+        }
+        packed_iterator operator-(difference_type d) const
+        {
+          return packed_iterator(array_, i_ - d);
+        }
+        difference_type operator-(packed_iterator const& rhs) const
+        {
+          return difference_type(i_) - difference_type(rhs.i_);
+        }
+        bool operator==(packed_iterator const& rhs) const
+        {
+          return i_ == rhs.i_;
+        }
+        bool operator!=(packed_iterator const& rhs) const
+        {
+          return i_ != rhs.i_;
+        }
+        bool operator<(packed_iterator const& rhs) const
+        {
+          return i_ < rhs.i_;
+        }
+        bool operator>(packed_iterator const& rhs) const
+        {
+          return i_ > rhs.i_;
+        }
+        bool operator<=(packed_iterator const& rhs) const
+        {
+          return i_ <= rhs.i_;
+        }
+        bool operator>=(packed_iterator const& rhs) const
+        {
+          return i_ >= rhs.i_;
+        }
+
+      private:
+        Array* array_;
+        std::size_t i_;
+      };
+    }
+
+    /**
+     * @brief Array of fixed point numbers stored on their digits.
+     *
+     * @TParams
+     * @Param{T,a @c real_t or an @c ureal_t of at most 64 digits}
+     *
+     * The element @c i occupies the bits <c>[i * bits, (i + 1) * bits)</c> of the words returned by @c data(), the
+     * bit 0 being the least significant bit of the first word. The non const accesses return proxies, which
+     * convert to @c T and are assignable from @c T, as the references of <c>std::vector<bool></c>.
+     *
+     * @Example
+     * @code
+     * typedef real_t<4, -7> sample;                     // 12 digits on an int16
+     * packed_array<sample> log(n);                      // 1.5 bytes per sample
+     * batch::pack(&samples[0], log, 0, n);
+     * log[3] = sample(1.5);
+     * batch::unpack(log, 0, &samples[0], n);
+     * @endcode
+     */
+    template <typename T>
+    class packed_array
+    {
+      typedef detail::packed_traits<T> traits;
+    public:
+      typedef T value_type;
+      typedef typename T::underlying_type underlying_type;
+      typedef std::size_t size_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef T const_reference;
+
+      //! The number of bits of each element.
+      BOOST_STATIC_CONSTEXPR std::size_t bits = T::digits;
+      BOOST_STATIC_ASSERT_MSG(T::digits >= 1 && T::digits <= 64, "The elements have between 1 and 64 digits.");
+
+      //! Proxy to an element.
+      class reference
+      {
+      public:
+        reference(packed_array& a, size_type i) :
+          array_(&a), i_(i)
+        {
+        }
+        operator T() const
+        {
+          return array_->get(i_);
+        }
+        reference& operator=(T const& x)
+        {
+          array_->set(i_, x);
+          return *this;
+        }
+        reference& operator=(reference const& x)
+        {
+          array_->set(i_, x.array_->get(x.i_));
+          return *this;
+        }
+        //! @Returns the underlying integer of the element.
+        underlying_type count() const
+        {
+          return array_->get(i_).count();
+        }
+      private:
+        packed_array* array_;
+        size_type i_;
+      };
+
+      typedef detail::packed_iterator<packed_array, reference> iterator;
+      typedef detail::packed_iterator<packed_array const, T> const_iterator;
+
+      //! @Effects constructs an empty array.
+      packed_array() :
+        size_(0), words_(1, 0)
+      {
+      }
+
+      //! @Effects constructs @c n zeros.
+      explicit packed_array(size_type n) :
+        size_(n), words_(word_count(n), 0)
+      {
+      }
+
+      //! @Effects constructs @c n copies of @c x.
+      packed_array(size_type n, T const& x) :
+        size_(n), words_(word_count(n), 0)
+      {
+        for (size_type i = 0; i < n; ++i)
+          set(i, x);
+      }
+
+      //! @Effects constructs the array of the numbers of <c>[first, last)</c>.
+      packed_array(T const* first, T const* last);
+
+      //! @Returns the number of elements.
+      size_type size() const
+      {
+        return size_;
+      }
+
+      bool empty() const
+      {
+        return size_ == 0;
+      }
+
+      //! @Returns the number of bytes of the packed elements, <c>ceil(size() * bits / 8)</c>.
+      size_type storage_size() const
+      {
+        return (size_ * bits + 7) / 8;
+      }
+
+      //! @Returns the element @c i.
+      T get(size_type i) const
+      {
+        const size_type pos = i * bits;
+        const size_type w = pos / 64;
+        const unsigned s = unsigned(pos % 64);
+        // the word w + 1 exists, there is always an extra word
+        return traits::decode((words_[w] >> s) | ((words_[w + 1] << 1) << (63 - s)));
+      }
+
+      //! @Effects sets the element @c i to @c x.
+      void set(size_type i, T const& x)
+      {
+        const size_type pos = i * bits;
+        const size_type w = pos / 64;
+        const unsigned s = unsigned(pos % 64);
+        const boost::uint64_t v = traits::encode(x);
+        words_[w] = (words_[w] & ~(traits::mask << s)) | (v << s);
+        if (s + bits > 64)
+          words_[w + 1] = (words_[w + 1] & ~(traits::mask >> (64 - s))) | (v >> (64 - s));
+      }
+
+      T operator[](size_type i) const
+      {
+        return get(i);
+      }
+      reference operator[](size_type i)
+      {
+        return reference(*this, i);
+      }
+
+      iterator begin()
+      {
+        return iterator(this, 0);
+      }
+      iterator end()
+      {
+        return iterator(this, size_);
+      }
+      const_iterator begin() const
+      {
+        return const_iterator(this, 0);
+      }
+      const_iterator end() const
+      {
+        return const_iterator(this, size_);
+      }
+
+      //! @Effects appends @c x.
+      void push_back(T const& x)
+      {
+        resize(size_ + 1);
+        set(size_ - 1, x);
+      }
+
+      /**
+       * @Effects removes the elements after the first @c n ones, or appends zeros.
+       */
+      void resize(size_type n)
+      {
+        if (n < size_)
+        {
+          // the bits after the last element stay 0
+          const size_type pos = n * bits;
+          words_.resize(word_count(n));
+          for (size_type w = (pos + 63) / 64; w < words_.size(); ++w)
+            words_[w] = 0;
+          if (pos % 64 != 0)
+            words_[pos / 64] &= (boost::uint64_t(1) << (pos % 64)) - 1;
+        }
+        else
+          words_.resize(word_count(n), 0);
+        size_ = n;
+      }
+
+      void clear()
+      {
+        resize(0);
+      }
+
+      void swap(packed_array& other)
+      {
+        std::swap(size_, other.size_);
+        words_.swap(other.words_);
+      }
+
+      /**
+       * @Returns the words of the elements, followed by an extra word. The bits after the last element are 0.
+       */
+      boost::uint64_t const* data() const
+      {
+        return &words_[0];
+      }
+      boost::uint64_t* data()
+      {
+        return &words_[0];
+      }
+
+    private:
+      //! The words of @c n elements and the extra word read with the last one.
+      static size_type word_count(size_type n)
+      {
+        return (n * bits + 63) / 64 + 1;
+      }
+
+      size_type size_;
+      std::vector<boost::uint64_t> words_;
+    };
+
+    namespace batch
+    {
+      namespace detail
+      {
+        //! Whether the packed arrays of @c T have SIMD kernels.
+        template <typename T>
+        struct packed_kernel_enabled
+        {
+          BOOST_STATIC_CONSTEXPR bool value = T::digits <= 25 && sizeof(typename T::underlying_type) <= 4
+              && sizeof(T) == sizeof(typename T::underlying_type);
+        };
+
+        template <typename T, bool Enabled = packed_kernel_enabled<T>::value>
+        struct packed_kernel
+        {
+          static std::size_t unpack(packed_array<T> const&, std::size_t, T*, std::size_t)
+          {
+            return 0;
+          }
+          static std::size_t pack(T const*, packed_array<T>&, std::size_t, std::size_t)
+          {
+            return 0;
+          }
+        };
+#if defined(BOOST_FIXED_POINT_SIMD_X86)
+        template <typename T>
+        struct packed_kernel<T, true>
+        {
+          static std::size_t unpack(packed_array<T> const& a, std::size_t first, T* res, std::size_t n)
+          {
+            return simd::detail::unpack_bits(reinterpret_cast<const boost::uint8_t*>(a.data()),
+                8 * ((a.size() * T::digits + 63) / 64 + 1), first, int(T::digits), T::is_signed, res,
+                sizeof(typename T::underlying_type), n);
+          }
+          static std::size_t pack(T const* x, packed_array<T>& a, std::size_t first, std::size_t n)
+          {
+            return simd::detail::pack_bits(x, sizeof(typename T::underlying_type),
+                reinterpret_cast<boost::uint8_t*>(a.data()), 8 * ((a.size() * T::digits + 63) / 64 + 1), first,
+                int(T::digits), n);
+          }
+        };
+#endif
+      }
+
+      /**
+       * @Requires <c>first + n <= a.size()</c> and @c res points to @c n numbers.
+       * @Effects <c>res[i] = a[first + i]</c> for every @c i in <c>[0, n)</c>.
+       */
+      template <typename T>
+      void unpack(packed_array<T> const& a, std::size_t first, T* res, std::size_t n)
+      {
+        std::size_t i = detail::packed_kernel<T>::unpack(a, first, res, n);
+        for (; i < n; ++i)
+          res[i] = a.get(first + i);
+      }
+
+      /**
+       * @Requires <c>first + n <= a.size()</c> and @c x points to @c n numbers.
+       * @Effects <c>a[first + i] = x[i]</c> for every @c i in <c>[0, n)</c>. The other elements are not changed.
+       */
+      template <typename T>
+      void pack(T const* x, packed_array<T>& a, std::size_t first, std::size_t n)
+      {
+        typedef fixed_point::detail::packed_traits<T> traits;
+        std::size_t i = detail::packed_kernel<T>::pack(x, a, first, n);
+        if (i == n) return;
+        // the remaining bits are accumulated in a word, written once full
+        const std::size_t bits = T::digits;
+        boost::uint64_t* words = a.data();
+        std::size_t w = (first + i) * bits / 64;
+        unsigned fill = unsigned((first + i) * bits % 64);
+        boost::uint64_t acc = words[w] & ((boost::uint64_t(1) << fill) - 1);
+        for (; i < n; ++i)
+        {
+          const boost::uint64_t v = traits::encode(x[i]);
+          acc |= v << fill;
+          fill += unsigned(bits);
+          if (fill >= 64)
+          {
+            words[w++] = acc;
+            fill -= 64;
+            acc = fill == 0 ? 0 : v >> (bits - fill);
+          }
+        }
+        if (fill != 0)
+          words[w] = acc | (words[w] & ~((boost::uint64_t(1) << fill) - 1));
+      }
+    }
+
+    template <typename T>
+    packed_array<T>::packed_array(T const* first, T const* last) :
+      size_(last - first), words_(word_count(last - first), 0)
+    {
+      batch::pack(first, *this, 0, size_);
+    }
+  }
+}
+
+#endif // header
@@ -0,0 +1,745 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Vicente J. Botet Escriba 2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/fixed_point for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file
+ * @brief Defines the stages of a pixel pipeline on planes of channels: premultiplication by alpha, blending of
+ * premultiplied pixels, color matrices and lookup tables.
+ *
+ * A channel is an @c ureal_t<B,0>, B <= 16, standing for the fraction <c>x / max</c> of its greatest value
+ * <c>max = 2^B - 1</c>. The products of two channels are divided by @c max with a multiplication and shifts, rounded
+ * to the nearest channel. The planes of 8 and 16 bits channels are processed with SSE4 or AVX2 instructions, and the
+ * lookups in tables of 8 bits channels with AVX2 or AVX-512 VBMI, as the kernels of batch.hpp.
+ */
+
+#ifndef BOOST_FIXED_POINT_PIXEL_HPP
+#define BOOST_FIXED_POINT_PIXEL_HPP
+
+#include <boost/fixed_point/number.hpp>
+#include <boost/fixed_point/batch.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <climits>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace boost
+{
+  namespace fixed_point
+  {
+#if defined(BOOST_FIXED_POINT_SIMD_X86)
+    namespace simd
+    {
+      namespace detail
+      {
+        /**
+         * Parameters of the color matrices of 8 bits channels: the pairs of int16 coefficients <c>(m[c][0],
+         * m[c][1])</c> and <c>(m[c][2], m[c][3])</c> of each output @c c, multiplied by the pairs <c>(r, g)</c> and
+         * <c>(b, 255)</c>, and the @c shift of the sums, rounded half up.
+         */
+        struct color_params
+        {
+          boost::int32_t rg[3];
+          boost::int32_t b1[3];
+          int shift;
+        };
+
+        ///////////////////////////////////////////////////////////////////////
+        // SSE4
+
+        //! The nearest integers to <c>x[i] / 255</c>, for @c x in [0, 255 * 255].
+        __attribute__((target("sse4.2")))
+        inline __m128i divide_255_sse4(__m128i x)
+        {
+          __m128i t = _mm_add_epi16(x, _mm_set1_epi16(128));
+          return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+        }
+        //! The nearest integers to <c>x[i] / 65535</c>, for @c x in [0, 65535 * 65535].
+        __attribute__((target("sse4.2")))
+        inline __m128i divide_65535_sse4(__m128i x)
+        {
+          __m128i t = _mm_add_epi32(x, _mm_set1_epi32(32768));
+          return _mm_srli_epi32(_mm_add_epi32(t, _mm_srli_epi32(t, 16)), 16);
+        }
+
+        //! <c>r[i] = c[i] * a[i] / 255</c>, or <c>r[i] = s[i] + c[i] * (255 - a[i]) / 255</c> if @c Blend.
+        template <bool Blend>
+        __attribute__((target("sse4.2")))
+        std::size_t scale_u8_sse4(const boost::uint8_t* s, const boost::uint8_t* c, const boost::uint8_t* a,
+            boost::uint8_t* r, std::size_t n)
+        {
+          const __m128i zero = _mm_setzero_si128();
+          std::size_t i = 0;
+          for (; i + 16 <= n; i += 16)
+          {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c + i));
+            __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            if (Blend) w = _mm_xor_si128(w, _mm_set1_epi8(-1));
+            __m128i lo = divide_255_sse4(_mm_mullo_epi16(_mm_unpacklo_epi8(x, zero), _mm_unpacklo_epi8(w, zero)));
+            __m128i hi = divide_255_sse4(_mm_mullo_epi16(_mm_unpackhi_epi8(x, zero), _mm_unpackhi_epi8(w, zero)));
+            __m128i y = _mm_packus_epi16(lo, hi);
+            if (Blend) y = _mm_adds_epu8(y, _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(r + i), y);
+          }
+          return i;
+        }
+
+        //! As scale_u8_sse4, for 16 bits channels.
+        template <bool Blend>
+        __attribute__((target("sse4.2")))
+        std::size_t scale_u16_sse4(const boost::uint16_t* s, const boost::uint16_t* c, const boost::uint16_t* a,
+            boost::uint16_t* r, std::size_t n)
+        {
+          std::size_t i = 0;
+          for (; i + 8 <= n; i += 8)
+          {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c + i));
+            __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            if (Blend) w = _mm_xor_si128(w, _mm_set1_epi16(-1));
+            __m128i p_lo = _mm_mullo_epi16(x, w), p_hi = _mm_mulhi_epu16(x, w);
+            __m128i lo = divide_65535_sse4(_mm_unpacklo_epi16(p_lo, p_hi));
+            __m128i hi = divide_65535_sse4(_mm_unpackhi_epi16(p_lo, p_hi));
+            __m128i y = _mm_packus_epi32(lo, hi);
+            if (Blend) y = _mm_adds_epu16(y, _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(r + i), y);
+          }
+          return i;
+        }
+
+        //! The 3 outputs of a color matrix of 8 bits channels, for the pairs @c rg and @c b1 of 4 pixels.
+        __attribute__((target("sse4.2")))
+        inline __m128i color_sse4(__m128i rg, __m128i b1, boost::int32_t crg, boost::int32_t cb1, __m128i half,
+            __m128i shift)
+        {
+          __m128i s = _mm_add_epi32(_mm_madd_epi16(rg, _mm_set1_epi32(crg)), _mm_madd_epi16(b1, _mm_set1_epi32(cb1)));
+          return _mm_sra_epi32(_mm_add_epi32(s, half), shift);
+        }
+
+        __attribute__((target("sse4.2")))
+        std::size_t color_u8_sse4(const boost::uint8_t* const* in, boost::uint8_t* const* out, std::size_t n,
+            color_params const& p)
+        {
+          const __m128i half = _mm_set1_epi32(p.shift > 0 ? 1 << (p.shift - 1) : 0);
+          const __m128i shift = _mm_cvtsi32_si128(p.shift);
+          const __m128i max = _mm_set1_epi16(255);
+          std::size_t i = 0;
+          for (; i + 8 <= n; i += 8)
+          {
+            __m128i r = _mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in[0] + i)));
+            __m128i g = _mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in[1] + i)));
+            __m128i b = _mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in[2] + i)));
+            __m128i rg_lo = _mm_unpacklo_epi16(r, g), rg_hi = _mm_unpackhi_epi16(r, g);
+            __m128i b1_lo = _mm_unpacklo_epi16(b, max), b1_hi = _mm_unpackhi_epi16(b, max);
+            // all the inputs are read before the outputs are written, as they may be the same planes
+            __m128i y[3];
+            for (std::size_t c = 0; c < 3; ++c)
+            {
+              __m128i v = _mm_packs_epi32(color_sse4(rg_lo, b1_lo, p.rg[c], p.b1[c], half, shift),
+                  color_sse4(rg_hi, b1_hi, p.rg[c], p.b1[c], half, shift));
+              y[c] = _mm_packus_epi16(v, v);
+            }
+            for (std::size_t c = 0; c < 3; ++c)
+              _mm_storel_epi64(reinterpret_cast<__m128i*>(out[c] + i), y[c]);
+          }
+          return i;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // AVX2
+
+        __attribute__((target("avx2")))
+        inline __m256i divide_255_avx2(__m256i x)
+        {
+          __m256i t = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+          return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+        }
+        __attribute__((target("avx2")))
+        inline __m256i divide_65535_avx2(__m256i x)
+        {
+          __m256i t = _mm256_add_epi32(x, _mm256_set1_epi32(32768));
+          return _mm256_srli_epi32(_mm256_add_epi32(t, _mm256_srli_epi32(t, 16)), 16);
+        }
+
+        // The unpacks and the packs both work within the 128 bits lanes, so the packs restore the order.
+        template <bool Blend>
+        __attribute__((target("avx2")))
+        std::size_t scale_u8_avx2(const boost::uint8_t* s, const boost::uint8_t* c, const boost::uint8_t* a,
+            boost::uint8_t* r, std::size_t n)
+        {
+          const __m256i zero = _mm256_setzero_si256();
+          std::size_t i = 0;
+          for (; i + 32 <= n; i += 32)
+          {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c + i));
+            __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            if (Blend) w = _mm256_xor_si256(w, _mm256_set1_epi8(-1));
+            __m256i lo = divide_255_avx2(_mm256_mullo_epi16(_mm256_unpacklo_epi8(x, zero),
+                _mm256_unpacklo_epi8(w, zero)));
+            __m256i hi = divide_255_avx2(_mm256_mullo_epi16(_mm256_unpackhi_epi8(x, zero),
+                _mm256_unpackhi_epi8(w, zero)));
+            __m256i y = _mm256_packus_epi16(lo, hi);
+            if (Blend) y = _mm256_adds_epu8(y, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(r + i), y);
+          }
+          return i;
+        }
+
+        template <bool Blend>
+        __attribute__((target("avx2")))
+        std::size_t scale_u16_avx2(const boost::uint16_t* s, const boost::uint16_t* c, const boost::uint16_t* a,
+            boost::uint16_t* r, std::size_t n)
+        {
+          std::size_t i = 0;
+          for (; i + 16 <= n; i += 16)
+          {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c + i));
+            __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            if (Blend) w = _mm256_xor_si256(w, _mm256_set1_epi16(-1));
+            __m256i p_lo = _mm256_mullo_epi16(x, w), p_hi = _mm256_mulhi_epu16(x, w);
+            __m256i lo = divide_65535_avx2(_mm256_unpacklo_epi16(p_lo, p_hi));
+            __m256i hi = divide_65535_avx2(_mm256_unpackhi_epi16(p_lo, p_hi));
+            __m256i y = _mm256_packus_epi32(lo, hi);
+            if (Blend) y = _mm256_adds_epu16(y, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(r + i), y);
+          }
+          return i;
+        }
+
+        __attribute__((target("avx2")))
+        inline __m256i color_avx2(__m256i rg, __m256i b1, boost::int32_t crg, boost::int32_t cb1, __m256i half,
+            __m128i shift)
+        {
+          __m256i s = _mm256_add_epi32(_mm256_madd_epi16(rg, _mm256_set1_epi32(crg)),
+              _mm256_madd_epi16(b1, _mm256_set1_epi32(cb1)));
+          return _mm256_sra_epi32(_mm256_add_epi32(s, half), shift);
+        }
+
+        __attribute__((target("avx2")))
+        std::size_t color_u8_avx2(const boost::uint8_t* const* in, boost::uint8_t* const* out, std::size_t n,
+            color_params const& p)
+        {
+          const __m256i half = _mm256_set1_epi32(p.shift > 0 ? 1 << (p.shift - 1) : 0);
+          const __m128i shift = _mm_cvtsi32_si128(p.shift);
+          const __m256i max = _mm256_set1_epi16(255);
+          std::size_t i = 0;
+          for (; i + 16 <= n; i += 16)
+          {
+            __m256i r = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in[0] + i)));
+            __m256i g = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in[1] + i)));
+            __m256i b = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in[2] + i)));
+            __m256i rg_lo = _mm256_unpacklo_epi16(r, g), rg_hi = _mm256_unpackhi_epi16(r, g);
+            __m256i b1_lo = _mm256_unpacklo_epi16(b, max), b1_hi = _mm256_unpackhi_epi16(b, max);
+            __m128i y[3];
+            for (std::size_t c = 0; c < 3; ++c)
+            {
+              __m256i v = _mm256_packs_epi32(color_avx2(rg_lo, b1_lo, p.rg[c], p.b1[c], half, shift),
+                  color_avx2(rg_hi, b1_hi, p.rg[c], p.b1[c], half, shift));
+              y[c] = _mm256_castsi256_si128(_mm256_permute4x64_epi64(_mm256_packus_epi16(v, v), 0x08));
+            }
+            for (std::size_t c = 0; c < 3; ++c)
+              _mm_storeu_si128(reinterpret_cast<__m128i*>(out[c] + i), y[c]);
+          }
+          return i;
+        }
+
+        /**
+         * <c>r[i] = table[x[i]]</c> for a table of 256 bytes: vpshufb looks up the 16 rows of 16 entries with the 4
+         * low bits, and a tree of vpblendvb selects the row with the 4 high bits.
+         */
+        __attribute__((target("avx2")))
+        inline std::size_t lookup_u8_avx2(const boost::uint8_t* table, const boost::uint8_t* x, boost::uint8_t* r,
+            std::size_t n)
+        {
+          __m256i rows[16];
+          for (std::size_t k = 0; k < 16; ++k)
+            rows[k] = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(table + 16 * k)));
+          const __m256i low = _mm256_set1_epi8(0x0f);
+          std::size_t i = 0;
+          for (; i + 32 <= n; i += 32)
+          {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+            __m256i l = _mm256_and_si256(v, low);
+            __m256i y[16];
+            for (std::size_t k = 0; k < 16; ++k)
+              y[k] = _mm256_shuffle_epi8(rows[k], l);
+            // the bit 4 + b of the index, moved to the bit 7 of each byte, selects between the rows
+            for (int b = 0; b < 4; ++b)
+            {
+              __m256i m = _mm256_slli_epi16(v, 3 - b);
+              for (std::size_t k = 0; k < std::size_t(8 >> b); ++k)
+                y[k] = _mm256_blendv_epi8(y[2 * k], y[2 * k + 1], m);
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(r + i), y[0]);
+          }
+          return i;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // AVX-512 VBMI
+
+        /**
+         * <c>r[i] = table[x[i]]</c> for a table of 256 bytes, held in four registers: vpermi2b looks up the 128
+         * entries selected by the 7 low bits in two of them, and the high bit selects the result.
+         */
+        __attribute__((target("avx512f,avx512bw,avx512vbmi")))
+        inline std::size_t lookup_u8_vbmi(const boost::uint8_t* table, const boost::uint8_t* x, boost::uint8_t* r,
+            std::size_t n)
+        {
+          const __m512i t0 = _mm512_loadu_si512(table), t1 = _mm512_loadu_si512(table + 64);
+          const __m512i t2 = _mm512_loadu_si512(table + 128), t3 = _mm512_loadu_si512(table + 192);
+          std::size_t i = 0;
+          for (; i + 64 <= n; i += 64)
+          {
+            __m512i v = _mm512_loadu_si512(x + i);
+            __m512i lo = _mm512_permutex2var_epi8(t0, v, t1);
+            __m512i hi = _mm512_permutex2var_epi8(t2, v, t3);
+            _mm512_storeu_si512(r + i, _mm512_mask_blend_epi8(_mm512_movepi8_mask(v), lo, hi));
+          }
+          return i;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // dispatch
+
+        /**
+         * AVX-512F lacks the operations on bytes and on 16 bits integers, so the AVX2 kernels are used at the AVX-512
+         * level.
+         */
+        template <bool Blend>
+        std::size_t scale_u8(const boost::uint8_t* s, const boost::uint8_t* c, const boost::uint8_t* a,
+            boost::uint8_t* r, std::size_t n)
+        {
+          switch (active())
+          {
+          case avx512:
+          case avx2: return scale_u8_avx2<Blend>(s, c, a, r, n);
+          case sse4: return scale_u8_sse4<Blend>(s, c, a, r, n);
+          default: return 0;
+          }
+        }
+        template <bool Blend>
+        std::size_t scale_u16(const boost::uint16_t* s, const boost::uint16_t* c, const boost::uint16_t* a,
+            boost::uint16_t* r, std::size_t n)
+        {
+          switch (active())
+          {
+          case avx512:
+          case avx2: return scale_u16_avx2<Blend>(s, c, a, r, n);
+          case sse4: return scale_u16_sse4<Blend>(s, c, a, r, n);
+          default: return 0;
+          }
+        }
+        inline std::size_t color_u8(const boost::uint8_t* const* in, boost::uint8_t* const* out, std::size_t n,
+            color_params const& p)
+        {
+          switch (active())
+          {
+          case avx512:
+          case avx2: return color_u8_avx2(in, out, n, p);
+          case sse4: return color_u8_sse4(in, out, n, p);
+          default: return 0;
+          }
+        }
+        inline std::size_t lookup_u8(const boost::uint8_t* table, const boost::uint8_t* x, boost::uint8_t* r,
+            std::size_t n)
+        {
+          switch (active())
+          {
+          case avx512: return vbmi_supported() ? lookup_u8_vbmi(table, x, r, n) : lookup_u8_avx2(table, x, r, n);
+          case avx2: return lookup_u8_avx2(table, x, r, n);
+          default: return 0;
+          }
+        }
+      }
+    }
+#endif
+
+    namespace detail
+    {
+      //! Whether @c T is a channel, an @c ureal_t<B,0> with B in [1, 16].
+      template <typename T>
+      struct is_channel
+      {
+        BOOST_STATIC_CONSTEXPR bool value = !T::is_signed && T::resolution_exp == 0 && T::range_exp >= 1
+            && T::range_exp <= 16;
+      };
+
+      /**
+       * @Requires @c x in <c>[0, (2^B - 1)^2]</c>.
+       * @Returns the nearest integer to <c>x / (2^B - 1)</c>. As 2^B - 1 is odd, there are no ties.
+       */
+      template <int B>
+      inline boost::uint32_t divide_by_max(boost::uint32_t x)
+      {
+        // x / (2^B - 1) = x / 2^B * (1 + 2^-B + 2^-2B + ...); two terms are enough for the products of channels
+        boost::uint32_t t = x + (boost::uint32_t(1) << (B - 1));
+        return (t + (t >> B)) >> B;
+      }
+
+      /**
+       * The bits of the integers on which the kernels see the channels @c T: 8 or 16 when @c T is stored on exactly
+       * as many bits, and 0, with no kernel, when it is stored on a wider integer, as with storage::native.
+       */
+      template <typename T>
+      struct channel_bits
+      {
+        BOOST_STATIC_CONSTEXPR int value = (T::range_exp == 8 || T::range_exp == 16)
+            && sizeof(T) * CHAR_BIT == T::range_exp && sizeof(typename T::underlying_type) * CHAR_BIT == T::range_exp
+            ? T::range_exp : 0;
+      };
+
+      //! The underlying integer of the channel @c T, as the kernels see it.
+      template <typename T, int Bits = channel_bits<T>::value>
+      struct channel_kernel
+      {
+        template <bool Blend>
+        static std::size_t scale(T const*, T const*, T const*, T*, std::size_t)
+        {
+          return 0;
+        }
+      };
+#if defined(BOOST_FIXED_POINT_SIMD_X86)
+      template <typename T>
+      struct channel_kernel<T, 8>
+      {
+        typedef boost::uint8_t type;
+        template <bool Blend>
+        static std::size_t scale(T const* s, T const* c, T const* a, T* r, std::size_t n)
+        {
+          return simd::detail::scale_u8<Blend>(reinterpret_cast<const type*>(s), reinterpret_cast<const type*>(c),
+              reinterpret_cast<const type*>(a), reinterpret_cast<type*>(r), n);
+        }
+      };
+      template <typename T>
+      struct channel_kernel<T, 16>
+      {
+        typedef boost::uint16_t type;
+        template <bool Blend>
+        static std::size_t scale(T const* s, T const* c, T const* a, T* r, std::size_t n)
+        {
+          return simd::detail::scale_u16<Blend>(reinterpret_cast<const type*>(s), reinterpret_cast<const type*>(c),
+              reinterpret_cast<const type*>(a), reinterpret_cast<type*>(r), n);
+        }
+      };
+#endif
+    }
+
+    /**
+     * @Returns the nearest channel to <c>x * a / max</c>, the product of @c x and @c a as fractions of @c max, the
+     * greatest channel.
+     *
+     * @Example
+     * @code
+     * ureal_t<8,0> r = normalized_multiply(color, alpha); // premultiplies the color by alpha
+     * @endcode
+     */
+    template <typename T>
+    T normalized_multiply(T const& x, T const& a)
+    {
+      BOOST_STATIC_ASSERT(detail::is_channel<T>::value);
+      return T(index(typename T::underlying_type(detail::divide_by_max<T::range_exp>(
+          boost::uint32_t(x.count()) * a.count()))));
+    }
+
+    /**
+     * Porter-Duff "over" of premultiplied channels.
+     *
+     * @Returns the channel <c>src + dst * (max - src_alpha) / max</c>, rounded to nearest, saturated to @c max when
+     * @c src is not premultiplied by @c src_alpha.
+     */
+    template <typename T>
+    T blend(T const& src, T const& src_alpha, T const& dst)
+    {
+      BOOST_STATIC_ASSERT(detail::is_channel<T>::value);
+      const boost::uint32_t max = T::max_index;
+      boost::uint32_t v = src.count() + detail::divide_by_max<T::range_exp>(
+          boost::uint32_t(dst.count()) * (max - src_alpha.count()));
+      return T(index(typename T::underlying_type(v < max ? v : max)));
+    }
+
+    /**
+     * A matrix of 3 x 4 coefficients transforming the 3 color channels of a pixel: the output @c c is
+     * <c>m[c][0] * r + m[c][1] * g + m[c][2] * b + m[c][3] * max</c>, rounded to nearest, ties up, and saturated to
+     * <c>[0, max]</c>. The last column is an offset, as a fraction of @c max.
+     *
+     * The planes of 8 bits channels are processed with SIMD instructions when the coefficients are stored on an
+     * int16 and have a resolution of at most 1, as the default <c>real_t<3,-12></c>.
+     *
+     * @Example
+     * @code
+     * const double sepia[3][4] = {
+     *   { 0.393, 0.769, 0.189, 0 }, { 0.349, 0.686, 0.168, 0 }, { 0.272, 0.534, 0.131, 0 } };
+     * color_matrix<> m(sepia);
+     * batch::color_transform(m, r, g, b, r, g, b, n);
+     * @endcode
+     */
+    template <typename Coefficient = real_t<3, -12> >
+    class color_matrix
+    {
+    public:
+      typedef Coefficient coefficient_type;
+
+      //! @Effects Constructs the matrix of the coefficients @c m.
+      explicit color_matrix(coefficient_type const (&m)[3][4])
+      {
+        for (std::size_t c = 0; c < 3; ++c)
+          for (std::size_t j = 0; j < 4; ++j)
+            m_[c][j] = m[c][j];
+      }
+      //! @Effects Constructs the matrix of the coefficients @c m, converted to @c coefficient_type.
+      explicit color_matrix(double const (&m)[3][4])
+      {
+        for (std::size_t c = 0; c < 3; ++c)
+          for (std::size_t j = 0; j < 4; ++j)
+            m_[c][j] = coefficient_type(m[c][j]);
+      }
+
+      //! @Returns the coefficient of the output @c c and of the input @c j, the offset if @c j is 3.
+      coefficient_type const& operator()(std::size_t c, std::size_t j) const
+      {
+        return m_[c][j];
+      }
+
+      /**
+       * @Effects <c>out[c] = </c> the output @c c of the transform of the pixel <c>(in[0], in[1], in[2])</c>.
+       * @c out may be @c in.
+       */
+      template <typename T>
+      void apply(T const* in, T* out) const
+      {
+        BOOST_STATIC_ASSERT(detail::is_channel<T>::value);
+        const boost::int64_t max = T::max_index;
+        T res[3];
+        for (std::size_t c = 0; c < 3; ++c)
+        {
+          boost::int64_t s = m_[c][3].count() * max;
+          for (std::size_t j = 0; j < 3; ++j)
+            s += boost::int64_t(m_[c][j].count()) * in[j].count();
+          if (coefficient_type::resolution_exp < 0)
+          {
+            const int shift = coefficient_type::resolution_exp < 0 ? -coefficient_type::resolution_exp : 0;
+            s = (s + (boost::int64_t(1) << (shift - 1))) >> shift;
+          }
+          else
+            s <<= coefficient_type::resolution_exp;
+          s = s < 0 ? 0 : s > max ? max : s;
+          res[c] = T(index(typename T::underlying_type(s)));
+        }
+        for (std::size_t c = 0; c < 3; ++c)
+          out[c] = res[c];
+      }
+
+    private:
+      coefficient_type m_[3][4];
+    };
+
+    /**
+     * A table of the images of all the channels @c T, as gamma curves or any other transfer function.
+     */
+    template <typename T>
+    class lookup_table
+    {
+      BOOST_STATIC_ASSERT(detail::is_channel<T>::value);
+    public:
+      typedef T value_type;
+
+      /**
+       * @Effects Constructs the table of the images of the channels by @c f.
+       * @Requires @c f is a function object taking and returning a @c T.
+       */
+      template <typename F>
+      explicit lookup_table(F f)
+      {
+        table_.reserve(std::size_t(T::max_index) + 1);
+        for (boost::uint32_t i = 0; i <= boost::uint32_t(T::max_index); ++i)
+          table_.push_back(f(T(index(typename T::underlying_type(i)))));
+      }
+
+      //! @Returns the image of @c x.
+      T operator()(T const& x) const
+      {
+        return table_[x.count()];
+      }
+
+      //! @Returns the <c>max + 1</c> images, in the order of the channels.
+      T const* data() const
+      {
+        return &table_[0];
+      }
+
+    private:
+      std::vector<T> table_;
+    };
+
+    namespace detail
+    {
+      template <typename T>
+      struct gamma_function
+      {
+        double gamma;
+        T operator()(T const& x) const
+        {
+          const double max = T::max_index;
+          return T(index(typename T::underlying_type(std::floor(max * std::pow(x.count() / max, gamma) + 0.5))));
+        }
+      };
+    }
+
+    /**
+     * @Returns the table of <c>max * (x / max)^gamma</c>, rounded to nearest: a @c gamma of 2.2 decodes the
+     * channels, and of 1/2.2 encodes them.
+     */
+    template <typename T>
+    lookup_table<T> gamma_table(double gamma)
+    {
+      detail::gamma_function<T> f;
+      f.gamma = gamma;
+      return lookup_table<T>(f);
+    }
+
+    namespace batch
+    {
+      /**
+       * @Requires @c c, @c alpha and @c res point to @c n channels. @c res may be @c c or @c alpha.
+       * @Effects <c>res[i] = normalized_multiply(c[i], alpha[i])</c> for every @c i in <c>[0, n)</c>.
+       */
+      template <typename T>
+      void premultiply(T const* c, T const* alpha, T* res, std::size_t n)
+      {
+        BOOST_STATIC_ASSERT(fixed_point::detail::is_channel<T>::value);
+        std::size_t i = fixed_point::detail::channel_kernel<T>::template scale<false>(c, c, alpha, res, n);
+        for (; i < n; ++i)
+          res[i] = fixed_point::normalized_multiply(c[i], alpha[i]);
+      }
+
+      /**
+       * Blends a plane of premultiplied channels over another one. The color and the alpha planes of the pixels
+       * are blended alike, with the alpha plane of the source.
+       *
+       * @Requires @c src, @c src_alpha, @c dst and @c res point to @c n channels. @c res may be any of them.
+       * @Effects <c>res[i] = blend(src[i], src_alpha[i], dst[i])</c> for every @c i in <c>[0, n)</c>.
+       */
+      template <typename T>
+      void blend(T const* src, T const* src_alpha, T const* dst, T* res, std::size_t n)
+      {
+        BOOST_STATIC_ASSERT(fixed_point::detail::is_channel<T>::value);
+        std::size_t i = fixed_point::detail::channel_kernel<T>::template scale<true>(src, dst, src_alpha, res, n);
+        for (; i < n; ++i)
+          res[i] = fixed_point::blend(src[i], src_alpha[i], dst[i]);
+      }
+
+      namespace detail
+      {
+        //! Whether the transforms of the planes of @c T by a color_matrix<C> have a SIMD kernel.
+        template <typename T, typename C>
+        struct color_kernel_enabled
+        {
+          BOOST_STATIC_CONSTEXPR bool value = fixed_point::detail::channel_bits<T>::value == 8 && C::is_signed
+              && sizeof(typename C::underlying_type) == 2 && C::resolution_exp <= 0 && C::resolution_exp >= -15;
+        };
+
+        template <typename T, typename C, bool Enabled = color_kernel_enabled<T, C>::value>
+        struct color_kernel
+        {
+          static std::size_t apply(color_matrix<C> const&, T const* const*, T* const*, std::size_t)
+          {
+            return 0;
+          }
+        };
+#if defined(BOOST_FIXED_POINT_SIMD_X86)
+        template <typename T, typename C>
+        struct color_kernel<T, C, true>
+        {
+          static std::size_t apply(color_matrix<C> const& m, T const* const* in, T* const* out, std::size_t n)
+          {
+            simd::detail::color_params p;
+            for (std::size_t c = 0; c < 3; ++c)
+            {
+              p.rg[c] = boost::int32_t(boost::uint32_t(boost::uint16_t(m(c, 1).count())) << 16
+                  | boost::uint16_t(m(c, 0).count()));
+              p.b1[c] = boost::int32_t(boost::uint32_t(boost::uint16_t(m(c, 3).count())) << 16
+                  | boost::uint16_t(m(c, 2).count()));
+            }
+            p.shift = -C::resolution_exp;
+            const boost::uint8_t* i[3];
+            boost::uint8_t* o[3];
+            for (std::size_t c = 0; c < 3; ++c)
+            {
+              i[c] = reinterpret_cast<const boost::uint8_t*>(in[c]);
+              o[c] = reinterpret_cast<boost::uint8_t*>(out[c]);
+            }
+            return simd::detail::color_u8(i, o, n, p);
+          }
+        };
+#endif
+
+        template <typename T, bool Enabled = fixed_point::detail::channel_bits<T>::value == 8>
+        struct lookup_kernel
+        {
+          static std::size_t apply(T const*, T const*, T*, std::size_t)
+          {
+            return 0;
+          }
+        };
+#if defined(BOOST_FIXED_POINT_SIMD_X86)
+        template <typename T>
+        struct lookup_kernel<T, true>
+        {
+          static std::size_t apply(T const* table, T const* x, T* res, std::size_t n)
+          {
+            return simd::detail::lookup_u8(reinterpret_cast<const boost::uint8_t*>(table),
+                reinterpret_cast<const boost::uint8_t*>(x), reinterpret_cast<boost::uint8_t*>(res), n);
+          }
+        };
+#endif
+      }
+
+      /**
+       * @Requires @c r, @c g, @c b, @c r_res, @c g_res and @c b_res point to @c n channels. The results may be the
+       * inputs.
+       * @Effects <c>(r_res[i], g_res[i], b_res[i])</c> is the transform of <c>(r[i], g[i], b[i])</c> by @c m, for
+       * every @c i in <c>[0, n)</c>.
+       */
+      template <typename C, typename T>
+      void color_transform(color_matrix<C> const& m, T const* r, T const* g, T const* b, T* r_res, T* g_res,
+          T* b_res, std::size_t n)
+      {
+        BOOST_STATIC_ASSERT(fixed_point::detail::is_channel<T>::value);
+        T const* in[3] = { r, g, b };
+        T* out[3] = { r_res, g_res, b_res };
+        std::size_t i = detail::color_kernel<T, C>::apply(m, in, out, n);
+        for (; i < n; ++i)
+        {
+          T x[3] = { r[i], g[i], b[i] };
+          m.apply(x, x);
+          r_res[i] = x[0];
+          g_res[i] = x[1];
+          b_res[i] = x[2];
+        }
+      }
+
+      /**
+       * @Requires @c x and @c res point to @c n channels. @c res may be @c x.
+       * @Effects <c>res[i] = table(x[i])</c> for every @c i in <c>[0, n)</c>.
+       */
+      template <typename T>
+      void lookup(lookup_table<T> const& table, T const* x, T* res, std::size_t n)
+      {
+        T const* t = table.data();
+        std::size_t i = detail::lookup_kernel<T>::apply(t, x, res, n);
+        for (; i < n; ++i)
+          res[i] = t[x[i].count()];
+      }
+    }
+  }
+}
+
+#endif // header
@@ -0,0 +1,270 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Vicente J. Botet Escriba 2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/fixed_point for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file
+ * @brief Defines the sum and the dot product of contiguous arrays of fixed point numbers, sequential and parallel.
+ *
+ * The sums are exact: the indices are added on an integer wide enough to hold the sum of 2^32 numbers, so that the
+ * result doesn't depend on the order of the additions, and the parallel reductions give the same bits whatever the
+ * number of threads. The parallel reductions use std::thread when the standard library provides it.
+ *
+ * Define BOOST_FIXED_POINT_NO_THREADS to compute the chunks of the parallel reductions one after the other on the
+ * calling thread.
+ */
+
+#ifndef BOOST_FIXED_POINT_REDUCE_HPP
+#define BOOST_FIXED_POINT_REDUCE_HPP
+
+#include <boost/fixed_point/number.hpp>
+#include <boost/assert.hpp>
+#include <cstddef>
+#include <vector>
+
+#if !defined(BOOST_FIXED_POINT_NO_THREADS) && !defined(BOOST_NO_CXX11_HDR_THREAD)
+#define BOOST_FIXED_POINT_THREADS
+#include <thread>
+#endif
+
+namespace boost
+{
+  namespace fixed_point
+  {
+    /**
+     * Type of the sum of up to 2^32 numbers of type @c T, the type @c add_result gives after 32 additions.
+     *
+     * The nested typedef type is only defined for open types:
+     * - <c>real_t<R+32, P, RP, OP, F></c> for a <c>real_t<R, P, RP, OP, F></c>,
+     * - <c>ureal_t<R+32, P, RP, OP, F></c> for an <c>ureal_t<R, P, RP, OP, F></c>.
+     */
+    template <typename T, bool B=is_open<T>::value>
+    struct sum_result
+    {
+    };
+#if ! defined(BOOST_FIXED_POINT_DOXYGEN_INVOKED)
+    template <int R, int P, typename RP, typename OP, typename F>
+    struct sum_result<real_t<R,P,RP,OP,F>, true>
+    {
+      typedef real_t<R+32, P, RP, OP, F> type;
+    };
+    template <int R, int P, typename RP, typename OP, typename F>
+    struct sum_result<ureal_t<R,P,RP,OP,F>, true>
+    {
+      typedef ureal_t<R+32, P, RP, OP, F> type;
+    };
+#endif
+
+    /**
+     * Type of the dot product of up to 2^32 pairs of numbers of types @c T1 and @c T2, the sum of their products
+     * <c>sum_result<multiply_result<T1,T2>::type>::type</c>.
+     */
+    template <typename T1, typename T2=T1>
+    struct dot_result : sum_result<typename multiply_result<T1,T2>::type>
+    {
+    };
+
+    namespace batch
+    {
+      namespace detail
+      {
+        //! The smallest number of elements a thread of the parallel reductions is given.
+        BOOST_STATIC_CONSTEXPR std::size_t min_chunk_size = 1 << 14;
+
+        //! Checks that there are at most 2^32 elements, as the accumulators hold 32 bits more than the elements.
+        inline void check_reduce_size(std::size_t n)
+        {
+          // n - 1 fits in 32 bits
+          BOOST_ASSERT_MSG((sizeof(std::size_t) <= 4 || n == 0 || ((n - 1) >> 16 >> 16) == 0),
+              "Too many elements to sum");
+          (void)n;
+        }
+
+        /**
+         * The sum of the indices of <c>p[first, last)</c>, on the underlying integer of @c Res.
+         */
+        template <typename Res, typename T>
+        struct sum_chunk
+        {
+          typedef typename Res::underlying_type result_type;
+          T const* p;
+          explicit sum_chunk(T const* p_) :
+            p(p_)
+          {
+          }
+          result_type operator()(std::size_t first, std::size_t last) const
+          {
+            result_type acc = 0;
+            for (std::size_t i = first; i < last; ++i)
+              acc += result_type(p[i].count());
+            return acc;
+          }
+        };
+
+        /**
+         * The sum of the products of the indices of <c>a[first, last)</c> and <c>b[first, last)</c>, on the
+         * underlying integer of @c Res. The products are computed on the underlying integer of their exact type.
+         */
+        template <typename Res, typename T1, typename T2>
+        struct dot_chunk
+        {
+          typedef typename Res::underlying_type result_type;
+          typedef typename multiply_result<T1, T2>::type::underlying_type product_type;
+          T1 const* a;
+          T2 const* b;
+          dot_chunk(T1 const* a_, T2 const* b_) :
+            a(a_), b(b_)
+          {
+          }
+          result_type operator()(std::size_t first, std::size_t last) const
+          {
+            result_type acc = 0;
+            for (std::size_t i = first; i < last; ++i)
+              acc += result_type(product_type(a[i].count()) * product_type(b[i].count()));
+            return acc;
+          }
+        };
+
+        /**
+         * The number of chunks of a parallel reduction of @c n elements on at most @c threads threads, the number of
+         * hardware threads when @c threads is 0.
+         */
+        inline std::size_t chunk_count(std::size_t n, unsigned threads)
+        {
+#if defined(BOOST_FIXED_POINT_THREADS)
+          if (threads == 0)
+            threads = std::thread::hardware_concurrency();
+#endif
+          std::size_t chunks = (threads == 0) ? 1 : threads;
+          std::size_t most = n / min_chunk_size;
+          if (chunks > most)
+            chunks = (most == 0) ? 1 : most;
+          return chunks;
+        }
+
+#if defined(BOOST_FIXED_POINT_THREADS)
+        //! Runs a chunk on its own thread, storing the partial result.
+        template <typename Chunk>
+        struct chunk_task
+        {
+          Chunk chunk;
+          typename Chunk::result_type* res;
+          std::size_t first;
+          std::size_t last;
+          void operator()() const
+          {
+            *res = chunk(first, last);
+          }
+        };
+#endif
+
+        /**
+         * Splits <c>[0, n)</c> in consecutive chunks, reduces each of them with @c chunk, on its own thread but the
+         * first one, and adds the partial results. As the additions are exact, the result doesn't depend on the
+         * number of chunks.
+         */
+        template <typename Chunk>
+        typename Chunk::result_type parallel_reduce(std::size_t n, unsigned threads, Chunk const& chunk)
+        {
+          typedef typename Chunk::result_type result_type;
+          check_reduce_size(n);
+          std::size_t chunks = chunk_count(n, threads);
+          if (chunks == 1)
+            return chunk(0, n);
+
+          std::size_t step = (n + chunks - 1) / chunks;
+          std::vector<result_type> partial(chunks, result_type(0));
+#if defined(BOOST_FIXED_POINT_THREADS)
+          std::vector<std::thread> workers;
+          workers.reserve(chunks - 1);
+          try
+          {
+            for (std::size_t c = 1; c < chunks; ++c)
+            {
+              chunk_task<Chunk> task =
+              { chunk, &partial[c], c * step < n ? c * step : n, (c + 1) * step < n ? (c + 1) * step : n };
+              workers.push_back(std::thread(task));
+            }
+          }
+          catch (...)
+          {
+            for (std::size_t w = 0; w < workers.size(); ++w)
+              workers[w].join();
+            throw;
+          }
+          partial[0] = chunk(0, step);
+          for (std::size_t w = 0; w < workers.size(); ++w)
+            workers[w].join();
+#else
+          for (std::size_t c = 0; c < chunks; ++c)
+            partial[c] = chunk(c * step < n ? c * step : n, (c + 1) * step < n ? (c + 1) * step : n);
+#endif
+          result_type res = 0;
+          for (std::size_t c = 0; c < chunks; ++c)
+            res += partial[c];
+          return res;
+        }
+      }
+
+      /**
+       * @Requires @c p points to @c n elements, with @c n at most 2^32.
+       * @Returns the exact sum of <c>p[i]</c> for every @c i in <c>[0, n)</c>.
+       */
+      template <typename T>
+      typename sum_result<T>::type sum(T const* p, std::size_t n)
+      {
+        typedef typename sum_result<T>::type RT;
+        detail::check_reduce_size(n);
+        return RT(index(detail::sum_chunk<RT, T>(p)(0, n)));
+      }
+
+      /**
+       * @Requires @c a and @c b point to @c n elements, with @c n at most 2^32.
+       * @Returns the exact sum of <c>a[i] * b[i]</c> for every @c i in <c>[0, n)</c>.
+       */
+      template <typename T1, typename T2>
+      typename dot_result<T1, T2>::type dot(T1 const* a, T2 const* b, std::size_t n)
+      {
+        typedef typename dot_result<T1, T2>::type RT;
+        detail::check_reduce_size(n);
+        return RT(index(detail::dot_chunk<RT, T1, T2>(a, b)(0, n)));
+      }
+
+      /**
+       * Parallel @c sum, on at most @c threads threads, or on the hardware threads when @c threads is 0. Each thread
+       * is given at least 2^14 elements.
+       *
+       * @Requires @c p points to @c n elements, with @c n at most 2^32.
+       * @Returns <c>sum(p, n)</c>, the same bits whatever the number of threads.
+       */
+      template <typename T>
+      typename sum_result<T>::type parallel_sum(T const* p, std::size_t n, unsigned threads = 0)
+      {
+        typedef typename sum_result<T>::type RT;
+        return RT(index(detail::parallel_reduce(n, threads, detail::sum_chunk<RT, T>(p))));
+      }
+
+      /**
+       * Parallel @c dot, on at most @c threads threads, or on the hardware threads when @c threads is 0. Each thread
+       * is given at least 2^14 elements.
+       *
+       * @Requires @c a and @c b point to @c n elements, with @c n at most 2^32.
+       * @Returns <c>dot(a, b, n)</c>, the same bits whatever the number of threads.
+       */
+      template <typename T1, typename T2>
+      typename dot_result<T1, T2>::type parallel_dot(T1 const* a, T2 const* b, std::size_t n, unsigned threads = 0)
+      {
+        typedef typename dot_result<T1, T2>::type RT;
+        return RT(index(detail::parallel_reduce(n, threads, detail::dot_chunk<RT, T1, T2>(a, b))));
+      }
+    }
+  }
+}
+
+#endif // header
@@ -0,0 +1,677 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Vicente J. Botet Escriba 2012.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/fixed_point for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file
+ * @brief Defines the sine, cosine and arctangent of fixed point angles measured in turns, computed on integers only
+ * with an interpolated table or with CORDIC.
+ *
+ */
+
+#ifndef BOOST_FIXED_POINT_TRIGONOMETRIC_HPP
+#define BOOST_FIXED_POINT_TRIGONOMETRIC_HPP
+
+#include <boost/fixed_point/number.hpp>
+#include <boost/fixed_point/math.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <cstddef>
+
+namespace boost
+{
+  namespace fixed_point
+  {
+    namespace detail
+    {
+      //! <c>values[i]</c> is sin(i*pi/512) in Q1.62, rounded to nearest, so that cos(i*pi/512) is
+      //! <c>values[256-i]</c>.
+      template <typename T>
+      struct sin_table
+      {
+        static const T values[257];
+      };
+      template <typename T>
+      const T sin_table<T>::values[257] =
+      {
+        UINTMAX_C(0x0000000000000000), UINTMAX_C(0x006487c3f99c01c4), UINTMAX_C(0x00c90e8fe6f63c23),
+        UINTMAX_C(0x012d936bbe30efd3), UINTMAX_C(0x0192155f7a3667e0), UINTMAX_C(0x01f693731d1cf010),
+        UINTMAX_C(0x025b0caeb28ab9a3), UINTMAX_C(0x02bf801a5219a86d), UINTMAX_C(0x0323ecbe21bb027d),
+        UINTMAX_C(0x038851a2581afc5a), UINTMAX_C(0x03ecadcf3f041bfe), UINTMAX_C(0x0451004d35c26ca0),
+        UINTMAX_C(0x04b54824b3867d73), UINTMAX_C(0x0519845e49c8256b), UINTMAX_C(0x057db402a6a90630),
+        UINTMAX_C(0x05e1d61a9756c856), UINTMAX_C(0x0645e9af0a6d0af8), UINTMAX_C(0x06a9edc9125700de),
+        UINTMAX_C(0x070de171e7b0b53d), UINTMAX_C(0x0771c3b2eba7f245), UINTMAX_C(0x07d59395aa5cc38d),
+        UINTMAX_C(0x08395023dd418e92), UINTMAX_C(0x089cf8676d7abb56), UINTMAX_C(0x09008b6a763de75b),
+        UINTMAX_C(0x0964083747309d11), UINTMAX_C(0x09c76dd866c689dd), UINTMAX_C(0x0a2abb58949f2ced),
+        UINTMAX_C(0x0a8defc2cbe2f8fd), UINTMAX_C(0x0af10a22459fe32a), UINTMAX_C(0x0b5409827b25591f),
+        UINTMAX_C(0x0bb6ecef285f98a4), UINTMAX_C(0x0c19b3744e3262dd), UINTMAX_C(0x0c7c5c1e34d3055b),
+        UINTMAX_C(0x0cdee5f96e21b333), UINTMAX_C(0x0d415012d802284f), UINTMAX_C(0x0da399779eb39137),
+        UINTMAX_C(0x0e05c1353f27b17e), UINTMAX_C(0x0e67c65989594312), UINTMAX_C(0x0ec9a7f2a2a188af),
+        UINTMAX_C(0x0f2b650f080d0da9), UINTMAX_C(0x0f8cfcbd90af8d58), UINTMAX_C(0x0fee6e0d6ff6fc5a),
+        UINTMAX_C(0x104fb80e37fdadff), UINTMAX_C(0x10b0d9cfdbdb9014), UINTMAX_C(0x1111d262b1f67761),
+        UINTMAX_C(0x1172a0d776517724), UINTMAX_C(0x11d3443f4cdb3dd2), UINTMAX_C(0x1233bbabc3bb7166),
+        UINTMAX_C(0x1294062ed59f05a9), UINTMAX_C(0x12f422daec0386a3), UINTMAX_C(0x135410c2e18151b1),
+        UINTMAX_C(0x13b3cefa0414b77d), UINTMAX_C(0x14135c9417660143), UINTMAX_C(0x1472b8a5571053c0),
+        UINTMAX_C(0x14d1e24278e76a25), UINTMAX_C(0x1530d880af3c2381), UINTMAX_C(0x158f9a75ab1fdcfe),
+        UINTMAX_C(0x15ee27379ea69359), UINTMAX_C(0x164c7ddd3f27c611), UINTMAX_C(0x16aa9d7dc77e16b2),
+        UINTMAX_C(0x17088530fa459eaf), UINTMAX_C(0x1766340f2418f64b), UINTMAX_C(0x17c3a9311dcce702),
+        UINTMAX_C(0x1820e3b04eaac3f3), UINTMAX_C(0x187de2a6aea962d2), UINTMAX_C(0x18daa52ec8a4afd2),
+        UINTMAX_C(0x19372a63bc93d72d), UINTMAX_C(0x1993716141bdfebb), UINTMAX_C(0x19ef7943a8ed8a2e),
+        UINTMAX_C(0x1a4b4127dea1e490), UINTMAX_C(0x1aa6c82b6d3fc98b), UINTMAX_C(0x1b020d6c7f400914),
+        UINTMAX_C(0x1b5d1009e15cc02b), UINTMAX_C(0x1bb7cf2304bd0134), UINTMAX_C(0x1c1249d8011ee6a0),
+        UINTMAX_C(0x1c6c7f4997000a90), UINTMAX_C(0x1cc66e9931c45e17), UINTMAX_C(0x1d2016e8e9db5ac7),
+        UINTMAX_C(0x1d79775b86e38955), UINTMAX_C(0x1dd28f1481cc57f1), UINTMAX_C(0x1e2b5d3806f63b1e),
+        UINTMAX_C(0x1e83e0eaf85113d1), UINTMAX_C(0x1edc1952ef78d589), UINTMAX_C(0x1f3405963fd06742),
+        UINTMAX_C(0x1f8ba4dbf89ab9fb), UINTMAX_C(0x1fe2f64be7120fb6), UINTMAX_C(0x2039f90e987d6db3),
+        UINTMAX_C(0x2090ac4d5c4434dd), UINTMAX_C(0x20e70f3245ffdb2d), UINTMAX_C(0x213d20e82f8bc101),
+        UINTMAX_C(0x2192e09abb131d39), UINTMAX_C(0x21e84d76551cfb22), UINTMAX_C(0x223d66a836964508),
+        UINTMAX_C(0x22922b5e66d9d67d), UINTMAX_C(0x22e69ac7bdb69141), UINTMAX_C(0x233ab413e5736fda),
+        UINTMAX_C(0x238e76735cd190d9), UINTMAX_C(0x23e1e117790c35de), UINTMAX_C(0x2434f33267d6b163),
+        UINTMAX_C(0x2487abf731583e71), UINTMAX_C(0x24da0a99ba25bd51), UINTMAX_C(0x252c0e4ec5395056),
+        UINTMAX_C(0x257db64bf5e7d3ef), UINTMAX_C(0x25cf01c7d1d42d27), UINTMAX_C(0x261feff9c2e069c2),
+        UINTMAX_C(0x2670801a191cad2a), UINTMAX_C(0x26c0b1620cb3e570), UINTMAX_C(0x2710830bbfd64398),
+        UINTMAX_C(0x275ff45240a17279), UINTMAX_C(0x27af04718b06877f), UINTMAX_C(0x27fdb2a68aada89b),
+        UINTMAX_C(0x284bfe2f1cd762be), UINTMAX_C(0x2899e64a123bac30), UINTMAX_C(0x28e76a3730e68e39),
+        UINTMAX_C(0x293489373612716c), UINTMAX_C(0x2981428bd8000812), UINTMAX_C(0x29cd9577c7cbd228),
+        UINTMAX_C(0x2a19813eb341365a), UINTMAX_C(0x2a65052546ab2b98), UINTMAX_C(0x2ab020712ea26ea3),
+        UINTMAX_C(0x2afad26919d93f45), UINTMAX_C(0x2b451a54bae4a0ac), UINTMAX_C(0x2b8ef77cca031883),
+        UINTMAX_C(0x2bd8692b06e0e878), UINTMAX_C(0x2c216eaa3a59bdb7), UINTMAX_C(0x2c6a07463837d222),
+        UINTMAX_C(0x2cb2324be0f07ae2), UINTMAX_C(0x2cf9ef09235e200c), UINTMAX_C(0x2d413cccfe779921),
+        UINTMAX_C(0x2d881ae78304ea25), UINTMAX_C(0x2dce88a9d5515d12), UINTMAX_C(0x2e1485662edaf38a),
+        UINTMAX_C(0x2e5a106fdfff2c87), UINTMAX_C(0x2e9f291b51a51a01), UINTMAX_C(0x2ee3cebe06e4c257),
+        UINTMAX_C(0x2f2800ae9eabc97b), UINTMAX_C(0x2f6bbe44d55f5dbc), UINTMAX_C(0x2faf06d9867b6446),
+        UINTMAX_C(0x2ff1d9c6ae2ee132), UINTMAX_C(0x303436676af59751), UINTMAX_C(0x30761c17ff2edba4),
+        UINTMAX_C(0x30b78a35d2b198a3), UINTMAX_C(0x30f8801f745d7d69), UINTMAX_C(0x3138fd349ba954ee),
+        UINTMAX_C(0x317900d62a2e816a), UINTMAX_C(0x31b88a662d319824), UINTMAX_C(0x31f79947df2819d2),
+        UINTMAX_C(0x32362cdfa93b43d9), UINTMAX_C(0x3274449324c7f69f), UINTMAX_C(0x32b1dfc91cdbad55),
+        UINTMAX_C(0x32eefde98fae8375), UINTMAX_C(0x332b9e5db01a445e), UINTMAX_C(0x3367c08fe70e8168),
+        UINTMAX_C(0x33a363ebd501aae3), UINTMAX_C(0x33de87de535f286c), UINTMAX_C(0x34192bd575f26d10),
+        UINTMAX_C(0x34534f408c4f03bb), UINTMAX_C(0x348cf1902335908e), UINTMAX_C(0x34c6123605f5c386),
+        UINTMAX_C(0x34feb0a53fcd3934), UINTMAX_C(0x3536cc521d434606), UINTMAX_C(0x356e64b22d81a8d4),
+        UINTMAX_C(0x35a5793c43aa215c), UINTMAX_C(0x35dc09687828e763), UINTMAX_C(0x361214b02a03ff37),
+        UINTMAX_C(0x36479a8e00276857), UINTMAX_C(0x367c9a7deaae230a), UINTMAX_C(0x36b113fd242809c4),
+        UINTMAX_C(0x36e5068a32dc7b22), UINTMAX_C(0x371871a4ea09d175), UINTMAX_C(0x374b54ce6b21a4bf),
+        UINTMAX_C(0x377daf892701d40e), UINTMAX_C(0x37af8158df2a533f), UINTMAX_C(0x37e0c9c2a6efba24),
+        UINTMAX_C(0x3811884ce4aa921b), UINTMAX_C(0x3841bc7f52e35f26), UINTMAX_C(0x387165e3017b61a4),
+        UINTMAX_C(0x38a0840256d20dd4), UINTMAX_C(0x38cf166910e7363b), UINTMAX_C(0x38fd1ca44679e636),
+        UINTMAX_C(0x392a96426823e9ed), UINTMAX_C(0x395782d3417200e2), UINTMAX_C(0x3983e1e7f9f8b879),
+        UINTMAX_C(0x39afb3131665ebc2), UINTMAX_C(0x39daf5e8798ee5e2), UINTMAX_C(0x3a05a9fd657b248d),
+        UINTMAX_C(0x3a2fcee87c6bb7ef), UINTMAX_C(0x3a596441c1df3d84), UINTMAX_C(0x3a8269a29b927359),
+        UINTMAX_C(0x3aaadea5d27d6140), UINTMAX_C(0x3ad2c2e793cd1586), UINTMAX_C(0x3afa160571d9f2c0),
+        UINTMAX_C(0x3b20d79e651a8c51), UINTMAX_C(0x3b470752cd130f54), UINTMAX_C(0x3b6ca4c471413595),
+        UINTMAX_C(0x3b91af968204c05b), UINTMAX_C(0x3bb6276d998478c2), UINTMAX_C(0x3bda0befbc8fb36a),
+        UINTMAX_C(0x3bfd5cc45b7c5557), UINTMAX_C(0x3c201994530157e0), UINTMAX_C(0x3c424209ed0dc97f),
+        UINTMAX_C(0x3c63d5d0e19c4991), UINTMAX_C(0x3c84d4965782fcd4), UINTMAX_C(0x3ca53e08e53ff8c8),
+        UINTMAX_C(0x3cc511d891c223dd), UINTMAX_C(0x3ce44fb6d52e8891), UINTMAX_C(0x3d02f75699a2198c),
+        UINTMAX_C(0x3d21086c3befe4e7), UINTMAX_C(0x3d3e82ad8c5bb4bb), UINTMAX_C(0x3d5b65d1cf511b37),
+        UINTMAX_C(0x3d77b191be16e872), UINTMAX_C(0x3d9365a7877f0846), UINTMAX_C(0x3dae81ced092c67a),
+        UINTMAX_C(0x3dc905c4b53b7792), UINTMAX_C(0x3de2f147c8e784b2), UINTMAX_C(0x3dfc4418172bd8e4),
+        UINTMAX_C(0x3e14fdf72461ae55), UINTMAX_C(0x3e2d1ea7ee40b9db), UINTMAX_C(0x3e44a5eeec75b370),
+        UINTMAX_C(0x3e5b939211353a0b), UINTMAX_C(0x3e71e758c9cb118a), UINTMAX_C(0x3e87a10bff25b938),
+        UINTMAX_C(0x3e9cc076165e599c), UINTMAX_C(0x3eb14562f13d0848), UINTMAX_C(0x3ec52f9feeb96056),
+        UINTMAX_C(0x3ed87efbeb776e61), UINTMAX_C(0x3eeb33474240eec2), UINTMAX_C(0x3efd4c53cc7adcdd),
+        UINTMAX_C(0x3f0ec9f4e297526b), UINTMAX_C(0x3f1fabff5c83b59d), UINTMAX_C(0x3f2ff2499213350f),
+        UINTMAX_C(0x3f3f9cab5b65907d), UINTMAX_C(0x3f4eaafe114a2d43), UINTMAX_C(0x3f5d1d1c8d9f75b1),
+        UINTMAX_C(0x3f6af2e32bae8247), UINTMAX_C(0x3f782c2fc8830bf5), UINTMAX_C(0x3f84c8e1c33fa68f),
+        UINTMAX_C(0x3f90c8d9fd6e4299), UINTMAX_C(0x3f9c2bfadb4cf5a9), UINTMAX_C(0x3fa6f228441708a9),
+        UINTMAX_C(0x3fb11b47a24a4b3c), UINTMAX_C(0x3fbaa73fe3e8ab95), UINTMAX_C(0x3fc395f97ab61234),
+        UINTMAX_C(0x3fcbe75e5c7280d9), UINTMAX_C(0x3fd39b5a0310742a), UINTMAX_C(0x3fdab1d96ce78786),
+        UINTMAX_C(0x3fe12acb1ce35a81), UINTMAX_C(0x3fe7061f1aaeb79b), UINTMAX_C(0x3fec43c6f2dafbc7),
+        UINTMAX_C(0x3ff0e3b5b703be63), UINTMAX_C(0x3ff4e5dffdeeb93a), UINTMAX_C(0x3ff84a3be3a7f05f),
+        UINTMAX_C(0x3ffb10c1099a1976), UINTMAX_C(0x3ffd396896a34257), UINTMAX_C(0x3ffec42d3725b6af),
+        UINTMAX_C(0x3fffb10b1d15249b), UINTMAX_C(0x4000000000000000)
+      };
+
+      //! <c>values[i]</c> is atan(i/256) in turns, atan(i/256)/(2*pi) in Q0.64, rounded to nearest.
+      template <typename T>
+      struct atan_table
+      {
+        static const T values[257];
+      };
+      template <typename T>
+      const T atan_table<T>::values[257] =
+      {
+        UINTMAX_C(0x0000000000000000), UINTMAX_C(0x0028be5346d0c337), UINTMAX_C(0x00517c5511d442af),
+        UINTMAX_C(0x007a39b3e90eed8b), UINTMAX_C(0x00a2f61e5c28262a), UINTMAX_C(0x00cbb143063a9d77),
+        UINTMAX_C(0x00f46ad091a35702), UINTMAX_C(0x011d2275bbcee3d2), UINTMAX_C(0x0145d7e159046278),
+        UINTMAX_C(0x016e8ac2582dd332), UINTMAX_C(0x01973ac7c69d4fb3), UINTMAX_C(0x01bfe7a0d3ceb6ae),
+        UINTMAX_C(0x01e890fcd5255c1a), UINTMAX_C(0x0211368b49a55003), UINTMAX_C(0x0239d7fbdda7ce9e),
+        UINTMAX_C(0x026274fe6e8a6d83), UINTMAX_C(0x028b0d430e589aed), UINTMAX_C(0x02b3a07a076f053a),
+        UINTMAX_C(0x02dc2e53e0188222), UINTMAX_C(0x0304b6815e240e7d), UINTMAX_C(0x032d38b38a738106),
+        UINTMAX_C(0x0355b49bb4828bed), UINTMAX_C(0x037e29eb75e5aad7), UINTMAX_C(0x03a69854b5c09c7c),
+        UINTMAX_C(0x03ceff89ac340906), UINTMAX_C(0x03f75f3ce5c1f7f6), UINTMAX_C(0x041fb72146a8ba83),
+        UINTMAX_C(0x044806ea0e33f132), UINTMAX_C(0x04704e4ada035582), UINTMAX_C(0x04988cf7a946f2c3),
+        UINTMAX_C(0x04c0c2a4dff07b1f), UINTMAX_C(0x04e8ef0749d96865), UINTMAX_C(0x051111d41ddd9a1b),
+        UINTMAX_C(0x05392ac100ea2506), UINTMAX_C(0x0561398409000a68), UINTMAX_C(0x05893dd3c02a8ff6),
+        UINTMAX_C(0x05b137672768f3a0), UINTMAX_C(0x05d925f5b98b392c), UINTMAX_C(0x060109376e01d1dc),
+        UINTMAX_C(0x0628e0e4bb9fe11a), UINTMAX_C(0x0650acb69b4fe3ae), UINTMAX_C(0x06786c668aba81ac),
+        UINTMAX_C(0x06a01fae8edf55e7), UINTMAX_C(0x06c7c649369f7861), UINTMAX_C(0x06ef5ff19d399bf0),
+        UINTMAX_C(0x0716ec636cb791eb), UINTMAX_C(0x073e6b5ae04d098b), UINTMAX_C(0x0765dc94c6a7633a),
+        UINTMAX_C(0x078d3fce842e72ec), UINTMAX_C(0x07b494c615360f47), UINTMAX_C(0x07dbdb3a10204e0b),
+        UINTMAX_C(0x080312e9a770510f), UINTMAX_C(0x082a3b94abcd89a5), UINTMAX_C(0x085154fb8df75b22),
+        UINTMAX_C(0x08785edf60a907e1), UINTMAX_C(0x089f5901da6dd6b8), UINTMAX_C(0x08c64325576561a1),
+        UINTMAX_C(0x08ed1d0cdaf800e8), UINTMAX_C(0x0913e67c117b48c9), UINTMAX_C(0x093a9f3751c69219),
+        UINTMAX_C(0x096147039eb78911), UINTMAX_C(0x0987dda6a8a6bfdc), UINTMAX_C(0x09ae62e6cecc4522),
+        UINTMAX_C(0x09d4d68b20944125), UINTMAX_C(0x09fb385b5ee39e8e), UINTMAX_C(0x0a21881ffd4cc655),
+        UINTMAX_C(0x0a47c5a2233478a9), UINTMAX_C(0x0a6df0abace6cef1), UINTMAX_C(0x0a9409072c9c755d),
+        UINTMAX_C(0x0aba0e7feb702ca6), UINTMAX_C(0x0ae000e1ea44a6d6), UINTMAX_C(0x0b05dff9e29ad417),
+        UINTMAX_C(0x0b2bab954758b68a), UINTMAX_C(0x0b5163824580d64c), UINTMAX_C(0x0b77078fc4da70b5),
+        UINTMAX_C(0x0b9c978d688a7fd3), UINTMAX_C(0x0bc2134b8f9db904), UINTMAX_C(0x0be77a9b5583a368),
+        UINTMAX_C(0x0c0ccd4e927ae89e), UINTMAX_C(0x0c320b37dbef03fb), UINTMAX_C(0x0c57342a84c77619),
+        UINTMAX_C(0x0c7c47fa9da8a426), UINTMAX_C(0x0ca1467cf5268bea), UINTMAX_C(0x0cc62f8717e976fe),
+        UINTMAX_C(0x0ceb02ef50c4d90e), UINTMAX_C(0x0d0fc08ca8c08664), UINTMAX_C(0x0d346836e7147140),
+        UINTMAX_C(0x0d58f9c691171dd3), UINTMAX_C(0x0d7d7514ea1efdba), UINTMAX_C(0x0da1d9fbf356e52c),
+        UINTMAX_C(0x0dc628566b85ccec), UINTMAX_C(0x0dea5fffceca1538), UINTMAX_C(0x0e0e80d456487ec6),
+        UINTMAX_C(0x0e328ab0f7cf0fd4), UINTMAX_C(0x0e567d73656c1c1c), UINTMAX_C(0x0e7a58fa0cf9a754),
+        UINTMAX_C(0x0e9e1d24179d5a77), UINTMAX_C(0x0ec1c9d1693d44e9), UINTMAX_C(0x0ee55ee29fe9a300),
+        UINTMAX_C(0x0f08dc39133be41e), UINTMAX_C(0x0f2c41b6d3ab2afa), UINTMAX_C(0x0f4f8f3ea9d68332),
+        UINTMAX_C(0x0f72c4b415c507a0), UINTMAX_C(0x0f95e1fb4e1c3536), UINTMAX_C(0x0fb8e6f93f4ca68f),
+        UINTMAX_C(0x0fdbd3938ab57475), UINTMAX_C(0x0ffea7b085be77f1), UINTMAX_C(0x1021633738e9aa8d),
+        UINTMAX_C(0x1044060f5edbe182), UINTMAX_C(0x10669021635d20a8), UINTMAX_C(0x108901566250c1f4),
+        UINTMAX_C(0x10ab599826a5ae49), UINTMAX_C(0x10cd98d1293ee442), UINTMAX_C(0x10efbeec8fd48997),
+        UINTMAX_C(0x1111cbd62bcdc362), UINTMAX_C(0x1133bf7a79139192), UINTMAX_C(0x115599c69cdce966),
+        UINTMAX_C(0x11775aa864744aa3), UINTMAX_C(0x1199020e43f70ad7), UINTMAX_C(0x11ba8fe7550e91ab),
+        UINTMAX_C(0x11dc042355a3c0dd), UINTMAX_C(0x11fd5eb2a68cc212), UINTMAX_C(0x121e9f864a35743c),
+        UINTMAX_C(0x123fc68fe342b1e3), UINTMAX_C(0x1260d3c1b330a904), UINTMAX_C(0x1281c70e98ec7cca),
+        UINTMAX_C(0x12a2a06a0f6968d1), UINTMAX_C(0x12c35fc82c319cfc), UINTMAX_C(0x12e4051d9df30866),
+        UINTMAX_C(0x1304905fab084941), UINTMAX_C(0x132501842ffdf6d8), UINTMAX_C(0x134558819e147a3f),
+        UINTMAX_C(0x1365954ef9bea97f), UINTMAX_C(0x1385b7e3d91d5873), UINTMAX_C(0x13a5c038627811a4),
+        UINTMAX_C(0x13c5ae454ab328e9), UINTMAX_C(0x13e58203d3c358a8), UINTMAX_C(0x14053b6dcb1f19d9),
+        UINTMAX_C(0x1424da7d882de63b), UINTMAX_C(0x14445f2deab59338), UINTMAX_C(0x1463c97a5945f355),
+        UINTMAX_C(0x1483195ebfa2eb05), UINTMAX_C(0x14a24ed78d2d2527), UINTMAX_C(0x14c169e1b3499265),
+        UINTMAX_C(0x14e06a7aa3c7ddee), UINTMAX_C(0x14ff50a04f480144), UINTMAX_C(0x151e1c51239f1fca),
+        UINTMAX_C(0x153ccd8c0a3bd220), UINTMAX_C(0x155b6450668a0849), UINTMAX_C(0x1579e09e1456a8e9),
+        UINTMAX_C(0x15984275663312f4), UINTMAX_C(0x15b689d723d8a654), UINTMAX_C(0x15d4b6c4888c7725),
+        UINTMAX_C(0x15f2c93f41834e68), UINTMAX_C(0x1610c1496c461a09), UINTMAX_C(0x162e9ee59516ed5c),
+        UINTMAX_C(0x164c6216b556b249), UINTMAX_C(0x166a0ae031ebaa8d), UINTMAX_C(0x16879945d9a8df94),
+        UINTMAX_C(0x16a50d4be3b69ea6), UINTMAX_C(0x16c266f6edfc1e3e), UINTMAX_C(0x16dfa64bfb8a689c),
+        UINTMAX_C(0x16fccb507308a6bc), UINTMAX_C(0x1719d60a1d21e616), UINTMAX_C(0x1736c67f22f472c7),
+        UINTMAX_C(0x17539cb60c82ded1), UINTMAX_C(0x177058b5bf26ce81), UINTMAX_C(0x178cfa857c05a114),
+        UINTMAX_C(0x17a9822cde870c11), UINTMAX_C(0x17c5efb3dacdbeeb), UINTMAX_C(0x17e24322bc3223cd),
+        UINTMAX_C(0x17fe7c8223bf51a8), UINTMAX_C(0x181a9bdb06b242e0), UINTMAX_C(0x1836a136acfb632c),
+        UINTMAX_C(0x18528c9eafc286a3), UINTMAX_C(0x186e5e1cf7ed5b08), UINTMAX_C(0x188a15bbbca863e4),
+        UINTMAX_C(0x18a5b38581f29125), UINTMAX_C(0x18c13785172b7f66), UINTMAX_C(0x18dca1c595a4703e),
+        UINTMAX_C(0x18f7f2525f34085c), UINTMAX_C(0x191329371ccce093), UINTMAX_C(0x192e467fbd16f63e),
+        UINTMAX_C(0x19494a38730c06d8), UINTMAX_C(0x1964346db496e206), UINTMAX_C(0x197f052c3935bca7),
+        UINTMAX_C(0x1999bc80f89f8eed), UINTMAX_C(0x19b45a79296c86ff), UINTMAX_C(0x19cedf223fc198ea),
+        UINTMAX_C(0x19e94a89ebff3444), UINTMAX_C(0x1a039cbe1973273a), UINTMAX_C(0x1a1dd5cced0db644),
+        UINTMAX_C(0x1a37f5c4c419ef33), UINTMAX_C(0x1a51fcb432f93dd0), UINTMAX_C(0x1a6beaaa03e247ac),
+        UINTMAX_C(0x1a85bfb535a31470), UINTMAX_C(0x1a9f7be4fa66874b), UINTMAX_C(0x1ab91f48b67d2dd0),
+        UINTMAX_C(0x1ad2a9efff296815), UINTMAX_C(0x1aec1bea996eed68), UINTMAX_C(0x1b05754878e5b08c),
+        UINTMAX_C(0x1b1eb619be902604), UINTMAX_C(0x1b37de6eb7b4ee86), UINTMAX_C(0x1b50ee57dcbbe750),
+        UINTMAX_C(0x1b69e5e5d00ea1a5), UINTMAX_C(0x1b82c5295cfc4273), UINTMAX_C(0x1b9b8c3376a0cab2),
+        UINTMAX_C(0x1bb43b1536cfc8b1), UINTMAX_C(0x1bccd1dfdd02723f), UINTMAX_C(0x1be550a4cd49272e),
+        UINTMAX_C(0x1bfdb7758f405b7f), UINTMAX_C(0x1c160663cd08e808), UINTMAX_C(0x1c2e3d815243c04a),
+        UINTMAX_C(0x1c465ce00b110bb7), UINTMAX_C(0x1c5e64920312a07b), UINTMAX_C(0x1c7654a96471dd86),
+        UINTMAX_C(0x1c8e2d3876e8e159), UINTMAX_C(0x1ca5ee519ecf1ad5), UINTMAX_C(0x1cbd98075c293105),
+        UINTMAX_C(0x1cd52a6c49bc3eb1), UINTMAX_C(0x1ceca5931c245e37), UINTMAX_C(0x1d04098ea0ee81fc),
+        UINTMAX_C(0x1d1b5671bdb59596), UINTMAX_C(0x1d328c4f6f42e388), UINTMAX_C(0x1d49ab3ac8b1bb50),
+        UINTMAX_C(0x1d60b346f2965344), UINTMAX_C(0x1d77a4872a27e193), UINTMAX_C(0x1d8e7f0ec06de79d),
+        UINTMAX_C(0x1da542f11970aa94), UINTMAX_C(0x1dbbf041ab6cd44e), UINTMAX_C(0x1dd28713fe0a36ef),
+        UINTMAX_C(0x1de9077ba995adfb), UINTMAX_C(0x1dff718c563e1741), UINTMAX_C(0x1e15c559bb545de1),
+        UINTMAX_C(0x1e2c02f79e8e919c), UINTMAX_C(0x1e422a79d34e047c), UINTMAX_C(0x1e583bf439e868c5),
+        UINTMAX_C(0x1e6e377abef3e908), UINTMAX_C(0x1e841d215a96340f), UINTMAX_C(0x1e99ecfc0fd67650),
+        UINTMAX_C(0x1eafa71eebf23a7b), UINTMAX_C(0x1ec54b9e05b52a98), UINTMAX_C(0x1edada8d7cd3ab1d),
+        UINTMAX_C(0x1ef054017948495f), UINTMAX_C(0x1f05b80e2ab3f69e), UINTMAX_C(0x1f1b06c7c7c108df),
+        UINTMAX_C(0x1f3040428d88facd), UINTMAX_C(0x1f456492befce3af), UINTMAX_C(0x1f5a73cca450a08d),
+        UINTMAX_C(0x1f6f6e048a68a792), UINTMAX_C(0x1f84534ec24a7e91), UINTMAX_C(0x1f9923bfa08fcdcb),
+        UINTMAX_C(0x1faddf6b7cdc07b6), UINTMAX_C(0x1fc28666b1549ed9), UINTMAX_C(0x1fd718c59a1bc281),
+        UINTMAX_C(0x1feb969c94cd9b3e), UINTMAX_C(0x2000000000000000)
+      };
+
+      //! <c>values[k]</c> is the CORDIC angle atan(2^-k) in turns, atan(2^-k)/(2*pi) in Q0.64, rounded to nearest.
+      template <typename T>
+      struct cordic_table
+      {
+        static const T values[62];
+      };
+      template <typename T>
+      const T cordic_table<T>::values[62] =
+      {
+        UINTMAX_C(0x2000000000000000), UINTMAX_C(0x12e4051d9df30866), UINTMAX_C(0x09fb385b5ee39e8e),
+        UINTMAX_C(0x051111d41ddd9a1b), UINTMAX_C(0x028b0d430e589aed), UINTMAX_C(0x0145d7e159046278),
+        UINTMAX_C(0x00a2f61e5c28262a), UINTMAX_C(0x00517c5511d442af), UINTMAX_C(0x0028be5346d0c337),
+        UINTMAX_C(0x00145f2ebb30ab38), UINTMAX_C(0x000a2f980091ba7b), UINTMAX_C(0x000517cc14a80cb7),
+        UINTMAX_C(0x00028be60cdfec62), UINTMAX_C(0x000145f306c172f2), UINTMAX_C(0x0000a2f9836ae911),
+        UINTMAX_C(0x0000517cc1b6ba7c), UINTMAX_C(0x000028be60db85fc), UINTMAX_C(0x0000145f306dc816),
+        UINTMAX_C(0x00000a2f9836e4ae), UINTMAX_C(0x00000517cc1b726b), UINTMAX_C(0x0000028be60db938),
+        UINTMAX_C(0x00000145f306dc9c), UINTMAX_C(0x000000a2f9836e4e), UINTMAX_C(0x000000517cc1b727),
+        UINTMAX_C(0x00000028be60db94), UINTMAX_C(0x000000145f306dca), UINTMAX_C(0x0000000a2f9836e5),
+        UINTMAX_C(0x0000000517cc1b72), UINTMAX_C(0x000000028be60db9), UINTMAX_C(0x0000000145f306dd),
+        UINTMAX_C(0x00000000a2f9836e), UINTMAX_C(0x00000000517cc1b7), UINTMAX_C(0x0000000028be60dc),
+        UINTMAX_C(0x00000000145f306e), UINTMAX_C(0x000000000a2f9837), UINTMAX_C(0x000000000517cc1b),
+        UINTMAX_C(0x00000000028be60e), UINTMAX_C(0x000000000145f307), UINTMAX_C(0x0000000000a2f983),
+        UINTMAX_C(0x0000000000517cc2), UINTMAX_C(0x000000000028be61), UINTMAX_C(0x0000000000145f30),
+        UINTMAX_C(0x00000000000a2f98), UINTMAX_C(0x00000000000517cc), UINTMAX_C(0x0000000000028be6),
+        UINTMAX_C(0x00000000000145f3), UINTMAX_C(0x000000000000a2fa), UINTMAX_C(0x000000000000517d),
+        UINTMAX_C(0x00000000000028be), UINTMAX_C(0x000000000000145f), UINTMAX_C(0x0000000000000a30),
+        UINTMAX_C(0x0000000000000518), UINTMAX_C(0x000000000000028c), UINTMAX_C(0x0000000000000146),
+        UINTMAX_C(0x00000000000000a3), UINTMAX_C(0x0000000000000051), UINTMAX_C(0x0000000000000029),
+        UINTMAX_C(0x0000000000000014), UINTMAX_C(0x000000000000000a), UINTMAX_C(0x0000000000000005),
+        UINTMAX_C(0x0000000000000003), UINTMAX_C(0x0000000000000001)
+      };
+
+      //! pi/2 in Q1.62.
+      BOOST_STATIC_CONSTEXPR boost::uintmax_t half_pi_q62 = UINTMAX_C(0x6487ed5110b4611a);
+      //! 1/(2*pi) in Q0.64.
+      BOOST_STATIC_CONSTEXPR boost::uintmax_t inv_two_pi_q64 = UINTMAX_C(0x28be60db9391054a);
+      //! The inverse of the CORDIC gain, the product of the 1/sqrt(1+2^-2k), in Q1.62.
+      BOOST_STATIC_CONSTEXPR boost::uintmax_t cordic_gain_inv_q62 = UINTMAX_C(0x26dd3b6a10d7969a);
+
+      //! The number of CORDIC iterations giving two bits more than @c bits fractional bits.
+      inline int cordic_iterations(int bits)
+      {
+        return (bits + 3 > 62) ? 62 : ((bits + 3 < 1) ? 1 : bits + 3);
+      }
+
+      //! @Returns the product of two signed Q1.62 numbers, truncated toward 0, as long as it is less than 2.
+      inline boost::intmax_t mul_q62(boost::intmax_t a, boost::intmax_t b)
+      {
+        boost::uintmax_t ua = (a < 0) ? boost::uintmax_t(0) - boost::uintmax_t(a) : boost::uintmax_t(a);
+        boost::uintmax_t ub = (b < 0) ? boost::uintmax_t(0) - boost::uintmax_t(b) : boost::uintmax_t(b);
+        boost::intmax_t res = boost::intmax_t(mul_q62(ua, ub));
+        return ((a < 0) != (b < 0)) ? -res : res;
+      }
+
+      /**
+       * The angle @c x in turns as a phase, the fraction of turn in Q0.64. The whole turns are dropped, as well as the
+       * bits of @c x below 2^-64.
+       */
+      template <typename T>
+      boost::uintmax_t turns_to_phase(T const& x)
+      {
+        BOOST_STATIC_CONSTEXPR int P = T::resolution_exp;
+        BOOST_STATIC_ASSERT(uintmax_digits == 64);
+        if (P >= 0)
+          return 0;
+        if (P >= -64)
+          return boost::uintmax_t(x.count()) << ((P >= -64 && P < 0) ? 64 + P : 0);
+        return boost::uintmax_t(x.count() >> ((P < -64) ? -64 - P : 0));
+      }
+
+      /**
+       * The phase @c p in Q0.64 as a @c Res: in [0, 1[ turn for an unsigned @c Res, where the rounding up to one turn
+       * wraps to 0, and in ]-1/2, 1/2] turn for a signed one.
+       */
+      template <typename Res>
+      Res phase_to_turns(boost::uintmax_t p)
+      {
+        BOOST_STATIC_CONSTEXPR int shift = 64 + Res::resolution_exp;
+        BOOST_STATIC_ASSERT_MSG((shift > 0 && shift < 64 - int(Res::is_signed)),
+            "The resolution of the angle must be between 2^-63 and 2^-1 turn, or 2^-2 turn if signed");
+        typedef typename Res::rounding_type rounding_type;
+        if (!Res::is_signed)
+        {
+          boost::uintmax_t d = boost::uintmax_t(1) << shift;
+          boost::uintmax_t res = rounding_type::template round_quotient<boost::uintmax_t>(p >> shift, p & (d - 1), d);
+          res &= (boost::uintmax_t(1) << (64 - shift)) - 1;
+          return Res(index(math_index<Res>(res)));
+        }
+        boost::intmax_t v = (p >> 63) ? -boost::intmax_t(~p) - 1 : boost::intmax_t(p);
+        boost::intmax_t d = boost::intmax_t(1) << (Res::is_signed ? shift : 0);
+        boost::intmax_t res = rounding_type::template round_quotient<boost::intmax_t>(v / d, v % d, d);
+        boost::intmax_t half = boost::intmax_t(1) << (63 - shift);
+        if (res == -half)
+          res = half;
+        return Res(index(math_index<Res>(res)));
+      }
+
+      //! The Q1.62 value @c v, in [-1, 1], as a @c Res.
+      template <typename Res>
+      Res q62_to_number(boost::intmax_t v)
+      {
+        BOOST_STATIC_CONSTEXPR int shift = 62 + Res::resolution_exp;
+        BOOST_STATIC_ASSERT_MSG(Res::is_signed, "The sine and the cosine need a signed result");
+        BOOST_STATIC_ASSERT_MSG((shift >= 0 && shift < 63), "The resolution must be between 2^-62 and 2^0");
+        boost::intmax_t d = boost::intmax_t(1) << shift;
+        return Res(index(math_index<Res>(
+            Res::rounding_type::template round_quotient<boost::intmax_t>(v / d, v % d, d))));
+      }
+
+      //! The sine and cosine of <c>a + q/4</c> turn from the sine @c s and the cosine @c c of @c a.
+      inline void unfold_quadrant(boost::uintmax_t q, boost::intmax_t& s, boost::intmax_t& c)
+      {
+        boost::intmax_t t = s;
+        switch (q & 3)
+        {
+        case 0:
+          break;
+        case 1:
+          s = c;
+          c = -t;
+          break;
+        case 2:
+          s = -s;
+          c = -c;
+          break;
+        default:
+          s = -c;
+          c = t;
+          break;
+        }
+      }
+
+      //! The sine and the cosine in Q1.62 of the phase @c p, with @c Method.
+      template <typename Method>
+      void sincos_q62(boost::uintmax_t p, int bits, boost::intmax_t& s, boost::intmax_t& c)
+      {
+        boost::uintmax_t q = Method::sincos(p, bits, s, c);
+        unfold_quadrant(q, s, c);
+      }
+
+      /**
+       * The phase of the vector (x, y), reduced to the first octant for @c Method by symmetries, and 0 for the null
+       * vector.
+       */
+      template <typename Method>
+      boost::uintmax_t atan2_phase(boost::intmax_t y, boost::intmax_t x, int bits)
+      {
+        boost::uintmax_t ax = (x < 0) ? boost::uintmax_t(0) - boost::uintmax_t(x) : boost::uintmax_t(x);
+        boost::uintmax_t ay = (y < 0) ? boost::uintmax_t(0) - boost::uintmax_t(y) : boost::uintmax_t(y);
+        bool swap = ay > ax;
+        if (swap)
+        {
+          boost::uintmax_t t = ax;
+          ax = ay;
+          ay = t;
+        }
+        if (ax == 0)
+          return 0;
+        // ax in [2^59, 2^60[
+        int e = log2_floor(ax);
+        if (e > 59)
+        {
+          ax >>= e - 59;
+          ay >>= e - 59;
+        }
+        else
+        {
+          ax <<= 59 - e;
+          ay <<= 59 - e;
+        }
+        boost::uintmax_t a = Method::atan(ax, ay, bits);
+        if (swap)
+          a = (boost::uintmax_t(1) << 62) - a;
+        if (x < 0)
+          a = (boost::uintmax_t(1) << 63) - a;
+        if (y < 0)
+          a = boost::uintmax_t(0) - a;
+        return a;
+      }
+    }
+
+    namespace trigonometric
+    {
+#if defined(BOOST_FIXED_POINT_DOXYGEN_INVOKED)
+      /**
+       * The trigonometric functions are computed on integers by a method, selected by the user as a policy.
+       * All of them follow this stereotype, where the phases are the fractions of turn in Q0.64 and the values are
+       * Q1.62 numbers, and @c bits is the number of fractional bits of the result, that the method can use to stop
+       * early.
+       */
+      struct stereotype
+      {
+        /**
+         * Sets @c s and @c c to the sine and the cosine of <c>p - q/4</c> turn.
+         * @Returns the quadrant @c q.
+         */
+        static boost::uintmax_t sincos(boost::uintmax_t p, int bits, boost::intmax_t& s, boost::intmax_t& c);
+        /**
+         * @Requires <c>0 <= y <= x</c> and <c>2^59 <= x < 2^60</c>.
+         * @Returns the phase of atan(y/x), in [0, 1/8] turn.
+         */
+        static boost::uintmax_t atan(boost::uintmax_t x, boost::uintmax_t y, int bits);
+      };
+#endif
+
+      /**
+       * Interpolated tables of 257 entries on an octant or a quadrant.
+       *
+       * The sine of a + b, where a is the angle of the table entry, is obtained by the angle addition formula from the
+       * sine and cosine of a in the table and the Taylor polynomials of the sine and the cosine of b < pi/512, whose
+       * degree depends on the resolution requested. The error before the rounding to the result is below
+       * 2^-(bits+2), and never below 2^-52.
+       *
+       * The arctangent of t = y/x in [0, 1] is the one of the entry t0 = i/256 plus atan((t-t0)/(1+t*t0)), on 32
+       * bits: the error before the rounding to the result is below 2^-32 turn.
+       */
+      struct table
+      {
+        static boost::uintmax_t sincos(boost::uintmax_t p, int bits, boost::intmax_t& s, boost::intmax_t& c)
+        {
+          using detail::mul_q62;
+          typedef detail::sin_table<boost::uintmax_t> sin_table;
+          const boost::uintmax_t one = boost::uintmax_t(1) << 62;
+          // the entry of a in the quadrant and b in radians
+          std::size_t i = std::size_t((p >> 54) & 255);
+          boost::uintmax_t b = mul_q62(p & ((boost::uintmax_t(1) << 54) - 1), detail::half_pi_q62);
+          boost::uintmax_t b2 = mul_q62(b, b);
+          // sin(b) = b - b^3/6 + b^5/120, cos(b) = 1 - b^2/2 + b^4/24, truncated to the terms above 2^-(bits+2)
+          boost::uintmax_t sb = b;
+          if (bits > 22)
+          {
+            boost::uintmax_t k = UINTMAX_C(0x0aaaaaaaaaaaaaab);
+            if (bits > 41)
+              k -= mul_q62(b2, UINTMAX_C(0x0088888888888889));
+            sb -= mul_q62(b, mul_q62(b2, k));
+          }
+          boost::uintmax_t cb = one - (b2 >> 1);
+          if (bits > 32)
+            cb += mul_q62(mul_q62(b2, b2), UINTMAX_C(0x02aaaaaaaaaaaaab));
+          boost::uintmax_t sa = sin_table::values[i];
+          boost::uintmax_t ca = sin_table::values[256 - i];
+          s = boost::intmax_t(mul_q62(sa, cb) + mul_q62(ca, sb));
+          c = boost::intmax_t(mul_q62(ca, cb)) - boost::intmax_t(mul_q62(sa, sb));
+          return p >> 62;
+        }
+
+        static boost::uintmax_t atan(boost::uintmax_t x, boost::uintmax_t y, int)
+        {
+          // t = y/x in Q0.32
+          boost::uintmax_t x32 = x >> 28;
+          boost::uintmax_t t = ((y >> 28) << 32) / x32;
+          std::size_t i = std::size_t(t >> 24);
+          boost::uintmax_t d = t - (boost::uintmax_t(i) << 24);
+          // u = (t - t0) / (1 + t*t0) < 2^-8, and atan(u) = u - u^3/3 in radians
+          boost::uintmax_t den = (boost::uintmax_t(1) << 32) + ((boost::uintmax_t(i) * t) >> 8);
+          boost::uintmax_t u = (d << 32) / den;
+          boost::uintmax_t u3 = (((u * u) >> 32) * u) >> 32;
+          return detail::atan_table<boost::uintmax_t>::values[i] + detail::mul_hi((u - u3 / 3) << 32,
+              detail::inv_two_pi_q64);
+        }
+      };
+
+      /**
+       * CORDIC, which rotates the vector by the angles atan(2^-k) with shifts and additions only.
+       *
+       * Each iteration gives one bit, and the number of iterations is two more than the number of fractional bits of
+       * the result, up to 62. The sine and the cosine stop at half of them, as the remaining angle z is then small
+       * enough for the rotation by z to be its first order approximation. The error before the rounding to the result
+       * is below 2^-(bits+2).
+       */
+      struct cordic
+      {
+        static boost::uintmax_t sincos(boost::uintmax_t p, int bits, boost::intmax_t& s, boost::intmax_t& c)
+        {
+          typedef detail::cordic_table<boost::uintmax_t> cordic_table;
+          typedef detail::sign_mask<boost::intmax_t> sign_mask;
+          // the nearest quadrant, and the remaining angle z in [-1/8, 1/8[ turn
+          boost::uintmax_t q = (p + (boost::uintmax_t(1) << 61)) >> 62;
+          boost::uintmax_t zp = p - (q << 62);
+          boost::intmax_t z = (zp >> 63) ? -boost::intmax_t(~zp) - 1 : boost::intmax_t(zp);
+          boost::intmax_t x = boost::intmax_t(detail::cordic_gain_inv_q62);
+          boost::intmax_t y = 0;
+          // |z| < 2^-(n-1) radians at the end, so that z^2/2 < 2^-(bits+2)
+          int n = (detail::cordic_iterations(bits) + 2) / 2;
+          for (int k = 0; k < n; ++k)
+          {
+            // rotates by atan(2^-k) toward z = 0, negating the steps when z < 0
+            boost::intmax_t m = sign_mask::apply(z);
+            boost::intmax_t dx = y >> k;
+            boost::intmax_t dy = x >> k;
+            x -= (dx ^ m) - m;
+            y += (dy ^ m) - m;
+            z -= (boost::intmax_t(cordic_table::values[k]) ^ m) - m;
+          }
+          // sin(a + z) = s + z * c and cos(a + z) = c - z * s, with z in radians
+          boost::intmax_t zr = detail::mul_q62(z, boost::intmax_t(detail::half_pi_q62));
+          s = y + detail::mul_q62(zr, x);
+          c = x - detail::mul_q62(zr, y);
+          return q;
+        }
+
+        static boost::uintmax_t atan(boost::uintmax_t x, boost::uintmax_t y, int bits)
+        {
+          typedef detail::cordic_table<boost::uintmax_t> cordic_table;
+          typedef detail::sign_mask<boost::intmax_t> sign_mask;
+          // x stays below 2^60 * sqrt(2) * 1.65 < 2^62
+          boost::intmax_t vx = boost::intmax_t(x);
+          boost::intmax_t vy = boost::intmax_t(y);
+          boost::uintmax_t z = 0;
+          int n = detail::cordic_iterations(bits);
+          for (int k = 0; k < n; ++k)
+          {
+            // rotates by atan(2^-k) toward y = 0, negating the steps when y < 0
+            boost::intmax_t m = sign_mask::apply(vy);
+            boost::intmax_t dx = vy >> k;
+            boost::intmax_t dy = vx >> k;
+            vx += (dx ^ m) - m;
+            vy -= (dy ^ m) - m;
+            z += (cordic_table::values[k] ^ boost::uintmax_t(m)) - boost::uintmax_t(m);
+          }
+          return z;
+        }
+      };
+    }
+
+    /**
+     * Sine of an angle measured in turns.
+     *
+     * @c x can be any fixed point number: only its fraction of turn is taken in account, so that a phase
+     * accumulator <c>ureal_t<0,-N,round::truncated,overflow::modulus></c> and a @c real_t angle are both accepted.
+     * The sine is computed on integers with @c Method, trigonometric::table or trigonometric::cordic. The error
+     * before the rounding to @c Res is below a quarter of its resolution, as long as @c Res has less than 50
+     * fractional bits with the table and 60 with CORDIC, so that the result is faithfully rounded with the round to
+     * nearest policies. 1 is only representable by a @c Res whose range exponent is positive, otherwise it is handled
+     * by the overflow policy.
+     *
+     * @Returns sin(2*pi*x) taking in account the rounding and the overflow policies of the signed result type @c Res.
+     */
+    template <typename Res, typename Method, typename T>
+    inline
+    Res
+    sin(T const& x)
+    {
+      boost::intmax_t s, c;
+      detail::sincos_q62<Method>(detail::turns_to_phase(x), -Res::resolution_exp, s, c);
+      return detail::q62_to_number<Res>(s);
+    }
+
+    /**
+     * @Returns <c>sin<Res, trigonometric::table>(x)</c>.
+     */
+    template <typename Res, typename T>
+    inline
+    Res
+    sin(T const& x)
+    {
+      return sin<Res, trigonometric::table>(x);
+    }
+
+    /**
+     * Cosine of an angle measured in turns, as @c sin.
+     *
+     * @Returns cos(2*pi*x) taking in account the rounding and the overflow policies of the signed result type @c Res.
+     */
+    template <typename Res, typename Method, typename T>
+    inline
+    Res
+    cos(T const& x)
+    {
+      boost::intmax_t s, c;
+      detail::sincos_q62<Method>(detail::turns_to_phase(x), -Res::resolution_exp, s, c);
+      return detail::q62_to_number<Res>(c);
+    }
+
+    /**
+     * @Returns <c>cos<Res, trigonometric::table>(x)</c>.
+     */
+    template <typename Res, typename T>
+    inline
+    Res
+    cos(T const& x)
+    {
+      return cos<Res, trigonometric::table>(x);
+    }
+
+    /**
+     * Sine and cosine of an angle measured in turns, computed together at the cost of one of them, as @c sin.
+     *
+     * @Effects <c>s = sin<Res, Method>(x)</c> and <c>c = cos<Res, Method>(x)</c>.
+     */
+    template <typename Method, typename T, typename Res>
+    inline
+    void
+    sincos(T const& x, Res& s, Res& c)
+    {
+      boost::intmax_t vs, vc;
+      detail::sincos_q62<Method>(detail::turns_to_phase(x), -Res::resolution_exp, vs, vc);
+      s = detail::q62_to_number<Res>(vs);
+      c = detail::q62_to_number<Res>(vc);
+    }
+
+    /**
+     * @Effects <c>sincos<trigonometric::table>(x, s, c)</c>.
+     */
+    template <typename T, typename Res>
+    inline
+    void
+    sincos(T const& x, Res& s, Res& c)
+    {
+      sincos<trigonometric::table>(x, s, c);
+    }
+
+    /**
+     * Angle of the vector (x, y) measured in turns.
+     *
+     * The arctangent is computed on integers with @c Method, trigonometric::table or trigonometric::cordic, after the
+     * reduction to the first octant. The error before the rounding to @c Res is below a quarter of its resolution,
+     * as long as @c Res has less than 30 fractional bits with the table and 60 with CORDIC, so that the result is
+     * faithfully rounded with the round to nearest policies.
+     * An unsigned @c Res, as a phase, gets the angle in [0, 1[ turn, and a signed one in ]-1/2, 1/2] turn.
+     *
+     * @Returns atan2(y, x)/(2*pi), 0 when both @c x and @c y are 0, taking in account the rounding and the overflow
+     * policies of the result type @c Res.
+     */
+    template <typename Res, typename Method, typename T>
+    inline
+    Res
+    atan2(T const& y, T const& x)
+    {
+      BOOST_STATIC_ASSERT_MSG((T::digits < detail::uintmax_digits),
+          "The arguments need more bits than boost::intmax_t");
+      return detail::phase_to_turns<Res>(detail::atan2_phase<Method>(boost::intmax_t(y.count()),
+          boost::intmax_t(x.count()), -Res::resolution_exp));
+    }
+
+    /**
+     * @Returns <c>atan2<Res, trigonometric::table>(y, x)</c>.
+     */
+    template <typename Res, typename T>
+    inline
+    Res
+    atan2(T const& y, T const& x)
+    {
+      return atan2<Res, trigonometric::table>(y, x);
+    }
+
+  }
+}
+
+#endif // header
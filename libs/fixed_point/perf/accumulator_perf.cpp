@@ -0,0 +1,86 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Measures the multiply-accumulate of 1024 products of Q7.8 numbers in [-4, 4], whose sum is normalized to Q15.16.
+//
+// Variants:
+// - baseline: the hand written loop on the indices.
+// - accumulator: accumulator<multiply_result<Q7.8>::type>, normalized once at the end.
+// - cast: the running sum kept in Q15.16 with a number_cast after each addition, and its overflow check.
+
+#include <boost/fixed_point/accumulator.hpp>
+#include "perf_harness.hpp"
+#include <boost/cstdint.hpp>
+#include <vector>
+
+using namespace boost::fixed_point;
+using boost::fixed_point::perf::random_indices;
+
+namespace
+{
+  const std::size_t buffer_size = 1024;
+
+  typedef real_t<7, -8> q7_8;
+  typedef real_t<15, -16> q15_16;
+
+  std::vector<q7_8> random_numbers(unsigned long long seed)
+  {
+    std::vector<boost::int16_t> idx = random_indices<boost::int16_t>(buffer_size, -1024, 1024, seed);
+    std::vector<q7_8> res;
+    for (std::size_t i = 0; i < buffer_size; ++i)
+      res.push_back(q7_8(index(idx[i])));
+    return res;
+  }
+
+  void mac_baseline(benchmark::State& state)
+  {
+    std::vector<q7_8> a = random_numbers(1);
+    std::vector<q7_8> b = random_numbers(2);
+    for (auto _ : state)
+    {
+      boost::int64_t acc = 0;
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        acc += boost::int32_t(a[i].count()) * b[i].count();
+      q15_16 r = q15_16(index(boost::int32_t(acc)));
+      benchmark::DoNotOptimize(r);
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  void mac_accumulator(benchmark::State& state)
+  {
+    std::vector<q7_8> a = random_numbers(1);
+    std::vector<q7_8> b = random_numbers(2);
+    for (auto _ : state)
+    {
+      accumulator<multiply_result<q7_8>::type> acc;
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        acc += a[i] * b[i];
+      q15_16 r = acc.get<q15_16>();
+      benchmark::DoNotOptimize(r);
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  void mac_cast(benchmark::State& state)
+  {
+    std::vector<q7_8> a = random_numbers(1);
+    std::vector<q7_8> b = random_numbers(2);
+    for (auto _ : state)
+    {
+      q15_16 acc(index(0));
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        acc = number_cast<q15_16>(acc + a[i] * b[i]);
+      benchmark::DoNotOptimize(acc);
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  const int mac_group = (benchmark::RegisterBenchmark("mac/baseline", mac_baseline),
+      benchmark::RegisterBenchmark("mac/accumulator", mac_accumulator),
+      benchmark::RegisterBenchmark("mac/cast", mac_cast), 0);
+}
+
+BOOST_FIXED_POINT_PERF_MAIN()
@@ -0,0 +1,354 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Measures the "zero overhead" primary objective: the basic operations on real_t must cost the same as the
+// integer-and-shift code a programmer would write by hand.
+//
+// Every group compares the library (variant real_t) with the equivalent int32/int64 code (variant baseline)
+// on buffers of Q15.16 values.
+
+#include <boost/fixed_point/number.hpp>
+#include "perf_harness.hpp"
+#include <boost/cstdint.hpp>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+using namespace boost::fixed_point;
+using boost::fixed_point::perf::random_indices;
+
+namespace
+{
+  const std::size_t buffer_size = 1024;
+
+  // Indices of Q15.16 values in ]-128, 128[, so that products and quotients fit back in a Q15.16.
+  const long long small_index = (1LL << 23) - 1;
+
+  template <typename RP, typename OP>
+  struct q15_16
+  {
+    typedef real_t<15, -16, RP, OP> type;
+  };
+
+  template <typename T>
+  std::vector<T> random_fxp(std::size_t n, long long lo, long long hi, unsigned long long seed = 12345)
+  {
+    std::vector<boost::int32_t> idx = random_indices<boost::int32_t>(n, lo, hi, seed);
+    std::vector<T> res;
+    res.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+      res.push_back(T(index(idx[i])));
+    return res;
+  }
+
+  // Divisors with a magnitude in [1, 16], with both signs.
+  template <typename T>
+  std::vector<T> random_divisors(std::size_t n)
+  {
+    std::vector<boost::int32_t> idx = random_indices<boost::int32_t>(n, 1LL << 16, 1LL << 20, 54321);
+    std::vector<T> res;
+    res.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+      res.push_back(T(index((i & 1) ? -idx[i] : idx[i])));
+    return res;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Hand written rounding and overflow kernels.
+
+  struct manual_negative
+  {
+    static boost::int64_t shift(boost::int64_t v, int d)
+    {
+      return v >> d;
+    }
+    static boost::int64_t divide(boost::int64_t n, boost::int64_t d)
+    {
+      boost::int64_t q = n / d;
+      return (q < 0 && q * d != n) ? q - 1 : q;
+    }
+  };
+  struct manual_truncated
+  {
+    static boost::int64_t shift(boost::int64_t v, int d)
+    {
+      return v >= 0 ? (v >> d) : -((-v) >> d);
+    }
+    static boost::int64_t divide(boost::int64_t n, boost::int64_t d)
+    {
+      return n / d;
+    }
+  };
+  struct manual_positive
+  {
+    static boost::int64_t shift(boost::int64_t v, int d)
+    {
+      return (v + ((boost::int64_t(1) << d) - 1)) >> d;
+    }
+    static boost::int64_t divide(boost::int64_t n, boost::int64_t d)
+    {
+      boost::int64_t q = n / d;
+      return (q >= 0 && q * d != n) ? q + 1 : q;
+    }
+  };
+
+  const boost::int64_t q15_16_max = (boost::int64_t(1) << 31) - 1;
+
+  struct manual_undefined
+  {
+    static boost::int32_t check(boost::int64_t v)
+    {
+      return boost::int32_t(v);
+    }
+  };
+  struct manual_saturate
+  {
+    static boost::int32_t check(boost::int64_t v)
+    {
+      return boost::int32_t(v > q15_16_max ? q15_16_max : (v < -q15_16_max ? -q15_16_max : v));
+    }
+  };
+  struct manual_exception
+  {
+    static boost::int32_t check(boost::int64_t v)
+    {
+      if (v > q15_16_max) throw positive_overflow();
+      if (v < -q15_16_max) throw negative_overflow();
+      return boost::int32_t(v);
+    }
+  };
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // operator+
+
+  void add_baseline(benchmark::State& state)
+  {
+    std::vector<boost::int32_t> a = random_indices<boost::int32_t>(buffer_size, -small_index, small_index, 1);
+    std::vector<boost::int32_t> b = random_indices<boost::int32_t>(buffer_size, -small_index, small_index, 2);
+    std::vector<boost::int64_t> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = boost::int64_t(a[i]) + b[i];
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+  BENCHMARK(add_baseline)->Name("add/baseline");
+
+  void add_real_t(benchmark::State& state)
+  {
+    typedef q15_16<round::negative, overflow::exception>::type T;
+    typedef add_result<T>::type RT;
+    std::vector<T> a = random_fxp<T>(buffer_size, -small_index, small_index, 1);
+    std::vector<T> b = random_fxp<T>(buffer_size, -small_index, small_index, 2);
+    std::vector<RT> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = a[i] + b[i];
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+  BENCHMARK(add_real_t)->Name("add/real_t");
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // operator*
+
+  void multiply_baseline(benchmark::State& state)
+  {
+    std::vector<boost::int32_t> a = random_indices<boost::int32_t>(buffer_size, -small_index, small_index, 1);
+    std::vector<boost::int32_t> b = random_indices<boost::int32_t>(buffer_size, -small_index, small_index, 2);
+    std::vector<boost::int64_t> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = boost::int64_t(a[i]) * b[i];
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+  BENCHMARK(multiply_baseline)->Name("multiply/baseline");
+
+  void multiply_real_t(benchmark::State& state)
+  {
+    typedef q15_16<round::negative, overflow::exception>::type T;
+    typedef multiply_result<T>::type RT;
+    std::vector<T> a = random_fxp<T>(buffer_size, -small_index, small_index, 1);
+    std::vector<T> b = random_fxp<T>(buffer_size, -small_index, small_index, 2);
+    std::vector<RT> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = a[i] * b[i];
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+  BENCHMARK(multiply_real_t)->Name("multiply/real_t");
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // number_cast: Q30.32 product back to Q15.16
+
+  template <typename MR, typename MO>
+  void number_cast_baseline(benchmark::State& state)
+  {
+    std::vector<boost::int32_t> a = random_indices<boost::int32_t>(buffer_size, -small_index, small_index, 1);
+    std::vector<boost::int32_t> b = random_indices<boost::int32_t>(buffer_size, -small_index, small_index, 2);
+    std::vector<boost::int64_t> p(buffer_size);
+    for (std::size_t i = 0; i < buffer_size; ++i)
+      p[i] = boost::int64_t(a[i]) * b[i];
+    std::vector<boost::int32_t> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = MO::check(MR::shift(p[i], 16));
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  template <typename RP, typename OP>
+  void number_cast_real_t(benchmark::State& state)
+  {
+    typedef typename q15_16<RP, OP>::type T;
+    typedef typename multiply_result<T>::type PT;
+    std::vector<T> a = random_fxp<T>(buffer_size, -small_index, small_index, 1);
+    std::vector<T> b = random_fxp<T>(buffer_size, -small_index, small_index, 2);
+    std::vector<PT> p;
+    p.reserve(buffer_size);
+    for (std::size_t i = 0; i < buffer_size; ++i)
+      p.push_back(a[i] * b[i]);
+    std::vector<T> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = number_cast<T>(p[i]);
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+#define BOOST_FIXED_POINT_PERF_NUMBER_CAST(RP, OP) \
+  BENCHMARK_TEMPLATE(number_cast_baseline, manual_##RP, manual_##OP)->Name("number_cast." #RP "." #OP "/baseline"); \
+  BENCHMARK_TEMPLATE(number_cast_real_t, round::RP, overflow::OP)->Name("number_cast." #RP "." #OP "/real_t")
+
+  BOOST_FIXED_POINT_PERF_NUMBER_CAST(negative, undefined);
+  BOOST_FIXED_POINT_PERF_NUMBER_CAST(negative, saturate);
+  BOOST_FIXED_POINT_PERF_NUMBER_CAST(negative, exception);
+  BOOST_FIXED_POINT_PERF_NUMBER_CAST(truncated, undefined);
+  BOOST_FIXED_POINT_PERF_NUMBER_CAST(truncated, saturate);
+  BOOST_FIXED_POINT_PERF_NUMBER_CAST(truncated, exception);
+  BOOST_FIXED_POINT_PERF_NUMBER_CAST(positive, undefined);
+  BOOST_FIXED_POINT_PERF_NUMBER_CAST(positive, saturate);
+  BOOST_FIXED_POINT_PERF_NUMBER_CAST(positive, exception);
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // divide<Res>
+
+  template <typename MR>
+  void divide_baseline(benchmark::State& state)
+  {
+    std::vector<boost::int32_t> a = random_indices<boost::int32_t>(buffer_size, -small_index, small_index, 1);
+    std::vector<boost::int32_t> b(buffer_size);
+    std::vector<boost::int32_t> d = random_indices<boost::int32_t>(buffer_size, 1LL << 16, 1LL << 20, 54321);
+    for (std::size_t i = 0; i < buffer_size; ++i)
+      b[i] = (i & 1) ? -d[i] : d[i];
+    std::vector<boost::int32_t> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = boost::int32_t(MR::divide(boost::int64_t(a[i]) << 16, b[i]));
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  template <typename RP>
+  void divide_real_t(benchmark::State& state)
+  {
+    typedef typename q15_16<RP, overflow::exception>::type T;
+    std::vector<T> a = random_fxp<T>(buffer_size, -small_index, small_index, 1);
+    std::vector<T> b = random_divisors<T>(buffer_size);
+    std::vector<T> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = divide<T>(a[i], b[i]);
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+#define BOOST_FIXED_POINT_PERF_DIVIDE(RP) \
+  BENCHMARK_TEMPLATE(divide_baseline, manual_##RP)->Name("divide." #RP "/baseline"); \
+  BENCHMARK_TEMPLATE(divide_real_t, round::RP)->Name("divide." #RP "/real_t")
+
+  BOOST_FIXED_POINT_PERF_DIVIDE(negative);
+  BOOST_FIXED_POINT_PERF_DIVIDE(truncated);
+  BOOST_FIXED_POINT_PERF_DIVIDE(positive);
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // classify: double to Q15.16
+
+  std::vector<double> random_doubles(std::size_t n)
+  {
+    std::vector<boost::int32_t> idx = random_indices<boost::int32_t>(n, -small_index, small_index, 3);
+    std::vector<double> res(n);
+    for (std::size_t i = 0; i < n; ++i)
+      res[i] = idx[i] / 65536.0 + 1.0 / (1 << 20);
+    return res;
+  }
+
+  template <typename MO>
+  void classify_baseline(benchmark::State& state)
+  {
+    std::vector<double> x = random_doubles(buffer_size);
+    std::vector<boost::int32_t> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = MO::check(boost::int64_t(std::floor(x[i] * 65536.0)));
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  template <typename OP>
+  void classify_real_t(benchmark::State& state)
+  {
+    typedef typename q15_16<round::negative, OP>::type T;
+    std::vector<double> x = random_doubles(buffer_size);
+    std::vector<T> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = T(index(T::classify(x[i])));
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+#define BOOST_FIXED_POINT_PERF_CLASSIFY(OP) \
+  BENCHMARK_TEMPLATE(classify_baseline, manual_##OP)->Name("classify.double." #OP "/baseline"); \
+  BENCHMARK_TEMPLATE(classify_real_t, overflow::OP)->Name("classify.double." #OP "/real_t")
+
+  BOOST_FIXED_POINT_PERF_CLASSIFY(undefined);
+  BOOST_FIXED_POINT_PERF_CLASSIFY(saturate);
+  BOOST_FIXED_POINT_PERF_CLASSIFY(exception);
+}
+
+BOOST_FIXED_POINT_PERF_MAIN()
@@ -0,0 +1,304 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Measures the batch operations on arrays of Q15.16 numbers.
+//
+// Groups:
+// - add: Q15.16 + Q15.16 -> Q16.16.
+// - multiply: Q15.16 * Q15.16 -> Q31.32.
+// - requantize: Q31.32 -> Q15.16 rounded to nearest even, with overflow::exception.
+// - saturate: Q31.32 -> Q15.16 rounded to nearest even, saturating.
+//
+// Variants:
+// - baseline: hand written integer loop, which the compiler may vectorize.
+// - scalar: the real_t operators applied element by element.
+// - sse4, avx2, avx512: the batch operations restricted to the instruction set; skipped when not supported.
+
+#include <boost/fixed_point/batch.hpp>
+#include "perf_harness.hpp"
+#include <boost/cstdint.hpp>
+#include <string>
+#include <vector>
+
+using namespace boost::fixed_point;
+using boost::fixed_point::perf::random_indices;
+
+namespace
+{
+  const std::size_t buffer_size = 1024;
+
+  typedef real_t<15, -16> q15_16;
+  typedef real_t<31, -32> q31_32;
+  typedef real_t<15, -16, round::nearest_even> q15_16_even;
+
+  template <typename T, typename I>
+  std::vector<T> random_numbers(I min, I max, unsigned long long seed)
+  {
+    std::vector<I> idx = random_indices<I>(buffer_size, min, max, seed);
+    std::vector<T> res;
+    res.reserve(buffer_size);
+    for (std::size_t i = 0; i < buffer_size; ++i)
+      res.push_back(T(index(idx[i])));
+    return res;
+  }
+
+  std::vector<q15_16> random_q15_16(unsigned long long seed)
+  {
+    return random_numbers<q15_16, boost::int32_t>(q15_16::min_index, q15_16::max_index, seed);
+  }
+
+  // Q31.32 values in ]-2^15, 2^15[, that don't overflow a Q15.16.
+  std::vector<q31_32> random_q31_32(unsigned long long seed)
+  {
+    return random_numbers<q31_32, boost::int64_t>(-(1LL << 47) + 1, (1LL << 47) - 1, seed);
+  }
+
+  // Restricts the batch operations to the instruction set of the variant during a benchmark.
+  struct scoped_level
+  {
+    simd::level prev;
+    scoped_level(benchmark::State& state, simd::level l) :
+      prev(simd::restrict_to(l))
+    {
+      if (simd::active() != l) state.SkipWithError("instruction set not supported");
+    }
+    ~scoped_level()
+    {
+      simd::restrict_to(prev);
+    }
+  };
+
+  const char* level_name(simd::level l)
+  {
+    switch (l)
+    {
+    case simd::sse4: return "sse4";
+    case simd::avx2: return "avx2";
+    case simd::avx512: return "avx512";
+    default: return "none";
+    }
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // add
+
+  void add_baseline(benchmark::State& state)
+  {
+    std::vector<boost::int32_t> a = random_indices<boost::int32_t>(buffer_size, q15_16::min_index, q15_16::max_index, 1);
+    std::vector<boost::int32_t> b = random_indices<boost::int32_t>(buffer_size, q15_16::min_index, q15_16::max_index, 2);
+    std::vector<boost::int64_t> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = boost::int64_t(a[i]) + b[i];
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+  BENCHMARK(add_baseline)->Name("add/baseline");
+
+  void add_scalar(benchmark::State& state)
+  {
+    std::vector<q15_16> a = random_q15_16(1);
+    std::vector<q15_16> b = random_q15_16(2);
+    std::vector<add_result<q15_16>::type> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = a[i] + b[i];
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+  BENCHMARK(add_scalar)->Name("add/scalar");
+
+  void add_batch(benchmark::State& state, simd::level l)
+  {
+    scoped_level level(state, l);
+    std::vector<q15_16> a = random_q15_16(1);
+    std::vector<q15_16> b = random_q15_16(2);
+    std::vector<add_result<q15_16>::type> c(buffer_size);
+    for (auto _ : state)
+    {
+      batch::add(a.data(), b.data(), c.data(), buffer_size);
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // multiply
+
+  void multiply_baseline(benchmark::State& state)
+  {
+    std::vector<boost::int32_t> a = random_indices<boost::int32_t>(buffer_size, q15_16::min_index, q15_16::max_index, 1);
+    std::vector<boost::int32_t> b = random_indices<boost::int32_t>(buffer_size, q15_16::min_index, q15_16::max_index, 2);
+    std::vector<boost::int64_t> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = boost::int64_t(a[i]) * b[i];
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+  BENCHMARK(multiply_baseline)->Name("multiply/baseline");
+
+  void multiply_scalar(benchmark::State& state)
+  {
+    std::vector<q15_16> a = random_q15_16(1);
+    std::vector<q15_16> b = random_q15_16(2);
+    std::vector<multiply_result<q15_16>::type> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = a[i] * b[i];
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+  BENCHMARK(multiply_scalar)->Name("multiply/scalar");
+
+  void multiply_batch(benchmark::State& state, simd::level l)
+  {
+    scoped_level level(state, l);
+    std::vector<q15_16> a = random_q15_16(1);
+    std::vector<q15_16> b = random_q15_16(2);
+    std::vector<multiply_result<q15_16>::type> c(buffer_size);
+    for (auto _ : state)
+    {
+      batch::multiply(a.data(), b.data(), c.data(), buffer_size);
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // requantize and saturate
+
+  // Rounds to nearest even and throws on overflow.
+  void requantize_baseline(benchmark::State& state)
+  {
+    std::vector<boost::int64_t> a = random_indices<boost::int64_t>(buffer_size, -(1LL << 47) + 1, (1LL << 47) - 1, 1);
+    std::vector<boost::int32_t> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+      {
+        boost::int64_t v = a[i];
+        if (v > (boost::int64_t(q15_16::max_index) << 16)) throw positive_overflow();
+        if (v < (boost::int64_t(q15_16::min_index) << 16)) throw negative_overflow();
+        c[i] = boost::int32_t((v + 0x7fff + ((v >> 16) & 1)) >> 16);
+      }
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+  BENCHMARK(requantize_baseline)->Name("requantize/baseline");
+
+  void requantize_scalar(benchmark::State& state)
+  {
+    std::vector<q31_32> a = random_q31_32(1);
+    std::vector<q15_16_even> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = number_cast<q15_16_even>(a[i]);
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+  BENCHMARK(requantize_scalar)->Name("requantize/scalar");
+
+  void requantize_batch(benchmark::State& state, simd::level l)
+  {
+    scoped_level level(state, l);
+    std::vector<q31_32> a = random_q31_32(1);
+    std::vector<q15_16_even> c(buffer_size);
+    for (auto _ : state)
+    {
+      batch::number_cast(a.data(), c.data(), buffer_size);
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  void saturate_baseline(benchmark::State& state)
+  {
+    std::vector<boost::int64_t> a = random_indices<boost::int64_t>(buffer_size, -(1LL << 48), 1LL << 48, 1);
+    std::vector<boost::int32_t> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+      {
+        boost::int64_t v = a[i];
+        boost::int64_t r = (v + 0x7fff + ((v >> 16) & 1)) >> 16;
+        r = v > (boost::int64_t(q15_16::max_index) << 16) ? q15_16::max_index : r;
+        r = v < (boost::int64_t(q15_16::min_index) << 16) ? q15_16::min_index : r;
+        c[i] = boost::int32_t(r);
+      }
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+  BENCHMARK(saturate_baseline)->Name("saturate/baseline");
+
+  void saturate_scalar(benchmark::State& state)
+  {
+    typedef real_t<15, -16, round::nearest_even, overflow::saturate> saturating;
+    std::vector<q31_32> a = random_numbers<q31_32, boost::int64_t>(-(1LL << 48), 1LL << 48, 1);
+    std::vector<q15_16_even> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = q15_16_even(index(number_cast<saturating>(a[i]).count()));
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+  BENCHMARK(saturate_scalar)->Name("saturate/scalar");
+
+  void saturate_batch(benchmark::State& state, simd::level l)
+  {
+    scoped_level level(state, l);
+    std::vector<q31_32> a = random_numbers<q31_32, boost::int64_t>(-(1LL << 48), 1LL << 48, 1);
+    std::vector<q15_16_even> c(buffer_size);
+    for (auto _ : state)
+    {
+      batch::saturate(a.data(), c.data(), buffer_size);
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  int register_batch_variants()
+  {
+    const simd::level levels[] = { simd::sse4, simd::avx2, simd::avx512 };
+    for (simd::level l : levels)
+    {
+      std::string name = level_name(l);
+      benchmark::RegisterBenchmark(("add/" + name).c_str(), add_batch, l);
+      benchmark::RegisterBenchmark(("multiply/" + name).c_str(), multiply_batch, l);
+      benchmark::RegisterBenchmark(("requantize/" + name).c_str(), requantize_batch, l);
+      benchmark::RegisterBenchmark(("saturate/" + name).c_str(), saturate_batch, l);
+    }
+    return 0;
+  }
+  const int batch_variants = register_batch_variants();
+}
+
+BOOST_FIXED_POINT_PERF_MAIN()
@@ -0,0 +1,214 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Measures the cascades of 1 or 4 low-pass biquads on 4096 Q15 samples, real_t<0,-15>, with Q2.30 coefficients,
+// real_t<1,-30>, and Q4.28 states, real_t<3,-28>, rounded to nearest even and saturated. Besides the samples per
+// second, the counter sample_sections reports the samples per second times the number of sections.
+//
+// Variants:
+// - baseline: the hand written direct form I on int16_t, int32_t and int64_t.
+// - double: the direct form I on double.
+// - df1: biquad_cascade in direct form I.
+// - df1_error_feedback: biquad_cascade in direct form I with a second order error feedback.
+// - tdf2: biquad_cascade in transposed direct form II.
+
+#include <boost/fixed_point/biquad.hpp>
+#include "perf_harness.hpp"
+#include <boost/cstdint.hpp>
+#include <cmath>
+#include <vector>
+
+using namespace boost::fixed_point;
+using boost::fixed_point::perf::random_indices;
+
+namespace
+{
+  const std::size_t buffer_size = 4096;
+
+  typedef real_t<0, -15, round::nearest_even, overflow::saturate> sample;
+  typedef real_t<1, -30> coefficient;
+  typedef real_t<3, -28, round::nearest_even, overflow::saturate> state_type;
+
+  // Low-pass sections of cutoff frequency 0.1 and increasing quality.
+  std::vector<biquad_coefficients<coefficient> > low_pass(std::size_t sections)
+  {
+    std::vector<biquad_coefficients<coefficient> > res;
+    for (std::size_t s = 0; s < sections; ++s)
+    {
+      double w = 2 * 3.14159265358979323846 * 0.1;
+      double alpha = std::sin(w) / (2 * (0.5 + 0.25 * s));
+      double a0 = 1 + alpha;
+      biquad_coefficients<coefficient> c;
+      c.b0 = coefficient((1 - std::cos(w)) / 2 / a0);
+      c.b1 = coefficient((1 - std::cos(w)) / a0);
+      c.b2 = c.b0;
+      c.a1 = coefficient(-2 * std::cos(w) / a0);
+      c.a2 = coefficient((1 - alpha) / a0);
+      res.push_back(c);
+    }
+    return res;
+  }
+
+  // Samples in [-0.25, 0.25], so that the cascades do not saturate.
+  std::vector<sample> random_samples(std::size_t n)
+  {
+    std::vector<boost::int16_t> idx = random_indices<boost::int16_t>(n, -8192, 8192, 1);
+    std::vector<sample> res;
+    for (std::size_t i = 0; i < n; ++i)
+      res.push_back(sample(index(idx[i])));
+    return res;
+  }
+
+  void set_counters(benchmark::State& state, std::size_t sections)
+  {
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+    state.counters["sample_sections"] = benchmark::Counter(double(state.iterations()) * buffer_size * sections,
+        benchmark::Counter::kIsRate);
+  }
+
+  // Rounds v, at the resolution 2^-shift of a unit, to nearest even and saturates it to [-max, max].
+  inline boost::int64_t round_saturate(boost::int64_t v, int shift, boost::int64_t max)
+  {
+    boost::int64_t half = boost::int64_t(1) << (shift - 1);
+    boost::int64_t q = v >> shift;
+    boost::int64_t r = v & ((boost::int64_t(1) << shift) - 1);
+    q += (r > half || (r == half && (q & 1))) ? 1 : 0;
+    return q > max ? max : q < -max ? -max : q;
+  }
+
+  void baseline(benchmark::State& state)
+  {
+    std::size_t sections = state.range(0);
+    std::vector<biquad_coefficients<coefficient> > c = low_pass(sections);
+    std::vector<boost::int32_t> k;
+    for (std::size_t s = 0; s < sections; ++s)
+    {
+      k.push_back(c[s].b0.count());
+      k.push_back(c[s].b1.count());
+      k.push_back(c[s].b2.count());
+      k.push_back(c[s].a1.count());
+      k.push_back(c[s].a2.count());
+    }
+    std::vector<sample> in = random_samples(buffer_size);
+    std::vector<boost::int16_t> x(buffer_size);
+    for (std::size_t i = 0; i < buffer_size; ++i)
+      x[i] = in[i].count();
+    std::vector<boost::int32_t> v(buffer_size);
+    std::vector<boost::int32_t> z(4 * sections);
+    std::vector<boost::int16_t> y(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        v[i] = boost::int32_t(x[i]) << 13;
+      for (std::size_t s = 0; s < sections; ++s)
+      {
+        const boost::int32_t* h = &k[5 * s];
+        boost::int32_t x1 = z[4 * s], x2 = z[4 * s + 1], y1 = z[4 * s + 2], y2 = z[4 * s + 3];
+        for (std::size_t i = 0; i < buffer_size; ++i)
+        {
+          boost::int64_t acc = boost::int64_t(h[0]) * v[i] + boost::int64_t(h[1]) * x1 + boost::int64_t(h[2]) * x2
+              - boost::int64_t(h[3]) * y1 - boost::int64_t(h[4]) * y2;
+          boost::int32_t out = boost::int32_t(round_saturate(acc, 30, 0x7FFFFFFF));
+          x2 = x1;
+          x1 = v[i];
+          y2 = y1;
+          y1 = out;
+          v[i] = out;
+        }
+        z[4 * s] = x1;
+        z[4 * s + 1] = x2;
+        z[4 * s + 2] = y1;
+        z[4 * s + 3] = y2;
+      }
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        y[i] = boost::int16_t(round_saturate(v[i], 13, 32767));
+      benchmark::DoNotOptimize(y.data());
+      benchmark::ClobberMemory();
+    }
+    set_counters(state, sections);
+  }
+
+  void double_variant(benchmark::State& state)
+  {
+    std::size_t sections = state.range(0);
+    std::vector<biquad_coefficients<coefficient> > c = low_pass(sections);
+    std::vector<double> k;
+    for (std::size_t s = 0; s < sections; ++s)
+    {
+      k.push_back(c[s].b0.as_double());
+      k.push_back(c[s].b1.as_double());
+      k.push_back(c[s].b2.as_double());
+      k.push_back(c[s].a1.as_double());
+      k.push_back(c[s].a2.as_double());
+    }
+    std::vector<sample> in = random_samples(buffer_size);
+    std::vector<double> x(buffer_size);
+    for (std::size_t i = 0; i < buffer_size; ++i)
+      x[i] = in[i].as_double();
+    std::vector<double> v(buffer_size);
+    std::vector<double> z(4 * sections);
+    for (auto _ : state)
+    {
+      v = x;
+      for (std::size_t s = 0; s < sections; ++s)
+      {
+        const double* h = &k[5 * s];
+        double x1 = z[4 * s], x2 = z[4 * s + 1], y1 = z[4 * s + 2], y2 = z[4 * s + 3];
+        for (std::size_t i = 0; i < buffer_size; ++i)
+        {
+          double out = h[0] * v[i] + h[1] * x1 + h[2] * x2 - h[3] * y1 - h[4] * y2;
+          x2 = x1;
+          x1 = v[i];
+          y2 = y1;
+          y1 = out;
+          v[i] = out;
+        }
+        z[4 * s] = x1;
+        z[4 * s + 1] = x2;
+        z[4 * s + 2] = y1;
+        z[4 * s + 3] = y2;
+      }
+      benchmark::DoNotOptimize(v.data());
+      benchmark::ClobberMemory();
+    }
+    set_counters(state, sections);
+  }
+
+  template <typename Form>
+  void cascade_variant(benchmark::State& state)
+  {
+    std::size_t sections = state.range(0);
+    std::vector<biquad_coefficients<coefficient> > c = low_pass(sections);
+    std::vector<sample> x = random_samples(buffer_size);
+    std::vector<sample> y(buffer_size, sample(index(0)));
+    biquad_cascade<sample, coefficient, state_type, Form> f(&c[0], sections);
+    for (auto _ : state)
+    {
+      f.process(&x[0], &y[0], buffer_size);
+      benchmark::DoNotOptimize(y.data());
+      benchmark::ClobberMemory();
+    }
+    set_counters(state, sections);
+  }
+
+  int register_benchmarks()
+  {
+    const int sections[] = { 1, 4 };
+    for (int i = 0; i < 2; ++i)
+    {
+      benchmark::RegisterBenchmark("biquad/baseline", baseline)->Arg(sections[i]);
+      benchmark::RegisterBenchmark("biquad/double", double_variant)->Arg(sections[i]);
+      benchmark::RegisterBenchmark("biquad/df1", cascade_variant<iir::direct_form_1<> >)->Arg(sections[i]);
+      benchmark::RegisterBenchmark("biquad/df1_error_feedback", cascade_variant<iir::direct_form_1<2> >)
+          ->Arg(sections[i]);
+      benchmark::RegisterBenchmark("biquad/tdf2", cascade_variant<iir::transposed_direct_form_2>)->Arg(sections[i]);
+    }
+    return 0;
+  }
+
+  const int registered = register_benchmarks();
+}
+
+BOOST_FIXED_POINT_PERF_MAIN()
@@ -0,0 +1,108 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Measures the element wise sums and products of two arrays of 4096 numbers. Besides the numbers per second, the
+// counter bytes_per_element reports the memory footprint of the arrays.
+//
+// Groups:
+// - add: the sums.
+// - multiply: the products.
+//
+// Variants:
+// - baseline: float arrays.
+// - block64: arrays of block_real_t<64>, 64 mantissas of 15 digits on int16 sharing an exponent, with batch::add
+//   and batch::multiply.
+// - block256: the same with blocks of 256 mantissas.
+
+#include <boost/fixed_point/block.hpp>
+#include "perf_harness.hpp"
+#include <boost/cstdint.hpp>
+#include <cmath>
+#include <vector>
+
+using namespace boost::fixed_point;
+using boost::fixed_point::perf::random_indices;
+
+namespace
+{
+  const std::size_t buffer_size = 4096;
+
+  // Numbers of absolute value below 2^e, with e in [-8, 8) for each chunk of 64 numbers.
+  std::vector<double> random_numbers(unsigned long long seed)
+  {
+    std::vector<boost::int64_t> m = random_indices<boost::int64_t>(buffer_size, -32767, 32767, seed);
+    std::vector<boost::int64_t> e = random_indices<boost::int64_t>(buffer_size / 64, -8, 7, seed + 1);
+    std::vector<double> res;
+    for (std::size_t i = 0; i < buffer_size; ++i)
+      res.push_back(std::ldexp(double(m[i]), int(e[i / 64]) - 15));
+    return res;
+  }
+
+  template <typename Block>
+  std::vector<Block> random_blocks(unsigned long long seed)
+  {
+    typedef real_t<16, -40> source_type;
+    std::vector<double> xs = random_numbers(seed);
+    std::vector<source_type> ys;
+    for (std::size_t i = 0; i < buffer_size; ++i)
+      ys.push_back(source_type(xs[i]));
+    std::vector<Block> res(buffer_size / Block::size(), Block(0));
+    for (std::size_t i = 0; i < res.size(); ++i)
+      batch::number_cast(&ys[i * Block::size()], res[i]);
+    return res;
+  }
+
+  void set_counters(benchmark::State& state, double bytes_per_element)
+  {
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+    state.counters["bytes_per_element"] = bytes_per_element;
+  }
+
+  template <bool Multiply>
+  void baseline(benchmark::State& state)
+  {
+    std::vector<double> xs = random_numbers(1), ys = random_numbers(3);
+    std::vector<float> a(xs.begin(), xs.end()), b(ys.begin(), ys.end()), c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = Multiply ? a[i] * b[i] : a[i] + b[i];
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    set_counters(state, sizeof(float));
+  }
+
+  template <typename Block, bool Multiply>
+  void block_variant(benchmark::State& state)
+  {
+    std::vector<Block> a = random_blocks<Block>(1), b = random_blocks<Block>(3), c(a.size(), Block(0));
+    for (auto _ : state)
+    {
+      if (Multiply)
+        batch::multiply(&a[0], &b[0], &c[0], a.size());
+      else
+        batch::add(&a[0], &b[0], &c[0], a.size());
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    set_counters(state, double(sizeof(Block)) / Block::size());
+  }
+
+  int register_benchmarks()
+  {
+    benchmark::RegisterBenchmark("add/baseline", baseline<false>);
+    benchmark::RegisterBenchmark("add/block64", block_variant<block_real_t<64>, false>);
+    benchmark::RegisterBenchmark("add/block256", block_variant<block_real_t<256>, false>);
+    benchmark::RegisterBenchmark("multiply/baseline", baseline<true>);
+    benchmark::RegisterBenchmark("multiply/block64", block_variant<block_real_t<64>, true>);
+    benchmark::RegisterBenchmark("multiply/block256", block_variant<block_real_t<256>, true>);
+    return 0;
+  }
+
+  const int registered = register_benchmarks();
+}
+
+BOOST_FIXED_POINT_PERF_MAIN()
@@ -0,0 +1,177 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Measures the exact products of 4096 pairs of complex numbers, with Q15 parts, real_t<0,-15>, whose products are
+// stored on 32 bits, and with Q31 parts, real_t<0,-31>, whose products are stored on 64 bits.
+//
+// Groups:
+// - multiply_q15: the products of Q15 complex numbers.
+// - multiply_q31: the products of Q31 complex numbers.
+// - norm_q15: the magnitudes squared of Q15 complex numbers.
+//
+// Variants:
+// - baseline: the hand written loop on the integers of the parts, stored in two arrays.
+// - batch: batch::complex_multiply or batch::norm, on two arrays.
+// - gauss: batch::complex_multiply_gauss, 3 multiplications on integers one bit wider.
+// - operator: complex<T> operator* on an array of complex numbers.
+
+#include <boost/fixed_point/complex.hpp>
+#include "perf_harness.hpp"
+#include <boost/cstdint.hpp>
+#include <vector>
+
+using namespace boost::fixed_point;
+using boost::fixed_point::perf::random_indices;
+
+namespace
+{
+  const std::size_t buffer_size = 4096;
+
+  typedef real_t<0, -15> q15;
+  typedef real_t<0, -31> q31;
+
+  template <typename T>
+  std::vector<T> random_numbers(std::size_t n, unsigned long long seed)
+  {
+    std::vector<boost::int64_t> idx = random_indices<boost::int64_t>(n, T::min_index, T::max_index, seed);
+    std::vector<T> res;
+    for (std::size_t i = 0; i < n; ++i)
+      res.push_back(T(index(typename T::underlying_type(idx[i]))));
+    return res;
+  }
+
+  // The parts of a random array of complex numbers.
+  template <typename T>
+  struct parts
+  {
+    std::vector<T> re, im;
+    explicit parts(unsigned long long seed) :
+      re(random_numbers<T>(buffer_size, seed)), im(random_numbers<T>(buffer_size, seed + 1))
+    {
+    }
+  };
+
+  template <typename T, typename I, typename W>
+  void multiply_baseline(benchmark::State& state)
+  {
+    parts<T> a(1), b(3);
+    std::vector<I> ar(buffer_size), ai(buffer_size), br(buffer_size), bi(buffer_size);
+    for (std::size_t i = 0; i < buffer_size; ++i)
+    {
+      ar[i] = a.re[i].count();
+      ai[i] = a.im[i].count();
+      br[i] = b.re[i].count();
+      bi[i] = b.im[i].count();
+    }
+    std::vector<W> cr(buffer_size), ci(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+      {
+        cr[i] = W(ar[i]) * br[i] - W(ai[i]) * bi[i];
+        ci[i] = W(ar[i]) * bi[i] + W(ai[i]) * br[i];
+      }
+      benchmark::DoNotOptimize(cr.data());
+      benchmark::DoNotOptimize(ci.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  template <typename T, bool Gauss>
+  void multiply_batch(benchmark::State& state)
+  {
+    typedef typename multiply_result<complex<T> >::type::value_type part_type;
+    parts<T> a(1), b(3);
+    std::vector<part_type> cr(buffer_size, part_type(index(0))), ci(buffer_size, part_type(index(0)));
+    for (auto _ : state)
+    {
+      if (Gauss)
+        batch::complex_multiply_gauss(&a.re[0], &a.im[0], &b.re[0], &b.im[0], &cr[0], &ci[0], buffer_size);
+      else
+        batch::complex_multiply(&a.re[0], &a.im[0], &b.re[0], &b.im[0], &cr[0], &ci[0], buffer_size);
+      benchmark::DoNotOptimize(cr.data());
+      benchmark::DoNotOptimize(ci.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  template <typename T>
+  void multiply_operator(benchmark::State& state)
+  {
+    typedef typename multiply_result<complex<T> >::type result_type;
+    typedef typename result_type::value_type part_type;
+    parts<T> pa(1), pb(3);
+    std::vector<complex<T> > a, b;
+    for (std::size_t i = 0; i < buffer_size; ++i)
+    {
+      a.push_back(complex<T>(pa.re[i], pa.im[i]));
+      b.push_back(complex<T>(pb.re[i], pb.im[i]));
+    }
+    std::vector<result_type> c(buffer_size, result_type(part_type(index(0))));
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = a[i] * b[i];
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  void norm_baseline(benchmark::State& state)
+  {
+    parts<q15> a(1);
+    std::vector<boost::int16_t> re(buffer_size), im(buffer_size);
+    for (std::size_t i = 0; i < buffer_size; ++i)
+    {
+      re[i] = a.re[i].count();
+      im[i] = a.im[i].count();
+    }
+    std::vector<boost::int32_t> res(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        res[i] = boost::int32_t(re[i]) * re[i] + boost::int32_t(im[i]) * im[i];
+      benchmark::DoNotOptimize(res.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  void norm_batch(benchmark::State& state)
+  {
+    typedef norm_result<q15>::type result_type;
+    parts<q15> a(1);
+    std::vector<result_type> res(buffer_size, result_type(index(0)));
+    for (auto _ : state)
+    {
+      batch::norm(&a.re[0], &a.im[0], &res[0], buffer_size);
+      benchmark::DoNotOptimize(res.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  int register_benchmarks()
+  {
+    benchmark::RegisterBenchmark("multiply_q15/baseline", multiply_baseline<q15, boost::int16_t, boost::int32_t>);
+    benchmark::RegisterBenchmark("multiply_q15/batch", multiply_batch<q15, false>);
+    benchmark::RegisterBenchmark("multiply_q15/gauss", multiply_batch<q15, true>);
+    benchmark::RegisterBenchmark("multiply_q15/operator", multiply_operator<q15>);
+    benchmark::RegisterBenchmark("multiply_q31/baseline", multiply_baseline<q31, boost::int32_t, boost::int64_t>);
+    benchmark::RegisterBenchmark("multiply_q31/batch", multiply_batch<q31, false>);
+    benchmark::RegisterBenchmark("multiply_q31/gauss", multiply_batch<q31, true>);
+    benchmark::RegisterBenchmark("multiply_q31/operator", multiply_operator<q31>);
+    benchmark::RegisterBenchmark("norm_q15/baseline", norm_baseline);
+    benchmark::RegisterBenchmark("norm_q15/batch", norm_batch);
+    return 0;
+  }
+
+  const int registered = register_benchmarks();
+}
+
+BOOST_FIXED_POINT_PERF_MAIN()
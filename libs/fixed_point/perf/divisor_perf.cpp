@@ -0,0 +1,94 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Measures the division of a buffer of Q15.16 values by the same Q15.16 scale factor.
+//
+// Variants:
+// - baseline: divide<Res>(a[i], scale), which does an integer division per element.
+// - divisor: divide<Res>(a[i], divisor<Q15.16>(scale)), which does a multiplication per element.
+
+#include <boost/fixed_point/divisor.hpp>
+#include "perf_harness.hpp"
+#include <boost/cstdint.hpp>
+#include <vector>
+
+using namespace boost::fixed_point;
+using boost::fixed_point::perf::random_indices;
+
+namespace
+{
+  const std::size_t buffer_size = 1024;
+
+  // Indices of Q15.16 values in ]-128, 128[.
+  const long long small_index = (1LL << 23) - 1;
+
+  template <typename RP>
+  struct q15_16
+  {
+    typedef real_t<15, -16, RP, overflow::undefined> type;
+  };
+
+  template <typename T>
+  std::vector<T> random_fxp()
+  {
+    std::vector<boost::int32_t> idx = random_indices<boost::int32_t>(buffer_size, -small_index, small_index, 1);
+    std::vector<T> res;
+    res.reserve(buffer_size);
+    for (std::size_t i = 0; i < buffer_size; ++i)
+      res.push_back(T(index(idx[i])));
+    return res;
+  }
+
+  // 3.14159 in Q15.16
+  const boost::int32_t scale_index = 205887;
+
+  template <typename RP>
+  void divide_baseline(benchmark::State& state)
+  {
+    typedef typename q15_16<RP>::type T;
+    std::vector<T> a = random_fxp<T>();
+    T scale = T(index(scale_index));
+    std::vector<T> c(buffer_size);
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(scale);
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = divide<T>(a[i], scale);
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  template <typename RP>
+  void divide_divisor(benchmark::State& state)
+  {
+    typedef typename q15_16<RP>::type T;
+    std::vector<T> a = random_fxp<T>();
+    T scale = T(index(scale_index));
+    std::vector<T> c(buffer_size);
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(scale);
+      divisor<T> d(scale);
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = divide<T>(a[i], d);
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+#define BOOST_FIXED_POINT_PERF_DIVISOR(RP) \
+  BENCHMARK_TEMPLATE(divide_baseline, round::RP)->Name("divide." #RP "/baseline"); \
+  BENCHMARK_TEMPLATE(divide_divisor, round::RP)->Name("divide." #RP "/divisor")
+
+  BOOST_FIXED_POINT_PERF_DIVISOR(negative);
+  BOOST_FIXED_POINT_PERF_DIVISOR(truncated);
+  BOOST_FIXED_POINT_PERF_DIVISOR(positive);
+  BOOST_FIXED_POINT_PERF_DIVISOR(nearest_even);
+}
+
+BOOST_FIXED_POINT_PERF_MAIN()
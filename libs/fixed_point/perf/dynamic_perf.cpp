@@ -0,0 +1,170 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Measures the conversions of 4096 indexes between formats chosen at run time and real_t.
+//
+// Groups:
+// - same_format: int16 indexes of format (0,-15) to real_t<0,-15>, a copy of the indexes.
+// - narrow: int32 indexes of format (0,-31) to real_t<0,-15>, rounded to nearest even and saturated.
+// - widen: real_t<0,-15> to int32 indexes of format (4,-20), exact.
+//
+// Variants:
+// - baseline: batch::number_cast between the real_t of the same formats, as selected by a switch on the format.
+// - batch: batch::from_dynamic or batch::to_dynamic.
+// - scalar: number_cast of a dynamic_real_t, or the dynamic_real_t constructor, for each index.
+
+#include <boost/fixed_point/dynamic.hpp>
+#include <boost/fixed_point/batch.hpp>
+#include "perf_harness.hpp"
+#include <boost/cstdint.hpp>
+#include <vector>
+
+using namespace boost::fixed_point;
+using boost::fixed_point::perf::random_indices;
+
+namespace
+{
+  const std::size_t buffer_size = 4096;
+
+  typedef real_t<0, -15, round::nearest_even, overflow::saturate> q15;
+  typedef real_t<0, -31, round::nearest_even, overflow::saturate> q31;
+  typedef real_t<4, -20, round::nearest_even, overflow::saturate> q4_20;
+  typedef dynamic_real_t<round::nearest_even, overflow::saturate> dynamic_type;
+
+  template <typename T>
+  std::vector<T> random_numbers(std::size_t n, unsigned long long seed)
+  {
+    std::vector<boost::int64_t> idx = random_indices<boost::int64_t>(n, T::min_index, T::max_index, seed);
+    std::vector<T> res;
+    for (std::size_t i = 0; i < n; ++i)
+      res.push_back(T(index(typename T::underlying_type(idx[i]))));
+    return res;
+  }
+
+  template <typename From, typename I>
+  std::vector<I> random_counts(unsigned long long seed)
+  {
+    std::vector<From> xs = random_numbers<From>(buffer_size, seed);
+    std::vector<I> res;
+    for (std::size_t i = 0; i < buffer_size; ++i)
+      res.push_back(I(xs[i].count()));
+    return res;
+  }
+
+  void set_counters(benchmark::State& state)
+  {
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  // The numbers of the format of the indexes are reinterpreted, and converted by the static conversion.
+  template <typename From, typename To, typename I>
+  void from_baseline(benchmark::State& state)
+  {
+    std::vector<I> counts = random_counts<From, I>(1);
+    std::vector<To> res(buffer_size, To(index(0)));
+    for (auto _ : state)
+    {
+      batch::number_cast(reinterpret_cast<From const*>(&counts[0]), &res[0], buffer_size);
+      benchmark::DoNotOptimize(res.data());
+      benchmark::ClobberMemory();
+    }
+    set_counters(state);
+  }
+
+  template <typename From, typename To, typename I>
+  void from_batch(benchmark::State& state)
+  {
+    std::vector<I> counts = random_counts<From, I>(1);
+    std::vector<To> res(buffer_size, To(index(0)));
+    format f = format_of<From>();
+    benchmark::DoNotOptimize(f);
+    for (auto _ : state)
+    {
+      batch::from_dynamic(&counts[0], f, &res[0], buffer_size);
+      benchmark::DoNotOptimize(res.data());
+      benchmark::ClobberMemory();
+    }
+    set_counters(state);
+  }
+
+  template <typename From, typename To, typename I>
+  void from_scalar(benchmark::State& state)
+  {
+    std::vector<I> counts = random_counts<From, I>(1);
+    std::vector<To> res(buffer_size, To(index(0)));
+    format f = format_of<From>();
+    benchmark::DoNotOptimize(f);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        res[i] = number_cast<To>(dynamic_type(index(counts[i]), f));
+      benchmark::DoNotOptimize(res.data());
+      benchmark::ClobberMemory();
+    }
+    set_counters(state);
+  }
+
+  void widen_baseline(benchmark::State& state)
+  {
+    std::vector<q15> xs = random_numbers<q15>(buffer_size, 1);
+    std::vector<q4_20> res(buffer_size, q4_20(index(0)));
+    for (auto _ : state)
+    {
+      batch::number_cast(&xs[0], &res[0], buffer_size);
+      benchmark::DoNotOptimize(res.data());
+      benchmark::ClobberMemory();
+    }
+    set_counters(state);
+  }
+
+  void widen_batch(benchmark::State& state)
+  {
+    std::vector<q15> xs = random_numbers<q15>(buffer_size, 1);
+    std::vector<boost::int32_t> res(buffer_size);
+    format f = format_of<q4_20>();
+    benchmark::DoNotOptimize(f);
+    for (auto _ : state)
+    {
+      batch::to_dynamic<dynamic_type>(&xs[0], f, &res[0], buffer_size);
+      benchmark::DoNotOptimize(res.data());
+      benchmark::ClobberMemory();
+    }
+    set_counters(state);
+  }
+
+  void widen_scalar(benchmark::State& state)
+  {
+    std::vector<q15> xs = random_numbers<q15>(buffer_size, 1);
+    std::vector<boost::int32_t> res(buffer_size);
+    format f = format_of<q4_20>();
+    benchmark::DoNotOptimize(f);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        res[i] = boost::int32_t(dynamic_type(xs[i], f).count());
+      benchmark::DoNotOptimize(res.data());
+      benchmark::ClobberMemory();
+    }
+    set_counters(state);
+  }
+
+  int register_benchmarks()
+  {
+    benchmark::RegisterBenchmark("same_format/baseline", from_baseline<q15, q15, boost::int16_t>);
+    benchmark::RegisterBenchmark("same_format/batch", from_batch<q15, q15, boost::int16_t>);
+    benchmark::RegisterBenchmark("same_format/scalar", from_scalar<q15, q15, boost::int16_t>);
+    benchmark::RegisterBenchmark("narrow/baseline", from_baseline<q31, q15, boost::int32_t>);
+    benchmark::RegisterBenchmark("narrow/batch", from_batch<q31, q15, boost::int32_t>);
+    benchmark::RegisterBenchmark("narrow/scalar", from_scalar<q31, q15, boost::int32_t>);
+    benchmark::RegisterBenchmark("widen/baseline", widen_baseline);
+    benchmark::RegisterBenchmark("widen/batch", widen_batch);
+    benchmark::RegisterBenchmark("widen/scalar", widen_scalar);
+    return 0;
+  }
+
+  const int registered = register_benchmarks();
+}
+
+BOOST_FIXED_POINT_PERF_MAIN()
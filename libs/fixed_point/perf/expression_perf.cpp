@@ -0,0 +1,103 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Measures the alpha blending of 1024 8 bit colour channels, c = r1 * a1 + r2 * a2 * (1 - a1), with the channels
+// ureal_t<8, 0> and the alphas ureal_t<0, -8>, rounded to nearest to ureal_t<8, 0>.
+//
+// Variants:
+// - baseline: the hand written integer expression and rounding shift.
+// - operators: number_cast of the expression built by the operators, an intermediate number for each of them.
+// - expression: number_cast of the expression tree built once the first channel is wrapped with lazy().
+
+#include <boost/fixed_point/expression.hpp>
+#include "perf_harness.hpp"
+#include <boost/cstdint.hpp>
+#include <vector>
+
+using namespace boost::fixed_point;
+using boost::fixed_point::perf::random_indices;
+
+namespace
+{
+  const std::size_t buffer_size = 1024;
+
+  typedef ureal_t<8, 0> channel;
+  typedef ureal_t<0, -8> alpha;
+  typedef ureal_t<8, 0, round::nearest_half_up> result;
+
+  template <typename T>
+  std::vector<T> random_numbers(unsigned long long seed)
+  {
+    std::vector<boost::uint8_t> idx = random_indices<boost::uint8_t>(buffer_size, 0, 255, seed);
+    std::vector<T> res;
+    for (std::size_t i = 0; i < buffer_size; ++i)
+      res.push_back(T(index(idx[i])));
+    return res;
+  }
+
+  struct inputs
+  {
+    std::vector<channel> r1, r2;
+    std::vector<alpha> a1, a2;
+    inputs() :
+      r1(random_numbers<channel>(1)), r2(random_numbers<channel>(2)), a1(random_numbers<alpha>(3)),
+          a2(random_numbers<alpha>(4))
+    {
+    }
+  };
+
+  void blend_baseline(benchmark::State& state)
+  {
+    inputs in;
+    std::vector<result> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+      {
+        boost::int32_t v = (boost::int32_t(in.r1[i].count()) * in.a1[i].count() << 8)
+            + boost::int32_t(in.r2[i].count()) * in.a2[i].count() * (256 - in.a1[i].count());
+        c[i] = result(index(boost::uint8_t((v + (1 << 15)) >> 16)));
+      }
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  void blend_operators(benchmark::State& state)
+  {
+    inputs in;
+    std::vector<result> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = number_cast<result>(in.r1[i] * in.a1[i] + in.r2[i] * in.a2[i] * (to_ureal_t<1, 0>() - in.a1[i]));
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  void blend_expression(benchmark::State& state)
+  {
+    inputs in;
+    std::vector<result> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = number_cast<result>(lazy(in.r1[i]) * in.a1[i] + in.r2[i] * in.a2[i]
+            * (to_ureal_t<1, 0>() - in.a1[i]));
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  const int blend_group = (benchmark::RegisterBenchmark("blend/baseline", blend_baseline),
+      benchmark::RegisterBenchmark("blend/operators", blend_operators),
+      benchmark::RegisterBenchmark("blend/expression", blend_expression), 0);
+}
+
+BOOST_FIXED_POINT_PERF_MAIN()
@@ -0,0 +1,176 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Measures the forward transforms of 256, 1024, 4096 and 16384 complex numbers, with the real and imaginary parts in
+// two arrays, copied from the inputs before each transform. Besides the transforms per second, the counter
+// butterflies reports the radix-2 butterflies per second, n/2 * log2(n) per transform.
+//
+// Variants:
+// - baseline: the same radix-2 decimation in frequency on float, with the twiddles of each stage contiguous.
+// - q15_unconditional: fft<real_t<0,-15>, fft_scaling::unconditional>, rounded to nearest even and saturated.
+// - q15_block_floating: fft<real_t<0,-15>, fft_scaling::block_floating>.
+// - q31_block_floating: fft<real_t<0,-31>, fft_scaling::block_floating>.
+
+#include <boost/fixed_point/fft.hpp>
+#include "perf_harness.hpp"
+#include <boost/cstdint.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace boost::fixed_point;
+using boost::fixed_point::perf::random_indices;
+
+namespace
+{
+  typedef real_t<0, -15, round::nearest_even, overflow::saturate> q15;
+  typedef real_t<0, -31, round::nearest_even, overflow::saturate> q31;
+
+  // n numbers of absolute value below 0.7.
+  template <typename T>
+  std::vector<T> random_numbers(std::size_t n, unsigned long long seed)
+  {
+    boost::int64_t m = boost::int64_t(0.7 * T::max_index);
+    std::vector<boost::int64_t> idx = random_indices<boost::int64_t>(n, -m, m, seed);
+    std::vector<T> res;
+    for (std::size_t i = 0; i < n; ++i)
+      res.push_back(T(index(idx[i])));
+    return res;
+  }
+
+  void set_counters(benchmark::State& state, std::size_t n)
+  {
+    int log2n = 0;
+    while ((std::size_t(1) << log2n) < n)
+      ++log2n;
+    state.SetItemsProcessed(state.iterations());
+    state.counters["butterflies"] = benchmark::Counter(double(state.iterations()) * n / 2 * log2n,
+        benchmark::Counter::kIsRate);
+  }
+
+  // The radix-2 decimation in frequency on float.
+  class float_fft
+  {
+  public:
+    explicit float_fft(std::size_t n) :
+      n_(n), wr_(n - 1), wi_(n - 1)
+    {
+      for (std::size_t h = 1; h < n; h <<= 1)
+        for (std::size_t k = 0; k < h; ++k)
+        {
+          wr_[h - 1 + k] = float(std::cos(3.14159265358979323846 * k / h));
+          wi_[h - 1 + k] = float(-std::sin(3.14159265358979323846 * k / h));
+        }
+      int log2n = 0;
+      while ((std::size_t(1) << log2n) < n)
+        ++log2n;
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        std::size_t r = 0;
+        for (int b = 0; b < log2n; ++b)
+          r |= ((i >> b) & 1) << (log2n - 1 - b);
+        if (i < r)
+        {
+          swaps_.push_back(i);
+          swaps_.push_back(r);
+        }
+      }
+    }
+
+    void forward(float* re, float* im) const
+    {
+      for (std::size_t h = n_ / 2; h > 0; h >>= 1)
+      {
+        const float* wr = &wr_[h - 1];
+        const float* wi = &wi_[h - 1];
+        for (std::size_t j = 0; j < n_; j += 2 * h)
+          for (std::size_t k = 0; k < h; ++k)
+          {
+            float xr = re[j + k], xi = im[j + k], yr = re[j + k + h], yi = im[j + k + h];
+            float dr = xr - yr, di = xi - yi;
+            re[j + k] = xr + yr;
+            im[j + k] = xi + yi;
+            re[j + k + h] = dr * wr[k] - di * wi[k];
+            im[j + k + h] = dr * wi[k] + di * wr[k];
+          }
+      }
+      for (std::size_t i = 0; i < swaps_.size(); i += 2)
+      {
+        std::swap(re[swaps_[i]], re[swaps_[i + 1]]);
+        std::swap(im[swaps_[i]], im[swaps_[i + 1]]);
+      }
+    }
+
+  private:
+    std::size_t n_;
+    std::vector<float> wr_, wi_;
+    std::vector<std::size_t> swaps_;
+  };
+
+  void baseline(benchmark::State& state)
+  {
+    std::size_t n = state.range(0);
+    std::vector<q15> xr = random_numbers<q15>(n, 1), xi = random_numbers<q15>(n, 2);
+    std::vector<float> ir(n), ii(n), re(n), im(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      ir[i] = float(xr[i].as_double());
+      ii[i] = float(xi[i].as_double());
+    }
+    float_fft f(n);
+    for (auto _ : state)
+    {
+      std::copy(ir.begin(), ir.end(), re.begin());
+      std::copy(ii.begin(), ii.end(), im.begin());
+      f.forward(&re[0], &im[0]);
+      benchmark::DoNotOptimize(re.data());
+      benchmark::DoNotOptimize(im.data());
+      benchmark::ClobberMemory();
+    }
+    set_counters(state, n);
+  }
+
+  template <typename T, typename Scaling>
+  void fixed_variant(benchmark::State& state)
+  {
+    std::size_t n = state.range(0);
+    std::vector<T> ir = random_numbers<T>(n, 1), ii = random_numbers<T>(n, 2);
+    std::vector<T> re(n, T(index(0))), im(n, T(index(0)));
+    fft<T, Scaling> f(n);
+    int e = 0;
+    for (auto _ : state)
+    {
+      std::copy(ir.begin(), ir.end(), re.begin());
+      std::copy(ii.begin(), ii.end(), im.begin());
+      e = f.forward(&re[0], &im[0]);
+      benchmark::DoNotOptimize(e);
+      benchmark::DoNotOptimize(re.data());
+      benchmark::DoNotOptimize(im.data());
+      benchmark::ClobberMemory();
+    }
+    set_counters(state, n);
+    state.counters["exponent"] = e;
+  }
+
+  int register_benchmarks()
+  {
+    const int sizes[] = { 256, 1024, 4096, 16384 };
+    for (int i = 0; i < 4; ++i)
+    {
+      benchmark::RegisterBenchmark("fft/baseline", baseline)->Arg(sizes[i]);
+      benchmark::RegisterBenchmark("fft/q15_unconditional", fixed_variant<q15, fft_scaling::unconditional>)
+          ->Arg(sizes[i]);
+      benchmark::RegisterBenchmark("fft/q15_block_floating", fixed_variant<q15, fft_scaling::block_floating>)
+          ->Arg(sizes[i]);
+      benchmark::RegisterBenchmark("fft/q31_block_floating", fixed_variant<q31, fft_scaling::block_floating>)
+          ->Arg(sizes[i]);
+    }
+    return 0;
+  }
+
+  const int registered = register_benchmarks();
+}
+
+BOOST_FIXED_POINT_PERF_MAIN()
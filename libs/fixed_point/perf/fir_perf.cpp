@@ -0,0 +1,230 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Measures the FIR filters of 4096 int16 samples, real_t<15,0>, with Q15 coefficients, real_t<0,-15>, and 16, 64 or
+// 256 taps. Besides the samples per second, the counter sample_taps reports the samples per second times the number of
+// taps, the multiply-accumulates per second.
+//
+// Groups:
+// - fir: the filter, the outputs rounded to nearest even and saturated.
+// - decimate: the filter followed by a decimation by 4, per input sample.
+// - interpolate: an interpolation by 4 followed by the filter, per output sample.
+//
+// Variants:
+// - baseline: the hand written loop on int16_t and int64_t, the direct form computing only the kept outputs of the
+//   decimation, and the filter of the input with zeros inserted for the interpolation.
+// - scalar: the filters without the SIMD kernels.
+// - simd: the filters with the most capable SIMD kernels supported.
+
+#include <boost/fixed_point/fir.hpp>
+#include "perf_harness.hpp"
+#include <boost/cstdint.hpp>
+#include <vector>
+
+using namespace boost::fixed_point;
+using boost::fixed_point::perf::random_indices;
+
+namespace
+{
+  const std::size_t buffer_size = 4096;
+  const std::size_t factor = 4;
+
+  typedef real_t<15, 0> sample;
+  typedef real_t<0, -15> coefficient;
+  typedef real_t<15, 0, round::nearest_even, overflow::saturate> result;
+
+  template <typename T>
+  std::vector<T> random_numbers(std::size_t n, unsigned long long seed)
+  {
+    std::vector<boost::int16_t> idx = random_indices<boost::int16_t>(n, -32767, 32767, seed);
+    std::vector<T> res;
+    for (std::size_t i = 0; i < n; ++i)
+      res.push_back(T(index(idx[i])));
+    return res;
+  }
+
+  // Restricts the SIMD kernels to the instruction set of the variant during a benchmark.
+  struct scoped_level
+  {
+    simd::level prev;
+    explicit scoped_level(bool simd) :
+      prev(simd::restrict_to(simd ? simd::supported() : simd::none))
+    {
+    }
+    ~scoped_level()
+    {
+      simd::restrict_to(prev);
+    }
+  };
+
+  void set_counters(benchmark::State& state, std::size_t samples, std::size_t taps)
+  {
+    state.SetItemsProcessed(state.iterations() * samples);
+    state.counters["sample_taps"] = benchmark::Counter(double(state.iterations()) * samples * taps,
+        benchmark::Counter::kIsRate);
+  }
+
+  /**
+   * The hand written filter: @c line holds taps - 1 zeros followed by the n samples, and @c hr the coefficients in
+   * reverse order, so that y[i] = sum of line[i + k] * hr[k], rounded to nearest even and saturated.
+   */
+  void filter_baseline(const boost::int16_t* line, const boost::int16_t* hr, std::size_t taps, boost::int16_t* y,
+      std::size_t n, std::size_t step)
+  {
+    for (std::size_t i = 0; i < n; i += step)
+    {
+      boost::int64_t acc = 0;
+      for (std::size_t k = 0; k < taps; ++k)
+        acc += boost::int32_t(line[i + k]) * hr[k];
+      boost::int64_t q = acc >> 15;
+      boost::int64_t r = acc & 0x7FFF;
+      q += (r > 0x4000 || (r == 0x4000 && (q & 1))) ? 1 : 0;
+      y[i / step] = boost::int16_t(q > 32767 ? 32767 : q < -32767 ? -32767 : q);
+    }
+  }
+
+  // taps - 1 zeros followed by n random samples.
+  std::vector<boost::int16_t> baseline_line(std::size_t taps, std::size_t n)
+  {
+    std::vector<boost::int16_t> x = random_indices<boost::int16_t>(n, -32767, 32767, 1);
+    x.insert(x.begin(), taps - 1, boost::int16_t(0));
+    return x;
+  }
+
+  void fir_baseline(benchmark::State& state)
+  {
+    std::size_t taps = state.range(0);
+    std::vector<boost::int16_t> x = baseline_line(taps, buffer_size);
+    std::vector<boost::int16_t> h = random_indices<boost::int16_t>(taps, -32767, 32767, 2);
+    std::vector<boost::int16_t> y(buffer_size);
+    for (auto _ : state)
+    {
+      filter_baseline(&x[0], &h[0], taps, &y[0], buffer_size, 1);
+      benchmark::DoNotOptimize(y.data());
+      benchmark::ClobberMemory();
+    }
+    set_counters(state, buffer_size, taps);
+  }
+
+  template <bool Simd>
+  void fir_filter_variant(benchmark::State& state)
+  {
+    scoped_level level(Simd);
+    std::size_t taps = state.range(0);
+    std::vector<sample> x = random_numbers<sample>(buffer_size, 1);
+    std::vector<coefficient> h = random_numbers<coefficient>(taps, 2);
+    std::vector<result> y(buffer_size, result(index(0)));
+    fir_filter<sample, coefficient, result> f(&h[0], taps);
+    for (auto _ : state)
+    {
+      f.process(&x[0], &y[0], buffer_size);
+      benchmark::DoNotOptimize(y.data());
+      benchmark::ClobberMemory();
+    }
+    set_counters(state, buffer_size, taps);
+  }
+
+  void decimate_baseline(benchmark::State& state)
+  {
+    std::size_t taps = state.range(0);
+    std::vector<boost::int16_t> x = baseline_line(taps, buffer_size);
+    std::vector<boost::int16_t> h = random_indices<boost::int16_t>(taps, -32767, 32767, 2);
+    std::vector<boost::int16_t> y(buffer_size / factor);
+    for (auto _ : state)
+    {
+      filter_baseline(&x[0], &h[0], taps, &y[0], buffer_size, factor);
+      benchmark::DoNotOptimize(y.data());
+      benchmark::ClobberMemory();
+    }
+    set_counters(state, buffer_size, taps);
+  }
+
+  template <bool Simd>
+  void decimate_variant(benchmark::State& state)
+  {
+    scoped_level level(Simd);
+    std::size_t taps = state.range(0);
+    std::vector<sample> x = random_numbers<sample>(buffer_size, 1);
+    std::vector<coefficient> h = random_numbers<coefficient>(taps, 2);
+    std::vector<result> y(buffer_size / factor + 1, result(index(0)));
+    fir_decimator<sample, coefficient, result> f(&h[0], taps, factor);
+    for (auto _ : state)
+    {
+      f.process(&x[0], &y[0], buffer_size);
+      benchmark::DoNotOptimize(y.data());
+      benchmark::ClobberMemory();
+    }
+    set_counters(state, buffer_size, taps);
+  }
+
+  void interpolate_baseline(benchmark::State& state)
+  {
+    std::size_t taps = state.range(0);
+    std::vector<boost::int16_t> x = random_indices<boost::int16_t>(buffer_size / factor, -32767, 32767, 1);
+    std::vector<boost::int16_t> h = random_indices<boost::int16_t>(taps, -32767, 32767, 2);
+    std::vector<boost::int16_t> stuffed(taps - 1 + buffer_size);
+    std::vector<boost::int16_t> y(buffer_size);
+    for (auto _ : state)
+    {
+      // the filter of the input with factor - 1 zeros inserted after each sample
+      for (std::size_t i = 0; i < x.size(); ++i)
+      {
+        stuffed[taps - 1 + i * factor] = x[i];
+        for (std::size_t p = 1; p < factor; ++p)
+          stuffed[taps - 1 + i * factor + p] = 0;
+      }
+      filter_baseline(&stuffed[0], &h[0], taps, &y[0], buffer_size, 1);
+      benchmark::DoNotOptimize(y.data());
+      benchmark::ClobberMemory();
+    }
+    set_counters(state, buffer_size, taps);
+  }
+
+  template <bool Simd>
+  void interpolate_variant(benchmark::State& state)
+  {
+    scoped_level level(Simd);
+    std::size_t taps = state.range(0);
+    std::vector<sample> x = random_numbers<sample>(buffer_size / factor, 1);
+    std::vector<coefficient> h = random_numbers<coefficient>(taps, 2);
+    std::vector<result> y(buffer_size, result(index(0)));
+    fir_interpolator<sample, coefficient, result> f(&h[0], taps, factor);
+    for (auto _ : state)
+    {
+      f.process(&x[0], &y[0], x.size());
+      benchmark::DoNotOptimize(y.data());
+      benchmark::ClobberMemory();
+    }
+    set_counters(state, buffer_size, taps);
+  }
+
+  int register_benchmarks()
+  {
+    const int taps[] = { 16, 64, 256 };
+    for (int i = 0; i < 3; ++i)
+    {
+      benchmark::RegisterBenchmark("fir/baseline", fir_baseline)->Arg(taps[i]);
+      benchmark::RegisterBenchmark("fir/scalar", fir_filter_variant<false>)->Arg(taps[i]);
+      benchmark::RegisterBenchmark("fir/simd", fir_filter_variant<true>)->Arg(taps[i]);
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+      benchmark::RegisterBenchmark("decimate/baseline", decimate_baseline)->Arg(taps[i]);
+      benchmark::RegisterBenchmark("decimate/scalar", decimate_variant<false>)->Arg(taps[i]);
+      benchmark::RegisterBenchmark("decimate/simd", decimate_variant<true>)->Arg(taps[i]);
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+      benchmark::RegisterBenchmark("interpolate/baseline", interpolate_baseline)->Arg(taps[i]);
+      benchmark::RegisterBenchmark("interpolate/scalar", interpolate_variant<false>)->Arg(taps[i]);
+      benchmark::RegisterBenchmark("interpolate/simd", interpolate_variant<true>)->Arg(taps[i]);
+    }
+    return 0;
+  }
+
+  const int registered = register_benchmarks();
+}
+
+BOOST_FIXED_POINT_PERF_MAIN()
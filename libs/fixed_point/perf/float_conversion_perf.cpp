@@ -0,0 +1,165 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Measures the conversion of arrays of doubles in ]-2^15, 2^15[ to Q15.16.
+//
+// Groups: from_double.<rounding> for round::negative and round::nearest_even.
+//
+// Variants:
+// - baseline: hand written multiplication by 2^16 and truncating conversion, corrected to the rounding.
+// - divide_floor: the division by the factor followed by std::floor, which the conversion used to do.
+// - real_t: the real_t constructor from double.
+// - sse4, avx2, avx512: batch::number_cast restricted to the instruction set; skipped when not supported.
+
+#include <boost/fixed_point/batch.hpp>
+#include "perf_harness.hpp"
+#include <boost/cstdint.hpp>
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace boost::fixed_point;
+using boost::fixed_point::perf::random_indices;
+
+namespace
+{
+  const std::size_t buffer_size = 1024;
+
+  std::vector<double> random_doubles(unsigned long long seed)
+  {
+    std::vector<boost::int64_t> idx = random_indices<boost::int64_t>(buffer_size, -(1LL << 52) + 1, (1LL << 52) - 1, seed);
+    std::vector<double> res;
+    res.reserve(buffer_size);
+    for (std::size_t i = 0; i < buffer_size; ++i)
+      res.push_back(std::ldexp(double(idx[i]), -37));
+    return res;
+  }
+
+  template <typename RP>
+  struct rounding_traits;
+  template <>
+  struct rounding_traits<round::negative>
+  {
+    static const char* name()
+    {
+      return "negative";
+    }
+    static boost::int32_t baseline(double x)
+    {
+      double y = x * 65536.0;
+      boost::int32_t t = boost::int32_t(y);
+      return t - (double(t) > y);
+    }
+    static boost::int32_t divide_floor(double x)
+    {
+      return boost::int32_t(std::floor(x / (1.0 / 65536.0)));
+    }
+  };
+  template <>
+  struct rounding_traits<round::nearest_even>
+  {
+    static const char* name()
+    {
+      return "nearest_even";
+    }
+    static boost::int32_t baseline(double x)
+    {
+      double y = x * 65536.0;
+      boost::int32_t t = boost::int32_t(y);
+      t -= (double(t) > y);
+      double r = y - double(t);
+      return t + ((r > 0.5) | ((r == 0.5) & (t & 1)));
+    }
+    static boost::int32_t divide_floor(double x)
+    {
+      double y = x / (1.0 / 65536.0);
+      double f = std::floor(y);
+      double r = y - f;
+      if (r > 0.5 || (r == 0.5 && std::fmod(f, 2.0) != 0)) f += 1;
+      return boost::int32_t(f);
+    }
+  };
+
+  template <typename RP>
+  void from_double_baseline(benchmark::State& state)
+  {
+    std::vector<double> a = random_doubles(1);
+    std::vector<boost::int32_t> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = rounding_traits<RP>::baseline(a[i]);
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  template <typename RP>
+  void from_double_divide_floor(benchmark::State& state)
+  {
+    std::vector<double> a = random_doubles(1);
+    std::vector<boost::int32_t> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = rounding_traits<RP>::divide_floor(a[i]);
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  template <typename RP>
+  void from_double_real_t(benchmark::State& state)
+  {
+    typedef real_t<15, -16, RP, overflow::exception> q15_16;
+    std::vector<double> a = random_doubles(1);
+    std::vector<q15_16> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = q15_16(a[i]);
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  template <typename RP>
+  void from_double_batch(benchmark::State& state, simd::level l)
+  {
+    typedef real_t<15, -16, RP, overflow::exception> q15_16;
+    simd::level prev = simd::restrict_to(l);
+    if (simd::active() != l) state.SkipWithError("instruction set not supported");
+    std::vector<double> a = random_doubles(1);
+    std::vector<q15_16> c(buffer_size);
+    for (auto _ : state)
+    {
+      batch::number_cast(a.data(), c.data(), buffer_size);
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+    simd::restrict_to(prev);
+  }
+
+  template <typename RP>
+  int register_group()
+  {
+    std::string group = std::string("from_double.") + rounding_traits<RP>::name();
+    benchmark::RegisterBenchmark((group + "/baseline").c_str(), from_double_baseline<RP>);
+    benchmark::RegisterBenchmark((group + "/divide_floor").c_str(), from_double_divide_floor<RP>);
+    benchmark::RegisterBenchmark((group + "/real_t").c_str(), from_double_real_t<RP>);
+    benchmark::RegisterBenchmark((group + "/sse4").c_str(), from_double_batch<RP>, simd::sse4);
+    benchmark::RegisterBenchmark((group + "/avx2").c_str(), from_double_batch<RP>, simd::avx2);
+    benchmark::RegisterBenchmark((group + "/avx512").c_str(), from_double_batch<RP>, simd::avx512);
+    return 0;
+  }
+  const int negative_group = register_group<round::negative>();
+  const int nearest_even_group = register_group<round::nearest_even>();
+}
+
+BOOST_FIXED_POINT_PERF_MAIN()
@@ -0,0 +1,142 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Measures a * b + c, with a and b Q15.16 numbers and c a Q7.24 number in [-4, 4], rounded to nearest even to Q15.16,
+// for 1024 triples, and reports as the counter max_ulp the largest error with respect to the exact result, in units
+// of the resolution.
+//
+// Variants:
+// - baseline: the hand written multiplication, addition and rounding shift on int64_t.
+// - fma: fma<Q15.16>(a, b, c), rounded once.
+// - composed: number_cast<Q15.16>(a * b + c), through the intermediate types of the operators.
+// - two_casts: the product converted to Q15.16 before the addition, rounded twice.
+
+#include <boost/fixed_point/number.hpp>
+#include "perf_harness.hpp"
+#include <boost/cstdint.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace boost::fixed_point;
+using boost::fixed_point::perf::random_indices;
+
+namespace
+{
+  const std::size_t buffer_size = 1024;
+
+  typedef real_t<15, -16, round::nearest_even> q15_16;
+  typedef real_t<7, -24, round::nearest_even> q7_24;
+
+  template <typename T>
+  std::vector<T> random_numbers(unsigned long long seed)
+  {
+    std::vector<boost::int32_t> idx = random_indices<boost::int32_t>(buffer_size, -(4LL << -T::resolution_exp),
+        4LL << -T::resolution_exp, seed);
+    std::vector<T> res;
+    for (std::size_t i = 0; i < buffer_size; ++i)
+      res.push_back(T(index(idx[i])));
+    return res;
+  }
+
+  struct inputs
+  {
+    std::vector<q15_16> a, b;
+    std::vector<q7_24> c;
+    inputs() :
+      a(random_numbers<q15_16>(1)), b(random_numbers<q15_16>(2)), c(random_numbers<q7_24>(3))
+    {
+    }
+  };
+
+  // The largest distance, in units of the resolution, between r[i] and the exact a[i] * b[i] + c[i].
+  double max_ulp(inputs const& in, std::vector<q15_16> const& r)
+  {
+    double res = 0;
+    for (std::size_t i = 0; i < buffer_size; ++i)
+    {
+      double exact = in.a[i].as_double() * in.b[i].as_double() + in.c[i].as_double();
+      res = std::max(res, std::fabs(r[i].as_double() - exact) * 65536.0);
+    }
+    return res;
+  }
+
+  boost::int32_t baseline_fma(boost::int32_t a, boost::int32_t b, boost::int32_t c)
+  {
+    boost::int64_t v = boost::int64_t(a) * b + (boost::int64_t(c) << 8);
+    boost::int64_t q = v >> 16;
+    boost::int64_t r = v & 0xFFFF;
+    if (r > 0x8000 || (r == 0x8000 && (q & 1)))
+      ++q;
+    return boost::int32_t(q);
+  }
+
+  void fma_baseline(benchmark::State& state)
+  {
+    inputs in;
+    std::vector<q15_16> r(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        r[i] = q15_16(index(baseline_fma(in.a[i].count(), in.b[i].count(), in.c[i].count())));
+      benchmark::DoNotOptimize(r.data());
+      benchmark::ClobberMemory();
+    }
+    state.counters["max_ulp"] = max_ulp(in, r);
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  void fma_fma(benchmark::State& state)
+  {
+    inputs in;
+    std::vector<q15_16> r(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        r[i] = fma<q15_16>(in.a[i], in.b[i], in.c[i]);
+      benchmark::DoNotOptimize(r.data());
+      benchmark::ClobberMemory();
+    }
+    state.counters["max_ulp"] = max_ulp(in, r);
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  void fma_composed(benchmark::State& state)
+  {
+    inputs in;
+    std::vector<q15_16> r(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        r[i] = number_cast<q15_16>(in.a[i] * in.b[i] + in.c[i]);
+      benchmark::DoNotOptimize(r.data());
+      benchmark::ClobberMemory();
+    }
+    state.counters["max_ulp"] = max_ulp(in, r);
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  void fma_two_casts(benchmark::State& state)
+  {
+    inputs in;
+    std::vector<q15_16> r(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        r[i] = number_cast<q15_16>(number_cast<q15_16>(in.a[i] * in.b[i]) + in.c[i]);
+      benchmark::DoNotOptimize(r.data());
+      benchmark::ClobberMemory();
+    }
+    state.counters["max_ulp"] = max_ulp(in, r);
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  const int fma_group = (benchmark::RegisterBenchmark("fma/baseline", fma_baseline),
+      benchmark::RegisterBenchmark("fma/fma", fma_fma),
+      benchmark::RegisterBenchmark("fma/composed", fma_composed),
+      benchmark::RegisterBenchmark("fma/two_casts", fma_two_casts), 0);
+}
+
+BOOST_FIXED_POINT_PERF_MAIN()
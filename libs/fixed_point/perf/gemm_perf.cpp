@@ -0,0 +1,162 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Measures the quantized products of matrices and of a matrix and a vector. The counter ops reports the
+// multiplications and additions per second, 2 * m * n * k per product, to compare with the floating point GFLOPS.
+//
+// Groups:
+// - gemm_int8: 256x256 activations ureal_t<0,-8> by 256x256 weights real_t<0,-7>, requantized to real_t<7,-8>.
+// - gemm_int16: 128x256 real_t<0,-15> by 256x128 real_t<0,-15>, requantized to real_t<15,-15>.
+// - gemv_int8: 1024x1024 weights real_t<0,-7> by 1024 activations ureal_t<0,-8>, requantized to real_t<7,-8>.
+//
+// Variants:
+// - baseline: the triple loop on the integers, with the columns of the second operand contiguous, rounding to
+//   nearest and saturating by hand.
+// - none, avx2, avx512: batch::gemm or batch::gemv restricted to an instruction set. avx512 uses AVX-512 VNNI
+//   for the numbers on 8 bits when the processor supports it, and AVX2 otherwise.
+
+#include <boost/fixed_point/gemm.hpp>
+#include "perf_harness.hpp"
+#include <boost/cstdint.hpp>
+#include <string>
+#include <vector>
+
+using namespace boost::fixed_point;
+using boost::fixed_point::perf::random_indices;
+
+namespace
+{
+  typedef ureal_t<0, -8> activation;
+  typedef real_t<0, -7> weight;
+  typedef real_t<7, -8, round::nearest_even, overflow::saturate> output8;
+  typedef real_t<0, -15> q15;
+  typedef real_t<15, -15, round::nearest_even, overflow::saturate> output16;
+
+  template <typename T>
+  std::vector<T> random_numbers(std::size_t n, unsigned long long seed)
+  {
+    std::vector<boost::int64_t> idx = random_indices<boost::int64_t>(n, T::min_index, T::max_index, seed);
+    std::vector<T> res;
+    for (std::size_t i = 0; i < n; ++i)
+      res.push_back(T(index(typename T::underlying_type(idx[i]))));
+    return res;
+  }
+
+  template <typename T>
+  std::vector<typename T::underlying_type> counts(std::vector<T> const& xs)
+  {
+    std::vector<typename T::underlying_type> res;
+    for (std::size_t i = 0; i < xs.size(); ++i)
+      res.push_back(xs[i].count());
+    return res;
+  }
+
+  // Rounds to nearest, ties to even, and saturates to [lo, hi].
+  inline boost::int64_t requantize(boost::int64_t v, int shift, boost::int64_t lo, boost::int64_t hi)
+  {
+    boost::int64_t half = boost::int64_t(1) << (shift - 1);
+    boost::int64_t q = v >> shift, r = v - (q << shift);
+    q += (r > half || (r == half && (q & 1))) ? 1 : 0;
+    return q < lo ? lo : q > hi ? hi : q;
+  }
+
+  // Restricts the batch operations to the instruction set of the variant during a benchmark.
+  struct scoped_level
+  {
+    simd::level prev;
+    scoped_level(benchmark::State& state, simd::level l) :
+      prev(simd::restrict_to(l))
+    {
+      if (simd::active() != l) state.SkipWithError("instruction set not supported");
+    }
+    ~scoped_level()
+    {
+      simd::restrict_to(prev);
+    }
+  };
+
+  const char* level_name(simd::level l)
+  {
+    switch (l)
+    {
+    case simd::sse4: return "sse4";
+    case simd::avx2: return "avx2";
+    case simd::avx512: return "avx512";
+    default: return "none";
+    }
+  }
+
+  void set_counters(benchmark::State& state, std::size_t m, std::size_t n, std::size_t k)
+  {
+    state.counters["ops"] = benchmark::Counter(2.0 * m * n * k, benchmark::Counter::kIsIterationInvariantRate);
+  }
+
+  // c = a b, a row major, b column major.
+  template <typename T1, typename T2, typename To, typename Acc>
+  void gemm_baseline(benchmark::State& state, std::size_t m, std::size_t n, std::size_t k, int shift)
+  {
+    std::vector<typename T1::underlying_type> a = counts(random_numbers<T1>(m * k, 1));
+    std::vector<typename T2::underlying_type> b = counts(random_numbers<T2>(k * n, 2));
+    std::vector<typename To::underlying_type> c(m * n);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < m; ++i)
+        for (std::size_t j = 0; j < n; ++j)
+        {
+          Acc acc = 0;
+          for (std::size_t p = 0; p < k; ++p)
+            acc += Acc(a[i * k + p]) * b[j * k + p];
+          c[i * n + j] = typename To::underlying_type(requantize(acc, shift, To::min_index, To::max_index));
+        }
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    set_counters(state, m, n, k);
+  }
+
+  template <typename T1, typename T2, typename To>
+  void gemm_batch(benchmark::State& state, simd::level l, std::size_t m, std::size_t n, std::size_t k)
+  {
+    scoped_level level(state, l);
+    std::vector<T1> a = random_numbers<T1>(m * k, 1);
+    std::vector<T2> b = random_numbers<T2>(k * n, 2);
+    std::vector<To> c(m * n, To(index(0)));
+    for (auto _ : state)
+    {
+      if (n == 1)
+        batch::gemv(&a[0], batch::row_major, &b[0], &c[0], m, k);
+      else
+        batch::gemm(&a[0], batch::row_major, &b[0], batch::column_major, &c[0], m, n, k);
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    set_counters(state, m, n, k);
+  }
+
+  int register_benchmarks()
+  {
+    benchmark::RegisterBenchmark("gemm_int8/baseline", gemm_baseline<activation, weight, output8, boost::int32_t>,
+        256, 256, 256, 7);
+    benchmark::RegisterBenchmark("gemm_int16/baseline", gemm_baseline<q15, q15, output16, boost::int64_t>,
+        128, 128, 256, 15);
+    benchmark::RegisterBenchmark("gemv_int8/baseline", gemm_baseline<weight, activation, output8, boost::int32_t>,
+        1024, 1, 1024, 7);
+    const simd::level levels[] = { simd::none, simd::avx2, simd::avx512 };
+    for (simd::level l : levels)
+    {
+      std::string name = level_name(l);
+      benchmark::RegisterBenchmark(("gemm_int8/" + name).c_str(), gemm_batch<activation, weight, output8>,
+          l, 256, 256, 256);
+      benchmark::RegisterBenchmark(("gemm_int16/" + name).c_str(), gemm_batch<q15, q15, output16>, l, 128, 128, 256);
+      benchmark::RegisterBenchmark(("gemv_int8/" + name).c_str(), gemm_batch<weight, activation, output8>,
+          l, 1024, 1, 1024);
+    }
+    return 0;
+  }
+
+  const int registered = register_benchmarks();
+}
+
+BOOST_FIXED_POINT_PERF_MAIN()
@@ -0,0 +1,177 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Measures the 128 bits integers on buffers of 4096 signed values. The counter items reports the operations per
+// second.
+//
+// Groups:
+// - sum: the exact sum of the values, added and subtracted in turn, a dependency chain of carry propagations.
+// - multiply: the low 128 bits of the products of two values.
+// - multiply_high: the high 128 bits of the 256 bits products of two values.
+//
+// Variants:
+// - baseline: the builtin __int128, the high products being built from four 64x64->128 products.
+// - limbs: int128 of int128.hpp, on two 64 bits limbs.
+// - cpp_int: boost::multiprecision::int128_t, the high products through int256_t. It stores a sign and a magnitude,
+//   so that its low products are the truncated magnitudes, not the two's complement ones.
+
+#include <boost/fixed_point/int128.hpp>
+#include "perf_harness.hpp"
+#include <boost/multiprecision/cpp_int.hpp>
+#include <boost/cstdint.hpp>
+#include <vector>
+
+using namespace boost::fixed_point;
+using boost::fixed_point::perf::random_indices;
+
+#if defined(BOOST_HAS_INT128)
+
+namespace
+{
+  const std::size_t buffer_size = 4096;
+
+  typedef boost::multiprecision::int128_t mp_int128;
+  typedef boost::multiprecision::int256_t mp_int256;
+
+  // Values with a high limb in [-2^40, 2^40], so that their sums don't overflow.
+  std::vector<int128> random_values(unsigned long long seed)
+  {
+    std::vector<boost::int64_t> hi = random_indices<boost::int64_t>(buffer_size, -(1LL << 40), 1LL << 40, seed);
+    std::vector<boost::int64_t> a = random_indices<boost::int64_t>(buffer_size, 0, 0xFFFFFFFFLL, seed + 1);
+    std::vector<boost::int64_t> b = random_indices<boost::int64_t>(buffer_size, 0, 0xFFFFFFFFLL, seed + 2);
+    std::vector<int128> res;
+    res.reserve(buffer_size);
+    for (std::size_t i = 0; i < buffer_size; ++i)
+    {
+      boost::uint64_t lo = (boost::uint64_t(a[i]) << 32) | boost::uint64_t(b[i]);
+      res.push_back(int128::from_limbs(boost::uint64_t(hi[i]), lo));
+    }
+    return res;
+  }
+
+  boost::int128_type to_builtin(int128 const& x)
+  {
+    return x.convert_to<boost::int128_type>();
+  }
+
+  mp_int128 to_cpp_int(int128 const& x)
+  {
+    bool negative = x < 0;
+    int128 m = negative ? -x : x;
+    mp_int128 res = (mp_int128(m.high()) << 64) | mp_int128(m.low());
+    return negative ? mp_int128(-res) : res;
+  }
+
+  template <typename T>
+  std::vector<T> convert(std::vector<int128> const& x, T (*f)(int128 const&))
+  {
+    std::vector<T> res;
+    for (std::size_t i = 0; i < x.size(); ++i)
+      res.push_back(f(x[i]));
+    return res;
+  }
+
+  int128 identity(int128 const& x)
+  {
+    return x;
+  }
+
+  boost::int128_type builtin_multiply_high(boost::int128_type a, boost::int128_type b)
+  {
+    typedef boost::uint128_type u128;
+    u128 ua = u128(a), ub = u128(b);
+    u128 ll = u128(boost::uint64_t(ua)) * boost::uint64_t(ub);
+    u128 lh = u128(boost::uint64_t(ua)) * boost::uint64_t(ub >> 64);
+    u128 hl = u128(boost::uint64_t(ua >> 64)) * boost::uint64_t(ub);
+    u128 hh = u128(boost::uint64_t(ua >> 64)) * boost::uint64_t(ub >> 64);
+    u128 mid = (ll >> 64) + boost::uint64_t(lh) + boost::uint64_t(hl);
+    u128 res = hh + (lh >> 64) + (hl >> 64) + (mid >> 64);
+    if (a < 0) res -= ub;
+    if (b < 0) res -= ua;
+    return boost::int128_type(res);
+  }
+
+  boost::int128_type builtin_multiply(boost::int128_type a, boost::int128_type b)
+  {
+    // the signed product would overflow
+    return boost::int128_type(boost::uint128_type(a) * boost::uint128_type(b));
+  }
+
+  int128 limbs_multiply(int128 const& a, int128 const& b)
+  {
+    return a * b;
+  }
+
+  int128 limbs_multiply_high(int128 const& a, int128 const& b)
+  {
+    return multiply_high(a, b);
+  }
+
+  mp_int128 cpp_int_multiply(mp_int128 const& a, mp_int128 const& b)
+  {
+    return a * b;
+  }
+
+  mp_int128 cpp_int_multiply_high(mp_int128 const& a, mp_int128 const& b)
+  {
+    return mp_int128(mp_int256(mp_int256(a) * b) >> 128);
+  }
+
+  template <typename T>
+  void sum(benchmark::State& state, T (*f)(int128 const&))
+  {
+    std::vector<T> x = convert(random_values(1), f);
+    for (auto _ : state)
+    {
+      T s = T(0);
+      for (std::size_t i = 0; i < buffer_size; i += 2)
+      {
+        s += x[i];
+        s -= x[i + 1];
+      }
+      benchmark::DoNotOptimize(s);
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  template <typename T, typename Arg, T (*Op)(Arg, Arg)>
+  void binary(benchmark::State& state, T (*f)(int128 const&))
+  {
+    std::vector<T> a = convert(random_values(1), f), b = convert(random_values(4), f), c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = Op(a[i], b[i]);
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  int register_benchmarks()
+  {
+    benchmark::RegisterBenchmark("sum/baseline", sum<boost::int128_type>, to_builtin);
+    benchmark::RegisterBenchmark("sum/limbs", sum<int128>, identity);
+    benchmark::RegisterBenchmark("sum/cpp_int", sum<mp_int128>, to_cpp_int);
+    benchmark::RegisterBenchmark("multiply/baseline",
+        binary<boost::int128_type, boost::int128_type, builtin_multiply>, to_builtin);
+    benchmark::RegisterBenchmark("multiply/limbs", binary<int128, int128 const&, limbs_multiply>, identity);
+    benchmark::RegisterBenchmark("multiply/cpp_int", binary<mp_int128, mp_int128 const&, cpp_int_multiply>,
+        to_cpp_int);
+    benchmark::RegisterBenchmark("multiply_high/baseline",
+        binary<boost::int128_type, boost::int128_type, builtin_multiply_high>, to_builtin);
+    benchmark::RegisterBenchmark("multiply_high/limbs", binary<int128, int128 const&, limbs_multiply_high>,
+        identity);
+    benchmark::RegisterBenchmark("multiply_high/cpp_int", binary<mp_int128, mp_int128 const&, cpp_int_multiply_high>,
+        to_cpp_int);
+    return 0;
+  }
+
+  const int registered = register_benchmarks();
+}
+
+#endif
+
+BOOST_FIXED_POINT_PERF_MAIN()
@@ -0,0 +1,192 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Measures the math functions of boost/fixed_point/math.hpp on arrays of positive Q15.16.
+//
+// Groups: sqrt, rsqrt, reciprocal, exp2 and log2, with the result types sqrt_result, rsqrt_result and
+// reciprocal_result, and Q15.16 for exp2 and log2.
+//
+// Variants:
+// - baseline: the round trip through double, as_double(), the function of <cmath> and the conversion of the double
+//   to the result type.
+// - integer: the integer only function of the library.
+
+#include <boost/fixed_point/math.hpp>
+#include "perf_harness.hpp"
+#include <boost/cstdint.hpp>
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace boost::fixed_point;
+using boost::fixed_point::perf::random_indices;
+
+namespace
+{
+  const std::size_t buffer_size = 1024;
+
+  typedef real_t<15, -16> q15_16;
+
+  std::vector<q15_16> random_numbers(long long lo, long long hi)
+  {
+    std::vector<boost::int32_t> idx = random_indices<boost::int32_t>(buffer_size, lo, hi, 1);
+    std::vector<q15_16> res;
+    res.reserve(buffer_size);
+    for (std::size_t i = 0; i < buffer_size; ++i)
+      res.push_back(q15_16(index(idx[i])));
+    return res;
+  }
+
+  struct sqrt_op
+  {
+    typedef sqrt_result<q15_16>::type result_type;
+    static const char* name()
+    {
+      return "sqrt";
+    }
+    static std::vector<q15_16> arguments()
+    {
+      return random_numbers(0, q15_16::max_index);
+    }
+    static result_type round_trip(q15_16 x)
+    {
+      return result_type(std::sqrt(x.as_double()));
+    }
+    static result_type integer(q15_16 x)
+    {
+      return boost::fixed_point::sqrt(x);
+    }
+  };
+
+  struct rsqrt_op
+  {
+    typedef rsqrt_result<q15_16>::type result_type;
+    static const char* name()
+    {
+      return "rsqrt";
+    }
+    static std::vector<q15_16> arguments()
+    {
+      return random_numbers(1, q15_16::max_index);
+    }
+    static result_type round_trip(q15_16 x)
+    {
+      return result_type(1 / std::sqrt(x.as_double()));
+    }
+    static result_type integer(q15_16 x)
+    {
+      return boost::fixed_point::rsqrt(x);
+    }
+  };
+
+  struct reciprocal_op
+  {
+    typedef reciprocal_result<q15_16>::type result_type;
+    static const char* name()
+    {
+      return "reciprocal";
+    }
+    static std::vector<q15_16> arguments()
+    {
+      return random_numbers(1, q15_16::max_index);
+    }
+    static result_type round_trip(q15_16 x)
+    {
+      return result_type(1 / x.as_double());
+    }
+    static result_type integer(q15_16 x)
+    {
+      return boost::fixed_point::reciprocal(x);
+    }
+  };
+
+  struct exp2_op
+  {
+    typedef q15_16 result_type;
+    static const char* name()
+    {
+      return "exp2";
+    }
+    static std::vector<q15_16> arguments()
+    {
+      return random_numbers(-16 << 16, 14 << 16);
+    }
+    static result_type round_trip(q15_16 x)
+    {
+      return result_type(std::exp2(x.as_double()));
+    }
+    static result_type integer(q15_16 x)
+    {
+      return boost::fixed_point::exp2<result_type>(x);
+    }
+  };
+
+  struct log2_op
+  {
+    typedef q15_16 result_type;
+    static const char* name()
+    {
+      return "log2";
+    }
+    static std::vector<q15_16> arguments()
+    {
+      return random_numbers(1, q15_16::max_index);
+    }
+    static result_type round_trip(q15_16 x)
+    {
+      return result_type(std::log2(x.as_double()));
+    }
+    static result_type integer(q15_16 x)
+    {
+      return boost::fixed_point::log2<result_type>(x);
+    }
+  };
+
+  template <typename Op>
+  void math_baseline(benchmark::State& state)
+  {
+    std::vector<q15_16> a = Op::arguments();
+    std::vector<typename Op::result_type> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = Op::round_trip(a[i]);
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  template <typename Op>
+  void math_integer(benchmark::State& state)
+  {
+    std::vector<q15_16> a = Op::arguments();
+    std::vector<typename Op::result_type> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = Op::integer(a[i]);
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  template <typename Op>
+  int register_group()
+  {
+    std::string group = Op::name();
+    benchmark::RegisterBenchmark((group + "/baseline").c_str(), math_baseline<Op>);
+    benchmark::RegisterBenchmark((group + "/integer").c_str(), math_integer<Op>);
+    return 0;
+  }
+  const int sqrt_group = register_group<sqrt_op>();
+  const int rsqrt_group = register_group<rsqrt_op>();
+  const int reciprocal_group = register_group<reciprocal_op>();
+  const int exp2_group = register_group<exp2_op>();
+  const int log2_group = register_group<log2_op>();
+}
+
+BOOST_FIXED_POINT_PERF_MAIN()
@@ -0,0 +1,136 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Measures phase accumulators wrapping on a turn, stored as ureal_t<0, -31> with overflow::modulus.
+//
+// Groups:
+// - phase: phase = number_cast<phase_t>(phase + increment), storing every phase.
+// - nco: numerically controlled oscillator, looking up a 1024 entries sine table with the upper bits of the phase.
+//
+// Variants:
+// - baseline: hand written unsigned addition masked to 31 bits.
+// - remainder: hand written addition wrapped with the % operator, as overflow::modulus used to do.
+// - modulus: the real_t code with overflow::modulus.
+
+#include <boost/fixed_point/number.hpp>
+#include "perf_harness.hpp"
+#include <boost/cstdint.hpp>
+#include <cmath>
+#include <vector>
+
+using namespace boost::fixed_point;
+
+namespace
+{
+  const std::size_t buffer_size = 1024;
+
+  typedef ureal_t<0, -31, round::negative, overflow::modulus> phase_t;
+  const boost::uint32_t phase_mask = phase_t::max_index;
+  const boost::uint32_t increment = 0x12345679u & phase_mask;
+  const int table_bits = 10;
+
+  std::vector<boost::int16_t> sine_table()
+  {
+    std::vector<boost::int16_t> res;
+    for (int i = 0; i < (1 << table_bits); ++i)
+      res.push_back(boost::int16_t(32767 * std::sin(2 * 3.14159265358979323846 * i / (1 << table_bits))));
+    return res;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // phase
+
+  void phase_baseline(benchmark::State& state)
+  {
+    std::vector<boost::uint32_t> c(buffer_size);
+    boost::uint32_t phase = 0;
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = phase = (phase + increment) & phase_mask;
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+  BENCHMARK(phase_baseline)->Name("phase/baseline");
+
+  void phase_remainder(benchmark::State& state)
+  {
+    std::vector<boost::uint32_t> c(buffer_size);
+    boost::uint32_t phase = 0;
+    boost::uint64_t range = boost::uint64_t(phase_mask) + 1;
+    benchmark::DoNotOptimize(range);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = phase = boost::uint32_t((boost::uint64_t(phase) + increment) % range);
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+  BENCHMARK(phase_remainder)->Name("phase/remainder");
+
+  void phase_modulus(benchmark::State& state)
+  {
+    std::vector<phase_t> c(buffer_size);
+    phase_t phase( (index(0)));
+    const phase_t inc( (index(increment)));
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = phase = number_cast<phase_t>(phase + inc);
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+  BENCHMARK(phase_modulus)->Name("phase/modulus");
+
+  ///////////////////////////////////////////////////////////////////////////
+  // nco
+
+  void nco_baseline(benchmark::State& state)
+  {
+    std::vector<boost::int16_t> table = sine_table();
+    std::vector<boost::int16_t> c(buffer_size);
+    boost::uint32_t phase = 0;
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+      {
+        phase = (phase + increment) & phase_mask;
+        c[i] = table[phase >> (31 - table_bits)];
+      }
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+  BENCHMARK(nco_baseline)->Name("nco/baseline");
+
+  void nco_modulus(benchmark::State& state)
+  {
+    std::vector<boost::int16_t> table = sine_table();
+    std::vector<boost::int16_t> c(buffer_size);
+    phase_t phase( (index(0)));
+    const phase_t inc( (index(increment)));
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+      {
+        phase = number_cast<phase_t>(phase + inc);
+        c[i] = table[phase.count() >> (31 - table_bits)];
+      }
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+  BENCHMARK(nco_modulus)->Name("nco/modulus");
+}
+
+BOOST_FIXED_POINT_PERF_MAIN()
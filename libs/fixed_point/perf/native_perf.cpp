@@ -0,0 +1,107 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Measures a dependency chain, the leaky integrator y[i] = a * y[i-1] + x[i], on 4096 samples stored on arrays of
+// storage::space numbers. Each step depends on the previous one, so its latency, and not the throughput of the
+// operations, sets the speed. The counter items reports the samples per second.
+//
+// Groups:
+// - chain_8: real_t<7,-8>, rounded toward negative infinity and saturated, stored on int16.
+// - chain_16: real_t<15,-16>, rounded toward negative infinity and saturated, stored on int32.
+//
+// Variants:
+// - baseline: hand-written loop on the integers of the arrays.
+// - space: the state and the operations on storage::space numbers.
+// - speed: the same with storage::speed.
+// - native: the state and the operations on storage::native numbers, which are converted from the elements when
+//   loaded and narrowed when stored.
+
+#include <boost/fixed_point/number.hpp>
+#include "perf_harness.hpp"
+#include <boost/cstdint.hpp>
+#include <vector>
+
+using namespace boost::fixed_point;
+using boost::fixed_point::perf::random_indices;
+
+namespace
+{
+  const std::size_t buffer_size = 4096;
+
+  typedef real_t<7, -8, round::negative, overflow::saturate> q8;
+  typedef real_t<15, -16, round::negative, overflow::saturate> q16;
+
+  template <typename T>
+  std::vector<T> random_numbers(unsigned long long seed)
+  {
+    // a tenth of the range, so that a few sums saturate
+    std::vector<boost::int64_t> idx = random_indices<boost::int64_t>(buffer_size, T::min_index / 10, T::max_index / 10,
+        seed);
+    std::vector<T> res;
+    res.reserve(buffer_size);
+    for (std::size_t i = 0; i < buffer_size; ++i)
+      res.push_back(T(index(typename T::underlying_type(idx[i]))));
+    return res;
+  }
+
+  // The hand-written step: the product of a Q.F and a Q.F has 2F fractional bits, the sum is brought back to F bits
+  // by an arithmetic shift and saturated.
+  template <typename T, typename Wide>
+  void chain_baseline(benchmark::State& state)
+  {
+    typedef typename T::underlying_type I;
+    const int f = -T::resolution_exp;
+    const Wide max = T::max_index, min = T::min_index;
+    std::vector<T> xt = random_numbers<T>(1);
+    std::vector<I> x(buffer_size), y(buffer_size);
+    for (std::size_t i = 0; i < buffer_size; ++i)
+      x[i] = xt[i].count();
+    const Wide a = Wide(T(0.875).count());
+    for (auto _ : state)
+    {
+      Wide s = 0;
+      for (std::size_t i = 0; i < buffer_size; ++i)
+      {
+        Wide v = (a * s + (Wide(x[i]) << f)) >> f;
+        s = v > max ? max : v < min ? min : v;
+        y[i] = I(s);
+      }
+      benchmark::DoNotOptimize(y.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  // The step on numbers of type C, the elements being of type T.
+  template <typename T, typename C>
+  void chain_fixed(benchmark::State& state)
+  {
+    std::vector<T> x = random_numbers<T>(1), y(buffer_size, T(index(0)));
+    const C a = C(0.875);
+    for (auto _ : state)
+    {
+      C s = C(index(0));
+      for (std::size_t i = 0; i < buffer_size; ++i)
+      {
+        s = number_cast<C>(a * s + C(x[i]));
+        y[i] = T(s);
+      }
+      benchmark::DoNotOptimize(y.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  BENCHMARK(chain_baseline<q8, boost::int32_t>)->Name("chain_8/baseline");
+  BENCHMARK(chain_fixed<q8, q8>)->Name("chain_8/space");
+  BENCHMARK(chain_fixed<q8, rebind_storage<q8, storage::speed>::type>)->Name("chain_8/speed");
+  BENCHMARK(chain_fixed<q8, rebind_storage<q8, storage::native>::type>)->Name("chain_8/native");
+  BENCHMARK(chain_baseline<q16, boost::int64_t>)->Name("chain_16/baseline");
+  BENCHMARK(chain_fixed<q16, q16>)->Name("chain_16/space");
+  BENCHMARK(chain_fixed<q16, rebind_storage<q16, storage::speed>::type>)->Name("chain_16/speed");
+  BENCHMARK(chain_fixed<q16, rebind_storage<q16, storage::native>::type>)->Name("chain_16/native");
+}
+
+BOOST_FIXED_POINT_PERF_MAIN()
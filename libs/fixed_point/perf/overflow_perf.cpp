@@ -0,0 +1,178 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Measures the cost of the overflow policies on conversions to Q15.16 that never overflow.
+//
+// Groups:
+// - number_cast: Q31.32 -> Q15.16, rounded towards negative infinity.
+// - from_double: double -> Q15.16, rounded towards negative infinity.
+//
+// Variants:
+// - baseline: hand written conversion saturating the overflows.
+// - exception, saturate, sticky: the real_t conversion with overflow::exception, overflow::saturate and
+//   overflow::sticky<>, the sticky status being checked once per buffer.
+// - batch_sticky: batch::number_cast to the overflow::sticky<> type.
+
+#include <boost/fixed_point/batch.hpp>
+#include "perf_harness.hpp"
+#include <boost/cstdint.hpp>
+#include <cmath>
+#include <vector>
+
+using namespace boost::fixed_point;
+using boost::fixed_point::perf::random_indices;
+
+namespace
+{
+  const std::size_t buffer_size = 1024;
+
+  typedef real_t<31, -32> q31_32;
+  const boost::int64_t max_shifted = boost::int64_t(real_t<15, -16>::max_index) << 16;
+  const boost::int64_t min_shifted = boost::int64_t(real_t<15, -16>::min_index) * 65536;
+
+  // Q31.32 values in ]-2^15, 2^15[, that don't overflow a Q15.16.
+  std::vector<q31_32> random_q31_32(unsigned long long seed)
+  {
+    std::vector<boost::int64_t> idx = random_indices<boost::int64_t>(buffer_size, -(1LL << 47) + 1, (1LL << 47) - 1, seed);
+    std::vector<q31_32> res;
+    res.reserve(buffer_size);
+    for (std::size_t i = 0; i < buffer_size; ++i)
+      res.push_back(q31_32(index(idx[i])));
+    return res;
+  }
+
+  std::vector<double> random_doubles(unsigned long long seed)
+  {
+    std::vector<q31_32> q = random_q31_32(seed);
+    std::vector<double> res;
+    res.reserve(buffer_size);
+    for (std::size_t i = 0; i < buffer_size; ++i)
+      res.push_back(q[i].as_double());
+    return res;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // number_cast
+
+  void number_cast_baseline(benchmark::State& state)
+  {
+    std::vector<q31_32> a = random_q31_32(1);
+    std::vector<boost::int32_t> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+      {
+        boost::int64_t v = a[i].count();
+        boost::int64_t r = v >> 16;
+        r = v > max_shifted ? real_t<15, -16>::max_index : r;
+        r = v < min_shifted ? real_t<15, -16>::min_index : r;
+        c[i] = boost::int32_t(r);
+      }
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+  BENCHMARK(number_cast_baseline)->Name("number_cast/baseline");
+
+  template <typename OP>
+  void number_cast_real_t(benchmark::State& state)
+  {
+    typedef real_t<15, -16, round::negative, OP> q15_16;
+    std::vector<q31_32> a = random_q31_32(1);
+    std::vector<q15_16> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = number_cast<q15_16>(a[i]);
+      if (overflow::reset_sticky_status() != overflow::no_overflow) state.SkipWithError("unexpected overflow");
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+  BENCHMARK_TEMPLATE(number_cast_real_t, overflow::exception)->Name("number_cast/exception");
+  BENCHMARK_TEMPLATE(number_cast_real_t, overflow::saturate)->Name("number_cast/saturate");
+  BENCHMARK_TEMPLATE(number_cast_real_t, overflow::sticky<>)->Name("number_cast/sticky");
+
+  void number_cast_batch_sticky(benchmark::State& state)
+  {
+    typedef real_t<15, -16, round::negative, overflow::sticky<> > q15_16;
+    std::vector<q31_32> a = random_q31_32(1);
+    std::vector<q15_16> c(buffer_size);
+    for (auto _ : state)
+    {
+      batch::number_cast(a.data(), c.data(), buffer_size);
+      if (overflow::reset_sticky_status() != overflow::no_overflow) state.SkipWithError("unexpected overflow");
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+  BENCHMARK(number_cast_batch_sticky)->Name("number_cast/batch_sticky");
+
+  ///////////////////////////////////////////////////////////////////////////
+  // from_double
+
+  void from_double_baseline(benchmark::State& state)
+  {
+    std::vector<double> a = random_doubles(1);
+    std::vector<boost::int32_t> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+      {
+        double y = a[i] * 65536.0;
+        boost::int64_t t = boost::int64_t(y);
+        t -= (double(t) > y);
+        t = t > real_t<15, -16>::max_index ? real_t<15, -16>::max_index : t;
+        t = t < real_t<15, -16>::min_index ? real_t<15, -16>::min_index : t;
+        c[i] = boost::int32_t(t);
+      }
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+  BENCHMARK(from_double_baseline)->Name("from_double/baseline");
+
+  template <typename OP>
+  void from_double_real_t(benchmark::State& state)
+  {
+    typedef real_t<15, -16, round::negative, OP> q15_16;
+    std::vector<double> a = random_doubles(1);
+    std::vector<q15_16> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = q15_16(a[i]);
+      if (overflow::reset_sticky_status() != overflow::no_overflow) state.SkipWithError("unexpected overflow");
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+  BENCHMARK_TEMPLATE(from_double_real_t, overflow::exception)->Name("from_double/exception");
+  BENCHMARK_TEMPLATE(from_double_real_t, overflow::saturate)->Name("from_double/saturate");
+  BENCHMARK_TEMPLATE(from_double_real_t, overflow::sticky<>)->Name("from_double/sticky");
+
+  void from_double_batch_sticky(benchmark::State& state)
+  {
+    typedef real_t<15, -16, round::negative, overflow::sticky<> > q15_16;
+    std::vector<double> a = random_doubles(1);
+    std::vector<q15_16> c(buffer_size);
+    for (auto _ : state)
+    {
+      batch::number_cast(a.data(), c.data(), buffer_size);
+      if (overflow::reset_sticky_status() != overflow::no_overflow) state.SkipWithError("unexpected overflow");
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+  BENCHMARK(from_double_batch_sticky)->Name("from_double/batch_sticky");
+}
+
+BOOST_FIXED_POINT_PERF_MAIN()
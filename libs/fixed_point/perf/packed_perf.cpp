@@ -0,0 +1,175 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Measures the conversions between packed arrays of 2^20 numbers and arrays of their type. The counter elements
+// reports the numbers per second and the counter bytes_per_element the size of the storage.
+//
+// Groups:
+// - unpack_12, pack_12: real_t<4,-7>, 12 digits stored on an int16.
+// - unpack_20, pack_20: real_t<9,-10>, 20 digits stored on an int32.
+//
+// Variants:
+// - baseline: the copy of an array of the numbers, as std::vector<T> stores them.
+// - proxy: the loop on the elements of the packed array, read or assigned through its proxies.
+// - none, avx2, avx512: batch::unpack or batch::pack restricted to an instruction set. avx512 uses AVX-512 VBMI
+//   when the processor supports it, and AVX2 otherwise.
+
+#include <boost/fixed_point/packed.hpp>
+#include "perf_harness.hpp"
+#include <boost/cstdint.hpp>
+#include <string>
+#include <vector>
+
+using namespace boost::fixed_point;
+using boost::fixed_point::perf::random_indices;
+
+namespace
+{
+  typedef real_t<4, -7> q12;
+  typedef real_t<9, -10> q20;
+  const std::size_t size = 1 << 20;
+
+  template <typename T>
+  std::vector<T> random_numbers(unsigned long long seed)
+  {
+    std::vector<boost::int64_t> idx = random_indices<boost::int64_t>(size, T::min_index, T::max_index, seed);
+    std::vector<T> res;
+    for (std::size_t i = 0; i < size; ++i)
+      res.push_back(T(index(typename T::underlying_type(idx[i]))));
+    return res;
+  }
+
+  void set_counters(benchmark::State& state, double bytes)
+  {
+    state.counters["elements"] = benchmark::Counter(double(size), benchmark::Counter::kIsIterationInvariantRate);
+    state.counters["bytes_per_element"] = bytes;
+  }
+
+  // Restricts the batch operations to the instruction set of the variant during a benchmark.
+  struct scoped_level
+  {
+    simd::level prev;
+    scoped_level(benchmark::State& state, simd::level l) :
+      prev(simd::restrict_to(l))
+    {
+      if (simd::active() != l) state.SkipWithError("instruction set not supported");
+    }
+    ~scoped_level()
+    {
+      simd::restrict_to(prev);
+    }
+  };
+
+  const char* level_name(simd::level l)
+  {
+    switch (l)
+    {
+    case simd::sse4: return "sse4";
+    case simd::avx2: return "avx2";
+    case simd::avx512: return "avx512";
+    default: return "none";
+    }
+  }
+
+  template <typename T>
+  void copy_baseline(benchmark::State& state)
+  {
+    std::vector<T> x = random_numbers<T>(1), r(size, T(index(0)));
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < size; ++i)
+        r[i] = x[i];
+      benchmark::DoNotOptimize(r.data());
+      benchmark::ClobberMemory();
+    }
+    set_counters(state, double(sizeof(T)));
+  }
+
+  template <typename T>
+  void unpack_proxy(benchmark::State& state)
+  {
+    std::vector<T> x = random_numbers<T>(1), r(size, T(index(0)));
+    packed_array<T> a(&x[0], &x[0] + size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < size; ++i)
+        r[i] = a[i];
+      benchmark::DoNotOptimize(r.data());
+      benchmark::ClobberMemory();
+    }
+    set_counters(state, double(a.storage_size()) / size);
+  }
+
+  template <typename T>
+  void pack_proxy(benchmark::State& state)
+  {
+    std::vector<T> x = random_numbers<T>(1);
+    packed_array<T> a(size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < size; ++i)
+        a[i] = x[i];
+      benchmark::DoNotOptimize(a.data());
+      benchmark::ClobberMemory();
+    }
+    set_counters(state, double(a.storage_size()) / size);
+  }
+
+  template <typename T>
+  void unpack_batch(benchmark::State& state, simd::level l)
+  {
+    scoped_level level(state, l);
+    std::vector<T> x = random_numbers<T>(1), r(size, T(index(0)));
+    packed_array<T> a(&x[0], &x[0] + size);
+    for (auto _ : state)
+    {
+      batch::unpack(a, 0, &r[0], size);
+      benchmark::DoNotOptimize(r.data());
+      benchmark::ClobberMemory();
+    }
+    set_counters(state, double(a.storage_size()) / size);
+  }
+
+  template <typename T>
+  void pack_batch(benchmark::State& state, simd::level l)
+  {
+    scoped_level level(state, l);
+    std::vector<T> x = random_numbers<T>(1);
+    packed_array<T> a(size);
+    for (auto _ : state)
+    {
+      batch::pack(&x[0], a, 0, size);
+      benchmark::DoNotOptimize(a.data());
+      benchmark::ClobberMemory();
+    }
+    set_counters(state, double(a.storage_size()) / size);
+  }
+
+  int register_benchmarks()
+  {
+    benchmark::RegisterBenchmark("unpack_12/baseline", copy_baseline<q12>);
+    benchmark::RegisterBenchmark("pack_12/baseline", copy_baseline<q12>);
+    benchmark::RegisterBenchmark("unpack_20/baseline", copy_baseline<q20>);
+    benchmark::RegisterBenchmark("pack_20/baseline", copy_baseline<q20>);
+    benchmark::RegisterBenchmark("unpack_12/proxy", unpack_proxy<q12>);
+    benchmark::RegisterBenchmark("pack_12/proxy", pack_proxy<q12>);
+    benchmark::RegisterBenchmark("unpack_20/proxy", unpack_proxy<q20>);
+    benchmark::RegisterBenchmark("pack_20/proxy", pack_proxy<q20>);
+    const simd::level levels[] = { simd::none, simd::avx2, simd::avx512 };
+    for (simd::level l : levels)
+    {
+      std::string name = level_name(l);
+      benchmark::RegisterBenchmark(("unpack_12/" + name).c_str(), unpack_batch<q12>, l);
+      benchmark::RegisterBenchmark(("pack_12/" + name).c_str(), pack_batch<q12>, l);
+      benchmark::RegisterBenchmark(("unpack_20/" + name).c_str(), unpack_batch<q20>, l);
+      benchmark::RegisterBenchmark(("pack_20/" + name).c_str(), pack_batch<q20>, l);
+    }
+    return 0;
+  }
+
+  const int registered = register_benchmarks();
+}
+
+BOOST_FIXED_POINT_PERF_MAIN()
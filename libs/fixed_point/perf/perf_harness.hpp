@@ -0,0 +1,143 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Common harness for the Boost.FixedPoint performance programs.
+//
+// Every benchmark is registered as <c>group/variant[/args]</c>. The variant named @c baseline is the hand written
+// integer code the library must not be slower than. Once all the benchmarks have run, a table with the ratio
+// <c>variant time / baseline time</c> is reported for each group, so that a regression shows up as a ratio growing
+// above 1. The time is the CPU time of the main thread, or the real time for the benchmarks registered with
+// UseRealTime(), as the multithreaded ones are.
+
+#ifndef BOOST_FIXED_POINT_PERF_HARNESS_HPP
+#define BOOST_FIXED_POINT_PERF_HARNESS_HPP
+
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace boost
+{
+  namespace fixed_point
+  {
+    namespace perf
+    {
+      //! Name of the reference variant of each group.
+      inline const char* baseline_name()
+      {
+        return "baseline";
+      }
+
+      /**
+       * Console reporter that, in addition to the usual report, collects the CPU time of each run and prints the
+       * ratio of every variant with respect to the baseline variant of the same group.
+       */
+      class ratio_reporter: public benchmark::ConsoleReporter
+      {
+      public:
+        void ReportRuns(const std::vector<Run>& runs)
+        {
+          benchmark::ConsoleReporter::ReportRuns(runs);
+          for (std::size_t i = 0; i < runs.size(); ++i)
+          {
+            if (runs[i].error_occurred || runs[i].run_type != Run::RT_Iteration) continue;
+            std::string group;
+            std::string variant;
+            split(runs[i].benchmark_name(), group, variant);
+            if (times_.find(group) == times_.end()) groups_.push_back(group);
+            times_[group][variant] = real_time(runs[i].benchmark_name()) ? runs[i].GetAdjustedRealTime()
+                : runs[i].GetAdjustedCPUTime();
+          }
+        }
+
+        void Finalize()
+        {
+          benchmark::ConsoleReporter::Finalize();
+          std::printf("\n%-48s %-24s %10s\n", "group", "variant", "ratio");
+          for (std::size_t i = 0; i < groups_.size(); ++i)
+          {
+            std::map<std::string, double> const& variants = times_[groups_[i]];
+            std::map<std::string, double>::const_iterator base = variants.find(baseline_name());
+            if (base == variants.end() || base->second <= 0) continue;
+            for (std::map<std::string, double>::const_iterator it = variants.begin(); it != variants.end(); ++it)
+            {
+              if (it == base) continue;
+              std::printf("%-48s %-24s %10.3f\n", groups_[i].c_str(), it->first.c_str(), it->second / base->second);
+            }
+          }
+        }
+
+      private:
+        // Google Benchmark appends "/real_time" to the names of the benchmarks measured on the real time.
+        static bool real_time(std::string const& name)
+        {
+          std::string const suffix = "/real_time";
+          return name.size() >= suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+        }
+
+        // "group/variant/args..." -> ("group/args...", "variant")
+        static void split(std::string const& name, std::string& group, std::string& variant)
+        {
+          std::string::size_type first = name.find('/');
+          if (first == std::string::npos)
+          {
+            group = name;
+            variant = baseline_name();
+            return;
+          }
+          std::string::size_type second = name.find('/', first + 1);
+          group = name.substr(0, first);
+          variant = name.substr(first + 1, second == std::string::npos ? std::string::npos : second - first - 1);
+          if (second != std::string::npos) group += name.substr(second);
+        }
+
+        std::vector<std::string> groups_;
+        std::map<std::string, std::map<std::string, double> > times_;
+      };
+
+      /**
+       * Deterministic sequence of @c n integers uniformly spread on <c>[lo, hi]</c>, so that every variant of a
+       * group sees the same input.
+       */
+      template <typename T>
+      std::vector<T> random_indices(std::size_t n, long long lo, long long hi, unsigned long long seed = 12345)
+      {
+        std::vector<T> res(n);
+        unsigned long long const width = (unsigned long long)(hi - lo) + 1;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+          seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+          res[i] = T(lo + (long long)((seed >> 11) % width));
+        }
+        return res;
+      }
+
+      /**
+       * Runs all the registered benchmarks with the ratio reporter.
+       */
+      inline int run_benchmarks(int argc, char** argv)
+      {
+        benchmark::Initialize(&argc, argv);
+        if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+        ratio_reporter reporter;
+        benchmark::RunSpecifiedBenchmarks(&reporter);
+        benchmark::Shutdown();
+        return 0;
+      }
+    }
+  }
+}
+
+//! Defines the main function of a performance program.
+#define BOOST_FIXED_POINT_PERF_MAIN() \
+  int main(int argc, char** argv) \
+  { \
+    return ::boost::fixed_point::perf::run_benchmarks(argc, argv); \
+  }
+
+#endif
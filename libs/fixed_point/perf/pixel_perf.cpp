@@ -0,0 +1,247 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Measures the stages of a pixel pipeline on a 3840x2160 frame of 8 bits channels. The counter pixels reports the
+// pixels per second.
+//
+// Groups:
+// - blend: a frame over another one.
+// - color_matrix: the sepia matrix, with coefficients real_t<3,-12>.
+// - gamma: the decoding of the channels with a gamma of 2.2.
+//
+// Variants:
+// - baseline: hand-written loops over interleaved RGBA pixels, as the blend() of example/ex_xx.cpp: the blend of
+//   straight alpha pixels with a division per channel, the color matrix on integers, and a lookup per channel.
+// - none, sse4, avx2, avx512: the batch functions of pixel.hpp on planes of channels, restricted to an instruction
+//   set. The blend of premultiplied planes needs no division.
+
+#include <boost/fixed_point/pixel.hpp>
+#include "perf_harness.hpp"
+#include <boost/cstdint.hpp>
+#include <string>
+#include <vector>
+
+using namespace boost::fixed_point;
+using boost::fixed_point::perf::random_indices;
+
+namespace
+{
+  typedef ureal_t<8, 0> channel;
+  const std::size_t frame_size = 3840 * 2160;
+  const double sepia[3][4] = { { 0.393, 0.769, 0.189, 0 }, { 0.349, 0.686, 0.168, 0 }, { 0.272, 0.534, 0.131, 0 } };
+
+  struct pixel
+  {
+    boost::uint8_t r, g, b, a;
+  };
+
+  std::vector<channel> random_plane(unsigned long long seed)
+  {
+    std::vector<boost::int64_t> idx = random_indices<boost::int64_t>(frame_size, 0, 255, seed);
+    std::vector<channel> res;
+    res.reserve(frame_size);
+    for (std::size_t i = 0; i < frame_size; ++i)
+      res.push_back(channel(index(boost::uint8_t(idx[i]))));
+    return res;
+  }
+
+  std::vector<pixel> random_pixels(unsigned long long seed)
+  {
+    std::vector<channel> p[4];
+    for (std::size_t c = 0; c < 4; ++c)
+      p[c] = random_plane(seed + c);
+    std::vector<pixel> res(frame_size);
+    for (std::size_t i = 0; i < frame_size; ++i)
+    {
+      pixel x = { p[0][i].count(), p[1][i].count(), p[2][i].count(), p[3][i].count() };
+      res[i] = x;
+    }
+    return res;
+  }
+
+  void set_counters(benchmark::State& state)
+  {
+    state.counters["pixels"] = benchmark::Counter(double(frame_size), benchmark::Counter::kIsIterationInvariantRate);
+  }
+
+  // Restricts the batch operations to the instruction set of the variant during a benchmark.
+  struct scoped_level
+  {
+    simd::level prev;
+    scoped_level(benchmark::State& state, simd::level l) :
+      prev(simd::restrict_to(l))
+    {
+      if (simd::active() != l) state.SkipWithError("instruction set not supported");
+    }
+    ~scoped_level()
+    {
+      simd::restrict_to(prev);
+    }
+  };
+
+  const char* level_name(simd::level l)
+  {
+    switch (l)
+    {
+    case simd::sse4: return "sse4";
+    case simd::avx2: return "avx2";
+    case simd::avx512: return "avx512";
+    default: return "none";
+    }
+  }
+
+  void blend_baseline(benchmark::State& state)
+  {
+    std::vector<pixel> a = random_pixels(1), b = random_pixels(5), c(frame_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < frame_size; ++i)
+      {
+        // c = a over b, on straight alpha channels scaled by 255
+        unsigned aa = a[i].a, ba = (b[i].a * (255 - aa) + 127) / 255, ca = aa + ba;
+        pixel x = { 0, 0, 0, boost::uint8_t(ca) };
+        if (ca != 0)
+        {
+          x.r = boost::uint8_t((a[i].r * aa + b[i].r * ba + ca / 2) / ca);
+          x.g = boost::uint8_t((a[i].g * aa + b[i].g * ba + ca / 2) / ca);
+          x.b = boost::uint8_t((a[i].b * aa + b[i].b * ba + ca / 2) / ca);
+        }
+        c[i] = x;
+      }
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    set_counters(state);
+  }
+
+  void blend_planes(benchmark::State& state, simd::level l)
+  {
+    scoped_level level(state, l);
+    std::vector<channel> a[4], b[4];
+    for (std::size_t c = 0; c < 4; ++c)
+    {
+      a[c] = random_plane(1 + c);
+      b[c] = random_plane(5 + c);
+    }
+    for (std::size_t c = 0; c < 3; ++c)
+      batch::premultiply(&a[c][0], &a[3][0], &a[c][0], frame_size);
+    std::vector<channel> r[4];
+    for (std::size_t c = 0; c < 4; ++c)
+      r[c].resize(frame_size, channel(index(0)));
+    for (auto _ : state)
+    {
+      for (std::size_t c = 0; c < 4; ++c)
+        batch::blend(&a[c][0], &a[3][0], &b[c][0], &r[c][0], frame_size);
+      benchmark::DoNotOptimize(r[0].data());
+      benchmark::ClobberMemory();
+    }
+    set_counters(state);
+  }
+
+  void color_baseline(benchmark::State& state)
+  {
+    std::vector<pixel> a = random_pixels(1), c(frame_size);
+    int m[3][3];
+    for (std::size_t i = 0; i < 3; ++i)
+      for (std::size_t j = 0; j < 3; ++j)
+        m[i][j] = int(sepia[i][j] * 4096 + 0.5);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < frame_size; ++i)
+      {
+        int v[3];
+        for (std::size_t k = 0; k < 3; ++k)
+        {
+          int s = (m[k][0] * a[i].r + m[k][1] * a[i].g + m[k][2] * a[i].b + 2048) >> 12;
+          v[k] = s < 0 ? 0 : s > 255 ? 255 : s;
+        }
+        pixel x = { boost::uint8_t(v[0]), boost::uint8_t(v[1]), boost::uint8_t(v[2]), a[i].a };
+        c[i] = x;
+      }
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    set_counters(state);
+  }
+
+  void color_planes(benchmark::State& state, simd::level l)
+  {
+    scoped_level level(state, l);
+    color_matrix<> m(sepia);
+    std::vector<channel> a[3], r[3];
+    for (std::size_t c = 0; c < 3; ++c)
+    {
+      a[c] = random_plane(1 + c);
+      r[c].resize(frame_size, channel(index(0)));
+    }
+    for (auto _ : state)
+    {
+      batch::color_transform(m, &a[0][0], &a[1][0], &a[2][0], &r[0][0], &r[1][0], &r[2][0], frame_size);
+      benchmark::DoNotOptimize(r[0].data());
+      benchmark::ClobberMemory();
+    }
+    set_counters(state);
+  }
+
+  void gamma_baseline(benchmark::State& state)
+  {
+    std::vector<pixel> a = random_pixels(1), c(frame_size);
+    lookup_table<channel> t = gamma_table<channel>(2.2);
+    boost::uint8_t table[256];
+    for (std::size_t i = 0; i < 256; ++i)
+      table[i] = t.data()[i].count();
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < frame_size; ++i)
+      {
+        pixel x = { table[a[i].r], table[a[i].g], table[a[i].b], a[i].a };
+        c[i] = x;
+      }
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    set_counters(state);
+  }
+
+  void gamma_planes(benchmark::State& state, simd::level l)
+  {
+    scoped_level level(state, l);
+    lookup_table<channel> t = gamma_table<channel>(2.2);
+    std::vector<channel> a[3], r[3];
+    for (std::size_t c = 0; c < 3; ++c)
+    {
+      a[c] = random_plane(1 + c);
+      r[c].resize(frame_size, channel(index(0)));
+    }
+    for (auto _ : state)
+    {
+      for (std::size_t c = 0; c < 3; ++c)
+        batch::lookup(t, &a[c][0], &r[c][0], frame_size);
+      benchmark::DoNotOptimize(r[0].data());
+      benchmark::ClobberMemory();
+    }
+    set_counters(state);
+  }
+
+  int register_benchmarks()
+  {
+    benchmark::RegisterBenchmark("blend/baseline", blend_baseline);
+    benchmark::RegisterBenchmark("color_matrix/baseline", color_baseline);
+    benchmark::RegisterBenchmark("gamma/baseline", gamma_baseline);
+    const simd::level levels[] = { simd::none, simd::sse4, simd::avx2, simd::avx512 };
+    for (simd::level l : levels)
+    {
+      std::string name = level_name(l);
+      benchmark::RegisterBenchmark(("blend/" + name).c_str(), blend_planes, l);
+      benchmark::RegisterBenchmark(("color_matrix/" + name).c_str(), color_planes, l);
+      benchmark::RegisterBenchmark(("gamma/" + name).c_str(), gamma_planes, l);
+    }
+    return 0;
+  }
+
+  const int registered = register_benchmarks();
+}
+
+BOOST_FIXED_POINT_PERF_MAIN()
@@ -0,0 +1,154 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Measures the reductions of boost/fixed_point/reduce.hpp on 2^22 Q15.16 numbers, and their scaling with the number
+// of threads. All the benchmarks are measured on the real time.
+//
+// Groups: sum and dot.
+//
+// Variants:
+// - baseline: the hand written loop on the indices, on a single thread.
+// - sequential: batch::sum and batch::dot.
+// - threads_N: batch::parallel_sum and batch::parallel_dot on N threads, from 1 to the number of hardware threads.
+
+#include <boost/fixed_point/reduce.hpp>
+#include "perf_harness.hpp"
+#include <boost/cstdint.hpp>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace boost::fixed_point;
+using boost::fixed_point::perf::random_indices;
+
+namespace
+{
+  const std::size_t buffer_size = std::size_t(1) << 22;
+
+  typedef real_t<15, -16> q15_16;
+
+  std::vector<q15_16> random_numbers(unsigned long long seed)
+  {
+    std::vector<boost::int32_t> idx = random_indices<boost::int32_t>(buffer_size, q15_16::min_index,
+        q15_16::max_index, seed);
+    std::vector<q15_16> res;
+    res.reserve(buffer_size);
+    for (std::size_t i = 0; i < buffer_size; ++i)
+      res.push_back(q15_16(index(idx[i])));
+    return res;
+  }
+
+  struct sum_op
+  {
+    typedef sum_result<q15_16>::type result_type;
+    static const char* name()
+    {
+      return "sum";
+    }
+    static result_type baseline(std::vector<q15_16> const& a, std::vector<q15_16> const&)
+    {
+      boost::int64_t acc = 0;
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        acc += a[i].count();
+      return result_type(index(acc));
+    }
+    static result_type sequential(std::vector<q15_16> const& a, std::vector<q15_16> const&)
+    {
+      return batch::sum(a.data(), buffer_size);
+    }
+    static result_type parallel(std::vector<q15_16> const& a, std::vector<q15_16> const&, unsigned threads)
+    {
+      return batch::parallel_sum(a.data(), buffer_size, threads);
+    }
+  };
+
+  struct dot_op
+  {
+    typedef dot_result<q15_16>::type result_type;
+    static const char* name()
+    {
+      return "dot";
+    }
+    static result_type baseline(std::vector<q15_16> const& a, std::vector<q15_16> const& b)
+    {
+      result_type::underlying_type acc = 0;
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        acc += boost::int64_t(a[i].count()) * b[i].count();
+      return result_type(index(acc));
+    }
+    static result_type sequential(std::vector<q15_16> const& a, std::vector<q15_16> const& b)
+    {
+      return batch::dot(a.data(), b.data(), buffer_size);
+    }
+    static result_type parallel(std::vector<q15_16> const& a, std::vector<q15_16> const& b, unsigned threads)
+    {
+      return batch::parallel_dot(a.data(), b.data(), buffer_size, threads);
+    }
+  };
+
+  template <typename Op>
+  void reduce_baseline(benchmark::State& state)
+  {
+    std::vector<q15_16> a = random_numbers(1);
+    std::vector<q15_16> b = random_numbers(2);
+    for (auto _ : state)
+    {
+      typename Op::result_type r = Op::baseline(a, b);
+      benchmark::DoNotOptimize(r);
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  template <typename Op>
+  void reduce_sequential(benchmark::State& state)
+  {
+    std::vector<q15_16> a = random_numbers(1);
+    std::vector<q15_16> b = random_numbers(2);
+    for (auto _ : state)
+    {
+      typename Op::result_type r = Op::sequential(a, b);
+      benchmark::DoNotOptimize(r);
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  template <typename Op>
+  void reduce_parallel(benchmark::State& state, unsigned threads)
+  {
+    std::vector<q15_16> a = random_numbers(1);
+    std::vector<q15_16> b = random_numbers(2);
+    for (auto _ : state)
+    {
+      typename Op::result_type r = Op::parallel(a, b, threads);
+      benchmark::DoNotOptimize(r);
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  template <typename Op>
+  int register_group()
+  {
+    std::string group = Op::name();
+    benchmark::RegisterBenchmark((group + "/baseline").c_str(), reduce_baseline<Op>)->UseRealTime();
+    benchmark::RegisterBenchmark((group + "/sequential").c_str(), reduce_sequential<Op>)->UseRealTime();
+    // 1, 2, 4... and the number of hardware threads
+    unsigned hardware = std::thread::hardware_concurrency();
+    for (unsigned threads = 1; threads == 1 || threads < 2 * hardware; threads *= 2)
+    {
+      unsigned n = (threads > hardware && hardware != 0) ? hardware : threads;
+      std::ostringstream variant;
+      variant << group << "/threads_" << n;
+      benchmark::RegisterBenchmark(variant.str().c_str(), reduce_parallel<Op>, n)->UseRealTime();
+      if (n == hardware)
+        break;
+    }
+    return 0;
+  }
+  const int sum_group = register_group<sum_op>();
+  const int dot_group = register_group<dot_op>();
+}
+
+BOOST_FIXED_POINT_PERF_MAIN()
@@ -0,0 +1,102 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Measures the cost of the rounding policies with respect to round::truncated (variant baseline), which is the
+// cheapest correct rounding for signed values.
+//
+// Groups:
+// - requantize: Q30.32 products back to Q15.16 with number_cast.
+// - divide: Q15.16 quotients with divide<Res>.
+
+#include <boost/fixed_point/number.hpp>
+#include "perf_harness.hpp"
+#include <boost/cstdint.hpp>
+#include <vector>
+
+using namespace boost::fixed_point;
+using boost::fixed_point::perf::random_indices;
+
+namespace
+{
+  const std::size_t buffer_size = 1024;
+
+  // Indices of Q15.16 values in ]-128, 128[, so that products and quotients fit back in a Q15.16.
+  const long long small_index = (1LL << 23) - 1;
+
+  template <typename RP>
+  struct q15_16
+  {
+    typedef real_t<15, -16, RP, overflow::undefined> type;
+  };
+
+  template <typename T>
+  std::vector<T> random_fxp(std::size_t n, long long lo, long long hi, unsigned long long seed)
+  {
+    std::vector<boost::int32_t> idx = random_indices<boost::int32_t>(n, lo, hi, seed);
+    std::vector<T> res;
+    res.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+      res.push_back(T(index(idx[i])));
+    return res;
+  }
+
+  template <typename RP>
+  void requantize(benchmark::State& state)
+  {
+    typedef typename q15_16<RP>::type T;
+    typedef typename multiply_result<T>::type PT;
+    std::vector<T> a = random_fxp<T>(buffer_size, -small_index, small_index, 1);
+    std::vector<T> b = random_fxp<T>(buffer_size, -small_index, small_index, 2);
+    std::vector<PT> p;
+    p.reserve(buffer_size);
+    for (std::size_t i = 0; i < buffer_size; ++i)
+      p.push_back(a[i] * b[i]);
+    std::vector<T> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = number_cast<T>(p[i]);
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  template <typename RP>
+  void quotient(benchmark::State& state)
+  {
+    typedef typename q15_16<RP>::type T;
+    std::vector<T> a = random_fxp<T>(buffer_size, -small_index, small_index, 1);
+    std::vector<boost::int32_t> d = random_indices<boost::int32_t>(buffer_size, 1LL << 16, 1LL << 20, 54321);
+    std::vector<T> b;
+    b.reserve(buffer_size);
+    for (std::size_t i = 0; i < buffer_size; ++i)
+      b.push_back(T(index((i & 1) ? -d[i] : d[i])));
+    std::vector<T> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = divide<T>(a[i], b[i]);
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+#define BOOST_FIXED_POINT_PERF_ROUND(RP) \
+  BENCHMARK_TEMPLATE(requantize, round::RP)->Name("requantize/" #RP); \
+  BENCHMARK_TEMPLATE(quotient, round::RP)->Name("divide/" #RP)
+
+  BENCHMARK_TEMPLATE(requantize, round::truncated)->Name("requantize/baseline");
+  BENCHMARK_TEMPLATE(quotient, round::truncated)->Name("divide/baseline");
+  BOOST_FIXED_POINT_PERF_ROUND(negative);
+  BOOST_FIXED_POINT_PERF_ROUND(positive);
+  BOOST_FIXED_POINT_PERF_ROUND(nearest_half_up);
+  BOOST_FIXED_POINT_PERF_ROUND(nearest_half_down);
+  BOOST_FIXED_POINT_PERF_ROUND(nearest_even);
+  BOOST_FIXED_POINT_PERF_ROUND(nearest_odd);
+}
+
+BOOST_FIXED_POINT_PERF_MAIN()
@@ -0,0 +1,162 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Measures the trigonometric functions of boost/fixed_point/trigonometric.hpp, per sample.
+//
+// Groups:
+// - sincos: the sine and the cosine in Q1.30 of a 32 bit phase accumulator, as a NCO does.
+// - atan2: the phase on 28 bits of vectors of Q15.16, as a phase detector does.
+//
+// Variants:
+// - baseline: the round trip through double, as_double(), std::sin and std::cos or std::atan2, and the conversion
+//   of the doubles to the result type.
+// - table: the interpolated tables, the default method.
+// - cordic: CORDIC.
+
+#include <boost/fixed_point/trigonometric.hpp>
+#include "perf_harness.hpp"
+#include <boost/cstdint.hpp>
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace boost::fixed_point;
+using boost::fixed_point::perf::random_indices;
+
+namespace
+{
+  const std::size_t buffer_size = 1024;
+  const double two_pi = 6.283185307179586476925286766559;
+
+  typedef ureal_t<0, -32, round::truncated, overflow::modulus> phase_t;
+  typedef real_t<1, -30> sample_t;
+  typedef ureal_t<0, -28, round::truncated, overflow::modulus> angle_t;
+  typedef real_t<15, -16> q15_16;
+
+  struct sincos_op
+  {
+    static const char* name()
+    {
+      return "sincos";
+    }
+    struct arguments
+    {
+      std::vector<phase_t> phases;
+      arguments()
+      {
+        std::vector<boost::uint32_t> idx = random_indices<boost::uint32_t>(buffer_size, 0, phase_t::max_index, 1);
+        for (std::size_t i = 0; i < buffer_size; ++i)
+          phases.push_back(phase_t(index(idx[i])));
+      }
+    };
+    struct results
+    {
+      std::vector<sample_t> s;
+      std::vector<sample_t> c;
+      results() :
+        s(buffer_size), c(buffer_size)
+      {
+      }
+    };
+    static void baseline(arguments const& a, results& r, std::size_t i)
+    {
+      double x = two_pi * a.phases[i].as_double();
+      r.s[i] = sample_t(std::sin(x));
+      r.c[i] = sample_t(std::cos(x));
+    }
+    template <typename Method>
+    static void apply(arguments const& a, results& r, std::size_t i)
+    {
+      sincos<Method>(a.phases[i], r.s[i], r.c[i]);
+    }
+  };
+
+  struct atan2_op
+  {
+    static const char* name()
+    {
+      return "atan2";
+    }
+    struct arguments
+    {
+      std::vector<q15_16> y;
+      std::vector<q15_16> x;
+      arguments()
+      {
+        std::vector<boost::int32_t> yi = random_indices<boost::int32_t>(buffer_size, q15_16::min_index,
+            q15_16::max_index, 1);
+        std::vector<boost::int32_t> xi = random_indices<boost::int32_t>(buffer_size, q15_16::min_index,
+            q15_16::max_index, 2);
+        for (std::size_t i = 0; i < buffer_size; ++i)
+        {
+          y.push_back(q15_16(index(yi[i])));
+          x.push_back(q15_16(index(xi[i])));
+        }
+      }
+    };
+    struct results
+    {
+      std::vector<angle_t> a;
+      results() :
+        a(buffer_size)
+      {
+      }
+    };
+    static void baseline(arguments const& a, results& r, std::size_t i)
+    {
+      double t = std::atan2(a.y[i].as_double(), a.x[i].as_double()) / two_pi;
+      r.a[i] = angle_t(t < 0 ? t + 1 : t);
+    }
+    template <typename Method>
+    static void apply(arguments const& a, results& r, std::size_t i)
+    {
+      r.a[i] = atan2<angle_t, Method>(a.y[i], a.x[i]);
+    }
+  };
+
+  template <typename Op>
+  void trigonometric_baseline(benchmark::State& state)
+  {
+    typename Op::arguments a;
+    typename Op::results r;
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        Op::baseline(a, r, i);
+      benchmark::DoNotOptimize(&r);
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  template <typename Op, typename Method>
+  void trigonometric_method(benchmark::State& state)
+  {
+    typename Op::arguments a;
+    typename Op::results r;
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        Op::template apply<Method>(a, r, i);
+      benchmark::DoNotOptimize(&r);
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+
+  template <typename Op>
+  int register_group()
+  {
+    std::string group = Op::name();
+    benchmark::RegisterBenchmark((group + "/baseline").c_str(), trigonometric_baseline<Op>);
+    benchmark::RegisterBenchmark((group + "/table").c_str(), trigonometric_method<Op, trigonometric::table>);
+    benchmark::RegisterBenchmark((group + "/cordic").c_str(), trigonometric_method<Op, trigonometric::cordic>);
+    return 0;
+  }
+  const int sincos_group = register_group<sincos_op>();
+  const int atan2_group = register_group<atan2_op>();
+}
+
+BOOST_FIXED_POINT_PERF_MAIN()
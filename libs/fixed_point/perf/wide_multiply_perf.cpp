@@ -0,0 +1,94 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Measures the Q31.32 x Q31.32 product brought back to Q31.32, whose intermediate result needs 128 bits.
+//
+// Variants:
+// - baseline: hand written __int128 multiply and shift.
+// - real_t: number_cast<Q31.32>(a * b), where a * b is stored on a 128 bits integer.
+// - double: the round-trip through double that was the only option when multiply_result was limited to 64 bits.
+
+#include <boost/fixed_point/number.hpp>
+#include "perf_harness.hpp"
+#include <boost/cstdint.hpp>
+#include <cmath>
+#include <vector>
+
+using namespace boost::fixed_point;
+using boost::fixed_point::perf::random_indices;
+
+#if defined(BOOST_HAS_INT128)
+
+namespace
+{
+  const std::size_t buffer_size = 1024;
+
+  typedef real_t<31, -32, round::negative, overflow::undefined> q31_32;
+
+  // Indices of Q31.32 values in ]-2^15, 2^15[, so that the products fit back in a Q31.32.
+  const long long small_index = (1LL << 47) - 1;
+
+  std::vector<q31_32> random_q31_32(unsigned long long seed)
+  {
+    std::vector<boost::int64_t> idx = random_indices<boost::int64_t>(buffer_size, -small_index, small_index, seed);
+    std::vector<q31_32> res;
+    res.reserve(buffer_size);
+    for (std::size_t i = 0; i < buffer_size; ++i)
+      res.push_back(q31_32(index(idx[i])));
+    return res;
+  }
+
+  void multiply_baseline(benchmark::State& state)
+  {
+    std::vector<boost::int64_t> a = random_indices<boost::int64_t>(buffer_size, -small_index, small_index, 1);
+    std::vector<boost::int64_t> b = random_indices<boost::int64_t>(buffer_size, -small_index, small_index, 2);
+    std::vector<boost::int64_t> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = boost::int64_t((boost::int128_type(a[i]) * b[i]) >> 32);
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+  BENCHMARK(multiply_baseline)->Name("multiply.q31_32/baseline");
+
+  void multiply_real_t(benchmark::State& state)
+  {
+    std::vector<q31_32> a = random_q31_32(1);
+    std::vector<q31_32> b = random_q31_32(2);
+    std::vector<q31_32> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = number_cast<q31_32>(a[i] * b[i]);
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+  BENCHMARK(multiply_real_t)->Name("multiply.q31_32/real_t");
+
+  void multiply_double(benchmark::State& state)
+  {
+    std::vector<q31_32> a = random_q31_32(1);
+    std::vector<q31_32> b = random_q31_32(2);
+    std::vector<q31_32> c(buffer_size);
+    for (auto _ : state)
+    {
+      for (std::size_t i = 0; i < buffer_size; ++i)
+        c[i] = q31_32(index(boost::int64_t(std::floor(std::ldexp(a[i].as_double() * b[i].as_double(), 32)))));
+      benchmark::DoNotOptimize(c.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+  }
+  BENCHMARK(multiply_double)->Name("multiply.q31_32/double");
+}
+
+#endif
+
+BOOST_FIXED_POINT_PERF_MAIN()
@@ -0,0 +1,95 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <iostream>
+#include <boost/fixed_point/accumulator.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/detail/lightweight_test.hpp>
+#include "random.hpp"
+
+using namespace boost::fixed_point;
+
+typedef real_t<7, -8> T;
+typedef multiply_result<T>::type P;
+
+BOOST_STATIC_ASSERT((boost::is_same<P, real_t<14, -16> >::value));
+BOOST_STATIC_ASSERT((boost::is_same<accumulator<P>::value_type, real_t<46, -16> >::value));
+BOOST_STATIC_ASSERT((boost::is_same<accumulator<P, 10>::value_type, real_t<24, -16> >::value));
+BOOST_STATIC_ASSERT((boost::is_same<accumulator<ureal_t<8, -8>, 4>::value_type, ureal_t<12, -8> >::value));
+
+int main()
+{
+  // the multiply-accumulate is exact
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    unsigned long long state = 1;
+    accumulator<P> acc;
+    long long expected = 0;
+    for (int i = 0; i < 100000; ++i)
+    {
+      // the extreme values, whose running sums overflow P
+      long long a = (i % 3 == 0) ? T::max_index : test::random_index(state, -T::max_index, T::max_index);
+      long long b = (i % 3 == 0) ? T::max_index : test::random_index(state, -T::max_index, T::max_index);
+      acc += T(index(a)) * T(index(b));
+      expected += a * b;
+      BOOST_TEST(acc.count() == expected);
+    }
+    BOOST_TEST(acc.value().count() == expected);
+    acc.clear();
+    BOOST_TEST(acc.count() == 0);
+  }
+  // the products of Q15.16 are summed on 128 bits
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    typedef real_t<15, -16> Q;
+    accumulator<multiply_result<Q>::type> acc;
+    Q max( (index(Q::max_index)));
+    for (int i = 0; i < 1000; ++i)
+      acc += max * max;
+    for (int i = 0; i < 999; ++i)
+      acc -= max * max;
+    BOOST_TEST( (acc.value() == max * max));
+    // (2^31 - 1)^2 / 2^16 = 2^46 - 2^16 + 2^-16
+    BOOST_TEST( (acc.get<real_t<31, -16, round::nearest_even> >().count() == (1LL << 46) - (1LL << 16)));
+    BOOST_TEST( (acc.get<real_t<31, -16, round::positive> >().count() == (1LL << 46) - (1LL << 16) + 1));
+  }
+  // the terms of coarser types and the partial sums
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    accumulator<P> acc(T(1.5) * T(2.0));
+    acc += T(0.25);
+    acc += ureal_t<4, 0>(3.0);
+    accumulator<P> other;
+    other += T(-0.5) * T(0.5);
+    acc += other;
+    BOOST_TEST( (acc.value() == real_t<46, -16>(6.0)));
+  }
+  // the sum is normalized once with the rounding and the overflow policies of the target
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    accumulator<P> acc;
+    for (int i = 0; i < 3; ++i)
+      acc += T(index(1)) * T(index(43));
+    // 129 / 2^16, or 0.50390625 / 2^8
+    BOOST_TEST( (acc.get<real_t<7, -8, round::negative> >().count() == 0));
+    BOOST_TEST( (acc.get<real_t<7, -8, round::positive> >().count() == 1));
+    BOOST_TEST( (acc.get<real_t<7, -8, round::nearest_even> >().count() == 1));
+    for (int i = 0; i < 1000; ++i)
+      acc += T(100.0) * T(100.0);
+    typedef real_t<7, -8, round::negative, overflow::saturate> S;
+    BOOST_TEST( (acc.get<S>().count() == S::max_index));
+    try
+    {
+      acc.get<real_t<7, -8> >();
+      BOOST_TEST(false);
+    }
+    catch (positive_overflow&)
+    {
+    }
+    BOOST_TEST( (acc.get<real_t<24, -8> >() == real_t<24, -8>(10000000.0)));
+  }
+  return boost::report_errors();
+}
@@ -0,0 +1,155 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <iostream>
+#include <vector>
+#include <boost/fixed_point/batch.hpp>
+#include <boost/detail/lightweight_test.hpp>
+#include "random.hpp"
+
+using namespace boost::fixed_point;
+
+// Pseudo random numbers covering the whole range, the extremes and the ties of the rounding.
+template <typename T>
+std::vector<T> make_numbers(std::size_t n, unsigned long long seed)
+{
+  std::vector<T> res;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    long long v = (long long) (test::next_random(seed) >> 1);
+    switch (i % 5)
+    {
+    case 0:
+      v = (i % 2) ? T::max_index : T::min_index;
+      break;
+    case 1:
+      v = (v >> 40) << 15; // a tie when shifted by 16
+      break;
+    case 2:
+      v = v >> 48;
+      break;
+    default:
+      break;
+    }
+    res.push_back(T(index(test::wrap_index(v, T::min_index, T::max_index))));
+  }
+  return res;
+}
+
+template <typename T>
+void check_add(std::size_t n)
+{
+  typedef typename add_result<T>::type RT;
+  typedef typename batch::detail::subtract_result<T>::type DT;
+  std::vector<T> a = make_numbers<T>(n, 1);
+  std::vector<T> b = make_numbers<T>(n, 2);
+  std::vector<RT> s(n + 1, RT(index(0)));
+  std::vector<DT> d(n + 1, DT(index(0)));
+  batch::add(&a[0], &b[0], &s[0], n);
+  batch::subtract(&a[0], &b[0], &d[0], n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    BOOST_TEST(s[i].count() == (a[i] + b[i]).count());
+    BOOST_TEST(d[i].count() == (a[i] - b[i]).count());
+  }
+  BOOST_TEST(s[n].count() == 0);
+  BOOST_TEST(d[n].count() == 0);
+}
+
+template <typename T>
+void check_multiply(std::size_t n)
+{
+  typedef typename multiply_result<T>::type RT;
+  std::vector<T> a = make_numbers<T>(n, 3);
+  std::vector<T> b = make_numbers<T>(n, 4);
+  std::vector<RT> p(n);
+  batch::multiply(&a[0], &b[0], &p[0], n);
+  for (std::size_t i = 0; i < n; ++i)
+    BOOST_TEST(p[i].count() == (a[i] * b[i]).count());
+}
+
+template <typename To, typename From>
+void check_number_cast(std::size_t n)
+{
+  typedef real_t<To::range_exp, To::resolution_exp, typename To::rounding_type, overflow::saturate> S;
+  std::vector<From> f = make_numbers<From>(n, 5);
+  // keep values that don't overflow, as the batch number_cast stops at the overflows.
+  std::vector<From> g;
+  for (std::size_t i = 0; i < n; ++i)
+    if (number_cast<S>(f[i]).count() != To::max_index && number_cast<S>(f[i]).count() != To::min_index)
+      g.push_back(f[i]);
+    else
+      g.push_back(From(index(f[i].count() >> 20)));
+  std::vector<To> t(n), s(n);
+  batch::number_cast(&g[0], &t[0], n);
+  batch::saturate(&f[0], &s[0], n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    BOOST_TEST(t[i].count() == number_cast<To>(g[i]).count());
+    BOOST_TEST(s[i].count() == number_cast<S>(f[i]).count());
+  }
+}
+
+template <typename To, typename From>
+void check_overflow(std::size_t n, std::size_t at)
+{
+  std::vector<From> f(n, From(index(1)));
+  f[at] = From(index(From::max_index));
+  std::vector<To> t(n);
+  try
+  {
+    batch::number_cast(&f[0], &t[0], n);
+    BOOST_TEST(false);
+  }
+  catch (positive_overflow&)
+  {
+  }
+  for (std::size_t i = 0; i < at; ++i)
+    BOOST_TEST(t[i].count() == number_cast<To>(f[i]).count());
+}
+
+template <typename RP>
+void check_rounding(std::size_t n)
+{
+  check_number_cast<real_t<15, -16, RP, overflow::exception>, real_t<31, -32> >(n);
+  check_number_cast<real_t<15, -16, RP, overflow::impossible>, real_t<31, -32> >(n);
+  check_number_cast<real_t<23, -8, RP, overflow::exception>, real_t<31, -32> >(n);
+  check_number_cast<real_t<3, -4, RP, overflow::exception>, real_t<3, -8> >(n);
+}
+
+void check_all(std::size_t n)
+{
+  check_add<real_t<14, -16> >(n);
+  check_add<real_t<15, -16> >(n);
+  check_add<real_t<3, -4> >(n);
+  check_add<ureal_t<15, -16> >(n);
+  check_multiply<real_t<15, -16> >(n);
+  check_multiply<real_t<7, -8> >(n);
+  check_multiply<ureal_t<15, -16> >(n);
+  check_rounding<round::negative>(n);
+  check_rounding<round::truncated>(n);
+  check_rounding<round::positive>(n);
+  check_rounding<round::nearest_half_up>(n);
+  check_rounding<round::nearest_half_down>(n);
+  check_rounding<round::nearest_even>(n);
+  check_rounding<round::nearest_odd>(n);
+  check_overflow<real_t<15, -16>, real_t<31, -32> >(n, n / 2);
+}
+
+int main()
+{
+  const simd::level levels[] =
+  { simd::none, simd::sse4, simd::avx2, simd::avx512 };
+  for (std::size_t l = 0; l < sizeof(levels) / sizeof(levels[0]); ++l)
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "] level " << levels[l] << std::endl;
+    simd::restrict_to(levels[l]);
+    check_all(1);
+    check_all(7);
+    check_all(1000);
+    check_all(1003);
+  }
+  return boost::report_errors();
+}
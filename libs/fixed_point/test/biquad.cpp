@@ -0,0 +1,185 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include <boost/fixed_point/biquad.hpp>
+#include <boost/detail/lightweight_test.hpp>
+#include "random.hpp"
+
+using namespace boost::fixed_point;
+
+typedef real_t<0, -15, round::nearest_even, overflow::saturate> sample;
+typedef real_t<1, -30> coefficient;
+typedef real_t<3, -28, round::nearest_even, overflow::saturate> state;
+
+const double pi = 3.14159265358979323846;
+
+// A low-pass biquad of cutoff frequency f, relative to the sampling frequency, and quality q.
+biquad_coefficients<coefficient> low_pass(double f, double q)
+{
+  double w = 2 * pi * f;
+  double alpha = std::sin(w) / (2 * q);
+  double a0 = 1 + alpha;
+  biquad_coefficients<coefficient> c;
+  c.b0 = coefficient((1 - std::cos(w)) / 2 / a0);
+  c.b1 = coefficient((1 - std::cos(w)) / a0);
+  c.b2 = c.b0;
+  c.a1 = coefficient(-2 * std::cos(w) / a0);
+  c.a2 = coefficient((1 - alpha) / a0);
+  return c;
+}
+
+// The cascade computed on doubles, with the quantized coefficients.
+std::vector<double> reference(std::vector<biquad_coefficients<coefficient> > const& c, std::vector<sample> const& x)
+{
+  std::vector<double> y;
+  for (std::size_t i = 0; i < x.size(); ++i)
+    y.push_back(x[i].as_double());
+  for (std::size_t s = 0; s < c.size(); ++s)
+  {
+    double x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+    for (std::size_t i = 0; i < y.size(); ++i)
+    {
+      double v = c[s].b0.as_double() * y[i] + c[s].b1.as_double() * x1 + c[s].b2.as_double() * x2
+          - c[s].a1.as_double() * y1 - c[s].a2.as_double() * y2;
+      x2 = x1;
+      x1 = y[i];
+      y2 = y1;
+      y1 = v;
+      y[i] = v;
+    }
+  }
+  return y;
+}
+
+// Pseudo random samples in [-amplitude, amplitude].
+std::vector<sample> noise(std::size_t n, double amplitude, unsigned long long seed)
+{
+  std::vector<sample> res;
+  long long m = (long long) (amplitude * (sample::max_index + 1));
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    res.push_back(sample(index(test::random_index(seed, -m, m))));
+  }
+  return res;
+}
+
+template <typename Filter>
+std::vector<sample> filter_block(Filter& f, std::vector<sample> const& x)
+{
+  std::vector<sample> y(x.size(), sample(index(0)));
+  f.process(&x[0], &y[0], x.size());
+  return y;
+}
+
+template <typename Filter>
+std::vector<sample> filter_each(Filter& f, std::vector<sample> const& x)
+{
+  std::vector<sample> y;
+  for (std::size_t i = 0; i < x.size(); ++i)
+    y.push_back(f(x[i]));
+  return y;
+}
+
+double max_error(std::vector<sample> const& y, std::vector<double> const& ref)
+{
+  double res = 0;
+  for (std::size_t i = 0; i < y.size(); ++i)
+    res = std::max(res, std::fabs(y[i].as_double() - ref[i]));
+  return res;
+}
+
+double rms_error(std::vector<sample> const& y, std::vector<double> const& ref)
+{
+  double res = 0;
+  for (std::size_t i = 0; i < y.size(); ++i)
+    res += (y[i].as_double() - ref[i]) * (y[i].as_double() - ref[i]);
+  return std::sqrt(res / y.size());
+}
+
+bool same(std::vector<sample> const& a, std::vector<sample> const& b)
+{
+  if (a.size() != b.size())
+    return false;
+  for (std::size_t i = 0; i < a.size(); ++i)
+    if (a[i].count() != b[i].count())
+      return false;
+  return true;
+}
+
+// With guard bits in the state, the outputs are within one unit of the samples of the double cascade.
+template <typename Form>
+void test_accuracy()
+{
+  std::vector<biquad_coefficients<coefficient> > c;
+  c.push_back(low_pass(0.1, 0.54));
+  c.push_back(low_pass(0.1, 1.31));
+  std::vector<sample> x = noise(4096, 0.25, 1);
+  std::vector<double> ref = reference(c, x);
+  const double unit = std::ldexp(1.0, sample::resolution_exp);
+
+  biquad_cascade<sample, coefficient, state, Form> f(&c[0], c.size());
+  BOOST_TEST_EQ(f.sections(), 2u);
+  std::vector<sample> y = filter_block(f, x);
+  BOOST_TEST(max_error(y, ref) <= unit);
+
+  // the outputs do not depend on the way the samples are given
+  f.reset();
+  BOOST_TEST(same(filter_each(f, x), y));
+  f.reset();
+  std::vector<sample> z(x.size(), sample(index(0)));
+  f.process(&x[0], &z[0], 1000);
+  f.process(&x[1000], &z[1000], x.size() - 1000);
+  BOOST_TEST(same(z, y));
+}
+
+// Without guard bits, the error feedback reduces the quantization noise of a filter with poles close to 1.
+void test_error_feedback()
+{
+  std::vector<biquad_coefficients<coefficient> > c(1, low_pass(0.01, 0.707));
+  std::vector<sample> x;
+  for (std::size_t i = 0; i < 8192; ++i)
+    x.push_back(sample(0.5 * std::sin(2 * pi * 0.002 * i)));
+  std::vector<double> ref = reference(c, x);
+
+  biquad_cascade<sample, coefficient> f0(&c[0], 1);
+  biquad_cascade<sample, coefficient, iir::default_state<sample>::type, iir::direct_form_1<1> > f1(&c[0], 1);
+  biquad_cascade<sample, coefficient, iir::default_state<sample>::type, iir::direct_form_1<2> > f2(&c[0], 1);
+  double e0 = rms_error(filter_block(f0, x), ref);
+  double e1 = rms_error(filter_block(f1, x), ref);
+  double e2 = rms_error(filter_block(f2, x), ref);
+  BOOST_TEST(e1 < e0);
+  BOOST_TEST(e2 < e0);
+}
+
+// An overflowing filter saturates instead of wrapping.
+template <typename Form>
+void test_saturation()
+{
+  biquad_coefficients<coefficient> c;
+  c.b0 = c.b1 = c.b2 = coefficient(1);
+  c.a1 = coefficient(-1.5);
+  c.a2 = coefficient(0.625);
+  biquad_cascade<sample, coefficient, iir::default_state<sample>::type, Form> f(&c, 1);
+  std::vector<sample> x(64, sample(0.5));
+  std::vector<sample> y = filter_block(f, x);
+  for (std::size_t i = 0; i < y.size(); ++i)
+    BOOST_TEST(y[i].count() >= 0);
+  const long long max_index = sample::max_index;
+  BOOST_TEST_EQ(y.back().count(), max_index);
+}
+
+int main()
+{
+  test_accuracy<iir::direct_form_1<> >();
+  test_accuracy<iir::direct_form_1<2> >();
+  test_accuracy<iir::transposed_direct_form_2>();
+  test_error_feedback();
+  test_saturation<iir::direct_form_1<> >();
+  test_saturation<iir::transposed_direct_form_2>();
+  return boost::report_errors();
+}
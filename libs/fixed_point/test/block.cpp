@@ -0,0 +1,258 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cmath>
+#include <vector>
+#include <boost/fixed_point/block.hpp>
+#include <boost/detail/lightweight_test.hpp>
+#include "random.hpp"
+
+using namespace boost::fixed_point;
+
+typedef real_t<0, -15> q15;
+typedef real_t<0, -31> q31;
+
+// A block of pseudo random mantissas of at most Bits bits, with the exponent e.
+template <typename B>
+B noise(int bits, int e, unsigned long long seed)
+{
+  B res(e);
+  long long m = (1LL << bits) - 1;
+  for (std::size_t i = 0; i < B::size(); ++i)
+  {
+    res.data()[i] = typename B::underlying_type(test::random_index(seed, -m, m));
+  }
+  return res;
+}
+
+// The greatest mantissa has all the digits, unless the block is zero.
+template <typename B>
+bool normalized(B const& b)
+{
+  long long greatest = 0;
+  for (std::size_t i = 0; i < B::size(); ++i)
+    greatest = std::max(greatest, std::abs((long long) b.data()[i]));
+  return greatest == 0 || greatest >= (1LL << (B::digits - 1));
+}
+
+// The greatest error of the elements of b, in units of the last digit of b.
+template <typename B>
+double max_error(B const& b, std::vector<double> const& exact)
+{
+  double res = 0;
+  for (std::size_t i = 0; i < B::size(); ++i)
+    res = std::max(res, std::fabs(b.as_double(i) - exact[i]));
+  return std::ldexp(res, B::digits - b.exponent());
+}
+
+void test_conversions()
+{
+  typedef block_real_t<16> block;
+  BOOST_TEST_EQ(sizeof(block::underlying_type), 2u);
+  std::vector<q15> xs;
+  for (int i = 0; i < 16; ++i)
+    xs.push_back(q15(index(i * 2001 - 16000)));
+  block b;
+  batch::number_cast(&xs[0], b);
+  // the greatest index, 14015, has 14 bits
+  BOOST_TEST_EQ(b.exponent(), -1);
+  std::vector<q15> ys(16, q15(index(0)));
+  batch::number_cast(b, &ys[0]);
+  for (int i = 0; i < 16; ++i)
+  {
+    BOOST_TEST_EQ(ys[i].count(), xs[i].count());
+    BOOST_TEST_EQ(b[i].as_double(), xs[i].as_double());
+    BOOST_TEST_EQ(number_cast<q15>(b[i]).count(), xs[i].count());
+  }
+
+  // small numbers keep 15 digits
+  std::vector<q31> zs;
+  for (int i = 0; i < 16; ++i)
+    zs.push_back(q31(index(i * 1234567 - 5000000)));
+  batch::number_cast(&zs[0], b);
+  BOOST_TEST(normalized(b));
+  // the greatest index, 13518505, has 24 bits
+  BOOST_TEST_EQ(b.exponent(), -7);
+  std::vector<double> exact;
+  for (int i = 0; i < 16; ++i)
+    exact.push_back(zs[i].as_double());
+  BOOST_TEST(max_error(b, exact) <= 0.5);
+  std::vector<q31> ws(16, q31(index(0)));
+  batch::number_cast(b, &ws[0]);
+  for (int i = 0; i < 16; ++i)
+    BOOST_TEST(std::abs((long long) ws[i].count() - zs[i].count()) <= 1 << 8);
+
+  // the rounding of 65535 / 2 reaches 2^15, so the indexes are shifted by 2 bits
+  std::vector<real_t<20, 0> > big(16, real_t<20, 0>(index(0)));
+  big[3] = real_t<20, 0>(index(65535));
+  batch::number_cast(&big[0], b);
+  BOOST_TEST_EQ(b.exponent(), 17);
+  BOOST_TEST_EQ(b.data()[3], 16384);
+}
+
+void test_normalize()
+{
+  typedef block_real_t<32, 15, round::truncated> block;
+  block b = noise<block>(9, 4, 1);
+  std::vector<double> before;
+  for (std::size_t i = 0; i < b.size(); ++i)
+    before.push_back(b.as_double(i));
+  b.normalize();
+  BOOST_TEST(normalized(b));
+  BOOST_TEST_EQ(b.exponent(), 4 - 6);
+  for (std::size_t i = 0; i < b.size(); ++i)
+    BOOST_TEST_EQ(b.as_double(i), before[i]);
+  block z(7);
+  z.normalize();
+  BOOST_TEST_EQ(z.exponent(), 7);
+}
+
+// Whether the rounding of -x is the opposite of the rounding of x.
+template <typename RP>
+struct symmetric
+{
+  static const bool value = false;
+};
+template <>
+struct symmetric<round::truncated>
+{
+  static const bool value = true;
+};
+template <>
+struct symmetric<round::nearest_even>
+{
+  static const bool value = true;
+};
+template <>
+struct symmetric<round::nearest_odd>
+{
+  static const bool value = true;
+};
+
+// The sums, differences and products are rounded once from the exact results, within half a unit when rounding to
+// nearest, and within a unit otherwise.
+template <typename B>
+void test_arithmetic(int ea, int eb, int bits)
+{
+  B a = noise<B>(bits, ea, 1), b = noise<B>(B::digits, eb, 2);
+  std::vector<double> sum, difference, opposite, product;
+  for (std::size_t i = 0; i < B::size(); ++i)
+  {
+    // exact when the exponents differ by less than 53 - digits, and within 2^(digits - 53) units otherwise
+    sum.push_back(a.as_double(i) + b.as_double(i));
+    difference.push_back(a.as_double(i) - b.as_double(i));
+    opposite.push_back(b.as_double(i) - a.as_double(i));
+    product.push_back(a.as_double(i) * b.as_double(i));
+  }
+  B s = a + b, d = a - b, p = a * b, r = b - a;
+  BOOST_TEST(normalized(s) && normalized(d) && normalized(p) && normalized(r));
+  double bound = B::rounding_type::round_style == std::round_to_nearest ? 0.5 : 1;
+  BOOST_TEST(max_error(s, sum) <= bound);
+  BOOST_TEST(max_error(d, difference) <= bound);
+  BOOST_TEST(max_error(r, opposite) <= bound);
+  BOOST_TEST(max_error(p, product) <= bound);
+  if (symmetric<typename B::rounding_type>::value)
+  {
+    for (std::size_t i = 0; i < B::size(); ++i)
+      BOOST_TEST_EQ(r.data()[i], -d.data()[i]);
+    BOOST_TEST_EQ(r.exponent(), d.exponent());
+  }
+  // the results can be one of the operands
+  B c = a;
+  c = c + b;
+  BOOST_TEST_EQ(c.exponent(), s.exponent());
+  a = a * b;
+  BOOST_TEST_EQ(a.exponent(), p.exponent());
+  for (std::size_t i = 0; i < B::size(); ++i)
+  {
+    BOOST_TEST_EQ(c.data()[i], s.data()[i]);
+    BOOST_TEST_EQ(a.data()[i], p.data()[i]);
+  }
+}
+
+// Far apart exponents: the smaller block only changes the rounding.
+void test_far()
+{
+  typedef block_real_t<8, 15, round::positive> block;
+  block a = noise<block>(15, 100, 1), b = noise<block>(15, 0, 2);
+  for (std::size_t i = 0; i < 8; ++i)
+    b.data()[i] = 1 + short(i);
+  a.data()[0] = 0;
+  block s = a + b;
+  BOOST_TEST_EQ(s.exponent(), 100);
+  BOOST_TEST_EQ(s.data()[0], 1);
+  for (std::size_t i = 1; i < 8; ++i)
+    BOOST_TEST_EQ(s.data()[i], a.data()[i] + 1);
+  // a zero block of greater exponent
+  block z(200);
+  s = z - b;
+  BOOST_TEST(normalized(s));
+  for (std::size_t i = 0; i < 8; ++i)
+    BOOST_TEST_EQ(s.as_double(i), -b.as_double(i));
+}
+
+// The differences of a block and a block of greater exponent are rounded in the direction of the rounding policy.
+template <typename RP>
+void test_directed(int direction)
+{
+  typedef block_real_t<1, 15, RP> block;
+  block a(0), b(20);
+  a.data()[0] = 1;            // 2^-15
+  b.data()[0] = 1 << 14;      // 2^19
+  block d = a - b, r = b - a;
+  double exact = std::ldexp(1.0, -15) - std::ldexp(1.0, 19);
+  BOOST_TEST(normalized(d) && normalized(r));
+  BOOST_TEST(direction * (d.as_double(0) - exact) > 0);
+  BOOST_TEST(direction * (r.as_double(0) + exact) > 0);
+  BOOST_TEST(max_error(d, std::vector<double>(1, exact)) < 1);
+  BOOST_TEST(max_error(r, std::vector<double>(1, -exact)) < 1);
+}
+
+void test_batch()
+{
+  typedef block_real_t<64> block;
+  std::vector<block> a, b;
+  for (int i = 0; i < 5; ++i)
+  {
+    a.push_back(noise<block>(15 - i, i - 2, i));
+    b.push_back(noise<block>(12 + i, 3 - i, i + 7));
+  }
+  std::vector<block> s(5, block(0)), p(5, block(0));
+  batch::add(&a[0], &b[0], &s[0], 5);
+  batch::multiply(&a[0], &b[0], &p[0], 5);
+  for (int i = 0; i < 5; ++i)
+  {
+    block s1 = a[i] + b[i], p1 = a[i] * b[i];
+    BOOST_TEST_EQ(s[i].exponent(), s1.exponent());
+    BOOST_TEST_EQ(p[i].exponent(), p1.exponent());
+    for (std::size_t j = 0; j < block::size(); ++j)
+    {
+      BOOST_TEST_EQ(s[i].data()[j], s1.data()[j]);
+      BOOST_TEST_EQ(p[i].data()[j], p1.data()[j]);
+    }
+  }
+}
+
+int main()
+{
+  test_conversions();
+  test_normalize();
+  test_arithmetic<block_real_t<64> >(0, 0, 15);
+  test_arithmetic<block_real_t<64> >(3, -5, 11);
+  test_arithmetic<block_real_t<64> >(-5, 3, 15);
+  test_arithmetic<block_real_t<64> >(-20, 20, 15);
+  test_arithmetic<block_real_t<64, 7> >(2, -4, 7);
+  test_arithmetic<block_real_t<64, 7, round::negative> >(2, -4, 7);
+  test_arithmetic<block_real_t<64, 24> >(5, -30, 24);
+  test_arithmetic<block_real_t<64, 30, round::truncated> >(1, 0, 30);
+  test_arithmetic<block_real_t<16, 15> >(60, -10, 15);
+  test_arithmetic<block_real_t<64, 7, round::positive> >(-4, 2, 7);
+  test_arithmetic<block_real_t<64, 15, round::nearest_half_up> >(-20, 20, 15);
+  test_far();
+  test_directed<round::negative>(-1);
+  test_directed<round::positive>(1);
+  test_batch();
+  return boost::report_errors();
+}
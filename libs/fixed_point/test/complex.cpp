@@ -0,0 +1,146 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <iostream>
+#include <vector>
+#include <boost/fixed_point/complex.hpp>
+#include <boost/detail/lightweight_test.hpp>
+#include "random.hpp"
+#include <boost/type_traits/is_same.hpp>
+
+using namespace boost::fixed_point;
+
+typedef real_t<0, -15> q15;
+typedef real_t<3, -12> q12;
+typedef real_t<0, -31> q31;
+
+template <typename T, typename U>
+bool same_type(U const&)
+{
+  return boost::is_same<T, U>::value;
+}
+
+template <typename T>
+std::vector<T> random_numbers(std::size_t n, unsigned long long seed)
+{
+  std::vector<T> res;
+  for (std::size_t i = 0; i < n; ++i)
+    res.push_back(T(index(test::random_index(seed, T::min_index, T::max_index))));
+  // the extreme values
+  res[0] = T(index(T::min_index));
+  res[1] = T(index(T::max_index));
+  return res;
+}
+
+void test_result_types()
+{
+  complex<q15> a(q15(0.5), q15(-0.25));
+  complex<q12> b(q12(2), q12(1.5));
+  BOOST_TEST((same_type<complex<real_t<4, -15> > >(a + b)));
+  BOOST_TEST((same_type<complex<real_t<4, -15> > >(a - b)));
+  BOOST_TEST((same_type<complex<real_t<4, -27> > >(a * b)));
+  BOOST_TEST((same_type<complex<real_t<4, -27> > >(multiply_gauss(a, b))));
+  BOOST_TEST((same_type<real_t<1, -30> >(norm(a))));
+  BOOST_TEST((same_type<complex<q15> >(conj(a))));
+  BOOST_TEST((same_type<complex<q15> >(-a)));
+}
+
+void test_arithmetic()
+{
+  complex<q15> a(q15(0.5), q15(-0.25));
+  complex<q12> b(q12(2), q12(1.5));
+  // (0.5 - 0.25i)(2 + 1.5i) = 1.375 + 0.25i
+  BOOST_TEST_EQ((a * b).real().as_double(), 1.375);
+  BOOST_TEST_EQ((a * b).imag().as_double(), 0.25);
+  BOOST_TEST_EQ((a + b).real().as_double(), 2.5);
+  BOOST_TEST_EQ((a + b).imag().as_double(), 1.25);
+  BOOST_TEST_EQ((a - b).real().as_double(), -1.5);
+  BOOST_TEST_EQ((a - b).imag().as_double(), -1.75);
+  BOOST_TEST_EQ(conj(a).imag().as_double(), 0.25);
+  BOOST_TEST_EQ((-a).real().as_double(), -0.5);
+  BOOST_TEST_EQ(norm(a).as_double(), 0.3125);
+  BOOST_TEST(a == a);
+  BOOST_TEST(a != conj(a));
+  BOOST_TEST(complex<q15>(q15(0.5)) == complex<q15>(q15(0.5), q15(index(0))));
+
+  // compound assignments convert back with the policies of the parts
+  complex<q15> c = a;
+  c *= a;
+  // (0.5 - 0.25i)^2 = 0.1875 - 0.25i
+  BOOST_TEST_EQ(c.real().as_double(), 0.1875);
+  BOOST_TEST_EQ(c.imag().as_double(), -0.25);
+  c += a;
+  BOOST_TEST_EQ(c.real().as_double(), 0.6875);
+  c -= a;
+  BOOST_TEST_EQ(c.real().as_double(), 0.1875);
+  c.real(q15(0.125));
+  c.imag(q15(-0.125));
+  BOOST_TEST_EQ(c.real().as_double(), 0.125);
+  BOOST_TEST_EQ(c.imag().as_double(), -0.125);
+}
+
+void test_number_cast()
+{
+  typedef real_t<0, -2, round::nearest_even, overflow::saturate> q2;
+  complex<q15> a(q15(0.375), q15(-0.625));
+  complex<q2> b = number_cast<complex<q2> >(a);
+  BOOST_TEST_EQ(b.real().as_double(), 0.5);
+  BOOST_TEST_EQ(b.imag().as_double(), -0.5);
+  complex<q2> c = number_cast<complex<q2> >(complex<q12>(q12(3), q12(-3)));
+  BOOST_TEST_EQ(c.real().count(), q2::max_index + 0);
+  BOOST_TEST_EQ(c.imag().count(), q2::min_index + 0);
+}
+
+// The Gauss product is the product, for every pair including the extreme values.
+template <typename T>
+void test_gauss()
+{
+  std::vector<T> re = random_numbers<T>(1000, 1), im = random_numbers<T>(1000, 2);
+  for (std::size_t i = 0; i < re.size(); ++i)
+    for (std::size_t j = 0; j < 4; ++j)
+    {
+      complex<T> a(re[i], im[i]);
+      complex<T> b(re[(i * 7 + j) % re.size()], im[(i * 13 + j) % re.size()]);
+      BOOST_TEST(multiply_gauss(a, b) == a * b);
+    }
+}
+
+// The batch kernels give the products of the complex numbers.
+template <typename T>
+void test_batch()
+{
+  typedef typename multiply_result<complex<T> >::type::value_type part_type;
+  std::size_t n = 257;
+  std::vector<T> ar = random_numbers<T>(n, 1), ai = random_numbers<T>(n, 2);
+  std::vector<T> br = random_numbers<T>(n, 3), bi = random_numbers<T>(n, 4);
+  std::vector<part_type> cr(n, part_type(index(0))), ci(n, part_type(index(0)));
+  std::vector<part_type> gr(n, part_type(index(0))), gi(n, part_type(index(0)));
+  std::vector<part_type> jr(n, part_type(index(0))), ji(n, part_type(index(0)));
+  std::vector<typename norm_result<T>::type> nr(n, typename norm_result<T>::type(index(0)));
+  batch::complex_multiply(&ar[0], &ai[0], &br[0], &bi[0], &cr[0], &ci[0], n);
+  batch::complex_multiply_gauss(&ar[0], &ai[0], &br[0], &bi[0], &gr[0], &gi[0], n);
+  batch::complex_multiply_conj(&ar[0], &ai[0], &br[0], &bi[0], &jr[0], &ji[0], n);
+  batch::norm(&ar[0], &ai[0], &nr[0], n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    complex<T> a(ar[i], ai[i]), b(br[i], bi[i]);
+    BOOST_TEST(complex<part_type>(cr[i], ci[i]) == a * b);
+    BOOST_TEST(complex<part_type>(gr[i], gi[i]) == a * b);
+    BOOST_TEST(complex<part_type>(jr[i], ji[i]) == a * conj(b));
+    BOOST_TEST(nr[i] == norm(a));
+  }
+}
+
+int main()
+{
+  test_result_types();
+  test_arithmetic();
+  test_number_cast();
+  test_gauss<q15>();
+  test_gauss<q31>();
+  test_batch<q15>();
+  test_batch<q31>();
+  return boost::report_errors();
+}
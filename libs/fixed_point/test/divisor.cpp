@@ -0,0 +1,99 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <iostream>
+#include <boost/fixed_point/divisor.hpp>
+#include <boost/detail/lightweight_test.hpp>
+
+using namespace boost::fixed_point;
+
+// Checks that dividing by a divisor gives the same result as dividing by its value for a set of dividends.
+template <typename Res, typename From, typename T>
+void check(T const& d)
+{
+  divisor<T> dv(d);
+  BOOST_TEST(dv.value().count() == d.count());
+  long long const values[] = { 0, 1, -1, 2, -2, 3, -3, 7, -7, 100, -100, 12345, -12345, 32767, -32767,
+      (1LL << 23) - 1, -(1LL << 23) + 1, 98765431, -98765431 };
+  for (std::size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i)
+  {
+    long long v = values[i];
+    if (v > From::max_index || v < From::min_index) continue;
+    // Skip the quotients that overflow Res.
+    long long ad = d.count() < 0 ? -(long long)(d.count()) : (long long)(d.count());
+    if ((((v < 0 ? -v : v) << -Res::resolution_exp) / ad) >= (long long)(Res::max_index)) continue;
+    From n( (index(v)));
+    Res expected = divide<Res>(n, d);
+    Res actual = divide<Res>(n, dv);
+    BOOST_TEST(actual.count() == expected.count());
+  }
+}
+
+template <typename RP>
+void check_rounding()
+{
+  typedef real_t<15, -16> Q;
+  typedef real_t<15, -16, RP> R;
+  long long const divisors[] = { 1, -1, 2, -2, 3, -3, 7, 65536, -65536, 65537, 100000, -123457, (1LL << 31) - 1,
+      -(1LL << 31) + 1 };
+  for (std::size_t i = 0; i < sizeof(divisors) / sizeof(divisors[0]); ++i)
+  {
+    check<R, Q>(Q(index(divisors[i])));
+  }
+  typedef ureal_t<16, -16> UQ;
+  typedef ureal_t<16, -16, RP> UR;
+  for (std::size_t i = 0; i < sizeof(divisors) / sizeof(divisors[0]); ++i)
+  {
+    if (divisors[i] > 0) check<UR, UQ>(UQ(index(divisors[i])));
+  }
+}
+
+int main()
+{
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    real_t<2, -2> n1( (index(-15)));
+    divisor<real_t<2, -2> > n2(real_t<2, -2>(index(7)));
+    real_t<4, -1> n3 = divide<real_t<4, -1, round::negative> > (n1, n2);
+    BOOST_TEST(n3.count() == -5);
+    n3 = divide<real_t<4, -1, round::positive> > (n1, n2);
+    BOOST_TEST(n3.count() == -4);
+    n3 = divide<real_t<4, -1, round::truncated> > (n1, n2);
+    BOOST_TEST(n3.count() == -4);
+  }
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    // A dividend with a coarser resolution than the divisor.
+    real_t<4, 0> n1( (index(5)));
+    divisor<real_t<2, -2> > n2(real_t<2, -2>(index(-3)));
+    BOOST_TEST( (divide<real_t<8, -2, round::nearest_even> > (n1, n2).count()
+        == divide<real_t<8, -2, round::nearest_even> > (n1, n2.value()).count()));
+  }
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    check_rounding<round::negative>();
+    check_rounding<round::truncated>();
+    check_rounding<round::positive>();
+    check_rounding<round::nearest_half_up>();
+    check_rounding<round::nearest_half_down>();
+    check_rounding<round::nearest_even>();
+    check_rounding<round::nearest_odd>();
+  }
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    // The quotient of the unsigned divisor is exact on the whole boost::uintmax_t range.
+    boost::uintmax_t const divisors[] = { 1, 2, 3, 5, 7, 10, 641, 65535, 65536, 4294967295ULL, 4294967297ULL,
+        ~boost::uintmax_t(0) / 3, (~boost::uintmax_t(0) >> 1) + 1, ~boost::uintmax_t(0) };
+    boost::uintmax_t const values[] = { 0, 1, 2, 641, 4294967296ULL, ~boost::uintmax_t(0) / 7,
+        (~boost::uintmax_t(0) >> 1), ~boost::uintmax_t(0) - 1, ~boost::uintmax_t(0) };
+    for (std::size_t i = 0; i < sizeof(divisors) / sizeof(divisors[0]); ++i)
+    {
+      detail::unsigned_divisor d(divisors[i]);
+      for (std::size_t j = 0; j < sizeof(values) / sizeof(values[0]); ++j)
+        BOOST_TEST(d.quotient(values[j]) == values[j] / divisors[i]);
+    }
+  }
+  return boost::report_errors();
+}
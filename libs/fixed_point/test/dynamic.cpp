@@ -0,0 +1,231 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <vector>
+#include <boost/fixed_point/dynamic.hpp>
+#include <boost/detail/lightweight_test.hpp>
+#include "random.hpp"
+
+using namespace boost::fixed_point;
+
+typedef real_t<0, -15> q15;
+typedef real_t<0, -31> q31;
+
+// Pseudo random indexes of T.
+template <typename T>
+std::vector<T> noise(std::size_t n, unsigned long long seed)
+{
+  std::vector<T> res;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    res.push_back(T(index(test::random_index(seed, T::min_index, T::max_index))));
+  }
+  return res;
+}
+
+void test_format()
+{
+  format f(0, -15);
+  BOOST_TEST_EQ(f.digits(), 15);
+  BOOST_TEST_EQ(f.max_index(), 32767);
+  BOOST_TEST_EQ(f.min_index(), -32767);
+  BOOST_TEST(f == format_of<q15>());
+  BOOST_TEST(f != format_of<q31>());
+  BOOST_TEST_EQ(format(63, 0).max_index(), boost::integer_traits<boost::intmax_t>::const_max);
+  BOOST_TEST_EQ(format(3, 3).max_index(), 0);
+}
+
+// The numbers of a static format keep their value and their format.
+void test_exact()
+{
+  q15 x(index(-12345));
+  dynamic_real_t<> d = x;
+  BOOST_TEST_EQ(d.count(), -12345);
+  BOOST_TEST(d.has_format<q15>());
+  BOOST_TEST(!d.has_format<q31>());
+  BOOST_TEST_EQ(d.as_double(), x.as_double());
+  BOOST_TEST_EQ(number_cast<q15>(d).count(), -12345);
+  BOOST_TEST_EQ(number_cast<q31>(d).count(), -12345LL * 65536);
+  BOOST_TEST_EQ(number_cast<dynamic_real_t<> >(x).count(), -12345);
+  ureal_t<4, -4> u(index(200));
+  dynamic_real_t<> du = u;
+  BOOST_TEST(du.get_format() == format(4, -4));
+  BOOST_TEST_EQ((number_cast<ureal_t<4, -4> >(du).count()), 200);
+  BOOST_TEST_EQ(dynamic_real_t<>(0.75, format(2, -3)).count(), 6);
+  BOOST_TEST_EQ(dynamic_real_t<>(-3.5, format(2, -1)).count(), -7);
+}
+
+// number_cast of a dynamic_real_t gives the same number as number_cast of the real_t of the same format.
+template <typename From, typename To>
+void test_cast()
+{
+  std::vector<From> xs = noise<From>(2000, 7);
+  for (std::size_t i = 0; i < xs.size(); ++i)
+  {
+    dynamic_real_t<> d = xs[i];
+    BOOST_TEST_EQ(number_cast<To>(d).count(), number_cast<To>(xs[i]).count());
+  }
+}
+
+template <typename From, typename RP>
+void test_cast_rounding()
+{
+  test_cast<From, real_t<2, -7, RP, overflow::saturate> >();
+  test_cast<From, real_t<0, -4, RP, overflow::saturate> >();
+  test_cast<From, real_t<-2, -9, RP, overflow::saturate> >();
+  test_cast<From, real_t<8, 2, RP, overflow::saturate> >();
+  test_cast<From, ureal_t<-1, -7, RP, overflow::saturate> >();
+  test_cast<From, ureal_t<-3, -8, RP, overflow::modulus> >();
+  // number_cast of a ureal_t to a finer real_t is not checked against the static conversion, which asserts
+  if (From::is_signed)
+  {
+    test_cast<From, real_t<-4, -20, RP, overflow::modulus> >();
+    test_cast<From, real_t<1, -40, RP, overflow::saturate> >();
+  }
+}
+
+template <typename From>
+void test_casts()
+{
+  test_cast_rounding<From, round::negative>();
+  test_cast_rounding<From, round::positive>();
+  test_cast_rounding<From, round::truncated>();
+  test_cast_rounding<From, round::nearest_half_up>();
+  test_cast_rounding<From, round::nearest_half_down>();
+  test_cast_rounding<From, round::nearest_even>();
+  test_cast_rounding<From, round::nearest_odd>();
+}
+
+// The shifts of more than 62 bits keep the rounding.
+void test_large_shifts()
+{
+  typedef dynamic_real_t<round::nearest_even, overflow::saturate> dyn;
+  dyn half(index(boost::intmax_t(1) << 62), format(63, 0));
+  BOOST_TEST_EQ(half.rescale(format(70, 63)).count(), 0);
+  dyn more(index((boost::intmax_t(1) << 62) + 1), format(63, 0));
+  BOOST_TEST_EQ(more.rescale(format(70, 63)).count(), 1);
+  BOOST_TEST_EQ((-more).rescale(format(70, 63)).count(), -1);
+  BOOST_TEST_EQ(more.rescale(format(100, 70)).count(), 0);
+  typedef dynamic_real_t<round::positive, overflow::saturate> up;
+  BOOST_TEST_EQ(up(index(1), format(1, -10)).rescale(format(100, 90)).count(), 1);
+  BOOST_TEST_EQ(up(index(-1), format(1, -10)).rescale(format(100, 90)).count(), 0);
+}
+
+void test_overflow()
+{
+  dynamic_real_t<> d(index(-3000), format(4, -8));
+  BOOST_TEST_THROWS(number_cast<q15>(d), negative_overflow);
+  BOOST_TEST_THROWS(d.rescale(format(2, -8)), negative_overflow);
+  typedef dynamic_real_t<round::negative, overflow::saturate> sat;
+  BOOST_TEST_EQ(sat(index(3000), format(4, -8)).rescale(format(2, -8)).count(), 1023);
+  BOOST_TEST_EQ(sat(index(-3000), format(4, -8)).rescale(format(2, -10)).count(), -4095);
+  BOOST_TEST_EQ(sat(index(5), format(4, -8)).rescale(format(-40, -100)).count(), format(-40, -100).max_index());
+  typedef dynamic_real_t<round::negative, overflow::modulus> mod;
+  // 3000 - 2047 = 953
+  BOOST_TEST_EQ(mod(index(3000), format(4, -8)).rescale(format(2, -8)).count(), 953);
+  BOOST_TEST_EQ(mod(index(-3000), format(4, -8)).rescale(format(2, -8)).count(), -953);
+  typedef dynamic_real_t<round::negative, overflow::sticky<> > sticky;
+  overflow::reset_sticky_status();
+  BOOST_TEST_EQ(sticky(index(3000), format(4, -8)).rescale(format(2, -8)).count(), 1023);
+  BOOST_TEST_EQ(overflow::reset_sticky_status(), unsigned(overflow::positive_overflow_flag));
+  BOOST_TEST_EQ(sticky(index(300), format(4, -8)).rescale(format(2, -8)).count(), 300);
+  BOOST_TEST_EQ(overflow::sticky_status(), unsigned(overflow::no_overflow));
+}
+
+// The conversions to a runtime format give the numbers of the static format.
+void test_rescale()
+{
+  typedef real_t<2, -9, round::nearest_even, overflow::saturate> to_type;
+  typedef dynamic_real_t<round::nearest_even, overflow::saturate> dyn;
+  std::vector<q31> xs = noise<q31>(2000, 3);
+  for (std::size_t i = 0; i < xs.size(); ++i)
+  {
+    dyn d(xs[i], format(2, -9));
+    BOOST_TEST_EQ(d.count(), number_cast<to_type>(xs[i]).count());
+    BOOST_TEST_EQ(dyn(xs[i]).rescale(format(2, -9)).count(), d.count());
+    BOOST_TEST_EQ(dyn(xs[i].as_double(), format(2, -9)).count(), d.count());
+  }
+}
+
+void test_arithmetic()
+{
+  typedef real_t<3, -5> a_type;
+  typedef real_t<1, -9> b_type;
+  std::vector<a_type> as = noise<a_type>(500, 1);
+  std::vector<b_type> bs = noise<b_type>(500, 2);
+  for (std::size_t i = 0; i < as.size(); ++i)
+  {
+    dynamic_real_t<> a = as[i], b = bs[i];
+    dynamic_real_t<> s = a + b, d = a - b, p = a * b;
+    BOOST_TEST((s.has_format<add_result<a_type, b_type>::type>()));
+    BOOST_TEST_EQ(s.count(), (as[i] + bs[i]).count());
+    BOOST_TEST_EQ(d.count(), (as[i] - bs[i]).count());
+    BOOST_TEST((p.has_format<multiply_result<a_type, b_type>::type>()));
+    BOOST_TEST_EQ(p.count(), (as[i] * bs[i]).count());
+    BOOST_TEST_EQ((-a).count(), -as[i].count());
+    BOOST_TEST_EQ(a < b, as[i] < bs[i]);
+    BOOST_TEST_EQ(a == b, as[i] == bs[i]);
+    BOOST_TEST_EQ(b >= a, bs[i] >= as[i]);
+  }
+  dynamic_real_t<> one(index(1), format(1, 0)), tiny(index(1), format(-60, -61));
+  dynamic_real_t<> huge(index(boost::intmax_t(1) << 40), format(41, 0));
+  BOOST_TEST(one == dynamic_real_t<>(index(boost::intmax_t(1) << 61), format(1, -61)));
+  BOOST_TEST(tiny < huge && huge > tiny && -huge < tiny);
+  BOOST_TEST(tiny != one);
+}
+
+// The batch conversions give the results of the scalar ones, on every path.
+template <typename To>
+void test_batch_from(format f)
+{
+  std::vector<boost::int32_t> idx;
+  std::vector<q31> xs = noise<q31>(700, 5);
+  for (std::size_t i = 0; i < xs.size(); ++i)
+    idx.push_back(boost::int32_t(xs[i].count() / (1 << (31 - f.digits()))));
+  std::vector<To> res(idx.size(), To(index(0)));
+  batch::from_dynamic(&idx[0], f, &res[0], idx.size());
+  for (std::size_t i = 0; i < idx.size(); ++i)
+    BOOST_TEST_EQ(res[i].count(), number_cast<To>(dynamic_real_t<>(index(idx[i]), f)).count());
+}
+
+template <typename From>
+void test_batch_to(format f)
+{
+  typedef dynamic_real_t<round::nearest_even, overflow::saturate> dyn;
+  std::vector<From> xs = noise<From>(700, 9);
+  std::vector<boost::int64_t> res(xs.size());
+  batch::to_dynamic<dyn>(&xs[0], f, &res[0], xs.size());
+  for (std::size_t i = 0; i < xs.size(); ++i)
+    BOOST_TEST_EQ(res[i], dyn(xs[i], f).count());
+}
+
+int main()
+{
+  test_format();
+  test_exact();
+  test_casts<q15>();
+  test_casts<q31>();
+  test_casts<real_t<5, -10> >();
+  test_casts<ureal_t<3, -12> >();
+  test_large_shifts();
+  test_overflow();
+  test_rescale();
+  test_arithmetic();
+  test_batch_from<q15>(format(0, -15));
+  test_batch_from<q15>(format(-2, -15));
+  test_batch_from<real_t<0, -15, round::nearest_even, overflow::saturate> >(format(2, -15));
+  test_batch_from<real_t<0, -15, round::nearest_even, overflow::saturate> >(format(0, -20));
+  test_batch_from<real_t<4, -15, round::positive, overflow::saturate> >(format(0, -10));
+  test_batch_from<real_t<0, -15, round::nearest_even, overflow::saturate> >(format(2, -10));
+  test_batch_from<real_t<0, -15, round::nearest_even, overflow::sticky<> > >(format(2, -10));
+  test_batch_from<real_t<0, -15, round::nearest_odd, overflow::modulus> >(format(0, -20));
+  test_batch_from<ureal_t<0, -16, round::nearest_even, overflow::saturate> >(format(0, -15));
+  test_batch_from<ureal_t<0, -32, round::nearest_even, overflow::saturate> >(format(0, -20));
+  test_batch_to<q15>(format(0, -15));
+  test_batch_to<q15>(format(4, -15));
+  test_batch_to<q31>(format(0, -15));
+  test_batch_to<q15>(format(-3, -18));
+  return boost::report_errors();
+}
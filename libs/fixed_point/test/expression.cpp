@@ -0,0 +1,142 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <iostream>
+#include <boost/fixed_point/expression.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/detail/lightweight_test.hpp>
+#include "random.hpp"
+
+using namespace boost::fixed_point;
+
+typedef real_t<7, -8> s8_8;
+typedef ureal_t<8, 0> u8;
+typedef real_t<15, -16> s16_16;
+
+// The value type of the tree is the type of the same expression built by the operators.
+template <typename E, typename T>
+bool same_value_type(E const&, T const&)
+{
+  return boost::is_same<typename E::value_type, T>::value;
+}
+
+// The exact value of the tree.
+template <typename E>
+typename E::value_type exact_value(E const& e)
+{
+  return number_cast<typename E::value_type>(e);
+}
+
+template <typename T>
+T random_number(unsigned long long& state)
+{
+  return T(index(test::random_index(state, T::min_index, T::max_index)));
+}
+
+template <typename Res>
+void check_signed()
+{
+  unsigned long long state = 1;
+  for (int i = 0; i < 10000; ++i)
+  {
+    s8_8 a = random_number<s8_8>(state);
+    s8_8 b = random_number<s8_8>(state);
+    s16_16 c = random_number<s16_16>(state);
+    u8 d = random_number<u8>(state);
+    BOOST_TEST( (number_cast<Res>(lazy(a) * b + c) == number_cast<Res>(a * b + c)));
+    BOOST_TEST( (number_cast<Res>(a * lazy(b) - c * a) == number_cast<Res>(a * b - c * a)));
+    BOOST_TEST( (number_cast<Res>(-(lazy(a) * d) + b * c) == number_cast<Res>(-(a * d) + b * c)));
+    BOOST_TEST( (number_cast<Res>(c - lazy(d) * d * a) == number_cast<Res>(c - d * d * a)));
+    BOOST_TEST( (number_cast<Res>((lazy(a) + b) * (c - d)) == number_cast<Res>((a + b) * (c - d))));
+  }
+}
+
+void check_unsigned()
+{
+  typedef ureal_t<16, 0, round::nearest_even> Res;
+  unsigned long long state = 2;
+  for (int i = 0; i < 10000; ++i)
+  {
+    u8 a = random_number<u8>(state);
+    u8 b = random_number<u8>(state);
+    u8 c = random_number<u8>(state);
+    BOOST_TEST( (number_cast<Res>(lazy(a) * b + c * (to_ureal_t<255, 0>() - b)) ==
+        number_cast<Res>(a * b + c * (to_ureal_t<255, 0>() - b))));
+  }
+}
+
+// The exact value needs 128 bits.
+void check_wide()
+{
+  typedef real_t<31, -32> q31_32;
+  typedef real_t<31, -32, round::nearest_even> Res;
+  unsigned long long state = 3;
+  for (int i = 0; i < 10000; ++i)
+  {
+    q31_32 a = random_number<q31_32>(state);
+    q31_32 b = random_number<q31_32>(state);
+    s8_8 c = random_number<s8_8>(state);
+    BOOST_TEST( (number_cast<Res>(lazy(a) * c - b * c) == number_cast<Res>(a * c - b * c)));
+  }
+}
+
+int main()
+{
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    s8_8 a( (index(0)));
+    u8 b( (index(0)));
+    s16_16 c( (index(0)));
+    BOOST_TEST(same_value_type(lazy(a) * a + a, a * a + a));
+    BOOST_TEST(same_value_type(lazy(b) * b + b * b, b * b + b * b));
+    BOOST_TEST(same_value_type(lazy(b) - b, b - b));
+    BOOST_TEST(same_value_type(a - lazy(b) * c, a - b * c));
+    BOOST_TEST(same_value_type(-(lazy(a) * b), -(a * b)));
+  }
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    check_signed<real_t<31, -16> >();
+    check_signed<real_t<31, -8, round::nearest_even> >();
+    check_signed<real_t<31, -4, round::positive> >();
+    check_signed<real_t<40, -40, round::truncated> >();
+    check_signed<real_t<15, -8, round::nearest_half_up, overflow::saturate> >();
+  }
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    check_unsigned();
+  }
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    check_wide();
+  }
+  // the value type has the policies of the leftmost number, and the exact value is kept
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    s8_8 a(1.5), b(-2.25);
+    BOOST_AUTO(e, lazy(a) * b + a);
+    BOOST_TEST( (exact_value(e) == a * b + a));
+    BOOST_TEST( (number_cast<s8_8>(e) == s8_8(-1.875)));
+    // the operands may have different policies
+    real_t<7, -8, round::nearest_even, overflow::saturate> c(0.5);
+    BOOST_TEST( (number_cast<s8_8>(lazy(a) * c + b) == s8_8(-1.5)));
+  }
+  // the overflows are handled by the policy of the result
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    typedef real_t<7, -8, round::negative, overflow::saturate> S;
+    s8_8 a(100.0);
+    BOOST_TEST( (number_cast<S>(lazy(a) * a).count() == S::max_index));
+    BOOST_TEST( (number_cast<S>(-lazy(a) * a).count() == S::min_index));
+    try
+    {
+      number_cast<s8_8>(lazy(a) * a + a);
+      BOOST_TEST(false);
+    }
+    catch (positive_overflow&)
+    {
+    }
+  }
+  return boost::report_errors();
+}
@@ -0,0 +1,192 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include <boost/fixed_point/fft.hpp>
+#include <boost/detail/lightweight_test.hpp>
+#include "random.hpp"
+
+using namespace boost::fixed_point;
+
+typedef real_t<0, -15, round::nearest_even, overflow::saturate> q15;
+typedef real_t<0, -31, round::nearest_even, overflow::saturate> q31;
+// the types whose butterflies convert through number_cast
+typedef real_t<0, -15, round::nearest_even, overflow::exception> e15;
+typedef real_t<0, -15, round::truncated, overflow::saturate> t15;
+
+const double pi = 3.14159265358979323846;
+
+// Pseudo random numbers of absolute value below amplitude.
+template <typename T>
+std::vector<T> noise(std::size_t n, double amplitude, unsigned long long seed)
+{
+  std::vector<T> res;
+  long long m = (long long) (amplitude * T::max_index);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    res.push_back(T(index(test::random_index(seed, -m, m))));
+  }
+  return res;
+}
+
+// The transform computed on doubles, by its definition.
+template <typename T>
+void dft(std::vector<T> const& re, std::vector<T> const& im, std::vector<double>& xr, std::vector<double>& xi)
+{
+  std::size_t n = re.size();
+  std::vector<double> c(n), s(n);
+  for (std::size_t k = 0; k < n; ++k)
+  {
+    c[k] = std::cos(2 * pi * k / n);
+    s[k] = std::sin(2 * pi * k / n);
+  }
+  xr.assign(n, 0);
+  xi.assign(n, 0);
+  for (std::size_t k = 0; k < n; ++k)
+    for (std::size_t j = 0; j < n; ++j)
+    {
+      std::size_t t = (j * k) % n;
+      xr[k] += re[j].as_double() * c[t] + im[j].as_double() * s[t];
+      xi[k] += im[j].as_double() * c[t] - re[j].as_double() * s[t];
+    }
+}
+
+// The largest error of the outputs scaled by 2^e, in units of the resolution of T.
+template <typename T>
+double max_error(std::vector<T> const& re, std::vector<T> const& im, int e, std::vector<double> const& xr,
+    std::vector<double> const& xi)
+{
+  double res = 0;
+  for (std::size_t k = 0; k < re.size(); ++k)
+  {
+    res = std::max(res, std::fabs(std::ldexp(re[k].as_double(), e) - xr[k]));
+    res = std::max(res, std::fabs(std::ldexp(im[k].as_double(), e) - xi[k]));
+  }
+  return std::ldexp(res, -T::resolution_exp);
+}
+
+int log2(std::size_t n)
+{
+  int res = 0;
+  while ((std::size_t(1) << res) < n)
+    ++res;
+  return res;
+}
+
+// The outputs are within log2(n) + 1 units of the transform, scaled by 2^e. Without scaling, the errors of the first
+// stages grow with the magnitudes, and the bound is 2 * sqrt(n) units.
+template <typename T, typename Scaling>
+void test_accuracy(std::size_t n, double amplitude)
+{
+  std::vector<T> re = noise<T>(n, amplitude, 1);
+  std::vector<T> im = noise<T>(n, amplitude, 2);
+  std::vector<double> xr, xi;
+  dft(re, im, xr, xi);
+  fft<T, Scaling> f(n);
+  BOOST_TEST_EQ(f.size(), n);
+  int e = f.forward(&re[0], &im[0]);
+  if (boost::is_same<Scaling, fft_scaling::none>::value)
+    BOOST_TEST_EQ(e, 0);
+  if (boost::is_same<Scaling, fft_scaling::unconditional>::value)
+    BOOST_TEST_EQ(e, log2(n));
+  BOOST_TEST(e >= 0 && e <= log2(n));
+  if (boost::is_same<Scaling, fft_scaling::none>::value)
+    BOOST_TEST(max_error(re, im, e, xr, xi) <= 2 * std::sqrt(double(n)));
+  else
+    BOOST_TEST(max_error(re, im, e, xr, xi) <= std::ldexp(double(log2(n) + 1), e));
+}
+
+// The transform of an impulse is constant.
+void test_impulse()
+{
+  std::vector<q15> re(64, q15(index(0))), im(64, q15(index(0)));
+  re[0] = q15(0.5);
+  fft<q15> f(64);
+  int e = f.forward(&re[0], &im[0]);
+  for (std::size_t k = 0; k < re.size(); ++k)
+  {
+    BOOST_TEST_EQ(std::ldexp(re[k].as_double(), e), 0.5);
+    BOOST_TEST_EQ(im[k].count(), 0);
+  }
+}
+
+// The block floating point keeps the resolution of small inputs, that the unconditional scaling loses.
+void test_block_floating()
+{
+  std::vector<q15> re = noise<q15>(256, 1.0 / 64, 1);
+  std::vector<q15> im = noise<q15>(256, 1.0 / 64, 2);
+  std::vector<double> xr, xi;
+  dft(re, im, xr, xi);
+  std::vector<q15> re1 = re, im1 = im;
+  int e = fft<q15>(256).forward(&re[0], &im[0]);
+  int e1 = fft<q15, fft_scaling::unconditional>(256).forward(&re1[0], &im1[0]);
+  BOOST_TEST(e < e1);
+  BOOST_TEST(max_error(re, im, e, xr, xi) < max_error(re1, im1, e1, xr, xi));
+}
+
+// The conversions through number_cast round as the branchless ones, which they replace for the other policies.
+template <typename Scaling>
+void test_number_cast(std::size_t n)
+{
+  std::vector<q15> re = noise<q15>(n, 0.7, 1);
+  std::vector<q15> im = noise<q15>(n, 0.7, 2);
+  std::vector<e15> re1, im1;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    re1.push_back(e15(index(re[i].count())));
+    im1.push_back(e15(index(im[i].count())));
+  }
+  int e = fft<q15, Scaling>(n).forward(&re[0], &im[0]);
+  int e1 = fft<e15, Scaling>(n).forward(&re1[0], &im1[0]);
+  BOOST_TEST_EQ(e1, e);
+  for (std::size_t k = 0; k < n; ++k)
+  {
+    BOOST_TEST_EQ(re1[k].count(), re[k].count());
+    BOOST_TEST_EQ(im1[k].count(), im[k].count());
+  }
+}
+
+// The inverse of the transform gives back the inputs times n, within 2 * log2(n) + 2 units of the outputs.
+template <typename Scaling>
+void test_inverse(std::size_t n)
+{
+  std::vector<q31> re = noise<q31>(n, 0.7, 1);
+  std::vector<q31> im = noise<q31>(n, 0.7, 2);
+  std::vector<q31> yr = re, yi = im;
+  fft<q31, Scaling> f(n);
+  int e = f.forward(&yr[0], &yi[0]);
+  e += f.inverse(&yr[0], &yi[0]);
+  double error = 0;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    error = std::max(error, std::fabs(std::ldexp(yr[i].as_double(), e - log2(n)) - re[i].as_double()));
+    error = std::max(error, std::fabs(std::ldexp(yi[i].as_double(), e - log2(n)) - im[i].as_double()));
+  }
+  BOOST_TEST(std::ldexp(error, 31 - e + log2(n)) <= 2 * log2(n) + 2);
+}
+
+int main()
+{
+  test_accuracy<q15, fft_scaling::unconditional>(64, 0.7);
+  test_accuracy<q15, fft_scaling::block_floating>(64, 0.7);
+  test_accuracy<q15, fft_scaling::none>(64, 1.0 / 64);
+  test_accuracy<q31, fft_scaling::unconditional>(256, 0.7);
+  test_accuracy<q31, fft_scaling::block_floating>(256, 0.7);
+  // the last stages are computed block by block
+  test_accuracy<q15, fft_scaling::block_floating>(4096, 0.7);
+  test_accuracy<q31, fft_scaling::unconditional>(4096, 0.7);
+  test_accuracy<q31, fft_scaling::none>(4096, 1.0 / 4096);
+  test_number_cast<fft_scaling::unconditional>(256);
+  test_number_cast<fft_scaling::block_floating>(4096);
+  test_accuracy<t15, fft_scaling::unconditional>(64, 0.7);
+  test_accuracy<t15, fft_scaling::block_floating>(4096, 0.7);
+  test_impulse();
+  test_block_floating();
+  test_inverse<fft_scaling::unconditional>(1024);
+  test_inverse<fft_scaling::block_floating>(2048);
+  return boost::report_errors();
+}
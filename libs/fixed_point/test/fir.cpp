@@ -0,0 +1,172 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <iostream>
+#include <vector>
+#include <boost/fixed_point/fir.hpp>
+#include <boost/detail/lightweight_test.hpp>
+#include "random.hpp"
+
+using namespace boost::fixed_point;
+
+typedef real_t<15, 0> sample;
+typedef real_t<0, -15> coefficient;
+typedef real_t<15, 0, round::nearest_even, overflow::saturate> result;
+
+template <typename T>
+std::vector<T> random_numbers(std::size_t n, unsigned long long seed)
+{
+  std::vector<T> res;
+  for (std::size_t i = 0; i < n; ++i)
+    res.push_back(T(index(test::random_index(seed, T::min_index, T::max_index))));
+  return res;
+}
+
+// The direct computation of the filter, converting the exact sum.
+template <typename Result, typename Sample, typename Coefficient>
+std::vector<Result> reference(std::vector<Sample> const& x, std::vector<Coefficient> const& h)
+{
+  std::vector<Result> y;
+  for (std::size_t n = 0; n < x.size(); ++n)
+  {
+    accumulator<typename multiply_result<Sample, Coefficient>::type, 16> acc;
+    for (std::size_t k = 0; k < h.size() && k <= n; ++k)
+      acc += x[n - k] * h[k];
+    y.push_back(acc.template get<Result>());
+  }
+  return y;
+}
+
+// The filter of x, processed by blocks of random lengths.
+template <typename Result, typename Sample, typename Coefficient>
+std::vector<Result> by_blocks(std::vector<Sample> const& x, std::vector<Coefficient> const& h)
+{
+  fir_filter<Sample, Coefficient, Result> f(&h[0], h.size());
+  std::vector<Result> y(x.size(), Result(index(0)));
+  unsigned long long state = 7;
+  for (std::size_t i = 0; i < x.size();)
+  {
+    std::size_t n = std::min<std::size_t>(test::random_index(state, 0, 100), x.size() - i);
+    f.process(&x[i], &y[i], n);
+    i += n;
+  }
+  return y;
+}
+
+template <typename Result, typename Sample, typename Coefficient>
+void check_filter(std::size_t taps)
+{
+  std::vector<Sample> x = random_numbers<Sample>(2000, 1);
+  std::vector<Coefficient> h = random_numbers<Coefficient>(taps, 2);
+  std::vector<Result> expected = reference<Result>(x, h);
+  BOOST_TEST(by_blocks<Result>(x, h) == expected);
+  // sample by sample
+  fir_filter<Sample, Coefficient, Result> f(&h[0], h.size());
+  bool same = true;
+  for (std::size_t i = 0; i < x.size(); ++i)
+    same = same && f(x[i]) == expected[i];
+  BOOST_TEST(same);
+  // after a reset the filter starts again
+  f.reset();
+  std::vector<Result> y(x.size(), Result(index(0)));
+  f.process(&x[0], &y[0], x.size());
+  BOOST_TEST(y == expected);
+  // without the SIMD kernels
+  simd::level prev = simd::restrict_to(simd::none);
+  BOOST_TEST(by_blocks<Result>(x, h) == expected);
+  simd::restrict_to(prev);
+}
+
+// The decimator gives one output of the filter out of factor, processed by blocks of random lengths.
+void check_decimator(std::size_t taps, std::size_t factor)
+{
+  std::vector<sample> x = random_numbers<sample>(2000, 3);
+  std::vector<coefficient> h = random_numbers<coefficient>(taps, 4);
+  std::vector<result> full = reference<result>(x, h);
+  fir_decimator<sample, coefficient, result> d(&h[0], h.size(), factor);
+  BOOST_TEST(d.factor() == factor && d.taps() == taps);
+  std::vector<result> y(x.size() / factor + 1, result(index(0)));
+  std::size_t k = 0;
+  unsigned long long state = 8;
+  for (std::size_t i = 0; i < x.size();)
+  {
+    std::size_t n = std::min<std::size_t>(test::random_index(state, 0, 50), x.size() - i);
+    k += d.process(&x[i], &y[k], n);
+    i += n;
+  }
+  BOOST_TEST(k == (x.size() + factor - 1) / factor);
+  bool same = true;
+  for (std::size_t j = 0; j < k; ++j)
+    same = same && y[j] == full[j * factor];
+  BOOST_TEST(same);
+}
+
+// The interpolator gives the filter of the input with factor - 1 zeros inserted after each sample.
+void check_interpolator(std::size_t taps, std::size_t factor)
+{
+  std::vector<sample> x = random_numbers<sample>(500, 5);
+  std::vector<coefficient> h = random_numbers<coefficient>(taps, 6);
+  std::vector<sample> stuffed(x.size() * factor, sample(index(0)));
+  for (std::size_t i = 0; i < x.size(); ++i)
+    stuffed[i * factor] = x[i];
+  std::vector<result> expected = reference<result>(stuffed, h);
+  fir_interpolator<sample, coefficient, result> f(&h[0], h.size(), factor);
+  BOOST_TEST(f.factor() == factor && f.taps() == taps);
+  std::vector<result> y(stuffed.size(), result(index(0)));
+  unsigned long long state = 9;
+  for (std::size_t i = 0; i < x.size();)
+  {
+    std::size_t n = std::min<std::size_t>(test::random_index(state, 0, 30), x.size() - i);
+    f.process(&x[i], &y[i * factor], n);
+    i += n;
+  }
+  BOOST_TEST(y == expected);
+}
+
+int main()
+{
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    check_filter<result, sample, coefficient>(1);
+    check_filter<result, sample, coefficient>(7);
+    check_filter<result, sample, coefficient>(64);
+    check_filter<result, sample, coefficient>(101);
+    check_filter<real_t<20, -15>, sample, coefficient>(33);
+  }
+  // the types that have no SIMD kernel
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    check_filter<real_t<15, -16, round::nearest_even, overflow::saturate>, real_t<15, -16>, real_t<1, -30> >(17);
+    check_filter<real_t<7, -8, round::truncated, overflow::saturate>, real_t<7, -8>, real_t<0, -7> >(9);
+  }
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    check_decimator(1, 3);
+    check_decimator(31, 2);
+    check_decimator(64, 4);
+    check_decimator(20, 1);
+  }
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    check_interpolator(1, 2);
+    check_interpolator(31, 2);
+    check_interpolator(64, 4);
+    check_interpolator(19, 3);
+  }
+  // the outputs are rounded once, with the policies of the result
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    coefficient h[] = { coefficient(0.5), coefficient(0.5) };
+    fir_filter<sample, coefficient, result> f(h, 2);
+    BOOST_TEST(f(sample(3.0)) == result(2.0)); // 1.5 rounds to even
+    BOOST_TEST(f(sample(2.0)) == result(2.0)); // 2.5 rounds to even
+    BOOST_TEST(f(sample(32767.0)) == result(16384.0)); // 16384.5 rounds to even
+    coefficient g[] = { coefficient(index(32767)), coefficient(index(32767)) };
+    fir_filter<sample, coefficient, result> s(g, 2);
+    s(sample(32767.0));
+    BOOST_TEST(s(sample(32767.0)).count() == result::max_index);
+  }
+  return boost::report_errors();
+}
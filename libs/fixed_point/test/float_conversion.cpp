@@ -0,0 +1,226 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <boost/fixed_point/batch.hpp>
+#include <boost/detail/lightweight_test.hpp>
+#include "random.hpp"
+
+using namespace boost::fixed_point;
+
+// Reference rounding of x, computed with the math library. kind is one of 'n' (negative), 't' (truncated),
+// 'p' (positive), 'u' (half up), 'd' (half down), 'e' (even) and 'o' (odd).
+double reference(double x, char kind)
+{
+  double f = std::floor(x);
+  double r = x - f;
+  switch (kind)
+  {
+  case 'n':
+    return f;
+  case 't':
+    return x < 0 ? std::ceil(x) : f;
+  case 'p':
+    return std::ceil(x);
+  default:
+    break;
+  }
+  if (r > 0.5) return f + 1;
+  if (r < 0.5) return f;
+  switch (kind)
+  {
+  case 'u':
+    return f >= 0 ? f + 1 : f;
+  case 'd':
+    return f >= 0 ? f : f + 1;
+  case 'e':
+    return std::fmod(f, 2.0) == 0 ? f : f + 1;
+  default:
+    return std::fmod(f, 2.0) == 0 ? f + 1 : f;
+  }
+}
+
+// Doubles in ]-2^15, 2^15[ with many exactly-half and integral values at the resolution 2^-16, and a quarter of values
+// in ]-3*2^15, 3*2^15[, most of them out of the range of a Q15.16.
+std::vector<double> make_doubles(std::size_t n, unsigned long long state)
+{
+  std::vector<double> res;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    double x = std::ldexp(double((long long) (test::next_random(state) >> 11) - (1LL << 52)), -37);
+    switch (i % 4)
+    {
+    case 0:
+      x = std::ldexp(std::floor(std::ldexp(x, 17)), -17);
+      break;
+    case 1:
+      x = std::ldexp(std::floor(std::ldexp(x, 16)), -16);
+      break;
+    case 2:
+      x = 3 * x;
+      break;
+    default:
+      break;
+    }
+    res.push_back(x);
+  }
+  return res;
+}
+
+template <typename RP>
+void check_scalar(char kind)
+{
+  std::vector<double> x = make_doubles(1000, 1);
+  for (std::size_t i = 0; i < x.size(); ++i)
+  {
+    if (std::fabs(x[i]) >= 32767) continue;
+    double y = std::ldexp(x[i], 16);
+    BOOST_TEST( (real_t<15, -16, RP, overflow::undefined>(x[i]).count() == (long long) reference(y, kind)));
+    BOOST_TEST( (real_t<15, -16, RP, overflow::undefined>(float(x[i])).count()
+        == (long long) reference(std::ldexp(double(float(x[i])), 16), kind)));
+    BOOST_TEST( (real_t<16, 8, RP, overflow::undefined>(x[i] / 2).count() == (long long) reference(std::ldexp(x[i], -9), kind)));
+    if (x[i] >= 0)
+      BOOST_TEST( (ureal_t<16, -16, RP, overflow::undefined>(x[i]).count() == (unsigned long long) reference(y, kind)));
+  }
+}
+
+template <typename RP>
+void check_batch(std::size_t n)
+{
+  typedef real_t<15, -16, RP, overflow::exception> T;
+  typedef real_t<15, -16, RP, overflow::saturate> S;
+  std::vector<double> x = make_doubles(n, 2);
+  std::vector<double> in_range;
+  for (std::size_t i = 0; i < n; ++i)
+    in_range.push_back(std::fabs(x[i]) < 32767 ? x[i] : x[i] / 4);
+  std::vector<T> t(n);
+  std::vector<T> s(n);
+  batch::number_cast(&in_range[0], &t[0], n);
+  batch::saturate(&x[0], &s[0], n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    BOOST_TEST(t[i].count() == T(in_range[i]).count());
+    BOOST_TEST(s[i].count() == S(x[i]).count());
+  }
+}
+
+void check_batch_overflow(std::size_t n, std::size_t at)
+{
+  std::vector<double> x(n, 0.5);
+  x[at] = -40000;
+  std::vector<real_t<15, -16> > t(n);
+  try
+  {
+    batch::number_cast(&x[0], &t[0], n);
+    BOOST_TEST(false);
+  }
+  catch (negative_overflow&)
+  {
+  }
+  for (std::size_t i = 0; i < at; ++i)
+    BOOST_TEST(t[i].count() == 1 << 15);
+}
+
+// The values far beyond the range, which don't fit in the integer on which they are rounded, saturate on the side of
+// their sign, as in the batches.
+template <typename Rounding>
+void check_saturate_far()
+{
+  typedef real_t<15, -16, Rounding, overflow::saturate> Q;
+  typedef real_t<31, -32, Rounding, overflow::saturate> Q64;
+  typedef ureal_t<16, -16, Rounding, overflow::saturate> U;
+  const double inf = std::numeric_limits<double>::infinity(), big = std::numeric_limits<double>::max();
+  const double far[] = { 1e20, big, inf, 32768.0, 9.3e18, std::ldexp(1.0, 63) };
+  const typename Q::underlying_type max = Q::max_index, min = Q::min_index;
+  const typename Q64::underlying_type max64 = Q64::max_index, min64 = Q64::min_index;
+  const typename U::underlying_type umax = U::max_index;
+  for (std::size_t i = 0; i < sizeof(far) / sizeof(far[0]); ++i)
+  {
+    BOOST_TEST_EQ(Q(far[i]).count(), max);
+    BOOST_TEST_EQ(Q(-far[i]).count(), min);
+    if (far[i] > 1e10)
+    {
+      BOOST_TEST_EQ(U(far[i]).count(), umax);
+      BOOST_TEST_EQ(Q64(far[i]).count(), max64);
+      BOOST_TEST_EQ(Q64(-far[i]).count(), min64);
+    }
+    Q b[2];
+    const double x[2] = { far[i], -far[i] };
+    batch::number_cast(x, b, 2);
+    BOOST_TEST_EQ(b[0].count(), max);
+    BOOST_TEST_EQ(b[1].count(), min);
+  }
+  try
+  {
+    real_t<15, -16, Rounding> n(-1e20);
+    BOOST_TEST(false);
+  }
+  catch (negative_overflow&)
+  {
+  }
+}
+
+void check_all_batch(std::size_t n)
+{
+  check_batch<round::negative>(n);
+  check_batch<round::truncated>(n);
+  check_batch<round::positive>(n);
+  check_batch<round::nearest_half_up>(n);
+  check_batch<round::nearest_half_down>(n);
+  check_batch<round::nearest_even>(n);
+  check_batch<round::nearest_odd>(n);
+  check_batch_overflow(n, n / 2);
+}
+
+int main()
+{
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    check_scalar<round::negative>('n');
+    check_scalar<round::truncated>('t');
+    check_scalar<round::positive>('p');
+    check_scalar<round::nearest_half_up>('u');
+    check_scalar<round::nearest_half_down>('d');
+    check_scalar<round::nearest_even>('e');
+    check_scalar<round::nearest_odd>('o');
+  }
+  // the overflows are detected on the value before its conversion to the underlying type
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    BOOST_TEST( (real_t<15, -16, round::negative, overflow::saturate>(100000.0).count() == 2147483647));
+    BOOST_TEST( (real_t<15, -16, round::negative, overflow::saturate>(-100000.0).count()
+        == (real_t<15, -16>::min_index)));
+    try
+    {
+      real_t<15, -16> n(70000.0);
+      BOOST_TEST(false);
+    }
+    catch (positive_overflow&)
+    {
+    }
+    check_saturate_far<round::negative>();
+    check_saturate_far<round::truncated>();
+    check_saturate_far<round::positive>();
+    check_saturate_far<round::nearest_half_up>();
+    check_saturate_far<round::nearest_half_down>();
+    check_saturate_far<round::nearest_even>();
+    check_saturate_far<round::nearest_odd>();
+  }
+  const simd::level levels[] =
+  { simd::none, simd::sse4, simd::avx2, simd::avx512 };
+  for (std::size_t l = 0; l < sizeof(levels) / sizeof(levels[0]); ++l)
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "] level " << levels[l] << std::endl;
+    simd::restrict_to(levels[l]);
+    check_all_batch(1);
+    check_all_batch(9);
+    check_all_batch(1000);
+    check_all_batch(1003);
+  }
+  return boost::report_errors();
+}
@@ -0,0 +1,107 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <iostream>
+#include <boost/fixed_point/number.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/detail/lightweight_test.hpp>
+#include "random.hpp"
+
+using namespace boost::fixed_point;
+
+BOOST_STATIC_ASSERT((boost::is_same<fma_result<real_t<7, -8>, real_t<7, -8>, real_t<15, -16> >::type,
+    real_t<16, -16> >::value));
+BOOST_STATIC_ASSERT((boost::is_same<fma_result<ureal_t<7, -8>, ureal_t<3, -4>, ureal_t<15, -4> >::type,
+    ureal_t<16, -12> >::value));
+
+// Pseudo random numbers of T, in [-max, max] when T is signed and in [0, max / 2 * 2] otherwise.
+template <typename T>
+T random_number(unsigned long long& state)
+{
+  const long long max = (long long) (T::max_index);
+  return T(index(T::is_signed ? test::random_index(state, -max, max) : test::random_index(state, 0, max / 2 * 2)));
+}
+
+// fma<Res> gives the single rounding of the exact result, as number_cast<Res>(a * b + c).
+template <typename Res, typename T1, typename T2, typename T3>
+void check_fma(unsigned long long seed)
+{
+  unsigned long long state = seed;
+  for (int i = 0; i < 10000; ++i)
+  {
+    T1 a = random_number<T1>(state);
+    T2 b = random_number<T2>(state);
+    T3 c = random_number<T3>(state);
+    BOOST_TEST( (fma<Res>(a, b, c) == number_cast<Res>(a * b + c)));
+  }
+}
+
+template <typename RP>
+void check_roundings()
+{
+  typedef real_t<7, -8, RP> T;
+  typedef ureal_t<7, -8, RP> U;
+  // coarser, finer and equal resolutions
+  check_fma<real_t<16, -8, RP>, T, T, real_t<15, -16, RP> >(1);
+  check_fma<real_t<15, -4, RP>, T, T, T>(2);
+  check_fma<real_t<20, -20, RP>, T, T, T>(3);
+  check_fma<real_t<16, -16, RP>, T, T, real_t<15, -16, RP> >(4);
+  check_fma<real_t<15, -8, RP>, T, U, T>(5);
+  check_fma<ureal_t<15, -8, RP>, U, U, U>(6);
+  // the exact value needs 128 bits
+  check_fma<real_t<31, -32, RP>, real_t<15, -48, RP>, real_t<15, -48, RP>, real_t<15, -48, RP> >(7);
+}
+
+int main()
+{
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    check_roundings<round::negative>();
+    check_roundings<round::truncated>();
+    check_roundings<round::positive>();
+    check_roundings<round::nearest_half_up>();
+    check_roundings<round::nearest_half_down>();
+    check_roundings<round::nearest_even>();
+    check_roundings<round::nearest_odd>();
+  }
+  // the result type is exact by default
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    real_t<7, -8> a(1.5), b(-2.25);
+    real_t<15, -16> c(0.0625);
+    BOOST_TEST( (fma(a, b, c) == real_t<16, -16>(-3.3125)));
+    BOOST_TEST( (fma(a, b, c) == a * b + c));
+    ureal_t<7, -8> u(1.5), v(2.25);
+    BOOST_TEST( (fma(u, v, u) == ureal_t<15, -16>(4.875)));
+  }
+  // a single rounding, where the composed operators round twice
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    typedef real_t<7, -4, round::nearest_even> T;
+    T a(0.0625);
+    real_t<7, -8, round::nearest_even> c(0.03125);
+    // 1/256 + 1/32 rounds to 1/16, while 1/256 rounds first to 0 and 0 + 1/32 is a tie that rounds to 0
+    BOOST_TEST( (fma<T>(a, a, c) == T(0.0625)));
+    BOOST_TEST( (number_cast<T>(number_cast<T>(a * a) + c) == T(0.0)));
+  }
+  // the overflows are handled by the policy of the result
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    typedef real_t<7, -8, round::negative, overflow::saturate> S;
+    real_t<7, -8> a(100.0);
+    BOOST_TEST( (fma<S>(a, a, a).count() == S::max_index));
+    BOOST_TEST( (fma<S>(a, -a, a).count() == S::min_index));
+    try
+    {
+      fma<real_t<7, -8> >(a, a, a);
+      BOOST_TEST(false);
+    }
+    catch (positive_overflow&)
+    {
+    }
+  }
+  return boost::report_errors();
+}
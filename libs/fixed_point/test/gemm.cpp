@@ -0,0 +1,149 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <iostream>
+#include <vector>
+#include <boost/fixed_point/gemm.hpp>
+#include <boost/detail/lightweight_test.hpp>
+#include "random.hpp"
+
+using namespace boost::fixed_point;
+
+typedef real_t<7, 0> s8;
+typedef ureal_t<8, 0> u8;
+typedef real_t<0, -7> q7;
+typedef real_t<0, -15> q15;
+
+// Pseudo random numbers of T, with indexes in [lo, hi].
+template <typename T>
+std::vector<T> noise(std::size_t n, long long lo, long long hi, unsigned long long seed)
+{
+  std::vector<T> res;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    res.push_back(T(index(test::random_index(seed, lo, hi))));
+  }
+  return res;
+}
+
+template <typename T>
+std::vector<T> noise(std::size_t n, unsigned long long seed)
+{
+  return noise<T>(n, (long long) (T::min_index), (long long) (T::max_index), seed);
+}
+
+// The element (i, j) of a matrix of r x c elements stored in the order l.
+template <typename T>
+T const& at(std::vector<T> const& p, batch::layout l, std::size_t r, std::size_t c, std::size_t i, std::size_t j)
+{
+  return l == batch::row_major ? p[i * c + j] : p[j * r + i];
+}
+
+// The products are the number_cast of the dot products of batch::dot.
+template <typename To, typename T1, typename T2>
+void check_gemm(std::vector<T1> const& a, batch::layout la, std::vector<T2> const& b, batch::layout lb,
+    std::size_t m, std::size_t n, std::size_t k)
+{
+  std::vector<To> c(m * n, To(index(0)));
+  batch::gemm(a.empty() ? 0 : &a[0], la, b.empty() ? 0 : &b[0], lb, &c[0], m, n, k);
+  std::vector<T1> row(k + 1, T1(index(0)));
+  std::vector<T2> column(k + 1, T2(index(0)));
+  for (std::size_t i = 0; i < m; ++i)
+    for (std::size_t j = 0; j < n; ++j)
+    {
+      for (std::size_t p = 0; p < k; ++p)
+      {
+        row[p] = at(a, la, m, k, i, p);
+        column[p] = at(b, lb, k, n, p, j);
+      }
+      BOOST_TEST_EQ(c[i * n + j].count(), number_cast<To>(batch::dot(&row[0], &column[0], k)).count());
+    }
+}
+
+template <typename To, typename T1, typename T2>
+void check_gemm(std::vector<T1> const& a, std::vector<T2> const& b, std::size_t m, std::size_t n, std::size_t k)
+{
+  check_gemm<To>(a, batch::row_major, b, batch::column_major, m, n, k);
+  check_gemm<To>(a, batch::column_major, b, batch::row_major, m, n, k);
+}
+
+template <typename To, typename T1, typename T2>
+void check_gemv(std::vector<T1> const& a, batch::layout la, std::vector<T2> const& x, std::size_t m, std::size_t k)
+{
+  std::vector<To> y(m, To(index(0)));
+  batch::gemv(&a[0], la, &x[0], &y[0], m, k);
+  std::vector<T1> row(k, T1(index(0)));
+  for (std::size_t i = 0; i < m; ++i)
+  {
+    for (std::size_t p = 0; p < k; ++p)
+      row[p] = at(a, la, m, k, i, p);
+    BOOST_TEST_EQ(y[i].count(), number_cast<To>(batch::dot(&row[0], &x[0], k)).count());
+  }
+}
+
+template <typename T1, typename T2, typename To>
+void test_shapes()
+{
+  const std::size_t shapes[][3] = { { 1, 1, 1 }, { 7, 5, 67 }, { 33, 9, 300 }, { 66, 131, 40 }, { 3, 6, 4100 } };
+  for (std::size_t s = 0; s < sizeof(shapes) / sizeof(shapes[0]); ++s)
+  {
+    std::size_t m = shapes[s][0], n = shapes[s][1], k = shapes[s][2];
+    std::vector<T1> a = noise<T1>(m * k, 1 + s);
+    std::vector<T2> b = noise<T2>(k * n, 11 + s);
+    check_gemm<To>(a, b, m, n, k);
+    check_gemv<To>(a, batch::row_major, b, m, k);
+    check_gemv<To>(a, batch::column_major, b, m, k);
+  }
+}
+
+void test_levels()
+{
+  typedef real_t<7, 0, round::nearest_even, overflow::saturate> s8_sat;
+  typedef real_t<0, -7, round::nearest_even, overflow::saturate> q7_sat;
+  typedef real_t<0, -15, round::nearest_even, overflow::saturate> q15_sat;
+  const simd::level levels[] = { simd::none, simd::sse4, simd::avx2, simd::avx512 };
+  simd::level prev = simd::active();
+  for (std::size_t l = 0; l < sizeof(levels) / sizeof(levels[0]); ++l)
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "] level " << levels[l] << std::endl;
+    simd::restrict_to(levels[l]);
+    // the four combinations of signed and unsigned numbers on 8 bits
+    test_shapes<u8, s8, real_t<24, 0> >();
+    test_shapes<s8, s8, s8_sat>();
+    test_shapes<u8, u8, ureal_t<30, 0> >();
+    test_shapes<q7, u8, q7_sat>();
+    // the weights in [-64, 64], for vpmaddubsw
+    std::vector<u8> a = noise<u8>(5 * 200, 3);
+    std::vector<s8> b = noise<s8>(200 * 9, -64, 64, 4);
+    check_gemm<real_t<20, 0> >(a, b, 5, 9, 200);
+    test_shapes<q15, q15, q15_sat>();
+    test_shapes<q15, q15, real_t<20, -20> >();
+    // the greatest products
+    std::vector<q15> c = noise<q15>(4 * 40, -32767, -32760, 5);
+    std::vector<q15> d = noise<q15>(40 * 6, -32767, -32760, 6);
+    check_gemm<real_t<16, -15> >(c, d, 4, 6, 40);
+    check_gemm<real_t<16, -15> >(noise<q15>(4 * 40, 7), d, 4, 6, 40);
+    // the generic tiles
+    test_shapes<real_t<15, -16>, ureal_t<3, -9>, real_t<20, -12, round::nearest_even, overflow::saturate> >();
+  }
+  simd::restrict_to(prev);
+}
+
+void test_empty()
+{
+  std::vector<q15> a(6, q15(index(1)));
+  std::vector<q15> c(6, q15(index(1)));
+  batch::gemm(&a[0], batch::row_major, &a[0], batch::row_major, &c[0], 2, 3, 0);
+  for (std::size_t i = 0; i < c.size(); ++i)
+    BOOST_TEST_EQ(c[i].count(), 0);
+  batch::gemm(&a[0], batch::row_major, &a[0], batch::row_major, &c[0], 0, 3, 2);
+}
+
+int main()
+{
+  test_levels();
+  test_empty();
+  return boost::report_errors();
+}
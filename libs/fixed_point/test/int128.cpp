@@ -0,0 +1,273 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <iostream>
+#include <vector>
+#include <boost/fixed_point/int128.hpp>
+#include <boost/fixed_point/accumulator.hpp>
+#include <boost/mpl/if.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/detail/lightweight_test.hpp>
+#include "random.hpp"
+
+using namespace boost::fixed_point;
+
+typedef real_t<31, -32> Q;
+typedef accumulator<Q, 32> A96;
+typedef accumulator<ureal_t<32, -32>, 64> A128;
+
+#if defined(BOOST_FIXED_POINT_HAS_INT128)
+BOOST_STATIC_ASSERT((boost::is_same<A96::underlying_type, boost::int128_type>::value));
+BOOST_STATIC_ASSERT((boost::is_same<A128::underlying_type, boost::uint128_type>::value));
+#else
+BOOST_STATIC_ASSERT((boost::is_same<A96::underlying_type, int128>::value));
+BOOST_STATIC_ASSERT((boost::is_same<A128::underlying_type, uint128>::value));
+#endif
+BOOST_STATIC_ASSERT((std::numeric_limits<int128>::digits == 127));
+BOOST_STATIC_ASSERT((std::numeric_limits<uint128>::digits == 128));
+BOOST_STATIC_ASSERT((std::numeric_limits<int128>::is_signed));
+BOOST_STATIC_ASSERT((!std::numeric_limits<uint128>::is_signed));
+BOOST_STATIC_ASSERT((std::numeric_limits<int128>::is_modulo));
+BOOST_STATIC_ASSERT((std::numeric_limits<uint128>::is_modulo));
+
+boost::uint64_t next(unsigned long long& state)
+{
+  unsigned long long r = test::next_random(state);
+  return r ^ (r >> 29);
+}
+
+// Pseudo random values on 128 bits, with magnitudes of any number of bits, and the extreme ones.
+std::vector<uint128> noise(std::size_t n)
+{
+  unsigned long long state = 1;
+  std::vector<uint128> res;
+  const boost::uint64_t ones = ~boost::uint64_t(0);
+  res.push_back(uint128(0));
+  res.push_back(uint128(1));
+  res.push_back(uint128(ones));
+  res.push_back(uint128::from_limbs(1, 0));
+  res.push_back(uint128::from_limbs(ones, ones));
+  res.push_back(uint128::from_limbs(ones >> 1, ones));
+  res.push_back(uint128::from_limbs(boost::uint64_t(1) << 63, 0));
+  res.push_back(uint128::from_limbs(boost::uint64_t(1) << 63, 1));
+  while (res.size() < n)
+  {
+    uint128 x = uint128::from_limbs(next(state), next(state));
+    res.push_back(x >> int(next(state) % 128));
+    res.push_back(-(x >> int(next(state) % 128)));
+  }
+  return res;
+}
+
+// The high half of the 256 bits product of the magnitudes, on digits of 32 bits, negated when the signs differ.
+template <bool Signed>
+integer128<Signed> reference_high(integer128<Signed> a, integer128<Signed> b)
+{
+  const bool negative = (a < 0) != (b < 0);
+  uint128 ua(a < 0 ? -a : a), ub(b < 0 ? -b : b);
+  boost::uint64_t x[4], y[4], z[8] = { 0 };
+  for (int i = 0; i < 4; ++i)
+  {
+    x[i] = (ua >> (32 * i)).low() & 0xFFFFFFFFu;
+    y[i] = (ub >> (32 * i)).low() & 0xFFFFFFFFu;
+  }
+  for (int i = 0; i < 4; ++i)
+  {
+    boost::uint64_t carry = 0;
+    for (int j = 0; j < 4; ++j)
+    {
+      boost::uint64_t t = x[i] * y[j] + z[i + j] + carry;
+      z[i + j] = t & 0xFFFFFFFFu;
+      carry = t >> 32;
+    }
+    z[i + 4] = carry;
+  }
+  uint128 hi = uint128::from_limbs((z[7] << 32) | z[6], (z[5] << 32) | z[4]);
+  uint128 lo = uint128::from_limbs((z[3] << 32) | z[2], (z[1] << 32) | z[0]);
+  if (negative)
+  {
+    // the two's complement of the 256 bits hi:lo
+    hi = ~hi + uint128(lo == 0);
+  }
+  return integer128<Signed>(hi);
+}
+
+#if defined(BOOST_HAS_INT128)
+template <typename I, bool Signed>
+bool same(integer128<Signed> const& x, I r)
+{
+  return x.low() == boost::uint64_t(r) && x.high() == boost::uint64_t(r >> 64);
+}
+
+template <typename I, bool Signed>
+I builtin(integer128<Signed> const& x)
+{
+  return I((boost::uint128_type(x.high()) << 64) | x.low());
+}
+#endif
+
+// The operators, compared with the builtin 128 bits integer when there is one.
+template <bool Signed>
+void check_operators()
+{
+  typedef integer128<Signed> I;
+  std::vector<uint128> u = noise(200);
+  for (std::size_t i = 0; i < u.size(); ++i)
+  {
+    I a(u[i]);
+    BOOST_TEST(a + I(0) == a);
+    BOOST_TEST(a - a == I(0));
+    BOOST_TEST(-(-a) == a);
+    BOOST_TEST((a ^ ~a) == I(-1));
+    BOOST_TEST(I::from_limbs(a.high(), a.low()) == a);
+    for (int n = 0; n < 128; ++n)
+      BOOST_TEST(((a << n) >> n << n) == (a << n));
+    for (std::size_t j = 0; j < u.size(); ++j)
+    {
+      I b(u[j]);
+      BOOST_TEST(a + b - b == a);
+      BOOST_TEST((a < b) + (a == b) + (a > b) == 1);
+      BOOST_TEST(multiply_high(a, b) == reference_high(a, b));
+      BOOST_TEST(multiply_high(a, b) == multiply_high(b, a));
+#if defined(BOOST_HAS_INT128)
+      typedef typename boost::mpl::if_c<Signed, boost::int128_type, boost::uint128_type>::type builtin_type;
+      builtin_type ra = builtin<builtin_type>(a), rb = builtin<builtin_type>(b);
+      BOOST_TEST(same(a + b, builtin_type(boost::uint128_type(ra) + boost::uint128_type(rb))));
+      BOOST_TEST(same(a - b, builtin_type(boost::uint128_type(ra) - boost::uint128_type(rb))));
+      BOOST_TEST(same(a * b, builtin_type(boost::uint128_type(ra) * boost::uint128_type(rb))));
+      BOOST_TEST(same(a & b, ra & rb));
+      BOOST_TEST(same(a | b, ra | rb));
+      BOOST_TEST((a < b) == (ra < rb));
+      BOOST_TEST((a <= b) == (ra <= rb));
+      BOOST_TEST(same(a >> int(j % 128), ra >> int(j % 128)));
+      BOOST_TEST(same(a << int(j % 128), builtin_type(boost::uint128_type(ra) << int(j % 128))));
+      // the overflowing quotient of the minimum by -1 is not tested
+      if (rb != 0 && !(Signed && rb == builtin_type(-1) && u[i] == uint128::from_limbs(boost::uint64_t(1) << 63, 0)))
+      {
+        BOOST_TEST(same(a / b, ra / rb));
+        BOOST_TEST(same(a % b, ra % rb));
+      }
+#endif
+    }
+  }
+  BOOST_TEST(std::numeric_limits<I>::max() + 1 == std::numeric_limits<I>::min());
+  BOOST_TEST(std::numeric_limits<I>::min() < std::numeric_limits<I>::max());
+  BOOST_TEST(I(-1).as_double() == (Signed ? -1.0 : 340282366920938463463374607431768211455.0));
+  BOOST_TEST((I(1) << 100).as_double() == 1267650600228229401496703205376.0);
+}
+
+void check_wide_multiply()
+{
+  unsigned long long state = 2;
+  for (int i = 0; i < 10000; ++i)
+  {
+    boost::uint64_t a = next(state) >> (i % 64), b = next(state) >> (i / 64 % 64);
+    BOOST_TEST(wide_multiply(a, b) == uint128(a) * uint128(b));
+    boost::int64_t sa = boost::int64_t(a) * ((i & 1) ? -1 : 1), sb = boost::int64_t(b) * ((i & 2) ? -1 : 1);
+    BOOST_TEST(wide_multiply(sa, sb) == int128(sa) * int128(sb));
+    BOOST_TEST(multiply_high(int128(sa), int128(sb)) == int128(wide_multiply(sa, sb) < 0 ? -1 : 0));
+  }
+  const boost::int64_t min = boost::integer_traits<boost::int64_t>::const_min;
+  BOOST_TEST(wide_multiply(min, min) == int128(1) << 126);
+}
+
+// The exact sums of 96 and 128 bits, and their normalization with the rounding and overflow policies.
+void check_accumulators()
+{
+  const boost::int64_t m = Q::max_index;
+  const int128 big = int128(1000) << 32;
+  A96 acc;
+  for (int i = 0; i < 1000; ++i)
+    acc += Q(index(m));
+  BOOST_TEST(int128(acc.count()) == int128(m) * 1000);
+  // 1000 * (2^63 - 1) / 2^31 = 1000 * 2^32 - 1000 / 2^31
+  BOOST_TEST(int128(acc.get<real_t<62, -1, round::negative> >().count()) == big - 1);
+  BOOST_TEST(int128(acc.get<real_t<62, -1, round::truncated> >().count()) == big - 1);
+  BOOST_TEST(int128(acc.get<real_t<62, -1, round::positive> >().count()) == big);
+  BOOST_TEST(int128(acc.get<real_t<62, -1, round::nearest_even> >().count()) == big);
+  BOOST_TEST(int128(acc.get<real_t<62, -1, round::nearest_half_down> >().count()) == big);
+  // saturated, thrown or wrapped
+  BOOST_TEST((acc.get<real_t<31, -32, round::negative, overflow::saturate> >().count() == m));
+  try
+  {
+    acc.get<real_t<31, -32, round::negative, overflow::exception> >();
+    BOOST_TEST(false);
+  }
+  catch (positive_overflow&)
+  {
+  }
+  // 1000 * (2^63 - 1) modulo 2^64
+  typedef ureal_t<32, -32, round::negative, overflow::modulus> U;
+  BOOST_TEST((acc.get<U>().count() == boost::uint64_t(0) - 1000));
+  // finer resolutions, the value shifted by 16 bits modulo 2^64
+  typedef ureal_t<16, -48, round::negative, overflow::modulus> V;
+  BOOST_TEST((acc.get<V>().count() == boost::uint64_t(0) - (boost::uint64_t(1000) << 16)));
+  // the range of a signed modulus is not a power of two: the two limbs wrap the exact quotient, where number_cast
+  // wraps its low bits
+#if !defined(BOOST_FIXED_POINT_HAS_INT128)
+  typedef real_t<7, -8, round::truncated, overflow::modulus> S;
+  int128 wrapped = (int128(acc.count()) >> 24) % 65535;
+  BOOST_TEST(int128(acc.get<S>().count()) == (wrapped > 32767 ? wrapped - 65535 : wrapped));
+#endif
+  // the negative sums
+  for (int i = 0; i < 2000; ++i)
+    acc -= Q(index(m));
+  BOOST_TEST(int128(acc.get<real_t<62, -1, round::negative> >().count()) == -big);
+  BOOST_TEST(int128(acc.get<real_t<62, -1, round::truncated> >().count()) == -big + 1);
+  BOOST_TEST(int128(acc.get<real_t<62, -1, round::positive> >().count()) == -big + 1);
+  BOOST_TEST(int128(acc.get<real_t<62, -1, round::nearest_odd> >().count()) == -big);
+  BOOST_TEST((acc.get<real_t<31, -32, round::negative, overflow::saturate> >().count() == -m));
+  BOOST_TEST((acc.get<U>().count() == 1000));
+#if !defined(BOOST_FIXED_POINT_HAS_INT128)
+  wrapped = -((int128(-acc.count()) >> 24) % 65535);
+  BOOST_TEST(int128(acc.get<S>().count()) == (wrapped < -32767 ? wrapped + 65535 : wrapped));
+#endif
+  try
+  {
+    acc.get<ureal_t<32, -32, round::negative, overflow::exception> >();
+    BOOST_TEST(false);
+  }
+  catch (negative_overflow&)
+  {
+  }
+  // the finer resolutions within the range
+  acc.clear();
+  acc += Q(3.0);
+  acc -= Q(0.5);
+  BOOST_TEST((acc.get<real_t<15, -40, round::negative, overflow::exception> >().count() == (5LL << 39)));
+  BOOST_TEST((acc.get<real_t<1, -62, round::negative, overflow::saturate> >().count() == Q::max_index));
+  // 2^64 terms of 2^64 - 1 indices
+  A128 wide;
+  ureal_t<32, -32> x( (index(ureal_t<32, -32>::max_index)));
+  for (int i = 0; i < 3; ++i)
+    wide += x;
+  BOOST_TEST((uint128(wide.count()) == uint128(3) * ureal_t<32, -32>::max_index));
+  BOOST_TEST((wide.get<ureal_t<34, -30, round::positive> >().count() == (boost::uint64_t(3) << 62)));
+  // the unsigned sums of 2^127 or more have no sign: 2^127 + 2^64 - 1
+  typedef ureal_t<64, 0> W;
+  accumulator<W, 64> top( (W(index(boost::uint64_t(1)))));
+  for (int i = 0; i < 127; ++i)
+    top += top;
+  top += W(index(W::max_index));
+  const boost::uint64_t half = boost::uint64_t(1) << 63;
+  BOOST_TEST((top.get<ureal_t<128, 64, round::negative> >().count() == half));
+  BOOST_TEST((top.get<ureal_t<128, 64, round::truncated> >().count() == half));
+  BOOST_TEST((top.get<ureal_t<128, 64, round::positive> >().count() == half + 1));
+  BOOST_TEST((top.get<ureal_t<128, 64, round::nearest_half_up> >().count() == half + 1));
+}
+
+int main()
+{
+  std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+  check_operators<true>();
+  std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+  check_operators<false>();
+  std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+  check_wide_multiply();
+  std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+  check_accumulators();
+  return boost::report_errors();
+}
@@ -0,0 +1,189 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <iostream>
+#include <cmath>
+#include <boost/fixed_point/math.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/detail/lightweight_test.hpp>
+#include "random.hpp"
+
+using namespace boost::fixed_point;
+
+BOOST_STATIC_ASSERT((boost::is_same<sqrt_result<real_t<15, -16> >::type, real_t<8, -8> >::value));
+BOOST_STATIC_ASSERT((boost::is_same<sqrt_result<ureal_t<15, -15> >::type, ureal_t<8, -8> >::value));
+BOOST_STATIC_ASSERT((boost::is_same<sqrt_result<ureal_t<-3, -20> >::type, ureal_t<-1, -10> >::value));
+BOOST_STATIC_ASSERT((boost::is_same<reciprocal_result<real_t<15, -16> >::type, real_t<17, -15> >::value));
+BOOST_STATIC_ASSERT((boost::is_same<rsqrt_result<ureal_t<15, -16> >::type, ureal_t<9, -8> >::value));
+
+// Pseudo random indices in [0, max], with many small values.
+unsigned long long next_index(unsigned long long& state, unsigned long long max)
+{
+  unsigned long long r = test::next_random(state), v = r >> 11;
+  return (r & 1) ? v % 1024 : v % (max + 1);
+}
+
+// The floor of the square root of n for each rounding policy, checked on integers:
+// n is between the squares of res - 1, res - 1/2, res, res + 1/2 or res + 1, depending on the policy.
+bool check_root(unsigned long long n, unsigned long long res, char kind)
+{
+  switch (kind)
+  {
+  case 'n':
+    return res * res <= n && (res + 1) * (res + 1) > n;
+  case 'p':
+    return res * res >= n && (res == 0 || (res - 1) * (res - 1) < n);
+  default:
+    return (2 * res + 1) * (2 * res + 1) > 4 * n && (res == 0 || (2 * res - 1) * (2 * res - 1) < 4 * n);
+  }
+}
+
+template <typename RP>
+void check_sqrt(char kind)
+{
+  typedef ureal_t<15, -16, RP> T;
+  typedef ureal_t<8, -12, RP> Res;
+  unsigned long long state = 1;
+  for (int i = 0; i < 10000; ++i)
+  {
+    T x( (index(next_index(state, T::max_index))));
+    // the index of the root of x at the resolution 2^-12 is the root of x.count() * 2^8
+    BOOST_TEST(check_root((unsigned long long) x.count() << 8, sqrt<Res>(x).count(), kind));
+    BOOST_TEST(check_root(x.count(), sqrt(x).count(), kind));
+    // roots of more than 24 bits are computed one bit at a time
+    if (kind != 'h')
+      BOOST_TEST(check_root((unsigned long long) x.count() << 32, (sqrt<ureal_t<8, -24, RP> >(x).count()), kind));
+    real_t<15, -16, RP> y( (index((long long) (x.count() >> 1))));
+    BOOST_TEST(check_root(y.count(), sqrt(y).count(), kind));
+  }
+}
+
+// |result - reference| must be below ulp.
+bool close(double result, double reference, double ulp)
+{
+  return std::fabs(result - reference) < ulp * (1 + 1e-9);
+}
+
+template <typename RP>
+void check_reciprocals(bool nearest)
+{
+  typedef real_t<15, -16, RP> T;
+  typedef real_t<17, -32, RP> Res;
+  typedef real_t<9, -20, RP> RootRes;
+  double ulp = std::ldexp(nearest ? 0.5 : 1.0, -32);
+  double root_ulp = std::ldexp(nearest ? 0.5 : 1.0, -20);
+  unsigned long long state = 2;
+  for (int i = 0; i < 10000; ++i)
+  {
+    long long c = (long long) next_index(state, T::max_index - 1) + 1;
+    T x( (index(c)));
+    T y( (index(-c)));
+    double d = x.as_double();
+    BOOST_TEST(close(reciprocal<Res>(x).as_double(), 1 / d, ulp));
+    BOOST_TEST(close(reciprocal<Res>(y).as_double(), -1 / d, ulp));
+    BOOST_TEST(close(reciprocal(x).as_double(), 1 / d, std::ldexp(1.0, -15)));
+    BOOST_TEST(close(rsqrt<RootRes>(x).as_double(), 1 / std::sqrt(d), root_ulp));
+    BOOST_TEST(close(rsqrt(x).as_double(), 1 / std::sqrt(d), std::ldexp(1.0, -8)));
+  }
+}
+
+template <typename RP>
+void check_exponentials()
+{
+  typedef real_t<7, -24, RP> T;
+  typedef real_t<24, -30, RP> Res;
+  unsigned long long state = 3;
+  for (int i = 0; i < 10000; ++i)
+  {
+    // x in ]-32, 16[
+    long long c = (long long) next_index(state, (48LL << 24) - 2) - (32LL << 24) + 1;
+    T x( (index(c)));
+    double e = std::pow(2.0, x.as_double());
+    BOOST_TEST(close(exp2<Res>(x).as_double(), e, std::ldexp(1.0, -30)));
+    if (c > 0)
+      BOOST_TEST(close(log2<Res>(x).as_double(), std::log(x.as_double()) / std::log(2.0), std::ldexp(1.0, -30)));
+  }
+  for (int i = -100; i <= 100; ++i)
+  {
+    BOOST_TEST(exp2<Res>(T(i / 8.0)).count() == Res(std::pow(2.0, i / 8.0)).count() ||
+        close(exp2<Res>(T(i / 8.0)).as_double(), std::pow(2.0, i / 8.0), std::ldexp(1.0, -30)));
+  }
+  for (int i = -20; i <= 6; ++i)
+  {
+    BOOST_TEST(exp2<Res>(T(i)).count() == Res(std::ldexp(1.0, i)).count());
+    BOOST_TEST(log2<Res>(T(std::ldexp(1.0, i))).count() == Res(double(i)).count());
+  }
+}
+
+int main()
+{
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    check_sqrt<round::negative>('n');
+    check_sqrt<round::truncated>('n');
+    check_sqrt<round::positive>('p');
+    check_sqrt<round::nearest_half_up>('h');
+    check_sqrt<round::nearest_even>('h');
+  }
+  // exactly half roots
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    ureal_t<8, -4> x(6.25);
+    BOOST_TEST( (sqrt<ureal_t<4, 0, round::nearest_half_up> >(x).count() == 3));
+    BOOST_TEST( (sqrt<ureal_t<4, 0, round::nearest_half_down> >(x).count() == 2));
+    BOOST_TEST( (sqrt<ureal_t<4, 0, round::nearest_even> >(x).count() == 2));
+    BOOST_TEST( (sqrt<ureal_t<4, 0, round::nearest_odd> >(x).count() == 3));
+    BOOST_TEST( (sqrt<ureal_t<4, 0, round::negative> >(x).count() == 2));
+    BOOST_TEST( (sqrt<ureal_t<4, 0, round::positive> >(x).count() == 3));
+    BOOST_TEST( (sqrt<ureal_t<4, 0, round::nearest_even> >(ureal_t<8, -4>(6.3125)).count() == 3));
+  }
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    check_reciprocals<round::negative>(false);
+    check_reciprocals<round::positive>(false);
+    check_reciprocals<round::nearest_even>(true);
+  }
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    check_exponentials<round::negative>();
+    check_exponentials<round::positive>();
+    check_exponentials<round::nearest_even>();
+  }
+  // fractions of more than 64 bits, whose sign extends above the bits of the count
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    typedef ureal_t<2, -40> Res;
+    typedef real_t<-8, -70> S;
+    typedef ureal_t<-8, -70> U;
+    for (int e = 9; e <= 70; ++e)
+    {
+      BOOST_TEST(close(exp2<Res>(S(index(-(1LL << (70 - e))))).as_double(), std::pow(2.0, -std::ldexp(1.0, -e)),
+          std::ldexp(1.0, -38)));
+      BOOST_TEST(close(exp2<Res>(S(index(1LL << (70 - e)))).as_double(), std::pow(2.0, std::ldexp(1.0, -e)),
+          std::ldexp(1.0, -38)));
+      BOOST_TEST(close(exp2<Res>(U(index(boost::uint64_t(1) << (70 - e)))).as_double(),
+          std::pow(2.0, std::ldexp(1.0, -e)), std::ldexp(1.0, -38)));
+    }
+  }
+  // the overflows are handled by the policy of the result
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    typedef real_t<7, -8, round::negative, overflow::saturate> S;
+    BOOST_TEST( (exp2<S>(real_t<15, -16>(10.0)).count() == S::max_index));
+    BOOST_TEST( (exp2<S>(real_t<15, -16>(1000.0)).count() == S::max_index));
+    BOOST_TEST( (exp2<S>(real_t<15, -16>(-1000.0)).count() == 0));
+    BOOST_TEST( (reciprocal<S>(real_t<15, -16>(index(1))).count() == S::max_index));
+    try
+    {
+      exp2<real_t<7, -8> >(real_t<15, -16>(7.0));
+      BOOST_TEST(false);
+    }
+    catch (positive_overflow&)
+    {
+    }
+  }
+  return boost::report_errors();
+}
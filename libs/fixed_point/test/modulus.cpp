@@ -0,0 +1,85 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <iostream>
+#include <boost/fixed_point/number.hpp>
+#include <boost/detail/lightweight_test.hpp>
+
+using namespace boost::fixed_point;
+
+// Mathematical modulo, whose result has the sign of the divisor.
+long long mod(long long a, long long b)
+{
+  long long r = a % b;
+  return r < 0 ? r + b : r;
+}
+
+int main()
+{
+  // the policy follows the stereotype
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    typedef ureal_t<3, -4, round::negative, overflow::modulus> T;
+    BOOST_TEST( (overflow::modulus::on_positive_overflow<T, int>(128 + 5) == 5));
+    BOOST_TEST( (overflow::modulus::on_negative_overflow<T, int>(-3) == 125));
+    BOOST_TEST( (overflow::modulus::on_positive_overflow<T, long long>(1LL << 40) == 0));
+  }
+  // unsigned conversions wrap on the range
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    typedef ureal_t<3, -4, round::negative, overflow::modulus> T;
+    for (int i = 0; i < 1024; ++i)
+    {
+      ureal_t<7, -4> n1( (index(i)));
+      T n2 = number_cast<T>(n1);
+      BOOST_TEST(n2.count() == i % 128);
+    }
+    BOOST_TEST( (T(17.0).count() == 16));
+    BOOST_TEST( (T(8.5).count() == 8));
+  }
+  // signed conversions wrap on the range [min_index, max_index]
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    typedef real_t<3, -4, round::negative, overflow::modulus> T;
+    for (int i = -1000; i <= 1000; ++i)
+    {
+      real_t<7, -4> n1( (index(i)));
+      T n2 = number_cast<T>(n1);
+      BOOST_TEST(n2.count() == mod(i - T::min_index, T::max_index - T::min_index + 1) + T::min_index);
+    }
+  }
+  // the negative signed values overflow negatively on the unsigned types, also when their range holds the source
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    typedef ureal_t<3, -4, round::negative, overflow::modulus> T;
+    typedef ureal_t<3, -4, round::negative, overflow::saturate> S;
+    typedef ureal_t<40, -4, round::negative, overflow::saturate> W;
+    for (int i = -1000; i <= 1000; ++i)
+    {
+      real_t<7, -4> n1( (index(i)));
+      BOOST_TEST(number_cast<T>(n1).count() == mod(i, 128));
+      BOOST_TEST(number_cast<S>(n1).count() == (i < 0 ? 0 : (i > 127 ? 127 : i)));
+      BOOST_TEST(number_cast<W>(n1).count() == boost::uint64_t(i < 0 ? 0 : i));
+      real_t<2, -4> n2( (index(i % 64)));
+      BOOST_TEST(number_cast<T>(n2).count() == mod(i % 64, 128));
+      BOOST_TEST(number_cast<S>(n2).count() == (i % 64 < 0 ? 0 : i % 64));
+    }
+  }
+  // phase accumulator
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    typedef ureal_t<0, -16, round::negative, overflow::modulus> phase_t;
+    phase_t phase( (index(0)));
+    const phase_t increment( (index(40000)));
+    unsigned long expected = 0;
+    for (int i = 0; i < 1000; ++i)
+    {
+      phase = number_cast<phase_t>(phase + increment);
+      expected = (expected + 40000) % 65536;
+      BOOST_TEST(phase.count() == expected);
+    }
+  }
+  return boost::report_errors();
+}
@@ -0,0 +1,139 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <iostream>
+#include <vector>
+#include <boost/fixed_point/number.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/detail/lightweight_test.hpp>
+#include "random.hpp"
+
+using namespace boost::fixed_point;
+
+typedef real_t<7, -8> Q;
+typedef rebind_storage<Q, storage::native>::type N;
+typedef ureal_t<8, -8> U;
+typedef rebind_storage<U, storage::native>::type NU;
+
+// The numbers and the intermediate results of the chains of operations are on the integer registers, so that no sign
+// or zero extension is needed between the operations.
+BOOST_STATIC_ASSERT((boost::is_same<N, real_t<7, -8, round::negative, overflow::exception,
+    family<storage::native> > >::value));
+BOOST_STATIC_ASSERT((boost::is_same<rebind_storage<N, storage::space>::type, Q>::value));
+BOOST_STATIC_ASSERT((boost::is_same<Q::underlying_type, boost::int16_t>::value));
+BOOST_STATIC_ASSERT((boost::is_same<N::underlying_type, detail::register_int>::value));
+BOOST_STATIC_ASSERT((boost::is_same<NU::underlying_type, detail::register_uint>::value));
+BOOST_STATIC_ASSERT((boost::is_same<multiply_result<N>::type::underlying_type, detail::register_int>::value));
+BOOST_STATIC_ASSERT((boost::is_same<add_result<multiply_result<N>::type, N>::type::underlying_type,
+    detail::register_int>::value));
+BOOST_STATIC_ASSERT((boost::is_same<add_result<NU>::type::underlying_type, detail::register_uint>::value));
+BOOST_STATIC_ASSERT((sizeof(detail::register_int) == sizeof(void*)));
+// the wider numbers keep the least integer with enough bits
+BOOST_STATIC_ASSERT((boost::is_same<rebind_storage<real_t<15, -16>, storage::native>::type::underlying_type,
+    detail::register_int>::value || sizeof(detail::register_int) < 4));
+#if defined(BOOST_FIXED_POINT_HAS_INT128)
+BOOST_STATIC_ASSERT((boost::is_same<rebind_storage<real_t<40, -40>, storage::native>::type::underlying_type,
+    boost::int128_type>::value));
+#endif
+
+// Pseudo random numbers of T, including the extreme ones.
+template <typename T>
+std::vector<T> noise(std::size_t n, unsigned long long seed)
+{
+  const long double lo = (long double) (T::min_index), hi = (long double) (T::max_index);
+  std::vector<T> res;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    long double u = test::random_fraction(seed);
+    typename T::underlying_type c = typename T::underlying_type(lo + u * (hi - lo + 1));
+    if (i % 7 == 0) c = T::min_index;
+    if (i % 11 == 0) c = T::max_index;
+    res.push_back(T(index(c)));
+  }
+  return res;
+}
+
+// The leaky integrator y[i] = a * y[i-1] + x[i] on numbers of type C, the elements being of type T.
+template <typename T, typename C>
+std::vector<T> chain(std::vector<T> const& x, double a)
+{
+  std::vector<T> y(x.size(), T(index(0)));
+  const C ca(a);
+  C s = C(index(0));
+  for (std::size_t i = 0; i < x.size(); ++i)
+  {
+    s = number_cast<C>(ca * s + C(x[i]));
+    y[i] = T(s);
+  }
+  return y;
+}
+
+// The chains give the same elements on registers as on the storage of the elements.
+template <typename T>
+void check_chain()
+{
+  typedef typename rebind_storage<T, storage::native>::type C;
+  std::vector<T> x = noise<T>(1000, 1);
+  const double as[] = { 0.875, -0.5, 0.9921875 };
+  for (std::size_t k = 0; k < sizeof(as) / sizeof(as[0]); ++k)
+  {
+    std::vector<T> expected = chain<T, T>(x, as[k]);
+    std::vector<T> y = chain<T, C>(x, as[k]);
+    for (std::size_t i = 0; i < x.size(); ++i)
+      BOOST_TEST_EQ(y[i].count(), expected[i].count());
+  }
+}
+
+// The operations of two numbers give the same values on both storages.
+template <typename T>
+void check_operations()
+{
+  typedef typename rebind_storage<T, storage::native>::type C;
+  std::vector<T> x = noise<T>(200, 2), y = noise<T>(200, 3);
+  for (std::size_t i = 0; i < x.size(); ++i)
+  {
+    C a = x[i], b = y[i];
+    BOOST_TEST_EQ(a.count(), x[i].count());
+    BOOST_TEST_EQ((a + b).count(), (x[i] + y[i]).count());
+    // the differences of two ureal_t are not negative
+    if (!(x[i] < y[i]))
+      BOOST_TEST_EQ((a - b).count(), (x[i] - y[i]).count());
+    BOOST_TEST_EQ((a * b).count(), (x[i] * y[i]).count());
+    BOOST_TEST_EQ((a < b), (x[i] < y[i]));
+    BOOST_TEST_EQ((a == b), (x[i] == y[i]));
+    BOOST_TEST_EQ(a.as_double(), x[i].as_double());
+    BOOST_TEST_EQ(T(number_cast<C>(a * b)).count(), number_cast<T>(x[i] * y[i]).count());
+  }
+}
+
+int main()
+{
+  std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+  check_chain<real_t<7, -8, round::negative, overflow::saturate> >();
+  check_chain<real_t<7, -8, round::nearest_even, overflow::saturate> >();
+  check_chain<real_t<15, -16, round::truncated, overflow::saturate> >();
+  check_chain<real_t<3, -12, round::nearest_half_up, overflow::saturate> >();
+  std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+  check_operations<real_t<7, -8, round::negative, overflow::saturate> >();
+  check_operations<real_t<15, -16, round::nearest_even, overflow::saturate> >();
+  check_operations<ureal_t<8, -8, round::negative, overflow::saturate> >();
+  // the overflows are detected on the registers as on the storage
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    N a(100.0), b(100.0);
+    try
+    {
+      number_cast<N>(a + b);
+      BOOST_TEST(false);
+    }
+    catch (positive_overflow&)
+    {
+    }
+    typedef rebind_storage<real_t<7, -8, round::negative, overflow::saturate>, storage::native>::type S;
+    BOOST_TEST_EQ(number_cast<S>(a * b).count(), S::underlying_type(S::max_index));
+  }
+  return boost::report_errors();
+}
@@ -0,0 +1,168 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <iostream>
+#include <vector>
+#include <boost/fixed_point/packed.hpp>
+#include <boost/detail/lightweight_test.hpp>
+#include "random.hpp"
+
+using namespace boost::fixed_point;
+
+// Pseudo random numbers of T, including the extreme ones.
+template <typename T>
+std::vector<T> noise(std::size_t n, unsigned long long seed)
+{
+  const long double lo = (long double) (T::min_index), hi = (long double) (T::max_index);
+  std::vector<T> res;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    long double u = test::random_fraction(seed);
+    typename T::underlying_type c = typename T::underlying_type(lo + u * (hi - lo + 1));
+    if (i % 7 == 0) c = T::min_index;
+    if (i % 11 == 0) c = T::max_index;
+    res.push_back(T(index(c)));
+  }
+  return res;
+}
+
+template <typename T>
+void check_equal(packed_array<T> const& a, std::vector<T> const& x)
+{
+  BOOST_TEST_EQ(a.size(), x.size());
+  for (std::size_t i = 0; i < x.size(); ++i)
+    BOOST_TEST_EQ(a[i].count(), x[i].count());
+}
+
+// The elements read and written one by one, through the proxies and the iterators.
+template <typename T>
+void check_elements()
+{
+  std::vector<T> x = noise<T>(200, 1);
+  packed_array<T> a(x.size());
+  BOOST_TEST_EQ(a.storage_size(), (x.size() * T::digits + 7) / 8);
+  for (std::size_t i = 0; i < x.size(); ++i)
+    BOOST_TEST_EQ(a[i].count(), 0);
+  for (std::size_t i = 0; i < x.size(); ++i)
+    a[i] = x[i];
+  check_equal(a, x);
+  typename packed_array<T>::iterator it = a.begin();
+  BOOST_TEST_EQ(a.end() - it, std::ptrdiff_t(x.size()));
+  BOOST_TEST_EQ((*(it + 5)).count(), x[5].count());
+  BOOST_TEST_EQ(it[7].count(), x[7].count());
+  it[3] = it[4];
+  BOOST_TEST_EQ(a[3].count(), x[4].count());
+  a[3] = x[3];
+  std::size_t n = 0;
+  for (typename packed_array<T>::const_iterator c = a.begin(); c != a.end(); ++c, ++n)
+    BOOST_TEST_EQ((*c).count(), x[n].count());
+  BOOST_TEST_EQ(n, x.size());
+  // the neighbors are not changed
+  a.set(10, T(index(T::max_index)));
+  a.set(11, T(index(T::min_index)));
+  BOOST_TEST_EQ(a[9].count(), x[9].count());
+  BOOST_TEST_EQ(a[12].count(), x[12].count());
+  // shrinking then growing appends zeros
+  a.resize(50);
+  a.resize(60);
+  BOOST_TEST_EQ(a[49].count(), x[49].count());
+  for (std::size_t i = 50; i < 60; ++i)
+    BOOST_TEST_EQ(a[i].count(), 0);
+  packed_array<T> b;
+  for (std::size_t i = 0; i < x.size(); ++i)
+    b.push_back(x[i]);
+  check_equal(b, x);
+}
+
+// The batch conversions on ranges starting at every bit of a byte, with tails, keeping the other elements.
+template <typename T>
+void check_batch()
+{
+  const std::size_t n = 300;
+  std::vector<T> x = noise<T>(n, 2), y = noise<T>(n, 3);
+  packed_array<T> a(&x[0], &x[0] + n);
+  check_equal(a, x);
+  std::vector<T> r(n, T(index(0)));
+  batch::unpack(a, 0, &r[0], n);
+  for (std::size_t i = 0; i < n; ++i)
+    BOOST_TEST_EQ(r[i].count(), x[i].count());
+  for (std::size_t first = 0; first < 9; ++first)
+  {
+    for (std::size_t m = 0; first + m <= n; m += 37 + first)
+    {
+      packed_array<T> b(&x[0], &x[0] + n);
+      batch::pack(&y[0], b, first, m);
+      std::vector<T> expected = x;
+      for (std::size_t i = 0; i < m; ++i)
+        expected[first + i] = y[i];
+      check_equal(b, expected);
+      std::vector<T> u(m + 1, T(index(0)));
+      batch::unpack(b, first, &u[0], m);
+      for (std::size_t i = 0; i < m; ++i)
+        BOOST_TEST_EQ(u[i].count(), y[i].count());
+      BOOST_TEST_EQ(u[m].count(), 0);
+    }
+  }
+}
+
+template <typename T>
+void check()
+{
+  check_elements<T>();
+  check_batch<T>();
+}
+
+void test_levels()
+{
+  const simd::level levels[] = { simd::none, simd::sse4, simd::avx2, simd::avx512 };
+  simd::level prev = simd::active();
+  for (std::size_t l = 0; l < sizeof(levels) / sizeof(levels[0]); ++l)
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "] level " << levels[l] << std::endl;
+    simd::restrict_to(levels[l]);
+    // every width on 8, 16 and 32 bits
+    check<ureal_t<1, 0> >();
+    check<real_t<1, 0> >();
+    check<ureal_t<3, 0> >();
+    check<real_t<2, -2> >();
+    check<ureal_t<0, -7> >();
+    check<real_t<0, -7> >();
+    check<ureal_t<8, 0> >();
+    check<real_t<0, -8> >();
+    check<ureal_t<4, -5> >();
+    check<real_t<4, -6> >();
+    check<real_t<4, -7> >();
+    check<ureal_t<12, -1> >();
+    check<real_t<7, -7> >();
+    check<ureal_t<15, 0> >();
+    check<real_t<0, -15> >();
+    check<ureal_t<16, 0> >();
+    check<real_t<8, -9> >();
+    check<ureal_t<10, -9> >();
+    check<real_t<11, -10> >();
+    check<ureal_t<20, -3> >();
+    check<real_t<12, -12> >();
+    check<ureal_t<25, 0> >();
+    check<real_t<26, 0> >();
+    check<ureal_t<31, 0> >();
+    check<real_t<15, -16> >();
+    check<ureal_t<16, -16> >();
+    check<real_t<20, -20> >();
+    check<ureal_t<40, -8> >();
+    check<real_t<31, -32> >();
+    check<ureal_t<64, 0> >();
+    // The register wide storage must keep off the kernels of the narrow underlying types.
+    check<rebind_storage<ureal_t<8, 0>, storage::native>::type>();
+    check<rebind_storage<real_t<4, -6>, storage::native>::type>();
+    check<rebind_storage<ureal_t<16, -16>, storage::native>::type>();
+  }
+  simd::restrict_to(prev);
+}
+
+int main()
+{
+  test_levels();
+  return boost::report_errors();
+}
@@ -0,0 +1,179 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include <boost/fixed_point/pixel.hpp>
+#include <boost/detail/lightweight_test.hpp>
+#include "random.hpp"
+
+using namespace boost::fixed_point;
+
+typedef ureal_t<8, 0> u8;
+typedef ureal_t<16, 0> u16;
+typedef ureal_t<5, 0> u5;
+// channels computed on the registers, which the kernels of the 8 and 16 bits channels don't see as bytes or words
+typedef rebind_storage<u8, storage::native>::type n8;
+typedef rebind_storage<u16, storage::native>::type n16;
+
+// Pseudo random channels in [0, hi].
+template <typename T>
+std::vector<T> noise(std::size_t n, unsigned long long hi, unsigned long long seed)
+{
+  std::vector<T> res;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    res.push_back(T(index(typename T::underlying_type(test::random_index(seed, 0, (long long) hi)))));
+  }
+  return res;
+}
+
+template <typename T>
+std::vector<T> noise(std::size_t n, unsigned long long seed)
+{
+  return noise<T>(n, (unsigned long long) (T::max_index), seed);
+}
+
+// The nearest integer to x / d, computed with a division.
+unsigned long long divide_nearest(unsigned long long x, unsigned long long d)
+{
+  return (2 * x + d) / (2 * d);
+}
+
+void test_normalized_multiply()
+{
+  for (unsigned x = 0; x < 256; ++x)
+    for (unsigned a = 0; a < 256; ++a)
+      BOOST_TEST_EQ(unsigned(normalized_multiply(u8(index(x)), u8(index(a))).count()), divide_nearest(x * a, 255));
+  for (unsigned x = 0; x < 32; ++x)
+    for (unsigned a = 0; a < 32; ++a)
+      BOOST_TEST_EQ(unsigned(normalized_multiply(u5(index(x)), u5(index(a))).count()), divide_nearest(x * a, 31));
+  std::vector<u16> x = noise<u16>(100000, 1), a = noise<u16>(100000, 2);
+  x.push_back(u16(index(65535)));
+  a.push_back(u16(index(65535)));
+  for (std::size_t i = 0; i < x.size(); ++i)
+    BOOST_TEST_EQ(normalized_multiply(x[i], a[i]).count(),
+        divide_nearest((unsigned long long) x[i].count() * a[i].count(), 65535));
+  // an opaque source hides the destination, a transparent one leaves it
+  BOOST_TEST_EQ(blend(u8(index(200)), u8(index(255)), u8(index(17))).count(), 200);
+  BOOST_TEST_EQ(blend(u8(index(0)), u8(index(0)), u8(index(17))).count(), 17);
+  // a source not premultiplied saturates
+  BOOST_TEST_EQ(blend(u8(index(250)), u8(index(10)), u8(index(250))).count(), 255);
+}
+
+// The kernels compute the same channels as the scalar functions, on sizes with tails.
+template <typename T>
+void check_planes(std::size_t n)
+{
+  std::vector<T> alpha = noise<T>(n, 3);
+  std::vector<T> c = noise<T>(n, 4), dst = noise<T>(n, 5);
+  std::vector<T> src(n, T(index(0))), res(n, T(index(0)));
+  batch::premultiply(&c[0], &alpha[0], &src[0], n);
+  for (std::size_t i = 0; i < n; ++i)
+    BOOST_TEST_EQ(src[i].count(), normalized_multiply(c[i], alpha[i]).count());
+  batch::blend(&src[0], &alpha[0], &dst[0], &res[0], n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    BOOST_TEST_EQ(res[i].count(), blend(src[i], alpha[i], dst[i]).count());
+    unsigned long long max = T::max_index;
+    BOOST_TEST_EQ(res[i].count(), src[i].count() + divide_nearest((unsigned long long) dst[i].count()
+        * (max - alpha[i].count()), max));
+  }
+  // not premultiplied, in place
+  std::vector<T> old = dst;
+  batch::blend(&c[0], &alpha[0], &dst[0], &dst[0], n);
+  for (std::size_t i = 0; i < n; ++i)
+    BOOST_TEST_EQ(dst[i].count(), blend(c[i], alpha[i], old[i]).count());
+}
+
+// The color matrices compared with the nearest integer computed with doubles.
+template <typename T, typename C>
+void check_color(double const (&m)[3][4], std::size_t n)
+{
+  color_matrix<C> cm(m);
+  std::vector<T> r = noise<T>(n, 6), g = noise<T>(n, 7), b = noise<T>(n, 8);
+  r[0] = g[0] = b[0] = T(index(T::max_index));
+  std::vector<T> rr(n, T(index(0))), gr(n, T(index(0))), br(n, T(index(0)));
+  batch::color_transform(cm, &r[0], &g[0], &b[0], &rr[0], &gr[0], &br[0], n);
+  const double max = T::max_index;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    T const* out[3] = { &rr[i], &gr[i], &br[i] };
+    for (std::size_t c = 0; c < 3; ++c)
+    {
+      double v = cm(c, 0).as_double() * r[i].count() + cm(c, 1).as_double() * g[i].count()
+          + cm(c, 2).as_double() * b[i].count() + cm(c, 3).as_double() * max;
+      v = std::floor(v + 0.5);
+      v = v < 0 ? 0 : v > max ? max : v;
+      BOOST_TEST_EQ(double(out[c]->count()), v);
+    }
+  }
+  // in place
+  batch::color_transform(cm, &r[0], &g[0], &b[0], &r[0], &g[0], &b[0], n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    BOOST_TEST_EQ(r[i].count(), rr[i].count());
+    BOOST_TEST_EQ(g[i].count(), gr[i].count());
+    BOOST_TEST_EQ(b[i].count(), br[i].count());
+  }
+}
+
+template <typename T>
+void check_lookup(std::size_t n)
+{
+  lookup_table<T> decode = gamma_table<T>(2.2);
+  const double max = T::max_index;
+  for (unsigned x = 0; x <= T::max_index; x += 1 + T::max_index / 1000)
+    BOOST_TEST_EQ(double(decode(T(index(x))).count()), std::floor(max * std::pow(x / max, 2.2) + 0.5));
+  std::vector<T> x = noise<T>(n, 9), y(n, T(index(0)));
+  batch::lookup(decode, &x[0], &y[0], n);
+  for (std::size_t i = 0; i < n; ++i)
+    BOOST_TEST_EQ(y[i].count(), decode(x[i]).count());
+  batch::lookup(decode, &x[0], &x[0], n);
+  for (std::size_t i = 0; i < n; ++i)
+    BOOST_TEST_EQ(x[i].count(), y[i].count());
+}
+
+void test_levels()
+{
+  // sepia, with the greatest coefficients, and with offsets
+  const double sepia[3][4] = { { 0.393, 0.769, 0.189, 0 }, { 0.349, 0.686, 0.168, 0 }, { 0.272, 0.534, 0.131, 0 } };
+  const double extreme[3][4] = { { 7.9, -7.9, 7.9, -7.9 }, { -7.9, -7.9, -7.9, 7.9 }, { 1, 0, 0, 0.25 } };
+  const double invert[3][4] = { { -1, 0, 0, 1 }, { 0, -1, 0, 1 }, { 0, 0, -1, 1 } };
+  const double coarse[3][4] = { { 0.5, 0.25, 0.25, 0 }, { 1, 1, -1, 0 }, { 0, 2, 0, -0.5 } };
+  const simd::level levels[] = { simd::none, simd::sse4, simd::avx2, simd::avx512 };
+  simd::level prev = simd::active();
+  for (std::size_t l = 0; l < sizeof(levels) / sizeof(levels[0]); ++l)
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "] level " << levels[l] << std::endl;
+    simd::restrict_to(levels[l]);
+    check_planes<u8>(1000);
+    check_planes<u16>(1000);
+    check_planes<u5>(100);
+    check_color<u8, real_t<3, -12> >(sepia, 1003);
+    check_color<u8, real_t<3, -12> >(extreme, 1003);
+    check_color<u8, real_t<3, -12> >(invert, 1003);
+    check_color<u8, real_t<7, -2> >(coarse, 1003);
+    check_color<u8, real_t<15, 0> >(invert, 1003);
+    check_color<u16, real_t<3, -12> >(sepia, 1003);
+    check_color<u16, real_t<3, -28> >(extreme, 1003);
+    check_lookup<u8>(1000);
+    check_lookup<u16>(1000);
+    check_planes<n8>(100);
+    check_planes<n16>(100);
+    check_color<n8, real_t<3, -12> >(sepia, 103);
+    check_lookup<n8>(100);
+    check_lookup<n16>(100);
+  }
+  simd::restrict_to(prev);
+}
+
+int main()
+{
+  test_normalized_multiply();
+  test_levels();
+  return boost::report_errors();
+}
@@ -0,0 +1,58 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Pseudo random numbers of the Boost.FixedPoint tests.
+//
+// The tests draw their data from the linear congruential generator of Knuth's MMIX, seeded by each test, so that the
+// data is the same on every platform. The ranges are computed in unsigned arithmetic, so that the indices of the
+// 64 bits numbers don't overflow.
+
+#ifndef BOOST_FIXED_POINT_TEST_RANDOM_HPP
+#define BOOST_FIXED_POINT_TEST_RANDOM_HPP
+
+namespace boost
+{
+  namespace fixed_point
+  {
+    namespace test
+    {
+      //! @Effects advances the generator. @Returns the new state, whose high bits are the most random ones.
+      inline unsigned long long next_random(unsigned long long& state)
+      {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return state;
+      }
+
+      /**
+       * @Returns the integer of <c>[lo, hi]</c> congruent to @c v modulo <c>hi - lo + 1</c>, @c v itself when the
+       * range is the whole range of the 64 bits integers.
+       */
+      inline long long wrap_index(long long v, long long lo, long long hi)
+      {
+        unsigned long long span = (unsigned long long) hi - (unsigned long long) lo + 1;
+        unsigned long long r = (unsigned long long) v - (unsigned long long) lo;
+        if (span != 0) r %= span;
+        return (long long) ((unsigned long long) lo + r);
+      }
+
+      //! @Effects advances the generator. @Returns a pseudo random integer of <c>[lo, hi]</c>.
+      inline long long random_index(unsigned long long& state, long long lo, long long hi)
+      {
+        unsigned long long span = (unsigned long long) hi - (unsigned long long) lo + 1;
+        unsigned long long r = next_random(state) >> 11;
+        if (span != 0) r %= span;
+        return (long long) ((unsigned long long) lo + r);
+      }
+
+      //! @Effects advances the generator. @Returns a pseudo random fraction of <c>[0, 1[</c> with 53 bits.
+      inline long double random_fraction(unsigned long long& state)
+      {
+        return (long double) (next_random(state) >> 11) / (long double) (1ULL << 53);
+      }
+    }
+  }
+}
+
+#endif // header
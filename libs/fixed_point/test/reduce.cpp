@@ -0,0 +1,82 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <iostream>
+#include <vector>
+#include <boost/fixed_point/reduce.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/detail/lightweight_test.hpp>
+#include "random.hpp"
+
+using namespace boost::fixed_point;
+
+BOOST_STATIC_ASSERT((boost::is_same<sum_result<real_t<15, -16> >::type, real_t<47, -16> >::value));
+BOOST_STATIC_ASSERT((boost::is_same<sum_result<ureal_t<7, -8> >::type, ureal_t<39, -8> >::value));
+BOOST_STATIC_ASSERT((boost::is_same<dot_result<real_t<7, -8> >::type, real_t<46, -16> >::value));
+BOOST_STATIC_ASSERT((boost::is_same<dot_result<ureal_t<7, -8>, real_t<3, -4> >::type, real_t<42, -12> >::value));
+
+int main()
+{
+  typedef real_t<15, -16> T;
+  typedef real_t<7, -8> U;
+  const std::size_t n = 100003;
+  std::vector<T> x;
+  std::vector<U> a;
+  std::vector<U> b;
+  long long sum_x = 0;
+  long long dot_ab = 0;
+  unsigned long long state = 1;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    // the extreme values, whose running sums overflow T
+    long long c = (i % 7 == 0) ? T::max_index : test::random_index(state, -T::max_index, T::max_index);
+    x.push_back(T(index(c)));
+    sum_x += c;
+    long long ca = test::random_index(state, -U::max_index, U::max_index);
+    long long cb = test::random_index(state, -U::max_index, U::max_index);
+    a.push_back(U(index(ca)));
+    b.push_back(U(index(cb)));
+    dot_ab += ca * cb;
+  }
+  // the sequential reductions are exact
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    BOOST_TEST(batch::sum(&x[0], n).count() == sum_x);
+    BOOST_TEST(batch::dot(&a[0], &b[0], n).count() == dot_ab);
+    BOOST_TEST(batch::sum(&x[0], 0).count() == 0);
+    BOOST_TEST(batch::sum(&x[0], 1).count() == x[0].count());
+  }
+  // the parallel reductions give the same bits whatever the number of threads
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    for (unsigned threads = 0; threads <= 9; ++threads)
+    {
+      for (std::size_t m = n - 3; m <= n; ++m)
+      {
+        BOOST_TEST(batch::parallel_sum(&x[0], m, threads) == batch::sum(&x[0], m));
+        BOOST_TEST(batch::parallel_dot(&a[0], &b[0], m, threads) == batch::dot(&a[0], &b[0], m));
+      }
+      BOOST_TEST(batch::parallel_sum(&x[0], 100, threads) == batch::sum(&x[0], 100));
+    }
+  }
+  // the unsigned and the mixed reductions
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    std::vector<ureal_t<7, -8> > u;
+    unsigned long long sum_u = 0;
+    long long dot_ux = 0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      u.push_back(ureal_t<7, -8>(index(i % 32768)));
+      sum_u += i % 32768;
+      dot_ux += (long long) (i % 32768) * x[i].count();
+    }
+    BOOST_TEST(batch::sum(&u[0], n).count() == sum_u);
+    BOOST_TEST(batch::parallel_sum(&u[0], n, 4).count() == sum_u);
+    BOOST_TEST(batch::parallel_dot(&u[0], &x[0], n, 3).count() == dot_ux);
+  }
+  return boost::report_errors();
+}
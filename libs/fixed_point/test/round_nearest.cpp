@@ -0,0 +1,151 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <iostream>
+#include <boost/fixed_point/number.hpp>
+#include <boost/detail/lightweight_test.hpp>
+
+using namespace boost::fixed_point;
+
+// Reference nearest rounding of n / 2^d computed with a floor division and an explicit comparison of the remainder.
+// tie is one of 'u' (half up), 'd' (half down), 'e' (even) and 'o' (odd).
+long long reference(long long n, int d, char tie)
+{
+  long long den = 1LL << d;
+  long long f = n >= 0 ? n / den : - ( (-n + den - 1) / den);
+  long long r = n - f * den;
+  if (2 * r > den) return f + 1;
+  if (2 * r < den) return f;
+  switch (tie)
+  {
+  case 'u':
+    return f >= 0 ? f + 1 : f;
+  case 'd':
+    return f >= 0 ? f : f + 1;
+  case 'e':
+    return (f % 2 == 0) ? f : f + 1;
+  default:
+    return (f % 2 == 0) ? f + 1 : f;
+  }
+}
+
+template <typename Rounding>
+void check_number_cast(char tie)
+{
+  for (int i = -64; i <= 63; ++i)
+  {
+    real_t<4, -3> n1( (index(i)));
+    real_t<4, -1, Rounding> n2 = number_cast<real_t<4, -1, Rounding> > (n1);
+    BOOST_TEST(n2.count() == reference(i, 2, tie));
+  }
+}
+
+int main()
+{
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    real_t<2, -3> n1( (index(2)));
+    real_t<2, -2, round::nearest_half_up> n2(n1);
+    BOOST_TEST(n2.count() == 1);
+  }
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    real_t<2, -3> n1( (index(-1)));
+    real_t<2, -2, round::nearest_half_up> n2(n1);
+    BOOST_TEST(n2.count() == -1);
+  }
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    real_t<2, -3> n1( (index(1)));
+    real_t<2, -2, round::nearest_half_down> n2(n1);
+    BOOST_TEST(n2.count() == 0);
+  }
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    real_t<2, -3> n1( (index(-1)));
+    real_t<2, -2, round::nearest_half_down> n2(n1);
+    BOOST_TEST(n2.count() == 0);
+  }
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    real_t<2, -3> n1( (index(3)));
+    real_t<2, -2, round::nearest_even> n2(n1);
+    BOOST_TEST(n2.count() == 2);
+  }
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    real_t<2, -3> n1( (index(3)));
+    real_t<2, -2, round::nearest_odd> n2(n1);
+    BOOST_TEST(n2.count() == 1);
+  }
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    ureal_t<2, -3> n1( (index(3)));
+    ureal_t<2, -2, round::nearest_half_up> n2(n1);
+    BOOST_TEST(n2.count() == 2);
+  }
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    ureal_t<2, -3> n1( (index(3)));
+    ureal_t<2, -2, round::nearest_half_down> n2(n1);
+    BOOST_TEST(n2.count() == 1);
+  }
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    check_number_cast<round::nearest_half_up>('u');
+    check_number_cast<round::nearest_half_down>('d');
+    check_number_cast<round::nearest_even>('e');
+    check_number_cast<round::nearest_odd>('o');
+  }
+  // C(double)
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    BOOST_TEST( (real_t<4, -1, round::nearest_half_up>(1.25).count() == 3));
+    BOOST_TEST( (real_t<4, -1, round::nearest_half_up>(-1.25).count() == -3));
+    BOOST_TEST( (real_t<4, -1, round::nearest_half_down>(1.25).count() == 2));
+    BOOST_TEST( (real_t<4, -1, round::nearest_half_down>(-1.25).count() == -2));
+    BOOST_TEST( (real_t<4, -1, round::nearest_even>(1.25).count() == 2));
+    BOOST_TEST( (real_t<4, -1, round::nearest_even>(-1.75).count() == -4));
+    BOOST_TEST( (real_t<4, -1, round::nearest_odd>(1.25).count() == 3));
+    BOOST_TEST( (real_t<4, -1, round::nearest_odd>(-1.75).count() == -3));
+    BOOST_TEST( (real_t<4, -1, round::nearest_even>(1.3).count() == 3));
+    BOOST_TEST( (real_t<4, -1, round::nearest_odd>(-1.2).count() == -2));
+  }
+  // divide
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    real_t<2, 0> n1( (index(3)));
+    real_t<2, 0> n2( (index(2)));
+    BOOST_TEST( (divide<real_t<3, 0, round::nearest_half_up> > (n1, n2).count() == 2));
+    BOOST_TEST( (divide<real_t<3, 0, round::nearest_half_down> > (n1, n2).count() == 1));
+    BOOST_TEST( (divide<real_t<3, 0, round::nearest_even> > (n1, n2).count() == 2));
+    BOOST_TEST( (divide<real_t<3, 0, round::nearest_odd> > (n1, n2).count() == 1));
+  }
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    real_t<2, 0> n1( (index(-3)));
+    real_t<2, 0> n2( (index(2)));
+    BOOST_TEST( (divide<real_t<3, 0, round::nearest_half_up> > (n1, n2).count() == -2));
+    BOOST_TEST( (divide<real_t<3, 0, round::nearest_half_down> > (n1, n2).count() == -1));
+    BOOST_TEST( (divide<real_t<3, 0, round::nearest_even> > (n1, n2).count() == -2));
+    BOOST_TEST( (divide<real_t<3, 0, round::nearest_odd> > (n1, n2).count() == -1));
+  }
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    real_t<4, 0> n1( (index(5)));
+    real_t<4, 0> n2( (index(-3)));
+    BOOST_TEST( (divide<real_t<4, -2, round::nearest_half_up> > (n1, n2).count() == -7));
+    BOOST_TEST( (divide<real_t<4, -2, round::nearest_even> > (n1, n2).count() == -7));
+  }
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    real_t<4, 0> n1( (index(7)));
+    real_t<4, 0> n2( (index(3)));
+    BOOST_TEST( (divide<real_t<4, 0, round::nearest_half_down> > (n1, n2).count() == 2));
+    real_t<4, 0> n3( (index(8)));
+    BOOST_TEST( (divide<real_t<4, 0, round::nearest_half_down> > (n3, n2).count() == 3));
+  }
+  return boost::report_errors();
+}
@@ -0,0 +1,92 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <iostream>
+#include <vector>
+#include <boost/fixed_point/batch.hpp>
+#include <boost/detail/lightweight_test.hpp>
+
+using namespace boost::fixed_point;
+
+typedef real_t<15, -16, round::nearest_even, overflow::sticky<> > q15_16;
+typedef real_t<15, -16, round::nearest_even, overflow::saturate> saturated;
+
+void check_batch(std::size_t n, std::size_t at, long long value, unsigned expected)
+{
+  std::vector<real_t<31, -32> > from(n, real_t<31, -32>(index(3LL << 30)));
+  std::vector<double> from_double(n, 0.75);
+  if (at < n)
+  {
+    from[at] = real_t<31, -32>(index(value));
+    from_double[at] = value / 4294967296.0;
+  }
+  std::vector<q15_16> to(n);
+  overflow::reset_sticky_status();
+  batch::number_cast(&from[0], &to[0], n);
+  BOOST_TEST(overflow::reset_sticky_status() == expected);
+  for (std::size_t i = 0; i < n; ++i)
+    BOOST_TEST(to[i].count() == number_cast<saturated>(from[i]).count());
+  std::vector<q15_16> to_double(n);
+  batch::number_cast(&from_double[0], &to_double[0], n);
+  BOOST_TEST(overflow::reset_sticky_status() == expected);
+  for (std::size_t i = 0; i < n; ++i)
+    BOOST_TEST(to_double[i].count() == saturated(from_double[i]).count());
+}
+
+int main()
+{
+  // nothing recorded without overflow
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    overflow::reset_sticky_status();
+    q15_16 n1(1.5);
+    q15_16 n2 = number_cast<q15_16>(real_t<31, -32>(index(1LL << 40)));
+    BOOST_TEST(n1.count() == 3 << 15);
+    BOOST_TEST(n2.count() == 1 << 24);
+    BOOST_TEST(overflow::sticky_status() == overflow::no_overflow);
+  }
+  // the overflowing values are saturated and the flags stick until reset
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    q15_16 n1(40000.0);
+    BOOST_TEST(n1.count() == q15_16::max_index);
+    BOOST_TEST(overflow::sticky_status() == overflow::positive_overflow_flag);
+    q15_16 n2(1.0);
+    BOOST_TEST(overflow::sticky_status() == overflow::positive_overflow_flag);
+    q15_16 n3 = number_cast<q15_16>(real_t<31, -32>(index(-(1LL << 60))));
+    BOOST_TEST(n3.count() == q15_16::min_index);
+    BOOST_TEST(overflow::sticky_status() == (overflow::positive_overflow_flag | overflow::negative_overflow_flag));
+    BOOST_TEST(overflow::reset_sticky_status()
+        == (overflow::positive_overflow_flag | overflow::negative_overflow_flag));
+    BOOST_TEST(overflow::sticky_status() == overflow::no_overflow);
+  }
+  // the handling of the value is delegated
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    typedef real_t<15, -16, round::negative, overflow::sticky<overflow::exception> > throwing;
+    try
+    {
+      throwing n1(-40000.0);
+      BOOST_TEST(false);
+    }
+    catch (negative_overflow&)
+    {
+    }
+    BOOST_TEST(overflow::reset_sticky_status() == overflow::negative_overflow_flag);
+  }
+  const simd::level levels[] =
+  { simd::none, simd::sse4, simd::avx2, simd::avx512 };
+  for (std::size_t l = 0; l < sizeof(levels) / sizeof(levels[0]); ++l)
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "] level " << levels[l] << std::endl;
+    simd::restrict_to(levels[l]);
+    check_batch(1000, 1000, 0, overflow::no_overflow);
+    check_batch(1000, 501, 1LL << 50, overflow::positive_overflow_flag);
+    check_batch(1000, 10, -(1LL << 50), overflow::negative_overflow_flag);
+    check_batch(1003, 1001, 1LL << 50, overflow::positive_overflow_flag);
+    check_batch(7, 3, -(1LL << 50), overflow::negative_overflow_flag);
+  }
+  return boost::report_errors();
+}
@@ -0,0 +1,169 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <iostream>
+#include <cmath>
+#include <boost/fixed_point/trigonometric.hpp>
+#include <boost/detail/lightweight_test.hpp>
+#include "random.hpp"
+
+using namespace boost::fixed_point;
+
+const double two_pi = 6.283185307179586476925286766559;
+
+// |result - reference| must be below ulp.
+bool close(double result, double reference, double ulp)
+{
+  return std::fabs(result - reference) < ulp * (1 + 1e-9);
+}
+
+// The error before the rounding is below the quarter of the resolution, so the error after it is below 3/4 of the
+// resolution when rounding to nearest and 5/4 of it otherwise.
+double tolerance(int F, bool nearest)
+{
+  return std::ldexp(nearest ? 0.75 : 1.25, -F);
+}
+
+// The distance between two angles in turns.
+double turn_distance(double a, double b)
+{
+  double d = std::fabs(a - b);
+  return d > 0.5 ? 1 - d : d;
+}
+
+template <typename Method, typename RP, int F>
+void check_sincos(bool nearest)
+{
+  double ulp = tolerance(F, nearest);
+  typedef ureal_t<0, -32, round::truncated, overflow::modulus> phase_t;
+  typedef real_t<1, -F, RP> Res;
+  unsigned long long state = 1;
+  for (int i = 0; i < 10000; ++i)
+  {
+    phase_t p( (index(boost::uint32_t(test::next_random(state) >> 32))));
+    double a = two_pi * p.as_double();
+    Res s, c;
+    sincos<Method>(p, s, c);
+    BOOST_TEST(close(s.as_double(), std::sin(a), ulp));
+    BOOST_TEST(close(c.as_double(), std::cos(a), ulp));
+    BOOST_TEST( (sin<Res, Method>(p).count() == s.count()));
+    BOOST_TEST( (cos<Res, Method>(p).count() == c.count()));
+  }
+}
+
+template <typename Method, typename RP, int F>
+void check_atan2(bool nearest)
+{
+  double ulp = tolerance(F, nearest);
+  typedef real_t<20, -8> T;
+  typedef real_t<0, -F, RP> Res;
+  typedef ureal_t<0, -F, RP, overflow::modulus> Phase;
+  unsigned long long state = 2;
+  for (int i = 0; i < 10000; ++i)
+  {
+    unsigned long long r = test::next_random(state);
+    // many small vectors
+    int bits = (r & 1) ? 6 : 27;
+    long long yi = (long long) ((r >> 8) % (1ULL << bits)) - (1LL << (bits - 1));
+    long long xi = (long long) ((r >> 36) % (1ULL << bits)) - (1LL << (bits - 1));
+    if (xi == 0 && yi == 0)
+      continue;
+    T y( (index(yi)));
+    T x( (index(xi)));
+    double a = std::atan2(double(yi), double(xi)) / two_pi;
+    BOOST_TEST(turn_distance(atan2<Res, Method>(y, x).as_double(), a) < ulp * (1 + 1e-9));
+    BOOST_TEST(turn_distance(atan2<Phase, Method>(y, x).as_double(), a < 0 ? a + 1 : a) < ulp * (1 + 1e-9));
+  }
+}
+
+template <typename Method>
+void check_exact()
+{
+  typedef real_t<1, -30, round::nearest_even> Res;
+  typedef real_t<0, -30, round::nearest_even> Angle;
+  typedef ureal_t<0, -30, round::nearest_even> Phase;
+  // the quadrants
+  for (int q = -8; q <= 8; ++q)
+  {
+    real_t<4, -2> x( (index(q)));
+    BOOST_TEST( (sin<Res, Method>(x).count() == Res(double(q % 4 == 1 || q % 4 == -3) - (q % 4 == 3 || q % 4 == -1))
+        .count()));
+    BOOST_TEST( (cos<Res, Method>(x).count() == Res(double(q % 4 == 0) - (q % 4 == 2 || q % 4 == -2)).count()));
+  }
+  BOOST_TEST( (sin<Res, Method>(real_t<3, -20>(0.125)) == Res(std::sqrt(0.5))));
+  BOOST_TEST( (cos<Res, Method>(real_t<3, -20>(-0.375)) == Res(-std::sqrt(0.5))));
+  // the axes and the diagonals
+  typedef real_t<15, -16> T;
+  BOOST_TEST( (atan2<Angle, Method>(T(0.0), T(0.0)).count() == 0));
+  BOOST_TEST( (atan2<Angle, Method>(T(0.0), T(3.0)).count() == 0));
+  BOOST_TEST( (atan2<Angle, Method>(T(3.0), T(0.0)) == Angle(0.25)));
+  BOOST_TEST( (atan2<Angle, Method>(T(-3.0), T(0.0)) == Angle(-0.25)));
+  BOOST_TEST( (atan2<Angle, Method>(T(0.0), T(-3.0)) == Angle(0.5)));
+  BOOST_TEST( (atan2<Angle, Method>(T(2.0), T(2.0)) == Angle(0.125)));
+  BOOST_TEST( (atan2<Angle, Method>(T(-2.0), T(-2.0)) == Angle(-0.375)));
+  BOOST_TEST( (atan2<Phase, Method>(T(-2.0), T(-2.0)) == Phase(0.625)));
+  BOOST_TEST( (atan2<Phase, Method>(T(0.0), T(-3.0)) == Phase(0.5)));
+}
+
+int main()
+{
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    check_sincos<trigonometric::table, round::nearest_even, 16>(true);
+    check_sincos<trigonometric::table, round::nearest_even, 30>(true);
+    check_sincos<trigonometric::table, round::negative, 30>(false);
+    check_sincos<trigonometric::table, round::positive, 30>(false);
+    check_sincos<trigonometric::table, round::nearest_even, 46>(true);
+  }
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    check_sincos<trigonometric::cordic, round::nearest_even, 16>(true);
+    check_sincos<trigonometric::cordic, round::nearest_even, 30>(true);
+    check_sincos<trigonometric::cordic, round::negative, 30>(false);
+    check_sincos<trigonometric::cordic, round::nearest_even, 46>(true);
+  }
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    check_atan2<trigonometric::table, round::nearest_even, 16>(true);
+    check_atan2<trigonometric::table, round::nearest_even, 28>(true);
+    check_atan2<trigonometric::table, round::negative, 28>(false);
+    check_atan2<trigonometric::cordic, round::nearest_even, 28>(true);
+    check_atan2<trigonometric::cordic, round::positive, 40>(false);
+  }
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    check_exact<trigonometric::table>();
+    check_exact<trigonometric::cordic>();
+  }
+  // the default method is the table
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    typedef real_t<1, -24> Res;
+    ureal_t<0, -32, round::truncated, overflow::modulus> p(0.3);
+    BOOST_TEST( (sin<Res>(p) == sin<Res, trigonometric::table>(p)));
+    BOOST_TEST( (cos<Res>(p) == cos<Res, trigonometric::table>(p)));
+    Res s, c;
+    sincos(p, s, c);
+    BOOST_TEST( (s == sin<Res>(p) && c == cos<Res>(p)));
+    BOOST_TEST( (atan2<real_t<0, -24> >(s, c) == atan2<real_t<0, -24>, trigonometric::table>(s, c)));
+  }
+  // 1 is handled by the overflow policy of a result without integral bits
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    typedef real_t<0, -15, round::nearest_even, overflow::saturate> S;
+    ureal_t<0, -16> quarter(0.25);
+    BOOST_TEST( (sin<S>(quarter).count() == S::max_index));
+    BOOST_TEST( (cos<S>(quarter).count() == 0));
+    try
+    {
+      sin<real_t<0, -15> >(quarter);
+      BOOST_TEST(false);
+    }
+    catch (positive_overflow&)
+    {
+    }
+  }
+  return boost::report_errors();
+}
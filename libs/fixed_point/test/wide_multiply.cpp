@@ -0,0 +1,90 @@
+// Copyright (C) 2012 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <iostream>
+#include <boost/fixed_point/number.hpp>
+#include <boost/detail/lightweight_test.hpp>
+
+using namespace boost::fixed_point;
+
+#if defined(BOOST_HAS_INT128)
+
+typedef real_t<31, -32> q31_32;
+typedef ureal_t<32, -32> uq32_32;
+
+q31_32 make(double x)
+{
+  return q31_32(index(boost::int64_t(std::ldexp(x, 32))));
+}
+
+int main()
+{
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    BOOST_TEST( (sizeof(multiply_result<q31_32>::type::underlying_type) == 16));
+    BOOST_TEST( (sizeof(multiply_result<uq32_32>::type::underlying_type) == 16));
+    BOOST_TEST( (q31_32::max_index == boost::int64_t((~boost::uint64_t(0)) >> 1)));
+    BOOST_TEST( (uq32_32::max_index == ~boost::uint64_t(0)));
+  }
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    q31_32 a = make(3.25);
+    q31_32 b = make(-1.5);
+    multiply_result<q31_32>::type p = a * b;
+    BOOST_TEST(p.as_double() == -4.875);
+    BOOST_TEST(number_cast<q31_32>(p).as_double() == -4.875);
+  }
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    // The product of the largest values needs all the 128 bits.
+    q31_32 a( (index(q31_32::max_index)));
+    multiply_result<q31_32>::type p = a * a;
+    BOOST_TEST(p.count() == boost::int128_type(q31_32::max_index) * q31_32::max_index);
+    BOOST_TEST(p.count() > 0);
+  }
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    // 2^-32 * 2^-32 = 2^-64 rounds to 0 or to 2^-32 depending on the rounding policy.
+    q31_32 a( (index(1)));
+    q31_32 m( (index(-1)));
+    BOOST_TEST( (number_cast<real_t<31, -32, round::negative> >(a * a).count() == 0));
+    BOOST_TEST( (number_cast<real_t<31, -32, round::positive> >(a * a).count() == 1));
+    BOOST_TEST( (number_cast<real_t<31, -32, round::negative> >(a * m).count() == -1));
+    BOOST_TEST( (number_cast<real_t<31, -32, round::truncated> >(a * m).count() == 0));
+    BOOST_TEST( (number_cast<real_t<31, -32, round::nearest_half_up> >(a * m).count() == 0));
+  }
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    q31_32 a = make(1 << 20);
+    q31_32 b = make(1 << 12);
+    BOOST_TEST( (number_cast<real_t<31, -32, round::negative, overflow::saturate> >(a * b).count()
+        == q31_32::max_index));
+    BOOST_TEST( (number_cast<real_t<31, -32, round::negative, overflow::saturate> >(a * -b).count()
+        == q31_32::min_index));
+  }
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    uq32_32 a( (index(boost::uint64_t(3) << 32)));
+    multiply_result<uq32_32>::type p = a * a;
+    BOOST_TEST(p.as_double() == 9);
+    BOOST_TEST(number_cast<uq32_32>(p).as_double() == 9);
+  }
+  {
+    std::cout << __FILE__ << "[" << __LINE__ << "]" << std::endl;
+    q31_32 a = make(6.5);
+    q31_32 b = make(-2);
+    BOOST_TEST(divide<q31_32>(a, b).as_double() == -3.25);
+  }
+  return boost::report_errors();
+}
+
+#else
+
+int main()
+{
+  return 0;
+}
+
+#endif